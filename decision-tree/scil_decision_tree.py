@@ -9,6 +9,7 @@ from sklearn.metrics import accuracy_score
 from sklearn.model_selection import train_test_split
 from sklearn.model_selection import cross_val_score
 import argparse
+import struct
 import os
 import warnings
 warnings.filterwarnings(action='ignore', category=DeprecationWarning)
@@ -33,8 +34,12 @@ parser.add_argument('tree_output',
                    help='Decision tree output file')
 parser.add_argument('method', type=int, choices=[1, 2, 3, 4],
                    help='Method to optimize for. 1: Group by kJ/CR 2: Group by Watt')
+parser.add_argument('--binary', action='store_true',
+                   help='Export the tree in the binary format')
 parser.add_argument('--image',
                    help='Export additionally as an image')
+parser.add_argument('--features',
+                   help='CSV file with the column Variable_Name and further features of each variable, see FEATURES')
 args = parser.parse_args()
 
 
@@ -64,42 +69,26 @@ elif args.method == 3:
     dataset['CR/Time'] = dataset['CR'] / dataset['Elapsed_Time'].apply(get_time)
     dataset = dataset.sort_values("CR/Time").groupby(["Variable_Name"], as_index=False).last()
 
-dataset = dataset.drop('FileSize_in_Folder_After', axis=1)
-dataset = dataset.drop('FileSize_in_Folder_Before', axis=1)
-dataset = dataset.drop('Nano_Seconds', axis=1)
-dataset = dataset.drop('CPU_Usage', axis=1)
-dataset = dataset.drop('Variable_Name', axis=1)
-dataset = dataset.drop('Min_Value', axis=1)
-dataset = dataset.drop('Max_Value', axis=1)
-dataset = dataset.drop('Elapsed_Time', axis=1)
-dataset = dataset.drop('Energy_Joules', axis=1)
-dataset = dataset.drop('CR', axis=1)
-dataset = dataset.drop('kJ/CR', axis=1, errors='ignore')
-dataset = dataset.drop('Watt', axis=1, errors='ignore')
-dataset = dataset.drop('Fill_Time', axis=1, errors='ignore')
-dataset = dataset.drop('Allocation_Time', axis=1, errors='ignore')
-dataset = dataset.drop('DataSpace_Class', axis=1, errors='ignore')
-dataset = dataset.drop('CR/Time', axis=1, errors='ignore')
-
-
-dataset = dataset.drop('Fill_Value', axis=1, errors='ignore')
-
-dataset = dataset.drop('Type_Precision', axis=1, errors='ignore')
-#dataset = dataset.drop('Number_of_Elements', axis=1, errors='ignore')
-dataset = dataset.drop('DataType_Size', axis=1, errors='ignore')
-dataset = dataset.drop('Number_of_Attributes', axis=1, errors='ignore')
-dataset = dataset.drop('Storage_Layout', axis=1, errors='ignore')
-dataset = dataset.drop('Fill_Value_Definition', axis=1, errors='ignore')
-
-
-#dataset = dataset.drop('Elapsed_Time', axis=1)
-dataset = dataset.drop('System_Time', axis=1)
-dataset = dataset.drop('User_Time', axis=1)
-#dataset = dataset.drop('Energy_Joules', axis=1)
-print(dataset.columns)
+# The features scilU_tree_compute_features() determines, see scilU_tree_feature_names in scil-decision-tree.c
+FEATURES = ['Storage_Size', 'Number_of_Elements', 'Array_Dimension', 'DM1', 'DM2', 'DM3', 'DM4',
+            'Data_Type_DOUBLE', 'Data_Type_FLOAT', 'Minimum', 'Maximum', 'Mean', 'Standard_Deviation',
+            'Gradient_Mean', 'Gradient_Maximum', 'Byte_Entropy', 'Fill_Ratio', 'Exponent_Span', 'Smoothness']
+
+# The measurements of variables_*.csv provide only the shape, the datatype, the minimum and the maximum of a
+# variable, a tree trained on them uses no other feature. The data features (Mean ... Smoothness) must be
+# provided with --features, e.g. as determined by scil_compute_data_characteristics() for the variables.
+# The shape features are those of the variable h5repack processed, at runtime SCIL reads them from the
+# H5REPACK_DIM_* environment variables if they are set and from the dims of the buffer otherwise.
+dataset = dataset.rename(columns={'Min_Value': 'Minimum', 'Max_Value': 'Maximum'})
+if args.features:
+    features = pd.read_csv(args.features)
+    features = features[['Variable_Name'] + [c for c in FEATURES if c in features.columns and c not in dataset.columns]]
+    dataset = dataset.merge(features, on='Variable_Name', how='inner')
 # Generate numerical data for categorical values
-X = pd.get_dummies(data=dataset, columns=['Data_Type']) # Fill_Value_Definition, Storage_Layout
-X = X.drop('Compressor', axis=1)
+X = pd.get_dummies(data=dataset, columns=['Data_Type'])
+# Only the features known to SCIL can be used, the others are measurements of the runs
+X = X[[c for c in FEATURES if c in X.columns]]
+print(X.columns)
 
 Y = dataset['Compressor']
 Y.tolist()
@@ -135,13 +124,7 @@ if args.image:
 
 # Process tree
 columns = ';'.join(map(str, X_train.columns.values))
-tree_classes = ''
-first = True
-for c in range(0, len(le.classes_)):
-    if not first:
-        tree_classes += ';'
-    tree_classes += ''.join(map(str, le.inverse_transform([c])))
-    first = False
+tree_classes = ';'.join(map(str, clf.classes_))
 
 # Export tree
 # Get values from tree
@@ -149,31 +132,48 @@ left = clf.tree_.children_left
 right = clf.tree_.children_right
 thresholds = clf.tree_.threshold
 features = clf.tree_.feature
-values = clf.tree_.value
-
-left_e = ';'.join(map(str, left))
-right_e = ';'.join(map(str, right))
-thresholds_e = ';'.join(map(str, thresholds))
-features_e = ';'.join(map(str, features))
-values_e = ';'.join(map(str, values))
-values_e = values_e.replace('[','').replace(']','').replace('  ', ' ')
-
-file = open(args.tree_output,"w")
-file.write("#classes\n")
-file.write(tree_classes)
-file.write("\n#columns\n") 
-file.write(columns)
-file.write("\n#left\n") 
-file.write(left_e)
-file.write("\n#right\n") 
-file.write(right_e)
-file.write("\n#thresholds\n") 
-file.write(thresholds_e)
-file.write("\n#indices\n") 
-file.write(features_e)
-file.write("\n#values\n") 
-file.write(values_e)
-file.close() 
+# the samples per class of each node
+values = clf.tree_.value[:, 0, :]
+
+if args.binary:
+    def pack_name(name):
+        data = str(name).encode()
+        return struct.pack('<H', len(data)) + data
+
+    count = len(left)
+    with open(args.tree_output, "wb") as file:
+        file.write(b'SCILTREE')
+        file.write(struct.pack('<4I', 1, count, len(X_train.columns), len(clf.classes_)))
+        for name in list(X_train.columns.values) + list(clf.classes_):
+            file.write(pack_name(name))
+        file.write(struct.pack('<{}i'.format(count), *left))
+        file.write(struct.pack('<{}i'.format(count), *right))
+        file.write(struct.pack('<{}i'.format(count), *features))
+        file.write(struct.pack('<{}d'.format(count), *thresholds))
+        file.write(struct.pack('<{}i'.format(count), *np.argmax(values, axis=1)))
+else:
+    left_e = ';'.join(map(str, left))
+    right_e = ';'.join(map(str, right))
+    thresholds_e = ';'.join(map(repr, map(float, thresholds)))
+    features_e = ';'.join(map(str, features))
+    values_e = ';'.join(' '.join(map(repr, map(float, v))) for v in values)
+
+    file = open(args.tree_output,"w")
+    file.write("#classes\n")
+    file.write(tree_classes)
+    file.write("\n#columns\n")
+    file.write(columns)
+    file.write("\n#left\n")
+    file.write(left_e)
+    file.write("\n#right\n")
+    file.write(right_e)
+    file.write("\n#thresholds\n")
+    file.write(thresholds_e)
+    file.write("\n#indices\n")
+    file.write(features_e)
+    file.write("\n#values\n")
+    file.write(values_e)
+    file.close()
 
 print()
 print("Use by exporting path to tree e.g.")
@@ -7,11 +7,20 @@ import sys
 import os
 import fnmatch
 
+# the bit widths for which the regions marked with "Repeat for each bit width" are created
+BIT_WIDTHS = range(1, 65)
+
 
 def replaceFunc(data, d):
   datatype_size = { "float": 4,"double": 8,"int8_t" : 1,"int16_t":2,"int32_t":4,"int64_t":8 }
   return data.replace("<DATATYPE>", d).replace("<DATATYPE_UPPER>", d.upper().replace("_T", "")).replace("<DATATYPE_SIZE>", str(datatype_size[d] * 8)).replace("<DATATYPE_SIZE_BYTE>", str(datatype_size[d]))
 
+def replaceBitWidth(data, bits):
+  return data.replace("<BITS>", str(bits))
+
+def createBitWidthList(name):
+  return ",\n      ".join( [ name + "_" + str(b) for b in BIT_WIDTHS ] )
+
 def createFunctionList(datatypes_list):
   DATATYPES_FULL=["float","double","int8_t","int16_t","int32_t","int64_t"]
 
@@ -38,6 +47,7 @@ def parsefile(infile, outfile):
   outData = []
   repeatData = []
   repeat = False
+  repeat_bits = False
   all_supported = []
 
   for l in lines:
@@ -49,6 +59,15 @@ def parsefile(infile, outfile):
     if re.search("//.*Repeat for each data type", l):
       repeat = True
       continue
+    if re.search("//.*Repeat for each bit width", l):
+      repeat_bits = True
+      continue
+    if re.search("//.*End repeat", l) and repeat_bits:
+      repeat_bits = False
+      for b in BIT_WIDTHS:
+        outData.append( replaceBitWidth("\n".join(repeatData), b) )
+      repeatData = []
+      continue
     if re.search("//.*End repeat", l):
       repeat = False
       # paste the lines
@@ -56,6 +75,10 @@ def parsefile(infile, outfile):
         outData.append( replaceFunc("\n".join(repeatData), d) )
       repeatData = []
       continue
+    m = re.search("CREATE_BIT_WIDTH_INITIALIZER[(](.*)[)]", l)
+    if(m):
+      outData.append(createBitWidthList(m.group(1)))
+      continue
     m = re.search("CREATE_INITIALIZER[(](.*)[)]", l)
     if(m):
       init_name = m.group(1)
@@ -71,7 +94,7 @@ def parsefile(infile, outfile):
       datatype_list = ",\n      ".join( datatypes_list )
       outData.append(datatype_list)
       continue
-    if not repeat:
+    if not repeat and not repeat_bits:
       outData.append(l)
     else:
       repeatData.append(l)
@@ -16,6 +16,12 @@ const char * performance_units[] = {
 	"SingleStreamSharedStorageSpeed"
 };
 
+const char * objective_names[] = {
+	"time",
+	"ratio",
+	"energy"
+};
+
 
 static const char * hint_names[] = {"relative_tolerance_percent",
 	"relative_err_finest_abs_tolerance",
@@ -28,6 +34,10 @@ static const char * hint_names[] = {"relative_tolerance_percent",
 	"comp_speed",
 	"decomp_speed",
 	"force_compression_methods",
+	"parallel_threads",
+	"parallel_block_size",
+	"checksum",
+	"objective",
 	NULL};
 
 static void print_hint_dbl_values(const char * name, const double val ){
@@ -89,6 +99,9 @@ void scil_user_hints_print(const scil_user_hints_t *hints)
 	print_hint_dbl_values("rel abs tol", hints->relative_err_finest_abs_tolerance);
 	print_performance_hint("Comp speed", hints->comp_speed);
 	print_performance_hint("Deco speed", hints->decomp_speed);
+	printf("\t%s:\t%s\n", "objective", objective_names[hints->objective]);
+	print_hint_int_values("threads", hints->parallel_threads);
+	printf("\t%s:\t%zu\n", "block size", hints->parallel_block_size);
 }
 
 static int scil_readline(FILE * fd, int maxlength, char * out){
@@ -136,6 +149,16 @@ static int scil_string_to_performance(char * value, scil_performance_hint_t * p)
 	return SCIL_EINVAL;
 }
 
+static int scil_string_to_objective(const char * value, enum scil_objective * o){
+	for(int i=0; i < SCIL_OBJECTIVE_LAST; i++){
+		if(strcasecmp(value, objective_names[i]) == 0){
+			*o = i;
+			return SCIL_NO_ERR;
+		}
+	}
+	return SCIL_EINVAL;
+}
+
 int scil_set_user_hint_from_string(scil_user_hints_t * hints, const char * var){
 	int len = strlen(var);
 	int i;
@@ -204,6 +227,22 @@ int scil_set_user_hint_from_string(scil_user_hints_t * hints, const char * var){
 				case(10):
 				  hints->force_compression_methods = strdup(value);
 				  break;
+				case(11):
+				  hints->parallel_threads = atoi(value);
+				  break;
+				case(12):
+				  hints->parallel_block_size = (size_t) atoll(value);
+				  break;
+				case(13):
+				  hints->checksum = atoi(value);
+				  break;
+				case(14):
+				  ret = scil_string_to_objective(value, & hints->objective);
+					if(ret != SCIL_NO_ERR){
+						printf("Error could not parse objective: %s", var);
+						exit(1);
+					}
+				  break;
 				default:
 					printf("Error could not parse key,value: %s,%s \n", key, value);
 					exit(1);
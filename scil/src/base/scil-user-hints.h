@@ -25,6 +25,22 @@ enum scil_performance_unit {
 
 extern const char * performance_units[];
 
+// ############################################################################
+// ## scil_objective
+// ############################################################################
+
+/**
+ * \brief What the chooser minimizes when it selects a chain.
+ */
+enum scil_objective {
+    SCIL_OBJECTIVE_TIME = 0, // the time to compress, transfer and decompress the data
+    SCIL_OBJECTIVE_RATIO, // the size of the compressed data
+    SCIL_OBJECTIVE_ENERGY, // the energy to compress, transfer and decompress the data
+    SCIL_OBJECTIVE_LAST
+};
+
+extern const char * objective_names[];
+
 /**
  * \brief Structure, describing the required performance.
  * It consists of a base unit and a multiplier, the result is "multiplier * unit".
@@ -104,9 +120,23 @@ typedef struct
     scil_performance_hint_t comp_speed;
     scil_performance_hint_t decomp_speed;
 
+    /** \brief What the chooser optimizes for among the chains that satisfy the other hints */
+    enum scil_objective objective;
+
     /** \brief */
     char *force_compression_methods;
 
+    /** \brief Number of threads used to compress blocks of the data in parallel, values below 2 disable the block mode */
+    int parallel_threads;
+
+    /** \brief Target size of an independently compressed block in bytes, 0 selects the default size.
+     * Setting it enables the block container also for a single thread, which allows to decompress regions efficiently.
+     */
+    size_t parallel_block_size;
+
+    /** \brief Store a checksum of the compressed data that is verified on decompression */
+    int checksum;
+
 } scil_user_hints_t;
 
 void scil_user_hints_initialize(scil_user_hints_t * hints);
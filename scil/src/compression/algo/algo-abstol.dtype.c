@@ -15,6 +15,7 @@
 
 #include <algo/algo-abstol.h>
 
+#include <scil-minmax.h>
 #include <scil-quantizer.h>
 #include <scil-swager.h>
 #include <scil-util.h>
@@ -31,6 +32,9 @@ static uint64_t round_up_byte(const uint64_t bits){
     return 1 + (bits - a) / 8;
 }
 
+// the number of values that are quantized and packed at once, the intermediate values stay in the L1 cache
+#define TILE_COUNT 256
+
 static int read_header(const byte* source,
                         size_t* source_size,
                         double* minimum,
@@ -85,6 +89,56 @@ static int write_header(byte* dest, double minimum, double absolute_tolerance, u
 //Repeat for each data type
 //Supported datatypes: double float int8_t int16_t int32_t int64_t
 
+// quantize and pack the data tile by tile in a single pass
+static void quantize_swage_<DATATYPE>(byte* restrict dest,
+                                      const <DATATYPE>* restrict source,
+                                      size_t count,
+                                      double abs_tol,
+                                      <DATATYPE> min,
+                                      <DATATYPE> max,
+                                      uint8_t bits_per_value,
+                                      double fill_value,
+                                      uint64_t next_free_number){
+    uint64_t tile[TILE_COUNT];
+    scil_swage_stream_t stream;
+    scil_swage_stream_begin(&stream, dest);
+
+    for(size_t i = 0; i < count; i += TILE_COUNT){
+        const size_t n = count - i < TILE_COUNT ? count - i : TILE_COUNT;
+        if (fill_value == DBL_MAX){
+            scil_quantize_buffer_minmax_<DATATYPE>(tile, source + i, n, abs_tol, min, max);
+        }else{
+            scil_quantize_buffer_minmax_fill_<DATATYPE>(tile, source + i, n, abs_tol, min, max, fill_value, next_free_number);
+        }
+        scil_swage_stream_push(&stream, tile, n, bits_per_value);
+    }
+    scil_swage_stream_end(&stream, dest);
+}
+
+// unpack and unquantize the data tile by tile in a single pass
+static void unswage_unquantize_<DATATYPE>(<DATATYPE>* restrict dest,
+                                          const byte* restrict source,
+                                          size_t count,
+                                          double abs_tol,
+                                          double min,
+                                          uint8_t bits_per_value,
+                                          double fill_value,
+                                          uint64_t next_free_number){
+    uint64_t tile[TILE_COUNT];
+    scil_unswage_stream_t stream;
+    scil_unswage_stream_begin(&stream, source);
+
+    for(size_t i = 0; i < count; i += TILE_COUNT){
+        const size_t n = count - i < TILE_COUNT ? count - i : TILE_COUNT;
+        scil_unswage_stream_pull(&stream, tile, n, bits_per_value);
+        if (fill_value == DBL_MAX){
+            scil_unquantize_buffer_<DATATYPE>(dest + i, tile, n, abs_tol, min);
+        }else{
+            scil_unquantize_buffer_fill_<DATATYPE>(dest + i, tile, n, abs_tol, min, fill_value, next_free_number);
+        }
+    }
+}
+
 int scil_abstol_compress_<DATATYPE>(const scil_context_t* ctx,
                                     byte* restrict dest,
                                     size_t* restrict dest_size,
@@ -100,12 +154,12 @@ int scil_abstol_compress_<DATATYPE>(const scil_context_t* ctx,
 
     // Finding minimum and maximum values in data
     <DATATYPE> min, max;
-    scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(source, count, &min, &max, ctx->hints.lossless_data_range_up_to,  ctx->hints.lossless_data_range_from, ctx->hints.fill_value);
+    scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>(ctx, source, count, &min, &max, ctx->hints.lossless_data_range_up_to,  ctx->hints.lossless_data_range_from, ctx->hints.fill_value);
 
     // Locally assigning absolute tolerance
     double abs_tol = ctx->hints.absolute_tolerance; // prevent rounding errors
 
-    uint64_t next_free_number;
+    uint64_t next_free_number = 0;
     int reserved = 0;
     // Get needed bits per compressed number in data
     uint8_t bits_per_value = scil_calculate_bits_needed_<DATATYPE>(min, max, abs_tol, reserved, & next_free_number);
@@ -132,27 +186,10 @@ int scil_abstol_compress_<DATATYPE>(const scil_context_t* ctx,
     }
     *dest_size = round_up_byte((uint64_t)bits_per_value * count) + header_size;
 
-    uint64_t* quantized_buffer = (uint64_t*)scilU_safe_malloc(count * sizeof(uint64_t));
-
-    if (ctx->hints.fill_value == DBL_MAX){
-      // Use quantization to reduce each values bit count
-      if(scil_quantize_buffer_minmax_<DATATYPE>(quantized_buffer, source, count, abs_tol, min, max)){
-          return SCIL_BUFFER_ERR;
-      }
-    }else{ // use the fill value
-      if(scil_quantize_buffer_minmax_fill_<DATATYPE>(quantized_buffer, source, count, abs_tol, min, max, ctx->hints.fill_value, next_free_number)){
-          return SCIL_BUFFER_ERR;
-      }
-    }
-
-    // Pack data in quantized buffer tightly
-    if(scil_swage(dest, quantized_buffer, count, bits_per_value)){
-        return SCIL_BUFFER_ERR;
-    }
+    // Use quantization to reduce each values bit count and pack the data tightly
+    quantize_swage_<DATATYPE>(dest, source, count, abs_tol, min, max, bits_per_value, ctx->hints.fill_value, next_free_number);
     // ========================================================================
 
-    free(quantized_buffer);
-
     return SCIL_NO_ERR;
 }
 
@@ -170,7 +207,7 @@ int scil_abstol_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
     byte* in = source;
     size_t in_size = source_size;
     size_t count = scil_dims_get_count(dims);
-    uint64_t next_free_number;
+    uint64_t next_free_number = 0;
 
     // ============ Decompress ================================================
     // Parse Header
@@ -182,32 +219,26 @@ int scil_abstol_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
       return SCIL_NO_ERR;
     }
 
-    uint64_t* unswaged_buffer = (uint64_t*)scilU_safe_malloc(count * sizeof(uint64_t*));
-    // Unpacking buffer
-    if(scil_unswage(unswaged_buffer, in, count, bits_per_value)){
+    if(in_size < round_up_byte((uint64_t)bits_per_value * count)){
         return SCIL_BUFFER_ERR;
     }
 
-    if (fill_value == DBL_MAX){
-      // Unquantizing buffer
-      if(scil_unquantize_buffer_<DATATYPE>(dest, unswaged_buffer, count, abs_tol, min)){
-          return SCIL_BUFFER_ERR;
-      }
-    }else{
-      if(scil_unquantize_buffer_fill_<DATATYPE>(dest, unswaged_buffer, count, abs_tol, min, fill_value, next_free_number)){
-          return SCIL_BUFFER_ERR;
-      }
-    }
+    // Unpacking and unquantizing buffer
+    unswage_unquantize_<DATATYPE>(dest, in, count, abs_tol, min, bits_per_value, fill_value, next_free_number);
     // ========================================================================
 
-    free(unswaged_buffer);
-
     return SCIL_NO_ERR;
 }
 // End repeat
 
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_abstol_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    // less bits than the datatype are used per value, the largest header contains the fill value and next free number
+    return in_size + 33;
+}
+
 scilU_algorithm_t algo_abstol = {
     .c.DNtype = {
         CREATE_INITIALIZER(scil_abstol)
@@ -215,5 +246,6 @@ scilU_algorithm_t algo_abstol = {
     "abstol",
     1,
     SCIL_COMPRESSOR_TYPE_DATATYPES,
-    1
+    1,
+    scil_abstol_compress_bound
 };
@@ -21,6 +21,7 @@
 #include <scil-error.h>
 #include <scil-util.h>
 #include <scil-quantizer.h>
+#include <scil-swager.h>
 
 static uint64_t mask[] = {
     0,
@@ -127,108 +128,6 @@ static uint64_t get_mantissa_double(uint64_t value, uint8_t mantissa_bit_count){
     return (value & mask[mantissa_bit_count]) << (MANTISSA_LENGTH_DOUBLE - mantissa_bit_count);
 }
 
-// Taken from scil-swager.c, but now working with steps of 1 value
-
-static uint8_t start_mask[9] = {
-    255, //0b11111111
-    127, //0b01111111
-    63,  //0b00111111
-    31,  //0b00011111
-    15,  //0b00001111
-    7,   //0b00000111
-    3,   //0b00000011
-    1,   //0b00000001
-    0    //0b00000000
-};
-
-static uint8_t end_mask[9] = {
-    0,         //0b00000000
-    255 - 127, //0b10000000
-    255 - 63,  //0b11000000
-    255 - 31,  //0b11100000
-    255 - 15,  //0b11110000
-    255 - 7,   //0b11111000
-    255 - 3,   //0b11111100
-    255 - 1,   //0b11111110
-    255        //0b11111111
-};
-
-// Can do negative right shifts!! (left shifts)
-static byte right_shift_64(uint64_t value, int amount){
-    return (byte)(amount >= 0 ?
-        value >> amount :
-        value << -amount);
-}
-
-static uint64_t right_shift_8(byte value, int amount){
-    return (amount >= 0 ?
-        ((uint64_t)value) >> amount :
-        ((uint64_t)value) << -amount);
-}
-
-static void swage_value(byte* restrict buf_out,
-                        const uint64_t value_in,
-                        const uint8_t bit_count,
-                        size_t* bit_index) {
-
-    size_t start_byte = *bit_index / 8;
-    size_t end_byte   = (*bit_index + bit_count) / 8;
-    uint8_t bit_offset = *bit_index % 8;
-
-    int8_t right_shifts = bit_count + bit_offset - 8;
-
-    // Write to first byte
-
-    // Set remaining bits in start_byte to 0
-    buf_out[start_byte] &= end_mask[bit_offset];
-    // Write as much bits of number as possible to remaining bits
-    buf_out[start_byte] |= right_shift_64(value_in, right_shifts);
-
-    // Write to following bytes
-    uint8_t k = 1;
-    for(uint64_t j = start_byte + 1; j <= end_byte; ++j)
-    {
-        buf_out[j] = right_shift_64(value_in, right_shifts - k * 8);
-        ++k;
-    }
-
-    *bit_index += bit_count;
-}
-
-static void unswage_value(uint64_t* value_out,
-                          const byte* restrict buf_in,
-                          const uint8_t bit_count,
-                          size_t* bit_index) {
-
-    size_t start_byte = *bit_index / 8;                         // Index of starting byte of current value in swaged buffer
-    size_t end_byte   = (*bit_index + bit_count) / 8;      // Index of ending byte of current value in swaged buffer
-
-    uint8_t bit_offset = *bit_index % 8;                        // Index of current bit in byte [0-7]
-    uint8_t end_byte_bits = (*bit_index + bit_count) % 8;  // Number of bits in end_byte occupied by current value
-
-    int8_t right_shifts = 8 - bit_count - bit_offset;
-
-    // Read from start_byte
-    uint64_t intermed = right_shift_8(buf_in[start_byte] & start_mask[bit_offset], right_shifts); // Masks away first value-unrelated bits in start_byte and shifts related bits to final position
-    // Read from intermediate bytes
-    uint8_t k = 1;
-    for(uint64_t j = start_byte + 1; j < end_byte; ++j)
-    {
-        intermed |= right_shift_8(buf_in[j], right_shifts + k * 8); // Shifts whole byte to final position and applies it
-        ++k;
-    }
-    // Read from end_byte
-    if(start_byte != end_byte)
-    {
-        intermed |= right_shift_8(buf_in[end_byte], 8 - end_byte_bits); // Shifts out unrelated end bits in end_byte and applies value
-    }
-
-    // Write to output buffer
-    *value_out = intermed;
-
-    *bit_index += bit_count;
-}
-
 //Supported datatypes: double float
 // Repeat for each data type
 
@@ -796,26 +695,26 @@ static int compress_buffer_<DATATYPE>(byte * restrict dest,
         cur.f = source[i];
 
         if((double)cur.f == fill_value && fill_value != DBL_MAX) {
-            swage_value(dest, fill_prefix_value,
+            scil_swage_value(dest, fill_prefix_value,
                 stats->fill.prefix_bit_count, &bit_index);
         } else if(cur.p.exponent < finest_exponent - 1) {
-            swage_value(dest, zero_prefix_value,
+            scil_swage_value(dest, zero_prefix_value,
                 stats->zero.prefix_bit_count, &bit_index);
         } else if(cur.p.exponent < finest_exponent) {
             if(cur.p.sign) {
-                swage_value(dest, relneg_prefix_value,
+                scil_swage_value(dest, relneg_prefix_value,
                     stats->relneg.prefix_bit_count, &bit_index);
-                swage_value(dest, finest_neg,
+                scil_swage_value(dest, finest_neg,
                     relneg_data_bit_count, &bit_index);
             } else {
-                swage_value(dest, relpos_prefix_value,
+                scil_swage_value(dest, relpos_prefix_value,
                     stats->relpos.prefix_bit_count, &bit_index);
-                swage_value(dest, finest_pos,
+                scil_swage_value(dest, finest_pos,
                     relpos_data_bit_count, &bit_index);
             }
         } else if(cur.p.exponent < abstol_min_exponent) {
             if(cur.p.sign) {
-                swage_value(dest, relneg_prefix_value,
+                scil_swage_value(dest, relneg_prefix_value,
                     stats->relneg.prefix_bit_count, &bit_index);
                 // Compress_value needs min_exponent, but caution:
                 // For negative values this is the exponent of the max
@@ -824,32 +723,32 @@ static int compress_buffer_<DATATYPE>(byte * restrict dest,
                     stats->relneg.exponent_bit_count,
                     stats->relneg.mantissa_bit_count,
                     stats->relneg.max.p.exponent);
-                swage_value(dest, unswaged,
+                scil_swage_value(dest, unswaged,
                     relneg_data_bit_count, &bit_index);
             } else {
-                swage_value(dest, relpos_prefix_value,
+                scil_swage_value(dest, relpos_prefix_value,
                     stats->relpos.prefix_bit_count, &bit_index);
                 unswaged = compress_value_<DATATYPE>(source[i],
                     stats->relpos.exponent_bit_count,
                     stats->relpos.mantissa_bit_count,
                     stats->relpos.min.p.exponent);
-                swage_value(dest, unswaged,
+                scil_swage_value(dest, unswaged,
                     relpos_data_bit_count, &bit_index);
             }
         } else {
             if(cur.p.sign) {
                 unswaged = quantize_value_<DATATYPE>(source[i], abstol,
                     stats->absneg.min.f);
-                swage_value(dest, absneg_prefix_value,
+                scil_swage_value(dest, absneg_prefix_value,
                     stats->absneg.prefix_bit_count, &bit_index);
-                swage_value(dest, unswaged,
+                scil_swage_value(dest, unswaged,
                     stats->absneg.mantissa_bit_count, &bit_index);
             } else {
                 unswaged = quantize_value_<DATATYPE>(source[i], abstol,
                     stats->abspos.min.f);
-                swage_value(dest, abspos_prefix_value,
+                scil_swage_value(dest, abspos_prefix_value,
                     stats->abspos.prefix_bit_count, &bit_index);
-                swage_value(dest, unswaged,
+                scil_swage_value(dest, unswaged,
                     stats->abspos.mantissa_bit_count, &bit_index);
             }
         }
@@ -884,7 +783,7 @@ static int decompress_buffer_<DATATYPE>(<DATATYPE>* restrict dest,
       // and then rewind some bits, because we did not read a full byte.
       // From knowing the region we then know how many data bits to read next.
 
-      unswage_value(&unswaged, source, 8, &bit_index);
+      scil_unswage_value(&unswaged, source, 8, &bit_index);
       prefix_byte = (uint8_t)unswaged;
 
       if ((prefix_byte & stats->zero.prefix_mask) ==
@@ -898,27 +797,27 @@ static int decompress_buffer_<DATATYPE>(<DATATYPE>* restrict dest,
       } else if ((prefix_byte & stats->relneg.prefix_mask) ==
         stats->relneg.prefix_value) {
           bit_index -= 8 - stats->relneg.prefix_bit_count;
-          unswage_value(&unswaged, source, relneg_data_bit_count, &bit_index);
+          scil_unswage_value(&unswaged, source, relneg_data_bit_count, &bit_index);
           dest[i] = -decompress_value_<DATATYPE>(unswaged,
             stats->relneg.exponent_bit_count, stats->relneg.mantissa_bit_count,
             stats->relneg.max.p.exponent);
       } else if ((prefix_byte & stats->relpos.prefix_mask) ==
         stats->relpos.prefix_value) {
           bit_index -= 8 - stats->relpos.prefix_bit_count;
-          unswage_value(&unswaged, source, relpos_data_bit_count, &bit_index);
+          scil_unswage_value(&unswaged, source, relpos_data_bit_count, &bit_index);
           dest[i] = decompress_value_<DATATYPE>(unswaged,
             stats->relpos.exponent_bit_count, stats->relpos.mantissa_bit_count,
             stats->relpos.min.p.exponent);
       } else if ((prefix_byte & stats->absneg.prefix_mask) ==
         stats->absneg.prefix_value) {
           bit_index -= 8 - stats->absneg.prefix_bit_count;
-          unswage_value(&unswaged, source, stats->absneg.mantissa_bit_count, &bit_index);
+          scil_unswage_value(&unswaged, source, stats->absneg.mantissa_bit_count, &bit_index);
           dest[i] = unquantize_value_<DATATYPE>(unswaged, abstol,
               stats->absneg.min.f);
       } else if ((prefix_byte & stats->abspos.prefix_mask) ==
         stats->abspos.prefix_value) {
           bit_index -= 8 - stats->abspos.prefix_bit_count;
-          unswage_value(&unswaged, source, stats->abspos.mantissa_bit_count, &bit_index);
+          scil_unswage_value(&unswaged, source, stats->abspos.mantissa_bit_count, &bit_index);
           dest[i] = unquantize_value_<DATATYPE>(unswaged, abstol,
               stats->abspos.min.f);
       } else {
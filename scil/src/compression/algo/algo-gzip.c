@@ -19,7 +19,7 @@
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_gzip_compress(const scil_context_t* ctx, byte* restrict dest, size_t* restrict dest_size, const byte*restrict source, const size_t source_size){
-  *dest_size = 2*source_size;
+  *dest_size = compressBound((uLong) source_size);
   int ret = compress( (Bytef*)dest, dest_size, (Bytef*)source, (uLong)(source_size) );
   if (ret == Z_OK){
     return SCIL_NO_ERR;
@@ -47,6 +47,11 @@ int scil_gzip_decompress(byte*restrict data_out, size_t buff_size,  const byte*r
   return ret;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_gzip_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  return compressBound((uLong) in_size);
+}
+
 scilU_algorithm_t algo_gzip = {
     .c.Btype = {
         scil_gzip_compress,
@@ -54,5 +59,7 @@ scilU_algorithm_t algo_gzip = {
     },
     "gzip",
     2,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_gzip_compress_bound
 };
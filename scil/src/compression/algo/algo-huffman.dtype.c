@@ -0,0 +1,136 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algo/algo-huffman.h>
+
+#include <scil-huffman.h>
+#include <scil-minmax.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <string.h>
+
+// the header is the mode and the minimum as int64_t
+#define HEADER_SIZE 9
+
+enum mode {
+    MODE_CODED = 0,
+    MODE_RAW
+};
+
+//Repeat for each data type
+//Supported datatypes: int8_t int16_t int32_t int64_t
+
+int scil_huffman_algo_compress_<DATATYPE>(const scil_context_t* ctx,
+                                          byte* restrict dest,
+                                          size_t* restrict dest_size,
+                                          <DATATYPE>* restrict source,
+                                          const scil_dims_t* dims){
+    assert(dest != NULL);
+    assert(dest_size != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    const size_t count = scil_dims_get_count(dims);
+    <DATATYPE> min, max;
+    scilC_find_minimum_maximum_<DATATYPE>(ctx, source, count, &min, &max);
+    const int64_t minimum = (int64_t) min;
+    scilU_pack8(dest + 1, minimum);
+
+    // the difference is computed unsigned, it does not overflow for int64_t
+    if((uint64_t) (int64_t) max - (uint64_t) minimum >= SCIL_HUFFMAN_MAX_SYMBOLS){
+        dest[0] = MODE_RAW;
+        memcpy(dest + HEADER_SIZE, source, count * sizeof(<DATATYPE>));
+        *dest_size = HEADER_SIZE + count * sizeof(<DATATYPE>);
+        return SCIL_NO_ERR;
+    }
+
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    uint64_t* values = (uint64_t*) scilU_workspace_alloc(ctx->workspace, count * sizeof(uint64_t));
+    if(values == NULL){
+        return SCIL_MEMORY_ERR;
+    }
+    for(size_t i = 0; i < count; i++){
+        values[i] = (uint64_t) (int64_t) source[i] - (uint64_t) minimum;
+    }
+    dest[0] = MODE_CODED;
+    size_t size;
+    int ret = scil_huffman_compress(dest + HEADER_SIZE, &size, values, count);
+    *dest_size = HEADER_SIZE + size;
+
+    scilU_workspace_release(ctx->workspace, mark);
+    return ret;
+}
+
+int scil_huffman_algo_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
+                                            scil_dims_t* dims,
+                                            byte* restrict source,
+                                            size_t in_size){
+    assert(dest != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    if(in_size < HEADER_SIZE){
+        return SCIL_BUFFER_ERR;
+    }
+    const size_t count = scil_dims_get_count(dims);
+    int64_t minimum;
+    scilU_unpack8(source + 1, &minimum);
+
+    if(source[0] == MODE_RAW){
+        if(in_size - HEADER_SIZE < count * sizeof(<DATATYPE>)){
+            return SCIL_BUFFER_ERR;
+        }
+        memcpy(dest, source + HEADER_SIZE, count * sizeof(<DATATYPE>));
+        return SCIL_NO_ERR;
+    }
+    if(source[0] != MODE_CODED){
+        return SCIL_BUFFER_ERR;
+    }
+
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    uint64_t* values = (uint64_t*) scilU_workspace_alloc(ws, count * sizeof(uint64_t));
+    if(values == NULL){
+        return SCIL_MEMORY_ERR;
+    }
+    int ret = scil_huffman_decompress(values, count, source + HEADER_SIZE, in_size - HEADER_SIZE);
+    if(ret == SCIL_NO_ERR){
+        for(size_t i = 0; i < count; i++){
+            dest[i] = (<DATATYPE>) (int64_t) (values[i] + (uint64_t) minimum);
+        }
+    }
+
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+// End repeat
+
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_huffman_algo_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    const size_t coded = scil_huffman_compress_bound(count);
+    return HEADER_SIZE + (coded > in_size ? coded : in_size);
+}
+
+scilU_algorithm_t algo_huffman = {
+    .c.DNtype = {
+        CREATE_INITIALIZER(scil_huffman_algo)
+    },
+    "huffman",
+    23,
+    SCIL_COMPRESSOR_TYPE_DATATYPES,
+    0,
+    scil_huffman_algo_compress_bound
+};
@@ -33,6 +33,11 @@ int scil_memcopy_decompress(byte*restrict dest, size_t buff_size, const byte*res
     return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_memcopy_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    return in_size;
+}
+
 scilU_algorithm_t algo_memcopy = {
     .c.Btype = {
         scil_memcopy_compress,
@@ -40,5 +45,7 @@ scilU_algorithm_t algo_memcopy = {
     },
     "memcopy",
     0,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_memcopy_compress_bound
 };
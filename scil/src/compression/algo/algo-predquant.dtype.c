@@ -0,0 +1,498 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algo/algo-predquant.h>
+
+#include <scil-rans.h>
+#include <scil-thread-pool.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+/*
+ * The format:
+ * double absolute tolerance
+ * double fill value, DBL_MAX if there is none
+ * uint64_t rows of the slowest dimension per block
+ * uint64_t blocks
+ * uint64_t the compressed size of each block
+ * the blocks, each consists of:
+ *   uint64_t exact values, then the exact values in the data type
+ *   the codes of all values of the block coded with scil_rans_compress()
+ */
+#define HEADER_SIZE 32
+
+#define MAX_DIMS 4
+
+// the target number of values of a block, the rANS model and the exact values are stored per block
+#define BLOCK_VALUES (1 << 18)
+
+// the largest bin, a residual that needs more is stored exactly
+#define QUANT_LIMIT 2147483647.0
+
+// the codes of the values, a bin q is coded as CODE_BIN + zigzag(q)
+#define CODE_EXACT 0
+#define CODE_FILL 1
+#define CODE_BIN 2
+
+/*
+ * The lorenzo predictor adds and subtracts the neighbours on the corners of the hypercube that ends at a value.
+ * At the borders of a block only the dimensions in which a neighbour exists are used,
+ * the terms for each combination of available dimensions (mask) are precomputed.
+ */
+typedef struct{
+    size_t length[MAX_DIMS]; // the lengths padded with 1
+    int slowest;             // the dimension the blocks are split along
+    size_t row_values;       // the values of one index of the slowest dimension
+    size_t rows_per_block;
+    size_t block_count;
+
+    int terms[1 << MAX_DIMS];
+    size_t offset[1 << MAX_DIMS][(1 << MAX_DIMS) - 1];
+    int negative[1 << MAX_DIMS][(1 << MAX_DIMS) - 1];
+} layout_t;
+
+// rows_per_block is derived from BLOCK_VALUES if it is 0
+static void layout_init(layout_t* l, const scil_dims_t* dims, size_t rows_per_block){
+    size_t stride[MAX_DIMS];
+    size_t count = 1;
+    l->slowest = dims->dims < 1 ? 0 : (dims->dims > MAX_DIMS ? MAX_DIMS : dims->dims) - 1;
+    for(int k = 0; k < MAX_DIMS; k++){
+        l->length[k] = 1;
+    }
+    // more dimensions are folded into the last one
+    for(int k = 0; k < dims->dims; k++){
+        l->length[k < MAX_DIMS ? k : MAX_DIMS - 1] *= dims->length[k];
+    }
+    for(int k = 0; k < MAX_DIMS; k++){
+        stride[k] = count;
+        count *= l->length[k];
+    }
+    l->row_values = stride[l->slowest];
+
+    if(rows_per_block == 0){
+        rows_per_block = l->row_values >= BLOCK_VALUES ? 1 : BLOCK_VALUES / l->row_values;
+    }
+    l->rows_per_block = rows_per_block;
+    l->block_count = count == 0 ? 0 : (l->length[l->slowest] + rows_per_block - 1) / rows_per_block;
+
+    for(int mask = 0; mask < 1 << MAX_DIMS; mask++){
+        l->terms[mask] = 0;
+        for(int subset = 1; subset < 1 << MAX_DIMS; subset++){
+            if((subset & mask) != subset){
+                continue;
+            }
+            size_t offset = 0;
+            int bits = 0;
+            for(int k = 0; k < MAX_DIMS; k++){
+                if(subset & (1 << k)){
+                    offset += stride[k];
+                    bits++;
+                }
+            }
+            l->offset[mask][l->terms[mask]] = offset;
+            l->negative[mask][l->terms[mask]] = bits % 2 == 0;
+            l->terms[mask]++;
+        }
+    }
+}
+
+static size_t block_rows(const layout_t* l, size_t block){
+    const size_t remaining = l->length[l->slowest] - block * l->rows_per_block;
+    return remaining < l->rows_per_block ? remaining : l->rows_per_block;
+}
+
+// advance the coordinates inside a block and return the mask of the dimensions with a predecessor
+static inline int next_position(size_t* c, const size_t* length){
+    for(int k = 0; k < MAX_DIMS && ++c[k] == length[k]; k++){
+        c[k] = 0;
+    }
+    return (c[0] > 0) | (c[1] > 0) << 1 | (c[2] > 0) << 2 | (c[3] > 0) << 3;
+}
+
+static inline uint64_t zigzag(int64_t d){
+    return ((uint64_t) d << 1) ^ (uint64_t) (d >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t z){
+    return (int64_t) ((z >> 1) ^ (0 - (z & 1)));
+}
+
+static size_t pick_thread_count(size_t block_count, int limit){
+    size_t threads = (size_t) scilU_thread_pool_size(scilU_get_thread_pool());
+    if(limit > 0 && threads > (size_t) limit){
+        threads = (size_t) limit;
+    }
+    return threads > block_count ? block_count : threads;
+}
+
+//Repeat for each data type
+//Supported datatypes: float double
+
+#define BLOCK_BOUND_<DATATYPE_UPPER>(values) (8 + (values) * sizeof(<DATATYPE>) + scil_rans_compress_bound(values))
+
+static inline <DATATYPE> predict_<DATATYPE>(const layout_t* l, const <DATATYPE>* r, int mask){
+    <DATATYPE> p = 0;
+    for(int t = 0; t < l->terms[mask]; t++){
+        const <DATATYPE> v = *(r - l->offset[mask][t]);
+        p = l->negative[mask][t] ? p - v : p + v;
+    }
+    return p;
+}
+
+// the value used by later predictions in place of a fill value or of a value that is not finite
+static inline <DATATYPE> substitute_<DATATYPE>(<DATATYPE> prediction){
+    return isfinite(prediction) ? prediction : 0;
+}
+
+typedef struct{
+    const layout_t* layout;
+    const <DATATYPE>* source;
+    double abs_tol;
+    double fill_value;
+    double lossless_up_to;
+    double lossless_from;
+
+    // buffers for all values, each block uses the part of its values
+    uint64_t* codes;
+    <DATATYPE>* reconstructed;
+    <DATATYPE>* exact;
+
+    // each block is compressed into dest at a provisional offset, the blocks are compacted afterwards
+    byte* dest;
+    size_t* offsets;
+    size_t* sizes;
+    int* rets;
+} compress_job_<DATATYPE>_t;
+
+static void compress_block_<DATATYPE>(void* user_ptr, size_t block, int slot){
+    compress_job_<DATATYPE>_t* job = (compress_job_<DATATYPE>_t*) user_ptr;
+    const layout_t* l = job->layout;
+
+    size_t length[MAX_DIMS];
+    memcpy(length, l->length, sizeof(length));
+    length[l->slowest] = block_rows(l, block);
+    const size_t start = block * l->rows_per_block * l->row_values;
+    const size_t count = length[l->slowest] * l->row_values;
+
+    const <DATATYPE>* restrict src = job->source + start;
+    <DATATYPE>* restrict recon = job->reconstructed + start;
+    <DATATYPE>* restrict exact = job->exact + start;
+    uint64_t* restrict codes = job->codes + start;
+    const double step = 2 * job->abs_tol;
+    const int use_fill = job->fill_value < DBL_MAX;
+
+    size_t exact_count = 0;
+    size_t c[MAX_DIMS] = {0};
+    int mask = 0;
+    for(size_t i = 0; i < count; i++, mask = next_position(c, length)){
+        const <DATATYPE> v = src[i];
+        const <DATATYPE> pred = predict_<DATATYPE>(l, recon + i, mask);
+        if(use_fill && (double) v <= job->fill_value && (double) v >= job->fill_value){
+            codes[i] = CODE_FILL;
+            recon[i] = substitute_<DATATYPE>(pred);
+            continue;
+        }
+        if((double) v > job->lossless_up_to && (double) v < job->lossless_from){
+            const double q = round(((double) v - (double) pred) / step);
+            if(fabs(q) <= QUANT_LIMIT){
+                const <DATATYPE> r = (<DATATYPE>) ((double) pred + q * step);
+                if(fabs((double) r - (double) v) <= job->abs_tol){
+                    codes[i] = CODE_BIN + zigzag((int64_t) q);
+                    recon[i] = r;
+                    continue;
+                }
+            }
+        }
+        codes[i] = CODE_EXACT;
+        exact[exact_count++] = v;
+        recon[i] = isfinite(v) ? v : substitute_<DATATYPE>(pred);
+    }
+
+    byte* out = job->dest + job->offsets[block];
+    const uint64_t exact_values = exact_count;
+    memcpy(out, &exact_values, sizeof(uint64_t));
+    out += 8;
+    memcpy(out, exact, exact_count * sizeof(<DATATYPE>));
+    out += exact_count * sizeof(<DATATYPE>);
+
+    size_t size;
+    job->rets[block] = scil_rans_compress(out, &size, codes, count);
+    job->sizes[block] = 8 + exact_count * sizeof(<DATATYPE>) + size;
+}
+
+int scil_predquant_compress_<DATATYPE>(const scil_context_t* ctx,
+                                       byte* restrict dest,
+                                       size_t* restrict dest_size,
+                                       <DATATYPE>* restrict source,
+                                       const scil_dims_t* dims){
+    assert(dest != NULL);
+    assert(dest_size != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    const double abs_tol = ctx->hints.absolute_tolerance;
+    if(abs_tol <= 0.0){
+        return SCIL_PRECISION_ERR;
+    }
+
+    layout_t layout;
+    layout_init(&layout, dims, 0);
+    const size_t count = scil_dims_get_count(dims);
+    const size_t blocks = layout.block_count;
+
+    scilU_pack8(dest, abs_tol);
+    dest += 8;
+    scilU_pack8(dest, ctx->hints.fill_value);
+    dest += 8;
+    uint64_t value = layout.rows_per_block;
+    memcpy(dest, &value, sizeof(uint64_t));
+    dest += 8;
+    value = blocks;
+    memcpy(dest, &value, sizeof(uint64_t));
+    dest += 8;
+
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    compress_job_<DATATYPE>_t job;
+    job.layout = &layout;
+    job.source = source;
+    job.abs_tol = abs_tol;
+    job.fill_value = ctx->hints.fill_value;
+    job.lossless_up_to = ctx->hints.lossless_data_range_up_to;
+    job.lossless_from = ctx->hints.lossless_data_range_from;
+    job.codes = (uint64_t*) scilU_workspace_alloc(ctx->workspace, count * sizeof(uint64_t));
+    job.reconstructed = (<DATATYPE>*) scilU_workspace_alloc(ctx->workspace, count * sizeof(<DATATYPE>));
+    job.exact = (<DATATYPE>*) scilU_workspace_alloc(ctx->workspace, count * sizeof(<DATATYPE>));
+    job.offsets = (size_t*) scilU_workspace_alloc(ctx->workspace, 2 * blocks * sizeof(size_t));
+    job.rets = (int*) scilU_workspace_alloc(ctx->workspace, blocks * sizeof(int));
+    if(job.codes == NULL || job.reconstructed == NULL || job.exact == NULL || job.offsets == NULL || job.rets == NULL){
+        scilU_workspace_release(ctx->workspace, mark);
+        return SCIL_MEMORY_ERR;
+    }
+    job.sizes = job.offsets + blocks;
+    job.dest = dest;
+
+    size_t offset = blocks * sizeof(uint64_t);
+    for(size_t b = 0; b < blocks; b++){
+        job.offsets[b] = offset;
+        offset += BLOCK_BOUND_<DATATYPE_UPPER>(block_rows(&layout, b) * layout.row_values);
+    }
+
+    const size_t threads = pick_thread_count(blocks, ctx->hints.parallel_threads > 1 ? ctx->hints.parallel_threads : 1);
+    scilU_thread_pool_run(scilU_get_thread_pool(), blocks, (int) threads, compress_block_<DATATYPE>, &job);
+
+    // the size table precedes the blocks, they move only towards the front
+    int ret = SCIL_NO_ERR;
+    size_t pos = blocks * sizeof(uint64_t);
+    for(size_t b = 0; b < blocks; b++){
+        if(job.rets[b] != SCIL_NO_ERR){
+            ret = job.rets[b];
+            break;
+        }
+        value = job.sizes[b];
+        memcpy(dest + b * sizeof(uint64_t), &value, sizeof(uint64_t));
+        memmove(dest + pos, dest + job.offsets[b], job.sizes[b]);
+        pos += job.sizes[b];
+    }
+    *dest_size = HEADER_SIZE + pos;
+
+    scilU_workspace_release(ctx->workspace, mark);
+    return ret;
+}
+
+typedef struct{
+    const layout_t* layout;
+    <DATATYPE>* dest;
+    double abs_tol;
+    double fill_value;
+    uint64_t* codes;
+    const byte* source;
+    const size_t* offsets;
+    const uint64_t* sizes;
+    int* rets;
+} decompress_job_<DATATYPE>_t;
+
+static int decompress_block_values_<DATATYPE>(decompress_job_<DATATYPE>_t* job, size_t block){
+    const layout_t* l = job->layout;
+
+    size_t length[MAX_DIMS];
+    memcpy(length, l->length, sizeof(length));
+    length[l->slowest] = block_rows(l, block);
+    const size_t start = block * l->rows_per_block * l->row_values;
+    const size_t count = length[l->slowest] * l->row_values;
+
+    const byte* in = job->source + job->offsets[block];
+    const size_t in_size = job->sizes[block];
+    uint64_t exact_count;
+    if(in_size < 8){
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(&exact_count, in, sizeof(uint64_t));
+    if(exact_count > count || exact_count * sizeof(<DATATYPE>) > in_size - 8){
+        return SCIL_BUFFER_ERR;
+    }
+    const byte* exact = in + 8;
+    const size_t exact_size = exact_count * sizeof(<DATATYPE>);
+
+    uint64_t* restrict codes = job->codes + start;
+    <DATATYPE>* restrict recon = job->dest + start;
+    int ret = scil_rans_decompress(codes, count, exact + exact_size, in_size - 8 - exact_size);
+    if(ret != SCIL_NO_ERR){
+        return ret;
+    }
+
+    const double step = 2 * job->abs_tol;
+    size_t exact_index = 0;
+    size_t c[MAX_DIMS] = {0};
+    int mask = 0;
+    for(size_t i = 0; i < count; i++, mask = next_position(c, length)){
+        const <DATATYPE> pred = predict_<DATATYPE>(l, recon + i, mask);
+        const uint64_t code = codes[i];
+        if(code >= CODE_BIN){
+            const double q = (double) unzigzag(code - CODE_BIN);
+            recon[i] = (<DATATYPE>) ((double) pred + q * step);
+        }else if(code == CODE_FILL){
+            recon[i] = substitute_<DATATYPE>(pred);
+        }else{
+            if(exact_index == exact_count){
+                return SCIL_BUFFER_ERR;
+            }
+            <DATATYPE> v;
+            memcpy(&v, exact + exact_index++ * sizeof(<DATATYPE>), sizeof(<DATATYPE>));
+            recon[i] = isfinite(v) ? v : substitute_<DATATYPE>(pred);
+        }
+    }
+    if(exact_index != exact_count){
+        return SCIL_BUFFER_ERR;
+    }
+
+    // the substitutes served the predictions of the neighbours, now the values are restored
+    exact_index = 0;
+    for(size_t i = 0; i < count; i++){
+        if(codes[i] == CODE_FILL){
+            recon[i] = (<DATATYPE>) job->fill_value;
+        }else if(codes[i] == CODE_EXACT){
+            memcpy(&recon[i], exact + exact_index++ * sizeof(<DATATYPE>), sizeof(<DATATYPE>));
+        }
+    }
+    return SCIL_NO_ERR;
+}
+
+static void decompress_block_<DATATYPE>(void* user_ptr, size_t block, int slot){
+    decompress_job_<DATATYPE>_t* job = (decompress_job_<DATATYPE>_t*) user_ptr;
+    job->rets[block] = decompress_block_values_<DATATYPE>(job, block);
+}
+
+int scil_predquant_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
+                                         scil_dims_t* dims,
+                                         byte* restrict source,
+                                         size_t in_size){
+    assert(dest != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    if(in_size < HEADER_SIZE){
+        return SCIL_BUFFER_ERR;
+    }
+    double abs_tol, fill_value;
+    uint64_t rows_per_block, blocks;
+    scilU_unpack8(source, &abs_tol);
+    source += 8;
+    scilU_unpack8(source, &fill_value);
+    source += 8;
+    memcpy(&rows_per_block, source, sizeof(uint64_t));
+    source += 8;
+    memcpy(&blocks, source, sizeof(uint64_t));
+    source += 8;
+    in_size -= HEADER_SIZE;
+
+    if(rows_per_block == 0){
+        return SCIL_BUFFER_ERR;
+    }
+    layout_t layout;
+    layout_init(&layout, dims, rows_per_block);
+    if(blocks != layout.block_count || blocks > in_size / sizeof(uint64_t)){
+        return SCIL_BUFFER_ERR;
+    }
+
+    const size_t count = scil_dims_get_count(dims);
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    decompress_job_<DATATYPE>_t job;
+    job.layout = &layout;
+    job.dest = dest;
+    job.abs_tol = abs_tol;
+    job.fill_value = fill_value;
+    job.codes = (uint64_t*) scilU_workspace_alloc(ws, count * sizeof(uint64_t));
+    job.source = source;
+    size_t* offsets = (size_t*) scilU_workspace_alloc(ws, blocks * sizeof(size_t));
+    uint64_t* sizes = (uint64_t*) scilU_workspace_alloc(ws, blocks * sizeof(uint64_t));
+    job.offsets = offsets;
+    job.sizes = sizes;
+    job.rets = (int*) scilU_workspace_alloc(ws, blocks * sizeof(int));
+    if(job.codes == NULL || offsets == NULL || sizes == NULL || job.rets == NULL){
+        scilU_workspace_release(ws, mark);
+        return SCIL_MEMORY_ERR;
+    }
+
+    int ret = SCIL_NO_ERR;
+    size_t pos = blocks * sizeof(uint64_t);
+    for(size_t b = 0; b < blocks; b++){
+        memcpy(&sizes[b], source + b * sizeof(uint64_t), sizeof(uint64_t));
+        if(sizes[b] > in_size - pos){
+            ret = SCIL_BUFFER_ERR;
+            break;
+        }
+        offsets[b] = pos;
+        pos += sizes[b];
+    }
+
+    if(ret == SCIL_NO_ERR){
+        const size_t threads = pick_thread_count(blocks, 0);
+        scilU_thread_pool_run(scilU_get_thread_pool(), blocks, (int) threads, decompress_block_<DATATYPE>, &job);
+        for(size_t b = 0; b < blocks; b++){
+            if(job.rets[b] != SCIL_NO_ERR){
+                ret = job.rets[b];
+                break;
+            }
+        }
+    }
+
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+// End repeat
+
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_predquant_algo_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    // every block but the last holds more than BLOCK_VALUES / 2 values
+    const size_t blocks = 2 * count / BLOCK_VALUES + 1;
+    const size_t per_value = scil_rans_compress_bound(1) - scil_rans_compress_bound(0);
+    return HEADER_SIZE + blocks * (2 * sizeof(uint64_t) + scil_rans_compress_bound(0)) + count * (DATATYPE_LENGTH(datatype) + per_value);
+}
+
+scilU_algorithm_t algo_predquant = {
+    .c.DNtype = {
+        CREATE_INITIALIZER(scil_predquant)
+    },
+    "predquant",
+    22,
+    SCIL_COMPRESSOR_TYPE_DATATYPES,
+    1,
+    scil_predquant_algo_compress_bound
+};
@@ -0,0 +1,66 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * \file
+ * \brief Error bounded quantization of the residuals of a prediction
+ *
+ * Each value is predicted by the lorenzo predictor from the already reconstructed neighbours in all dimensions.
+ * The residual is quantized with twice the absolute tolerance, hence the reconstruction the decompressor computes
+ * is within the tolerance. Values whose residual does not fit into a bin, which are not finite or which lie in the
+ * lossless data range are stored exactly, the fill value is kept as well. The bins are coded with the rANS coder.
+ * The data is split into blocks along the slowest dimension that are compressed and decompressed in parallel.
+ */
+
+#ifndef SCIL_PREDQUANT_ALGO_H_
+#define SCIL_PREDQUANT_ALGO_H_
+
+#include <scil-algorithm-impl.h>
+
+//Repeat for each data type
+//Supported datatypes: float double
+
+/**
+ * \brief Compression function of predquant
+ * \param ctx Compression context used for this compression
+ * \param dest Preallocated buffer which will hold the compressed data
+ * \param dest_size Byte size the compressed buffer will have
+ * \param source Uncompressed data which should be processed
+ * \param dims Dimensional information of uncompressed buffer
+ * \return Success state of the compression
+ */
+int scil_predquant_compress_<DATATYPE>(const scil_context_t* ctx,
+                                       byte* restrict dest,
+                                       size_t* restrict dest_size,
+                                       <DATATYPE>* restrict source,
+                                       const scil_dims_t* dims);
+
+/**
+ * \brief Decompression function of predquant
+ * \param dest Pre allocated buffer which will hold the decompressed data
+ * \param dims Dimensional information of the decompressed buffer
+ * \param source Compressed data which should be processed
+ * \param in_size Byte size of compressed buffer
+ * \return Success state of the decompression
+ */
+int scil_predquant_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
+                                         scil_dims_t* dims,
+                                         byte* restrict source,
+                                         size_t in_size);
+// End repeat
+
+extern scilU_algorithm_t algo_predquant;
+
+#endif /* SCIL_PREDQUANT_ALGO_H_ */
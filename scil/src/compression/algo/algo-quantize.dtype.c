@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include <algo-quantize.h>
+#include <scil-minmax.h>
 #include <scil-quantizer.h>
 #include <scil-util.h>
 
@@ -19,7 +20,7 @@ int scil_quantize_compress_<DATATYPE>(const scil_context_t* ctx,
     size_t count = scil_dims_get_count(dims);
 
     <DATATYPE> minimum, maximum;
-    scilU_find_minimum_maximum_<DATATYPE>(source, count, &minimum, &maximum);
+    scilC_find_minimum_maximum_<DATATYPE>(ctx, source, count, &minimum, &maximum);
 
     uint8_t bits_per_value = scil_calculate_bits_needed_<DATATYPE>(minimum, maximum, ctx->hints.absolute_tolerance, 0, NULL);
     if (bits_per_value > 64)
@@ -56,6 +57,11 @@ int scil_quantize_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
 }
 // End repeat
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_quantize_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    return 16 + count * sizeof(int64_t);
+}
+
 scilU_algorithm_t algo_quantize = {
     .c.Ctype = {
         CREATE_INITIALIZER(scil_quantize)
@@ -63,5 +69,6 @@ scilU_algorithm_t algo_quantize = {
     "quantize",
     9,
     SCIL_COMPRESSOR_TYPE_DATATYPES_CONVERTER,
-    1
+    1,
+    scil_quantize_compress_bound
 };
@@ -0,0 +1,384 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algo/algo-rans.h>
+#include <algo/precond-lorenzo.h>
+
+#include <scil-minmax.h>
+#include <scil-quantizer.h>
+#include <scil-rans.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+/*
+ * The format:
+ * byte version, RANS_VERSION_LORENZO is written
+ * double minimum of the quantized values, double absolute tolerance
+ * RANS_VERSION_DELTA: the bins are the differences of neighbouring bins coded with scil_rans_compress(), the stream ends
+ * uint32_t size of the predictor's header, then the header
+ * uint64_t number of exceptions, i.e., fill values and values stored exactly, if there are any:
+ *   double fill value
+ *   uint64_t number of exact values, then the exact values in the data type
+ *   uint64_t size of the positions, then the positions coded with scil_rans_compress()
+ * the residuals of all values coded with scil_rans_compress()
+ */
+#define HEADER_SIZE 21
+// the version, the minimum and the absolute tolerance
+#define DELTA_HEADER_SIZE 17
+
+// the differences of neighbouring bins without exceptions, written by the first version of rans
+#define RANS_VERSION_DELTA 1
+// the bins predicted by lorenzo with exceptions
+#define RANS_VERSION_LORENZO 2
+
+// the position of an exception is coded as the gap to the previous one and whether it is a fill value
+#define POSITION_FILL 1
+
+// map the residuals of the prediction to small values, i.e., 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+static void zigzag(uint64_t* buf, size_t count){
+    for(size_t i = 0; i < count; i++){
+        const int64_t d = (int64_t) buf[i];
+        buf[i] = ((uint64_t) d << 1) ^ (uint64_t) (d >> 63);
+    }
+}
+
+static void unzigzag(uint64_t* buf, size_t count){
+    for(size_t i = 0; i < count; i++){
+        buf[i] = (buf[i] >> 1) ^ (0 - (buf[i] & 1));
+    }
+}
+
+static void undo_delta_zigzag(uint64_t* buf, size_t count){
+    for(size_t i = 1; i < count; i++){
+        const uint64_t d = (buf[i] >> 1) ^ (0 - (buf[i] & 1));
+        buf[i] = buf[i - 1] + d;
+    }
+}
+
+static size_t exceptions_bound(size_t count, size_t value_size){
+    return 8 + 8 + 8 + count * value_size + 8 + scil_rans_compress_bound(count);
+}
+
+//Repeat for each data type
+//Supported datatypes: float double
+
+// fill values, values in the lossless range and values that are not finite are not quantized
+static inline int is_exception_<DATATYPE>(<DATATYPE> v, int use_fill, double fill_value, double lossless_up_to, double lossless_from){
+    const double d = (double) v;
+    return (use_fill && d <= fill_value && d >= fill_value) || d <= lossless_up_to || d >= lossless_from || ! isfinite(v);
+}
+
+/*
+ * Write the exceptions and replace them in the input to quantize by their predecessor, it keeps the bins smooth.
+ * The number of bytes written is returned in size_out, the number of exceptions in exceptions_out.
+ */
+static int write_exceptions_<DATATYPE>(const scil_context_t* ctx, byte* dest, size_t* size_out, size_t* exceptions_out,
+                                       const <DATATYPE>* restrict source, <DATATYPE>* restrict clean, size_t count,
+                                       uint64_t* restrict positions){
+    const double fill_value = ctx->hints.fill_value;
+    const int use_fill = fill_value < DBL_MAX;
+    const double up_to = ctx->hints.lossless_data_range_up_to;
+    const double from = ctx->hints.lossless_data_range_from;
+
+    byte* out = dest + 8;
+    scilU_pack8(out, fill_value);
+    out += 8;
+    byte* exact = out + 8;
+    size_t exceptions = 0;
+    size_t exact_count = 0;
+    size_t last = 0;
+    <DATATYPE> previous = 0;
+    for(size_t i = 0; i < count; i++){
+        const <DATATYPE> v = source[i];
+        if(! is_exception_<DATATYPE>(v, use_fill, fill_value, up_to, from)){
+            clean[i] = v;
+            previous = v;
+            continue;
+        }
+        clean[i] = previous;
+        const int fill = use_fill && (double) v <= fill_value && (double) v >= fill_value;
+        positions[exceptions++] = ((uint64_t) (i - last) << 1) | (uint64_t) (fill ? POSITION_FILL : 0);
+        last = i + 1;
+        if(! fill){
+            memcpy(exact + exact_count++ * sizeof(<DATATYPE>), &v, sizeof(<DATATYPE>));
+        }
+    }
+    const uint64_t exact_values = exact_count;
+    memcpy(out, &exact_values, sizeof(uint64_t));
+    out += 8 + exact_count * sizeof(<DATATYPE>);
+
+    size_t positions_size;
+    int ret = scil_rans_compress(out + 8, &positions_size, positions, exceptions);
+    const uint64_t value = positions_size;
+    memcpy(out, &value, sizeof(uint64_t));
+    out += 8 + positions_size;
+
+    const uint64_t exception_values = exceptions;
+    memcpy(dest, &exception_values, sizeof(uint64_t));
+    *exceptions_out = exceptions;
+    *size_out = exceptions == 0 ? 8 : (size_t) (out - dest);
+    return ret;
+}
+
+// restore the exceptions after the unquantization
+static int read_exceptions_<DATATYPE>(<DATATYPE>* restrict dest, size_t count, const byte* in, size_t in_size,
+                                      uint64_t exceptions, uint64_t* restrict positions){
+    if(in_size < 24){
+        return SCIL_BUFFER_ERR;
+    }
+    double fill_value;
+    scilU_unpack8(in, &fill_value);
+    uint64_t exact_count;
+    memcpy(&exact_count, in + 8, sizeof(uint64_t));
+    in += 16;
+    in_size -= 16;
+    if(exact_count > exceptions || (in_size - 8) / sizeof(<DATATYPE>) < exact_count){
+        return SCIL_BUFFER_ERR;
+    }
+    const byte* exact = in;
+    in += exact_count * sizeof(<DATATYPE>);
+    in_size -= exact_count * sizeof(<DATATYPE>);
+    uint64_t positions_size;
+    memcpy(&positions_size, in, sizeof(uint64_t));
+    if(in_size - 8 < positions_size){
+        return SCIL_BUFFER_ERR;
+    }
+    int ret = scil_rans_decompress(positions, exceptions, in + 8, positions_size);
+    if(ret != SCIL_NO_ERR){
+        return ret;
+    }
+
+    const <DATATYPE> fill = (<DATATYPE>) fill_value;
+    size_t pos = 0;
+    size_t exact_index = 0;
+    for(size_t e = 0; e < exceptions; e++){
+        const uint64_t gap = positions[e] >> 1;
+        if(gap >= count - pos){
+            return SCIL_BUFFER_ERR;
+        }
+        pos += gap;
+        if(positions[e] & POSITION_FILL){
+            dest[pos] = fill;
+        }else{
+            if(exact_index == exact_count){
+                return SCIL_BUFFER_ERR;
+            }
+            memcpy(dest + pos, exact + exact_index++ * sizeof(<DATATYPE>), sizeof(<DATATYPE>));
+        }
+        pos++;
+    }
+    return exact_index == exact_count ? SCIL_NO_ERR : SCIL_BUFFER_ERR;
+}
+
+int scil_rans_compress_<DATATYPE>(const scil_context_t* ctx,
+                                  byte* restrict dest,
+                                  size_t* restrict dest_size,
+                                  <DATATYPE>* restrict source,
+                                  const scil_dims_t* dims){
+    assert(dest != NULL);
+    assert(dest_size != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    const size_t count = scil_dims_get_count(dims);
+    double abs_tol = ctx->hints.absolute_tolerance;
+    if(abs_tol <= 0.0){
+        return SCIL_PRECISION_ERR;
+    }
+
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    uint64_t* bins = (uint64_t*) scilU_workspace_alloc(ctx->workspace, 2 * count * sizeof(uint64_t));
+    <DATATYPE>* clean = (<DATATYPE>*) scilU_workspace_alloc(ctx->workspace, count * sizeof(<DATATYPE>));
+    if(bins == NULL || clean == NULL){
+        scilU_workspace_release(ctx->workspace, mark);
+        return SCIL_MEMORY_ERR;
+    }
+    uint64_t* residuals = bins + count;
+
+    // the exceptions are written behind the space of the predictor's header and moved after it is known
+    byte* exceptions_out = dest + HEADER_SIZE + scil_lorenzo_precond_header_bound(count);
+    size_t exceptions_size, exceptions;
+    int ret = write_exceptions_<DATATYPE>(ctx, exceptions_out, &exceptions_size, &exceptions, source, clean, count, residuals);
+    const <DATATYPE>* quantized = exceptions == 0 ? source : clean;
+
+    <DATATYPE> min = 0, max = 0;
+    if(exceptions == 0){
+        scilC_find_minimum_maximum_<DATATYPE>(ctx, source, count, &min, &max);
+    }else if(exceptions < count){
+        scilU_find_minimum_maximum_<DATATYPE>(clean, count, &min, &max);
+    }
+    if(ret == SCIL_NO_ERR && scil_calculate_bits_needed_<DATATYPE>(min, max, abs_tol, 0, NULL) >= 64){
+        ret = SCIL_PRECISION_ERR;
+    }
+    if(ret != SCIL_NO_ERR){
+        scilU_workspace_release(ctx->workspace, mark);
+        return ret;
+    }
+
+    *dest++ = RANS_VERSION_LORENZO;
+    double minimum = (double) min;
+    scilU_pack8(dest, minimum);
+    dest += 8;
+    scilU_pack8(dest, abs_tol);
+    dest += 8;
+    scil_quantize_buffer_minmax_<DATATYPE>(bins, quantized, count, abs_tol, min, max);
+
+    // the bins are predicted in all dimensions, the header of the predictor precedes the exceptions and the coded residuals
+    int header_size;
+    ret = scil_lorenzo_precond_compress_int64_t(ctx, (int64_t*) residuals, dest + 4, &header_size, (int64_t*) bins, dims);
+    if(ret == SCIL_NO_ERR){
+        const uint32_t predictor_size = (uint32_t) header_size;
+        memcpy(dest, &predictor_size, sizeof(uint32_t));
+        dest += 4 + predictor_size;
+        memmove(dest, exceptions_out, exceptions_size);
+        dest += exceptions_size;
+        zigzag(residuals, count);
+
+        size_t size;
+        ret = scil_rans_compress(dest, &size, residuals, count);
+        *dest_size = HEADER_SIZE + predictor_size + exceptions_size + size;
+    }
+
+    scilU_workspace_release(ctx->workspace, mark);
+    return ret;
+}
+
+static int decompress_delta_<DATATYPE>(<DATATYPE>* restrict dest, size_t count, const byte* in, size_t in_size,
+                                      double minimum, double abs_tol){
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    uint64_t* bins = (uint64_t*) scilU_workspace_alloc(ws, count * sizeof(uint64_t));
+    if(bins == NULL){
+        return SCIL_MEMORY_ERR;
+    }
+    int ret = scil_rans_decompress(bins, count, in, in_size);
+    if(ret == SCIL_NO_ERR){
+        undo_delta_zigzag(bins, count);
+        ret = scil_unquantize_buffer_<DATATYPE>(dest, bins, count, abs_tol, (<DATATYPE>) minimum);
+    }
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+
+int scil_rans_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
+                                    scil_dims_t* dims,
+                                    byte* restrict source,
+                                    size_t in_size){
+    assert(dest != NULL);
+    assert(source != NULL);
+    assert(dims != NULL);
+
+    if(in_size < DELTA_HEADER_SIZE || (source[0] != RANS_VERSION_DELTA && source[0] != RANS_VERSION_LORENZO)){
+        return SCIL_BUFFER_ERR;
+    }
+    const byte version = *source++;
+    const byte* end = source + in_size - 1;
+    double minimum, abs_tol;
+    scilU_unpack8(source, &minimum);
+    source += 8;
+    scilU_unpack8(source, &abs_tol);
+    source += 8;
+    const size_t count = scil_dims_get_count(dims);
+    if(version == RANS_VERSION_DELTA){
+        return decompress_delta_<DATATYPE>(dest, count, source, (size_t) (end - source), minimum, abs_tol);
+    }
+    if(in_size < HEADER_SIZE){
+        return SCIL_BUFFER_ERR;
+    }
+
+    uint32_t predictor_size;
+    memcpy(&predictor_size, source, sizeof(uint32_t));
+    source += 4;
+    if(in_size - HEADER_SIZE < (size_t) predictor_size + 8){
+        return SCIL_BUFFER_ERR;
+    }
+    byte* predictor_header = source;
+    source += predictor_size;
+
+    uint64_t exceptions;
+    memcpy(&exceptions, source, sizeof(uint64_t));
+    const byte* exceptions_in = source + 8;
+    size_t exceptions_size = 0;
+    source += 8;
+    if(exceptions > count){
+        return SCIL_BUFFER_ERR;
+    }
+    if(exceptions > 0){
+        // the size of the exceptions follows from their counts
+        if(end - source < 24){
+            return SCIL_BUFFER_ERR;
+        }
+        uint64_t exact_count, positions_size;
+        memcpy(&exact_count, source + 8, sizeof(uint64_t));
+        if(exact_count > exceptions || (size_t) (end - source - 24) / sizeof(<DATATYPE>) < exact_count){
+            return SCIL_BUFFER_ERR;
+        }
+        memcpy(&positions_size, source + 16 + exact_count * sizeof(<DATATYPE>), sizeof(uint64_t));
+        exceptions_size = 24 + exact_count * sizeof(<DATATYPE>);
+        if((size_t) (end - source) - exceptions_size < positions_size){
+            return SCIL_BUFFER_ERR;
+        }
+        exceptions_size += positions_size;
+        source += exceptions_size;
+    }
+
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    uint64_t* bins = (uint64_t*) scilU_workspace_alloc(ws, 2 * count * sizeof(uint64_t));
+    if(bins == NULL){
+        return SCIL_MEMORY_ERR;
+    }
+    uint64_t* residuals = bins + count;
+
+    int ret = scil_rans_decompress(residuals, count, source, (size_t) (end - source));
+    if(ret == SCIL_NO_ERR){
+        unzigzag(residuals, count);
+        int header_parsed;
+        ret = scil_lorenzo_precond_decompress_int64_t((int64_t*) bins, dims, (int64_t*) residuals, predictor_header + predictor_size - 1, &header_parsed);
+        if(ret == SCIL_NO_ERR && (uint32_t) header_parsed != predictor_size){
+            ret = SCIL_BUFFER_ERR;
+        }
+    }
+    if(ret == SCIL_NO_ERR){
+        ret = scil_unquantize_buffer_<DATATYPE>(dest, bins, count, abs_tol, (<DATATYPE>) minimum);
+    }
+    if(ret == SCIL_NO_ERR && exceptions > 0){
+        ret = read_exceptions_<DATATYPE>(dest, count, exceptions_in, exceptions_size, exceptions, residuals);
+    }
+
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+// End repeat
+
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_rans_algo_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    return HEADER_SIZE + scil_lorenzo_precond_header_bound(count) + exceptions_bound(count, DATATYPE_LENGTH(datatype)) + scil_rans_compress_bound(count);
+}
+
+scilU_algorithm_t algo_rans = {
+    .c.DNtype = {
+        CREATE_INITIALIZER(scil_rans)
+    },
+    "rans",
+    20,
+    SCIL_COMPRESSOR_TYPE_DATATYPES,
+    1,
+    scil_rans_algo_compress_bound
+};
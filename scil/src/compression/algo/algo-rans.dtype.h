@@ -0,0 +1,68 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * \file
+ * \brief Quantization with rANS entropy coding of the bins
+ *
+ * The values are quantized with the absolute tolerance, the bins are predicted by the lorenzo preconditioner in all
+ * dimensions, the residuals are zigzag mapped to small unsigned integers and coded with the interleaved rANS coder of scil-rans.h.
+ * Fill values, values in the lossless data range and values that are not finite are kept exactly, their positions are
+ * coded with the rANS coder as well.
+ *
+ * It is a data compressor for float and double that quantizes itself: a data compressor behind the quantize converter
+ * is called with the datatype of the variable and not with the int64_t bins.
+ */
+
+#ifndef SCIL_RANS_ALGO_H_
+#define SCIL_RANS_ALGO_H_
+
+#include <scil-algorithm-impl.h>
+
+//Repeat for each data type
+//Supported datatypes: float double
+
+/**
+ * \brief Compression function of rans
+ * \param ctx Compression context used for this compression
+ * \param dest Preallocated buffer which will hold the compressed data
+ * \param dest_size Byte size the compressed buffer will have
+ * \param source Uncompressed data which should be processed
+ * \param dims Dimensional information of uncompressed buffer
+ * \return Success state of the compression
+ */
+int scil_rans_compress_<DATATYPE>(const scil_context_t* ctx,
+                                  byte* restrict dest,
+                                  size_t* restrict dest_size,
+                                  <DATATYPE>* restrict source,
+                                  const scil_dims_t* dims);
+
+/**
+ * \brief Decompression function of rans
+ * \param dest Pre allocated buffer which will hold the decompressed data
+ * \param dims Dimensional information of the decompressed buffer
+ * \param source Compressed data which should be processed
+ * \param in_size Byte size of compressed buffer
+ * \return Success state of the decompression
+ */
+int scil_rans_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
+                                    scil_dims_t* dims,
+                                    byte* restrict source,
+                                    size_t in_size);
+// End repeat
+
+extern scilU_algorithm_t algo_rans;
+
+#endif /* SCIL_RANS_ALGO_H_ */
@@ -547,8 +547,8 @@ static void get_header_data_fill_<DATATYPE>(const <DATATYPE>* source,
     int16_t maximum_exponent;
     uint8_t minimum_sign, maximum_sign;
 
-    byte *keys = (byte*)scilU_safe_malloc((EXPONENT_LENGTH_<DATATYPE_UPPER> - 1) << 2);
-    memset(keys, 0, (EXPONENT_LENGTH_<DATATYPE_UPPER> - 1) << 2);
+    byte keys[(EXPONENT_LENGTH_<DATATYPE_UPPER> - 1) << 2];
+    memset(keys, 0, sizeof(keys));
 
     find_minimums_and_maximums_fill_<DATATYPE>(source,
                                           count,
@@ -638,7 +638,6 @@ static void get_header_data_fill_<DATATYPE>(const <DATATYPE>* source,
         }
     }
 
-    free(keys);
     return;
 }
 
@@ -715,7 +714,12 @@ int scil_sigbits_compress_<DATATYPE>(const scil_context_t* ctx,
     // ==================== Compression ========================================
 
     // Allocate intermediate buffer
-    uint64_t* compressed_buffer = (uint64_t*)scilU_safe_malloc(count * sizeof(uint64_t));
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    uint64_t* compressed_buffer = (uint64_t*)scilU_workspace_alloc(ctx->workspace, count * sizeof(uint64_t));
+    if(compressed_buffer == NULL){
+        ret = SCIL_MEMORY_ERR;
+        goto comp_cleanup;
+    }
 
     if (ctx->hints.fill_value == DBL_MAX){
       // Compress each value in source buffer
@@ -743,7 +747,7 @@ int scil_sigbits_compress_<DATATYPE>(const scil_context_t* ctx,
     // ==================== Cleanup ============================================
 
     comp_cleanup:
-    free(compressed_buffer);
+    scilU_workspace_release(ctx->workspace, mark);
     return ret;
 }
 
@@ -774,9 +778,15 @@ int scil_sigbits_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
 
     // ==================== Decompression ======================================
 
-    uint64_t* unswaged_buffer = (uint64_t*)scilU_safe_malloc(count * sizeof(uint64_t));
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    uint64_t* unswaged_buffer = (uint64_t*)scilU_workspace_alloc(ws, count * sizeof(uint64_t));
 
     int ret = SCIL_NO_ERR;
+    if(unswaged_buffer == NULL){
+        ret = SCIL_MEMORY_ERR;
+        goto decomp_cleanup;
+    }
 
     if(scil_unswage(unswaged_buffer, source, count, bit_count_per_value)){
         ret = SCIL_BUFFER_ERR;
@@ -799,12 +809,19 @@ int scil_sigbits_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
     // ==================== Cleanup ============================================
 
     decomp_cleanup:
-    free(unswaged_buffer);
+    scilU_workspace_release(ws, mark);
     return ret;
 }
 
 // End repeat
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_sigbits_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    // at most the bits of the datatype are stored per value, the largest header contains both masks,
+    // the packing may touch one byte after the data
+    return in_size + 29 + 1;
+}
+
 scilU_algorithm_t algo_sigbits = {
     .c.DNtype = {
         CREATE_INITIALIZER(scil_sigbits)
@@ -812,5 +829,6 @@ scilU_algorithm_t algo_sigbits = {
     "sigbits",
     3,
     SCIL_COMPRESSOR_TYPE_DATATYPES,
-    1
+    1,
+    scil_sigbits_compress_bound
 };
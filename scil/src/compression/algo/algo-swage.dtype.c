@@ -1,77 +1,34 @@
 
 #include <algo/algo-swage.h>
 #include <scil-quantizer.h>
+#include <scil-swager.h>
 #include <scil-util.h>
 
-static uint8_t start_mask[9] = {
-    255, //0b11111111
-    127, //0b01111111
-    63,  //0b00111111
-    31,  //0b00011111
-    15,  //0b00001111
-    7,   //0b00000111
-    3,   //0b00000011
-    1,   //0b00000001
-    0    //0b00000000
-};
-
-static uint8_t end_mask[9] = {
-    0,         //0b00000000
-    255 - 127, //0b10000000
-    255 - 63,  //0b11000000
-    255 - 31,  //0b11100000
-    255 - 15,  //0b11110000
-    255 - 7,   //0b11111000
-    255 - 3,   //0b11111100
-    255 - 1,   //0b11111110
-    255        //0b11111111
-};
+// the number of values converted at once
+#define TILE_COUNT 256
 
 //Supported datatypes: int8_t int16_t int32_t int64_t
 // Repeat for each data type
 
-// Can do negative right shifts!! (left shifts)
-static byte right_shift_64_<DATATYPE>(<DATATYPE> value, int amount)
-{
-    return (byte)(amount >= 0 ? value >> amount : value << -amount);
-}
-static <DATATYPE> right_shift_8_<DATATYPE>(byte value, int amount)
-{
-    return (amount >= 0 ? ((<DATATYPE>)value) >> amount : ((<DATATYPE>)value) << -amount);
-}
-
 static int scil_swage_<DATATYPE>(byte* restrict buf_out,
                                  const <DATATYPE>* restrict buf_in,
                                  const size_t count,
                                  const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
-    for(size_t i = 0; i < count; ++i)
+    const uint64_t mask = bits_per_value >= 64 ? UINT64_MAX : (((uint64_t) 1) << bits_per_value) - 1;
+    uint64_t tile[TILE_COUNT];
+    scil_swage_stream_t stream;
+    scil_swage_stream_begin(&stream, buf_out);
+    for(size_t i = 0; i < count; i += TILE_COUNT)
     {
-        size_t start_byte = bit_index / 8;
-        size_t end_byte   = (bit_index + bits_per_value) / 8;
-        uint8_t bit_offset = bit_index % 8;
-
-        int8_t right_shifts = bits_per_value + bit_offset - 8;
-
-        // Write to first byte
-
-        // Set remaining bits in start_byte to 0
-        buf_out[start_byte] &= end_mask[bit_offset];
-        // Write as much bits of number as possible to remaining bits
-        buf_out[start_byte] |= right_shift_64_<DATATYPE>(buf_in[i], right_shifts);
-
-        // Write to following bytes
-        uint8_t k = 1;
-        for(size_t j = start_byte + 1; j <= end_byte; ++j)
+        const size_t n = count - i < TILE_COUNT ? count - i : TILE_COUNT;
+        for(size_t j = 0; j < n; ++j)
         {
-            buf_out[j] = right_shift_64_<DATATYPE>(buf_in[i], right_shifts - k * 8);
-            ++k;
+            tile[j] = ((uint64_t) buf_in[i + j]) & mask;
         }
-
-        bit_index += bits_per_value;
+        scil_swage_stream_push(&stream, tile, n, bits_per_value);
     }
-
+    scil_swage_stream_end(&stream, buf_out);
     return 0;
 }
 
@@ -80,38 +37,18 @@ static int scil_unswage_<DATATYPE>(<DATATYPE>* restrict buf_out,
                                    const size_t count,
                                    const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
-    for(size_t i = 0; i < count; ++i)
+    uint64_t tile[TILE_COUNT];
+    scil_unswage_stream_t stream;
+    scil_unswage_stream_begin(&stream, buf_in);
+    for(size_t i = 0; i < count; i += TILE_COUNT)
     {
-        size_t start_byte = bit_index / 8;                         // Index of starting byte of current value in swaged buffer
-        size_t end_byte   = (bit_index + bits_per_value) / 8;      // Index of ending byte of current value in swaged buffer
-
-        uint8_t bit_offset = bit_index % 8;                        // Index of current bit in byte [0-7]
-        uint8_t end_byte_bits = (bit_index + bits_per_value) % 8;  // Number of bits in end_byte occupied by current value
-
-        int8_t right_shifts = 8 - bits_per_value - bit_offset;
-
-        // Read from start_byte
-        uint64_t intermed = right_shift_8_<DATATYPE>(buf_in[start_byte] & start_mask[bit_offset], right_shifts); // Masks away first value-unrelated bits in start_byte and shifts related bits to final position
-        // Read from intermediate bytes
-        uint8_t k = 1;
-        for(size_t j = start_byte + 1; j < end_byte; ++j)
+        const size_t n = count - i < TILE_COUNT ? count - i : TILE_COUNT;
+        scil_unswage_stream_pull(&stream, tile, n, bits_per_value);
+        for(size_t j = 0; j < n; ++j)
         {
-            intermed |= right_shift_8_<DATATYPE>(buf_in[j], right_shifts + k * 8); // Shifts whole byte to final position and applies it
-            ++k;
+            buf_out[i + j] = (<DATATYPE>) tile[j];
         }
-        // Read from end_byte
-        if(start_byte != end_byte)
-        {
-            intermed |= right_shift_8_<DATATYPE>(buf_in[end_byte], 8 - end_byte_bits); // Shifts out unrelated end bits in end_byte and applies value
-        }
-
-        // Write to output buffer
-        buf_out[i] = intermed;
-
-        bit_index += bits_per_value;
     }
-
     return 0;
 }
 
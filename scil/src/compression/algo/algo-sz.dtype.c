@@ -18,6 +18,8 @@ the maximum decompression error would be slightly larger than the specified erro
 
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <sz.h>
@@ -25,12 +27,18 @@ the maximum decompression error would be slightly larger than the specified erro
 #include <algo/algo-sz.h>
 #include <scil-util.h>
 
-static struct sz_params * params = NULL;
-
-static void init_sz_if_needed(){
-  if (params) return;
-  params = malloc(sizeof(struct sz_params));
-  struct sz_params * p = params;
+/*
+ * SZ keeps its configuration and the intermediate state of a call in process-global variables,
+ * SZ_compress_args2() and SZ_decompress_args() overwrite them with the arguments of the call.
+ * Therefore, the library is initialized once and the calls are serialized by a lock.
+ * This allows to use the stage from concurrent contexts and from the blocks of the block container.
+ */
+static struct sz_params params;
+static pthread_once_t sz_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sz_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_sz(){
+  struct sz_params * p = & params;
   memset(p, -1, sizeof(struct sz_params));
   p->dataEndianType = LITTLE_ENDIAN_DATA;
   p->max_quant_intervals = 65536;
@@ -50,6 +58,22 @@ static void init_sz_if_needed(){
   SZ_Init_Params(p);
 }
 
+static void sz_lock_library(){
+  pthread_once(& sz_once, init_sz);
+  pthread_mutex_lock(& sz_lock);
+}
+
+static void sz_unlock_library(){
+  pthread_mutex_unlock(& sz_lock);
+}
+
+// SZ expects 0 for unused dimensions, the lengths beyond dims->dims are not initialized for the blocks of the block container
+static void sz_lengths(const scil_dims_t* dims, size_t* r){
+  for(int i = 0; i < 4; i++){
+    r[i] = i < dims->dims ? dims->length[i] : 0;
+  }
+}
+
 //Repeat for each data type
 //Supported datatypes: double float
 
@@ -58,7 +82,6 @@ int scil_sz_compress_<DATATYPE>(const scil_context_t* ctx,
                                     size_t* restrict dest_size,
                                     <DATATYPE>* restrict source,
                                     const scil_dims_t* dims){
-  init_sz_if_needed();
   size_t size = 0;
   double abstol = ctx->hints.absolute_tolerance;
   double reltol = ctx->hints.relative_tolerance_percent / 100.0;
@@ -75,8 +98,11 @@ int scil_sz_compress_<DATATYPE>(const scil_context_t* ctx,
   }
   //printf("Running SZ: with %d %f %f\n", mode, abstol, reltol);
 
-  int ret;
-  ret = SZ_compress_args2(SZ_<DATATYPE_UPPER>, source, dest, & size, mode, abstol, reltol, 0.0, 0, 0, dims->length[3], dims->length[2], dims->length[1], dims->length[0]);
+  size_t r[4];
+  sz_lengths(dims, r);
+  sz_lock_library();
+  const int ret = SZ_compress_args2(SZ_<DATATYPE_UPPER>, source, dest, & size, mode, abstol, reltol, 0.0, 0, 0, r[3], r[2], r[1], r[0]);
+  sz_unlock_library();
   //printf("Returns: %d\n", size);
   if (ret == 0){
     *dest_size = size;
@@ -91,10 +117,13 @@ int scil_sz_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
                                       scil_dims_t* dims,
                                       byte* restrict source,
                                       size_t source_size){
-  init_sz_if_needed();
   int size = (int) source_size;
   //printf("Decompress %d %d\n", size, dims->length[0]);
-  int elems = SZ_decompress_args(SZ_<DATATYPE_UPPER>, source, size, (void*) dest, 0, dims->length[3], dims->length[2], dims->length[1], dims->length[0]);
+  size_t r[4];
+  sz_lengths(dims, r);
+  sz_lock_library();
+  const int elems = SZ_decompress_args(SZ_<DATATYPE_UPPER>, source, size, (void*) dest, 0, r[3], r[2], r[1], r[0]);
+  sz_unlock_library();
 
   if (elems < 0){
     printf("SZ DError: %d\n", elems);
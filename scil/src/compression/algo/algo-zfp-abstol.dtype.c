@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include <scil-util.h>
+#include <scil-minmax.h>
 
 #include <zfp.h>
 
@@ -86,9 +87,9 @@ int scil_zfp_abstol_compress_<DATATYPE>(const scil_context_t* ctx,
       in = (<DATATYPE>*)scilU_safe_malloc(count * sizeof(<DATATYPE>));
       memcpy(in, source, count * sizeof(<DATATYPE>));
 
-      // Finding minimum and maximum values in data
+      // Finding minimum and maximum values in data, the copy has the same content as the source
       <DATATYPE> min, max;
-      scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(in, count, &min, &max, ctx->hints.lossless_data_range_up_to,  ctx->hints.lossless_data_range_from, ctx->hints.fill_value);
+      scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>(ctx, source, count, &min, &max, ctx->hints.lossless_data_range_up_to,  ctx->hints.lossless_data_range_from, ctx->hints.fill_value);
 
       next_free_number = max + 2 * abs_tol;
 
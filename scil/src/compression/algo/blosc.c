@@ -52,6 +52,11 @@ int scil_blosc_decompress(byte*restrict dest, size_t buff_size, const byte*restr
     return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_blosc_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    return in_size + BLOSC_MAX_OVERHEAD;
+}
+
 scilU_algorithm_t algo_blosc = {
         .c.Btype = {
                 scil_blosc_compress,
@@ -59,5 +64,7 @@ scilU_algorithm_t algo_blosc = {
         },
         "blosc",
         19,
-        SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+        SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+        0,
+        scil_blosc_compress_bound
 };
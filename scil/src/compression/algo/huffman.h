@@ -17,7 +17,7 @@ typedef struct huffman_entity {
 } huffman_entity;
 
 // pre: data, count is set (count = 0 is allowed)
-// post: bitmask, bitvalue, bitcount will be set
+// post: bitmask, bitvalue, bitcount will be set, the codes are canonical and have at most 8 bits
 void huffman_encode(huffman_entity* entities, size_t size);
 
 #endif // HUFFMAN_H
@@ -24,7 +24,7 @@ int scil_lz4fast_compress(const scil_context_t* ctx, byte* restrict dest, size_t
     // store the size of the data
     *((int*) dest) = source_size;
     // normal compression, not fast
-    size = LZ4_compress_fast((const char *) (source), (char *) dest + 4, source_size, 2*source_size, 4);
+    size = LZ4_compress_fast((const char *) (source), (char *) dest + 4, source_size, LZ4_compressBound(source_size), 4);
     *out_size = size + 4;
     if (size == 0){
       return -1;
@@ -44,6 +44,12 @@ int scil_lz4fast_decompress(byte*restrict dest, size_t buff_size, const byte*res
     return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_lz4fast_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+    // the size of the data is stored in front of the compressed data
+    return LZ4_compressBound(in_size) + 4;
+}
+
 scilU_algorithm_t algo_lz4fast = {
     .c.Btype = {
         scil_lz4fast_compress,
@@ -51,5 +57,7 @@ scilU_algorithm_t algo_lz4fast = {
     },
     "lz4",
     7,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_lz4fast_compress_bound
 };
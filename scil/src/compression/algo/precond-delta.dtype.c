@@ -117,6 +117,11 @@ int scil_delta_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out, scil_
 // End repeat
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_delta_precond_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  return in_size;
+}
+
 scilU_algorithm_t algo_precond_delta = {
     .c.PFtype = {
         CREATE_INITIALIZER(scil_delta_precond)
@@ -124,5 +129,6 @@ scilU_algorithm_t algo_precond_delta = {
     "delta",
     14,
     SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST,
-    0
+    0,
+    scil_delta_precond_compress_bound
 };
@@ -46,6 +46,11 @@ static int scil_dummy_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out
 // End repeat
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_dummy_precond_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  return in_size + 5;
+}
+
 scilU_algorithm_t algo_precond_dummy = {
     .c.PFtype = {
         CREATE_INITIALIZER(scil_dummy_precond)
@@ -53,5 +58,6 @@ scilU_algorithm_t algo_precond_dummy = {
     "dummy-precond",
     8,
     SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST,
-    0
+    0,
+    scil_dummy_precond_compress_bound
 };
@@ -100,6 +100,12 @@ static int scil_delta_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out
 // End repeat
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_fp_delta_precond_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  // the minimum of each block is stored in the header
+  return in_size + (count + BLOCK_SIZE - 1) / BLOCK_SIZE * DATATYPE_LENGTH(datatype);
+}
+
 scilU_algorithm_t algo_precond_fp_delta = {
     .c.PFtype = {
         CREATE_INITIALIZER(scil_delta_precond)
@@ -107,5 +113,6 @@ scilU_algorithm_t algo_precond_fp_delta = {
     "fpdelta",
     15,
     SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST,
-    0
+    0,
+    scil_fp_delta_precond_compress_bound
 };
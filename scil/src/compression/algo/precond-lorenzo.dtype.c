@@ -0,0 +1,463 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include <algo/precond-lorenzo.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+/*
+ * The header contains the (dims + 1) float coefficients of each block predicted by regression, followed by a bitmap
+ * with one bit for each full block that tells whether it uses the regression.
+ * Only blocks with the full edge length in all dimensions may use the regression, the others use the Lorenzo predictor.
+ */
+
+#define MAX_DIMS 4
+
+// a block holds at least BLOCK_MIN_COUNT values
+#define BLOCK_MIN_COUNT 256
+
+// the log2 of the edge length of the blocks for 1, 2, 3 and 4 dimensions
+static const int block_edge_bits[MAX_DIMS] = {8, 4, 3, 2};
+
+typedef struct {
+  int dims;
+  size_t n[MAX_DIMS];       // the length of each dimension, 1 for unused dimensions
+  size_t stride[MAX_DIMS];
+  int edge_bits;
+  size_t edge;
+  size_t full[MAX_DIMS];    // the number of full blocks in each dimension
+  size_t full_blocks;
+
+  // the neighbours of a value in the previous rows, i.e., the subsets of the dimensions 1..dims-1 for the Lorenzo predictor
+  int row_subsets;
+  size_t row_offset[1 << (MAX_DIMS - 1)];
+  int row_mask[1 << (MAX_DIMS - 1)];
+  int row_odd[1 << (MAX_DIMS - 1)];
+} geometry_t;
+
+static void geometry_init(geometry_t* g, const scil_dims_t* dims){
+  memset(g, 0, sizeof(geometry_t));
+  g->dims = dims->dims < 1 ? 1 : (dims->dims > MAX_DIMS ? MAX_DIMS : dims->dims);
+  for(int k = 0; k < MAX_DIMS; k++){
+    g->n[k] = 1;
+  }
+  for(int k = 0; k < dims->dims; k++){
+    g->n[k < MAX_DIMS ? k : MAX_DIMS - 1] *= dims->length[k];
+  }
+  g->edge_bits = block_edge_bits[g->dims - 1];
+  g->edge = (size_t) 1 << g->edge_bits;
+  g->full_blocks = 1;
+  size_t stride = 1;
+  for(int k = 0; k < MAX_DIMS; k++){
+    g->stride[k] = stride;
+    stride *= g->n[k];
+    g->full[k] = k < g->dims ? g->n[k] >> g->edge_bits : 1;
+    g->full_blocks *= g->full[k];
+  }
+
+  for(int t = 1; t < (1 << (g->dims - 1)); t++){
+    size_t offset = 0;
+    int bits = 0;
+    for(int k = 1; k < g->dims; k++){
+      if(t & (1 << (k - 1))){
+        offset += g->stride[k];
+        bits++;
+      }
+    }
+    g->row_offset[g->row_subsets] = offset;
+    g->row_mask[g->row_subsets] = t;
+    g->row_odd[g->row_subsets] = bits % 2;
+    g->row_subsets++;
+  }
+}
+
+size_t scil_lorenzo_precond_header_bound(size_t count){
+  // the bitmap and the coefficients of at most 4 dimensions
+  const size_t blocks = count / BLOCK_MIN_COUNT;
+  return (blocks + 7) / 8 + blocks * (MAX_DIMS + 1) * sizeof(float);
+}
+
+// the regression of a block at the start of a row, the coefficient of dimension 0 is applied per value
+static double regression_base(const float* coeff, const geometry_t* g, const size_t* j){
+  double base = coeff[0];
+  for(int k = 1; k < g->dims; k++){
+    base += (double) coeff[k + 1] * (double) (j[k] & (g->edge - 1));
+  }
+  return base;
+}
+
+static inline int block_uses_regression(const byte* bitmap, size_t block){
+  return (bitmap[block / 8] >> (block % 8)) & 1;
+}
+
+// the index of the full block of the row segment b0, or full_blocks if the row is not in a full block
+static size_t row_block(const geometry_t* g, const size_t* j, size_t b0){
+  size_t block = 0;
+  for(int k = g->dims - 1; k >= 1; k--){
+    const size_t b = j[k] >> g->edge_bits;
+    if(b >= g->full[k]){
+      return g->full_blocks;
+    }
+    block = block * g->full[k] + b;
+  }
+  return block * g->full[0] + b0;
+}
+
+static int row_zero_mask(const geometry_t* g, const size_t* j){
+  int mask = 0;
+  for(int k = 1; k < g->dims; k++){
+    if(j[k] == 0){
+      mask |= 1 << (k - 1);
+    }
+  }
+  return mask;
+}
+
+//Supported datatypes: float double
+// Repeat for each data type
+typedef <DATATYPE> pred_<DATATYPE>_t;
+
+// negative values get their bits inverted, positive values get the sign bit, the integers are ordered like the values
+static inline uint<DATATYPE_SIZE>_t to_ordered_<DATATYPE>(pred_<DATATYPE>_t v){
+  const uint<DATATYPE_SIZE>_t sign = (uint<DATATYPE_SIZE>_t) 1 << (<DATATYPE_SIZE> - 1);
+  uint<DATATYPE_SIZE>_t u;
+  memcpy(&u, &v, sizeof(u));
+  return u ^ ((0 - (u >> (<DATATYPE_SIZE> - 1))) | sign);
+}
+
+static inline pred_<DATATYPE>_t from_ordered_<DATATYPE>(uint<DATATYPE_SIZE>_t o){
+  const uint<DATATYPE_SIZE>_t sign = (uint<DATATYPE_SIZE>_t) 1 << (<DATATYPE_SIZE> - 1);
+  const uint<DATATYPE_SIZE>_t u = o ^ (((o >> (<DATATYPE_SIZE> - 1)) - 1) | sign);
+  pred_<DATATYPE>_t v;
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+static inline pred_<DATATYPE>_t regression_value_<DATATYPE>(double v){
+  return (<DATATYPE>) v;
+}
+// End repeat
+
+//Supported datatypes: int8_t int16_t int32_t int64_t
+// Repeat for each data type
+typedef uint<DATATYPE_SIZE>_t pred_<DATATYPE>_t;
+
+static inline uint<DATATYPE_SIZE>_t to_ordered_<DATATYPE>(pred_<DATATYPE>_t v){
+  return v;
+}
+
+static inline pred_<DATATYPE>_t from_ordered_<DATATYPE>(uint<DATATYPE_SIZE>_t o){
+  return o;
+}
+
+static inline pred_<DATATYPE>_t regression_value_<DATATYPE>(double v){
+  if(v >= (double) <DATATYPE_UPPER>_MAX){
+    return (pred_<DATATYPE>_t) <DATATYPE_UPPER>_MAX;
+  }
+  if(v <= (double) <DATATYPE_UPPER>_MIN){
+    return (pred_<DATATYPE>_t) <DATATYPE_UPPER>_MIN;
+  }
+  return (pred_<DATATYPE>_t) (<DATATYPE>) llround(v);
+}
+// End repeat
+
+//Supported datatypes: float double int8_t int16_t int32_t int64_t
+// Repeat for each data type
+
+// the part of the Lorenzo prediction of a row that depends on the previous rows, the prediction of x[i] is x[i-1] + q[i]
+static void lorenzo_row_<DATATYPE>(pred_<DATATYPE>_t* restrict q, const pred_<DATATYPE>_t* row, const geometry_t* g, int zero_mask){
+  const size_t n = g->n[0];
+  for(size_t i = 0; i < n; i++){
+    q[i] = 0;
+  }
+  for(int t = 0; t < g->row_subsets; t++){
+    if(g->row_mask[t] & zero_mask){
+      continue;
+    }
+    const pred_<DATATYPE>_t* r = row - g->row_offset[t];
+    if(g->row_odd[t]){
+      q[0] += r[0];
+      for(size_t i = 1; i < n; i++){
+        q[i] += r[i] - r[i - 1];
+      }
+    }else{
+      q[0] -= r[0];
+      for(size_t i = 1; i < n; i++){
+        q[i] += r[i - 1] - r[i];
+      }
+    }
+  }
+}
+
+static void regression_segment_<DATATYPE>(pred_<DATATYPE>_t* restrict pred, const float* coeff, double base, size_t count){
+  const double slope = coeff[1];
+  for(size_t t = 0; t < count; t++){
+    pred[t] = regression_value_<DATATYPE>(base + slope * (double) t);
+  }
+}
+
+// fit a linear function to a full block and decide if it predicts better than the Lorenzo predictor
+static int fit_block_<DATATYPE>(float* coeff, const <DATATYPE>* data, const geometry_t* g, const size_t* origin){
+  const int d = g->dims;
+  const size_t count = (size_t) 1 << (g->edge_bits * d);
+  const size_t mask = g->edge - 1;
+  const double n = (double) count;
+  const double e = (double) g->edge;
+  const double mean_t = (e - 1) / 2;
+
+  size_t start = 0;
+  for(int k = 0; k < d; k++){
+    start += origin[k] * g->stride[k];
+  }
+
+  double sum = 0;
+  double sum_t[MAX_DIMS] = {0};
+  for(size_t v = 0; v < count; v++){
+    size_t pos = start;
+    for(int k = 0; k < d; k++){
+      pos += ((v >> (k * g->edge_bits)) & mask) * g->stride[k];
+    }
+    const double f = (double) data[pos];
+    sum += f;
+    for(int k = 0; k < d; k++){
+      sum_t[k] += (double) ((v >> (k * g->edge_bits)) & mask) * f;
+    }
+  }
+
+  // the grid is regular, so the least squares solution decouples into one slope per dimension
+  const double variance = n * (e * e - 1) / 12;
+  double intercept = sum / n;
+  for(int k = 0; k < d; k++){
+    const float slope = (float) ((sum_t[k] - mean_t * sum) / variance);
+    coeff[k + 1] = slope;
+    intercept -= (double) slope * mean_t;
+  }
+  coeff[0] = (float) intercept;
+  for(int k = 0; k <= d; k++){
+    if(! isfinite(coeff[k])){
+      return 0;
+    }
+  }
+
+  // compare the absolute errors of both predictors, the Lorenzo predictor uses all neighbours with a smaller index
+  double error_regression = 0;
+  double error_lorenzo = 0;
+  for(size_t v = 0; v < count; v++){
+    size_t pos = start;
+    double predicted = coeff[0];
+    int zero = 0;
+    for(int k = 0; k < d; k++){
+      const size_t t = (v >> (k * g->edge_bits)) & mask;
+      pos += t * g->stride[k];
+      predicted += (double) coeff[k + 1] * (double) t;
+      zero |= (origin[k] + t == 0) << k;
+    }
+    const double f = (double) data[pos];
+    error_regression += fabs(f - predicted);
+
+    double lorenzo = 0;
+    for(int s = 1; s < (1 << d); s++){
+      if(s & zero){
+        continue;
+      }
+      size_t offset = 0;
+      int bits = 0;
+      for(int k = 0; k < d; k++){
+        if(s & (1 << k)){
+          offset += g->stride[k];
+          bits++;
+        }
+      }
+      lorenzo += bits % 2 ? (double) data[pos - offset] : - (double) data[pos - offset];
+    }
+    error_lorenzo += fabs(f - lorenzo);
+  }
+  return error_regression < error_lorenzo;
+}
+
+int scil_lorenzo_precond_compress_<DATATYPE>(const scil_context_t* ctx, <DATATYPE>* restrict data_out, byte*restrict header, int * header_size_out, <DATATYPE>*restrict data_in, const scil_dims_t* dims){
+  geometry_t g;
+  geometry_init(&g, dims);
+  const int d = g.dims;
+
+  const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+  pred_<DATATYPE>_t* q = (pred_<DATATYPE>_t*) scilU_workspace_alloc(ctx->workspace, 2 * g.n[0] * sizeof(pred_<DATATYPE>_t));
+  pred_<DATATYPE>_t* pred = q + g.n[0];
+  float* coeff = (float*) scilU_workspace_alloc(ctx->workspace, g.full_blocks * (d + 1) * sizeof(float) + 1);
+  const size_t bitmap_size = (g.full_blocks + 7) / 8;
+  byte* bitmap = (byte*) scilU_workspace_alloc(ctx->workspace, bitmap_size + 1);
+  if(q == NULL || coeff == NULL || bitmap == NULL){
+    scilU_workspace_release(ctx->workspace, mark);
+    return SCIL_MEMORY_ERR;
+  }
+  memset(bitmap, 0, bitmap_size);
+
+  // choose the predictor of each full block
+  size_t regression_blocks = 0;
+  for(size_t block = 0; block < g.full_blocks; block++){
+    size_t origin[MAX_DIMS];
+    size_t rest = block;
+    for(int k = 0; k < d; k++){
+      origin[k] = (rest % g.full[k]) << g.edge_bits;
+      rest /= g.full[k];
+    }
+    if(fit_block_<DATATYPE>(coeff + block * (d + 1), data_in, &g, origin)){
+      bitmap[block / 8] |= (byte) (1 << (block % 8));
+      regression_blocks++;
+    }
+  }
+
+  // the rows along dimension 0 are predicted at once, only the previous value is needed in addition to the previous rows
+  const pred_<DATATYPE>_t* in = (const pred_<DATATYPE>_t*) data_in;
+  uint<DATATYPE_SIZE>_t* out = (uint<DATATYPE_SIZE>_t*) data_out;
+  const size_t n = g.n[0];
+  size_t j[MAX_DIMS] = {0};
+  for(j[3] = 0; j[3] < g.n[3]; j[3]++){
+    for(j[2] = 0; j[2] < g.n[2]; j[2]++){
+      for(j[1] = 0; j[1] < g.n[1]; j[1]++){
+        const size_t row = j[1] * g.stride[1] + j[2] * g.stride[2] + j[3] * g.stride[3];
+        const pred_<DATATYPE>_t* x = in + row;
+        lorenzo_row_<DATATYPE>(q, x, &g, row_zero_mask(&g, j));
+        if(n > 0){
+          pred[0] = q[0];
+        }
+        for(size_t i = 1; i < n; i++){
+          pred[i] = x[i - 1] + q[i];
+        }
+        for(size_t b0 = 0; b0 < g.full[0]; b0++){
+          const size_t block = row_block(&g, j, b0);
+          if(block < g.full_blocks && block_uses_regression(bitmap, block)){
+            const float* c = coeff + block * (d + 1);
+            regression_segment_<DATATYPE>(pred + (b0 << g.edge_bits), c, regression_base(c, &g, j), g.edge);
+          }
+        }
+        for(size_t i = 0; i < n; i++){
+          out[row + i] = to_ordered_<DATATYPE>(x[i]) - to_ordered_<DATATYPE>(pred[i]);
+        }
+      }
+    }
+  }
+
+  // store the coefficients of the blocks that use them, then the bitmap
+  byte* header_pos = header;
+  for(size_t block = 0; block < g.full_blocks; block++){
+    if(block_uses_regression(bitmap, block)){
+      memcpy(header_pos, coeff + block * (d + 1), (d + 1) * sizeof(float));
+      header_pos += (d + 1) * sizeof(float);
+    }
+  }
+  memcpy(header_pos, bitmap, bitmap_size);
+  header_pos += bitmap_size;
+  assert(header_pos - header == (ptrdiff_t) (regression_blocks * (d + 1) * sizeof(float) + bitmap_size));
+  *header_size_out = (int) (header_pos - header);
+
+  scilU_workspace_release(ctx->workspace, mark);
+  return SCIL_NO_ERR;
+}
+
+int scil_lorenzo_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out, scil_dims_t* dims, <DATATYPE>*restrict data_in, byte*restrict header, int * header_parsed_out){
+  geometry_t g;
+  geometry_init(&g, dims);
+  const int d = g.dims;
+
+  // the header ends at header, the bitmap tells the number of coefficients before it
+  const size_t bitmap_size = (g.full_blocks + 7) / 8;
+  const byte* bitmap = header + 1 - bitmap_size;
+  size_t regression_blocks = 0;
+  for(size_t block = 0; block < g.full_blocks; block++){
+    regression_blocks += block_uses_regression(bitmap, block);
+  }
+  const byte* coeff_pos = bitmap - regression_blocks * (d + 1) * sizeof(float);
+  *header_parsed_out = (int) (header + 1 - coeff_pos);
+
+  scilU_workspace_t* ws = scilU_get_thread_workspace();
+  const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+  pred_<DATATYPE>_t* q = (pred_<DATATYPE>_t*) scilU_workspace_alloc(ws, 2 * g.n[0] * sizeof(pred_<DATATYPE>_t));
+  pred_<DATATYPE>_t* pred = q + g.n[0];
+  float* coeff = (float*) scilU_workspace_alloc(ws, g.full_blocks * (d + 1) * sizeof(float) + 1);
+  if(q == NULL || coeff == NULL){
+    scilU_workspace_release(ws, mark);
+    return SCIL_MEMORY_ERR;
+  }
+  for(size_t block = 0; block < g.full_blocks; block++){
+    if(block_uses_regression(bitmap, block)){
+      memcpy(coeff + block * (d + 1), coeff_pos, (d + 1) * sizeof(float));
+      coeff_pos += (d + 1) * sizeof(float);
+    }
+  }
+
+  const uint<DATATYPE_SIZE>_t* in = (const uint<DATATYPE_SIZE>_t*) data_in;
+  pred_<DATATYPE>_t* out = (pred_<DATATYPE>_t*) data_out;
+  const size_t n = g.n[0];
+  size_t j[MAX_DIMS] = {0};
+  for(j[3] = 0; j[3] < g.n[3]; j[3]++){
+    for(j[2] = 0; j[2] < g.n[2]; j[2]++){
+      for(j[1] = 0; j[1] < g.n[1]; j[1]++){
+        const size_t row = j[1] * g.stride[1] + j[2] * g.stride[2] + j[3] * g.stride[3];
+        pred_<DATATYPE>_t* x = out + row;
+        const uint<DATATYPE_SIZE>_t* r = in + row;
+        lorenzo_row_<DATATYPE>(q, x, &g, row_zero_mask(&g, j));
+
+        // a segment predicted by regression is independent of the values before it
+        for(size_t i = 0; i < n;){
+          const size_t b0 = i >> g.edge_bits;
+          const size_t end = (b0 + 1) << g.edge_bits < n ? (b0 + 1) << g.edge_bits : n;
+          const size_t block = b0 < g.full[0] ? row_block(&g, j, b0) : g.full_blocks;
+          if(block < g.full_blocks && block_uses_regression(bitmap, block)){
+            const float* c = coeff + block * (d + 1);
+            regression_segment_<DATATYPE>(pred + i, c, regression_base(c, &g, j), end - i);
+            for(; i < end; i++){
+              x[i] = from_ordered_<DATATYPE>(to_ordered_<DATATYPE>(pred[i]) + r[i]);
+            }
+          }else{
+            if(i == 0){
+              x[0] = from_ordered_<DATATYPE>(to_ordered_<DATATYPE>(q[0]) + r[0]);
+              i++;
+            }
+            for(; i < end; i++){
+              const pred_<DATATYPE>_t p = x[i - 1] + q[i];
+              x[i] = from_ordered_<DATATYPE>(to_ordered_<DATATYPE>(p) + r[i]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  scilU_workspace_release(ws, mark);
+  return SCIL_NO_ERR;
+}
+
+// End repeat
+
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_lorenzo_precond_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  return in_size + scil_lorenzo_precond_header_bound(count);
+}
+
+scilU_algorithm_t algo_precond_lorenzo = {
+    .c.PFtype = {
+        CREATE_INITIALIZER(scil_lorenzo_precond)
+    },
+    "lorenzo",
+    21,
+    SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST,
+    0,
+    scil_lorenzo_precond_compress_bound
+};
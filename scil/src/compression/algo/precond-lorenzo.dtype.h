@@ -0,0 +1,42 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_PRECOND_LORENZO_H_
+#define SCIL_PRECOND_LORENZO_H_
+#include <scil-algorithm-impl.h>
+
+/*
+ * This preconditioner replaces each value by the residual of its prediction, it is lossless.
+ * The data is split into blocks, each block is predicted either by the Lorenzo predictor over all dimensions,
+ * i.e., from the neighbours with a smaller index, or by a linear regression whose coefficients are stored in the header.
+ * Floating point values are predicted in their type, the residual is the difference of the integers that
+ * preserve the order of the values and of the predictions. Integers are predicted with wrap around arithmetic.
+ */
+
+// Repeat for each data type
+//Supported datatypes: float double int8_t int16_t int32_t int64_t
+int scil_lorenzo_precond_compress_<DATATYPE>(const scil_context_t* ctx, <DATATYPE>* restrict data_out, byte*restrict header, int * header_size_out, <DATATYPE>*restrict data_in, const scil_dims_t* dims);
+
+int scil_lorenzo_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out, scil_dims_t* dims, <DATATYPE>*restrict data_in, byte*restrict header, int * header_parsed_out);
+// End repeat
+
+/*
+ * The largest header written for count values.
+ */
+size_t scil_lorenzo_precond_header_bound(size_t count);
+
+extern scilU_algorithm_t algo_precond_lorenzo;
+
+#endif
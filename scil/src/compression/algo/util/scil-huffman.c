@@ -0,0 +1,575 @@
+#include <scil-huffman.h>
+#include <scil-swager-width.h>
+#include <scil-error.h>
+#include <scil-util.h>
+#include <scil-workspace.h>
+
+#include <string.h>
+
+/*
+ * The format written by scil_huffman_compress():
+ * uint32_t symbols // the largest value + 1
+ * the code length of each symbol as a byte, a length of 0 is followed by a uint16_t with the number of
+ *   further symbols of length 0, i.e., a run of unused symbols takes 3 bytes
+ * the codes of the values, the most significant bit of a code comes first
+ */
+
+// the number of bits the decoder looks up at once
+#define TABLE_BITS 11
+
+// the codes of up to two symbols that start with the index of the entry
+typedef struct
+{
+    uint16_t symbol[2];
+    uint8_t count;      // 0 if the code is longer than TABLE_BITS
+    uint8_t bits[2];    // the bits consumed by the first and by both symbols
+} table_entry_t;
+
+typedef struct
+{
+    uint64_t frequency;
+    uint32_t symbol;
+} leaf_t;
+
+static int compare_leaves(const void* a, const void* b)
+{
+    const leaf_t* x = (const leaf_t*) a;
+    const leaf_t* y = (const leaf_t*) b;
+    if(x->frequency != y->frequency)
+    {
+        return x->frequency < y->frequency ? -1 : 1;
+    }
+    return x->symbol < y->symbol ? -1 : (x->symbol > y->symbol);
+}
+
+// a binary min heap of node indices, nodes of equal weight are ordered by index
+static inline int heap_less(const uint64_t* weight, uint32_t a, uint32_t b)
+{
+    return weight[a] < weight[b] || (weight[a] == weight[b] && a < b);
+}
+
+static void heap_sift_down(uint32_t* heap, uint32_t size, uint32_t pos, const uint64_t* weight)
+{
+    const uint32_t node = heap[pos];
+    while(2 * pos + 1 < size)
+    {
+        uint32_t child = 2 * pos + 1;
+        if(child + 1 < size && heap_less(weight, heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if(! heap_less(weight, heap[child], node))
+        {
+            break;
+        }
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    heap[pos] = node;
+}
+
+static uint32_t heap_pop(uint32_t* heap, uint32_t* size, const uint64_t* weight)
+{
+    const uint32_t top = heap[0];
+    heap[0] = heap[--*size];
+    heap_sift_down(heap, *size, 0, weight);
+    return top;
+}
+
+static void heap_push(uint32_t* heap, uint32_t* size, uint32_t node, const uint64_t* weight)
+{
+    uint32_t pos = (*size)++;
+    while(pos > 0 && heap_less(weight, node, heap[(pos - 1) / 2]))
+    {
+        heap[pos] = heap[(pos - 1) / 2];
+        pos = (pos - 1) / 2;
+    }
+    heap[pos] = node;
+}
+
+int scil_huffman_code_lengths(uint8_t* restrict lengths_out,
+                              const uint64_t* restrict frequencies,
+                              const uint32_t symbols,
+                              const uint8_t max_length)
+{
+    if(symbols > SCIL_HUFFMAN_MAX_SYMBOLS || max_length == 0 || max_length > SCIL_HUFFMAN_MAX_LENGTH)
+    {
+        return SCIL_EINVAL;
+    }
+    memset(lengths_out, 0, symbols);
+
+    uint32_t n = 0;
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        n += frequencies[i] > 0;
+    }
+    if(n == 0)
+    {
+        return SCIL_NO_ERR;
+    }
+    if(n > ((uint32_t) 1) << max_length)
+    {
+        return SCIL_EINVAL;
+    }
+
+    // the leaves ordered by frequency, the least frequent symbols get the longest codes
+    const uint32_t nodes = 2 * n - 1;
+    leaf_t* leaves = (leaf_t*) scilU_safe_malloc(n * sizeof(leaf_t) + nodes * (sizeof(uint64_t) + sizeof(uint32_t)) + n * sizeof(uint32_t));
+    uint64_t* weight = (uint64_t*) (leaves + n);
+    uint32_t* parent = (uint32_t*) (weight + nodes);
+    uint32_t* heap = parent + nodes;
+    n = 0;
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        if(frequencies[i] > 0)
+        {
+            leaves[n].frequency = frequencies[i];
+            leaves[n].symbol = i;
+            n++;
+        }
+    }
+    qsort(leaves, n, sizeof(leaf_t), compare_leaves);
+
+    // merge the two lightest nodes until a single tree is left, the parent has a larger index than its children
+    uint32_t heap_size = 0;
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        weight[i] = leaves[i].frequency;
+        heap_push(heap, &heap_size, i, weight);
+    }
+    for(uint32_t node = n; node < nodes; ++node)
+    {
+        const uint32_t a = heap_pop(heap, &heap_size, weight);
+        const uint32_t b = heap_pop(heap, &heap_size, weight);
+        weight[node] = weight[a] + weight[b];
+        parent[a] = node;
+        parent[b] = node;
+        heap_push(heap, &heap_size, node, weight);
+    }
+
+    // the depth of each node replaces its parent, parents are processed before their children
+    uint32_t length_count[SCIL_HUFFMAN_MAX_LENGTH + 1] = {0};
+    parent[nodes - 1] = 0;
+    for(uint32_t node = nodes - 1; node-- > 0;)
+    {
+        parent[node] = parent[parent[node]] + 1;
+    }
+    for(uint32_t i = 0; i < n; ++i)
+    {
+        length_count[parent[i] < max_length ? parent[i] : max_length]++;
+    }
+
+    // Limit the lengths: the Kraft sum of the shortened codes exceeds 1, it is reduced by moving
+    // the longest codes below max_length one level down until the lengths form a prefix code again
+    const uint64_t kraft_limit = ((uint64_t) 1) << max_length;
+    uint64_t kraft = 0;
+    for(int l = 1; l <= max_length; ++l)
+    {
+        kraft += (uint64_t) length_count[l] << (max_length - l);
+    }
+    while(kraft > kraft_limit)
+    {
+        int l = max_length - 1;
+        while(length_count[l] == 0)
+        {
+            l--;
+        }
+        length_count[l]--;
+        length_count[l + 1]++;
+        kraft -= ((uint64_t) 1) << (max_length - l - 1);
+    }
+    // codes that became free are given to the most frequent symbols that fit
+    for(int l = 2; l <= max_length; ++l)
+    {
+        while(length_count[l] > 0 && kraft + (((uint64_t) 1) << (max_length - l)) <= kraft_limit)
+        {
+            length_count[l]--;
+            length_count[l - 1]++;
+            kraft += ((uint64_t) 1) << (max_length - l);
+        }
+    }
+
+    // assign the lengths in the order of frequency, this keeps the code optimal if no length was limited
+    uint32_t leaf = 0;
+    for(int l = max_length; l > 0; --l)
+    {
+        for(uint32_t i = 0; i < length_count[l]; ++i)
+        {
+            lengths_out[leaves[leaf++].symbol] = (uint8_t) l;
+        }
+    }
+    if(n == 1)
+    {
+        lengths_out[leaves[0].symbol] = 1;
+    }
+    free(leaves);
+    return SCIL_NO_ERR;
+}
+
+// the first code of each length, codes of the same length are consecutive
+static void first_codes(uint32_t* first_code, const uint32_t* length_count)
+{
+    uint32_t code = 0;
+    first_code[0] = 0;
+    for(int l = 1; l <= SCIL_HUFFMAN_MAX_LENGTH; ++l)
+    {
+        code = (code + length_count[l - 1]) << 1;
+        first_code[l] = code;
+    }
+}
+
+void scil_huffman_canonical_codes(uint32_t* restrict codes_out,
+                                  const uint8_t* restrict lengths,
+                                  const uint32_t symbols)
+{
+    uint32_t length_count[SCIL_HUFFMAN_MAX_LENGTH + 1] = {0};
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        length_count[lengths[i]]++;
+    }
+    length_count[0] = 0;
+    uint32_t next_code[SCIL_HUFFMAN_MAX_LENGTH + 1];
+    first_codes(next_code, length_count);
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        codes_out[i] = lengths[i] > 0 ? next_code[lengths[i]]++ : 0;
+    }
+}
+
+size_t scil_huffman_compress_bound(const size_t count)
+{
+    // a used symbol takes 1 byte of the table, each run of unused symbols before it 3 bytes
+    const size_t used = count < SCIL_HUFFMAN_MAX_SYMBOLS ? count : SCIL_HUFFMAN_MAX_SYMBOLS;
+    // the writer stores 8 bytes at once
+    return sizeof(uint32_t) + 4 * used + 3 + (count * SCIL_HUFFMAN_MAX_LENGTH + 7) / 8 + 8;
+}
+
+static byte* write_lengths(byte* out, const uint8_t* lengths, uint32_t symbols)
+{
+    memcpy(out, &symbols, sizeof(uint32_t));
+    out += sizeof(uint32_t);
+    for(uint32_t i = 0; i < symbols;)
+    {
+        *out++ = lengths[i];
+        if(lengths[i] > 0)
+        {
+            i++;
+            continue;
+        }
+        uint32_t run = 1;
+        while(i + run < symbols && lengths[i + run] == 0)
+        {
+            run++;
+        }
+        const uint16_t further = (uint16_t) (run - 1);
+        memcpy(out, &further, sizeof(uint16_t));
+        out += sizeof(uint16_t);
+        i += run;
+    }
+    return out;
+}
+
+int scil_huffman_compress(byte* restrict buf_out,
+                          size_t* restrict out_size,
+                          const uint64_t* restrict buf_in,
+                          const size_t count)
+{
+    uint64_t largest = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+        largest = buf_in[i] > largest ? buf_in[i] : largest;
+    }
+    if(largest >= SCIL_HUFFMAN_MAX_SYMBOLS)
+    {
+        return SCIL_EINVAL;
+    }
+    const uint32_t symbols = count > 0 ? (uint32_t) largest + 1 : 0;
+
+    uint64_t* frequencies = (uint64_t*) scilU_safe_malloc(symbols * (sizeof(uint64_t) + sizeof(uint32_t) + 1) + 1);
+    uint32_t* codes = (uint32_t*) (frequencies + symbols);
+    uint8_t* lengths = (uint8_t*) (codes + symbols);
+    memset(frequencies, 0, symbols * sizeof(uint64_t));
+    for(size_t i = 0; i < count; ++i)
+    {
+        frequencies[buf_in[i]]++;
+    }
+    int ret = scil_huffman_code_lengths(lengths, frequencies, symbols, SCIL_HUFFMAN_MAX_LENGTH);
+    if(ret != SCIL_NO_ERR)
+    {
+        free(frequencies);
+        return ret;
+    }
+    scil_huffman_canonical_codes(codes, lengths, symbols);
+    byte* out = write_lengths(buf_out, lengths, symbols);
+
+    // the pending bits are written as soon as they fill 4 bytes, a code has at most 24 bits
+    uint64_t bits = 0;
+    int bit_count = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const uint64_t value = buf_in[i];
+        bits = (bits << lengths[value]) | codes[value];
+        bit_count += lengths[value];
+        if(bit_count >= 32)
+        {
+            scil_store_be64(out, bits << (64 - bit_count));
+            out += bit_count / 8;
+            bit_count %= 8;
+        }
+    }
+    for(; bit_count > 0; bit_count -= 8)
+    {
+        *out++ = (byte) ((bits << (64 - bit_count)) >> 56);
+    }
+    free(frequencies);
+
+    *out_size = (size_t) (out - buf_out);
+    return SCIL_NO_ERR;
+}
+
+typedef struct
+{
+    uint8_t max_length;
+    table_entry_t table[1 << TABLE_BITS];
+    // the canonical decoding of the codes longer than TABLE_BITS
+    uint32_t length_count[SCIL_HUFFMAN_MAX_LENGTH + 1];
+    uint32_t first_code[SCIL_HUFFMAN_MAX_LENGTH + 1];
+    uint32_t first_index[SCIL_HUFFMAN_MAX_LENGTH + 1];
+    uint16_t sorted[SCIL_HUFFMAN_MAX_SYMBOLS];
+} decoder_t;
+
+static int decoder_create(decoder_t* d, const uint8_t* lengths, uint32_t symbols)
+{
+    memset(d->length_count, 0, sizeof(d->length_count));
+    d->max_length = 0;
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        if(lengths[i] > SCIL_HUFFMAN_MAX_LENGTH)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        d->length_count[lengths[i]]++;
+        d->max_length = lengths[i] > d->max_length ? lengths[i] : d->max_length;
+    }
+    d->length_count[0] = 0;
+    uint64_t kraft = 0;
+    for(int l = 1; l <= SCIL_HUFFMAN_MAX_LENGTH; ++l)
+    {
+        kraft += (uint64_t) d->length_count[l] << (SCIL_HUFFMAN_MAX_LENGTH - l);
+    }
+    if(kraft > ((uint64_t) 1) << SCIL_HUFFMAN_MAX_LENGTH)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    first_codes(d->first_code, d->length_count);
+
+    // the symbols in the order of their codes
+    uint32_t index = 0;
+    for(int l = 1; l <= SCIL_HUFFMAN_MAX_LENGTH; ++l)
+    {
+        d->first_index[l] = index;
+        index += d->length_count[l];
+    }
+    uint32_t next[SCIL_HUFFMAN_MAX_LENGTH + 1];
+    memcpy(next, d->first_index, sizeof(next));
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        if(lengths[i] > 0)
+        {
+            d->sorted[next[lengths[i]]++] = (uint16_t) i;
+        }
+    }
+
+    // a single symbol for every index that starts with a short code
+    memset(d->table, 0, sizeof(d->table));
+    for(int l = 1; l <= TABLE_BITS; ++l)
+    {
+        for(uint32_t k = 0; k < d->length_count[l]; ++k)
+        {
+            const uint32_t code = d->first_code[l] + k;
+            table_entry_t* e = &d->table[code << (TABLE_BITS - l)];
+            for(uint32_t j = 0; j < ((uint32_t) 1) << (TABLE_BITS - l); ++j)
+            {
+                e[j].symbol[0] = d->sorted[d->first_index[l] + k];
+                e[j].count = 1;
+                e[j].bits[0] = (uint8_t) l;
+            }
+        }
+    }
+    // a second symbol if its code fits into the remaining bits of the index
+    for(uint32_t i = 0; i < (1 << TABLE_BITS); ++i)
+    {
+        table_entry_t* e = &d->table[i];
+        if(e->count == 0)
+        {
+            continue;
+        }
+        const table_entry_t* second = &d->table[(i << e->bits[0]) & ((1 << TABLE_BITS) - 1)];
+        if(second->count > 0 && e->bits[0] + second->bits[0] <= TABLE_BITS)
+        {
+            e->symbol[1] = second->symbol[0];
+            e->count = 2;
+            e->bits[1] = (uint8_t) (e->bits[0] + second->bits[0]);
+        }
+    }
+    return SCIL_NO_ERR;
+}
+
+typedef struct
+{
+    const byte* in;
+    size_t size;
+    size_t pos;
+    uint64_t bits;  // the next bit is the most significant one
+    int count;
+} bit_reader_t;
+
+// fill the reader to at least 56 bits, the bits after the input are 0
+static inline void reader_refill(bit_reader_t* r)
+{
+    if(r->pos + 8 <= r->size)
+    {
+        r->bits |= scil_load_be64(r->in + r->pos) >> r->count;
+        r->pos += (63 - r->count) >> 3;
+        r->count |= 56;
+        return;
+    }
+    while(r->count <= 56)
+    {
+        const uint64_t b = r->pos < r->size ? r->in[r->pos] : 0;
+        r->bits |= b << (56 - r->count);
+        r->pos++;
+        r->count += 8;
+    }
+}
+
+static inline void reader_consume(bit_reader_t* r, int bits)
+{
+    r->bits <<= bits;
+    r->count -= bits;
+}
+
+// decode a code longer than TABLE_BITS by its length
+static inline int decode_long(const decoder_t* d, bit_reader_t* r, uint64_t* out)
+{
+    for(int l = TABLE_BITS + 1; l <= d->max_length; ++l)
+    {
+        const uint32_t code = (uint32_t) (r->bits >> (64 - l));
+        if(code - d->first_code[l] < d->length_count[l])
+        {
+            *out = d->sorted[d->first_index[l] + code - d->first_code[l]];
+            reader_consume(r, l);
+            return SCIL_NO_ERR;
+        }
+    }
+    return SCIL_BUFFER_ERR;
+}
+
+static int read_lengths(uint8_t* lengths, uint32_t symbols, const byte** in, const byte* end)
+{
+    for(uint32_t i = 0; i < symbols;)
+    {
+        if(*in >= end)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        lengths[i] = *(*in)++;
+        if(lengths[i] > 0)
+        {
+            i++;
+            continue;
+        }
+        if(*in + sizeof(uint16_t) > end)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        uint16_t further;
+        memcpy(&further, *in, sizeof(uint16_t));
+        *in += sizeof(uint16_t);
+        if(i + 1 + (uint32_t) further > symbols)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        memset(lengths + i + 1, 0, further);
+        i += 1 + further;
+    }
+    return SCIL_NO_ERR;
+}
+
+int scil_huffman_decompress(uint64_t* restrict buf_out,
+                            const size_t count,
+                            const byte* restrict buf_in,
+                            const size_t in_size)
+{
+    uint32_t symbols;
+    if(in_size < sizeof(uint32_t))
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(&symbols, buf_in, sizeof(uint32_t));
+    if(symbols > SCIL_HUFFMAN_MAX_SYMBOLS || (symbols == 0 && count > 0))
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    if(count == 0)
+    {
+        return SCIL_NO_ERR;
+    }
+
+    // the decoder is too large for the stack and is needed for every call, it is kept in the workspace of the thread
+    scilU_workspace_t* ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    decoder_t* d = (decoder_t*) scilU_workspace_alloc(ws, sizeof(decoder_t) + symbols);
+    if(d == NULL)
+    {
+        return SCIL_MEMORY_ERR;
+    }
+    uint8_t* lengths = (uint8_t*) (d + 1);
+    const byte* in = buf_in + sizeof(uint32_t);
+    int ret = read_lengths(lengths, symbols, &in, buf_in + in_size);
+    if(ret == SCIL_NO_ERR)
+    {
+        ret = decoder_create(d, lengths, symbols);
+    }
+    if(ret != SCIL_NO_ERR)
+    {
+        scilU_workspace_release(ws, mark);
+        return ret;
+    }
+
+    bit_reader_t r = {in, (size_t) (buf_in + in_size - in), 0, 0, 0};
+    size_t i = 0;
+    while(i < count)
+    {
+        if(r.count < SCIL_HUFFMAN_MAX_LENGTH)
+        {
+            reader_refill(&r);
+        }
+        const table_entry_t* e = &d->table[r.bits >> (64 - TABLE_BITS)];
+        if(e->count == 2 && i + 1 < count)
+        {
+            buf_out[i] = e->symbol[0];
+            buf_out[i + 1] = e->symbol[1];
+            reader_consume(&r, e->bits[1]);
+            i += 2;
+        }
+        else if(e->count > 0)
+        {
+            buf_out[i++] = e->symbol[0];
+            reader_consume(&r, e->bits[0]);
+        }
+        else if(decode_long(d, &r, &buf_out[i++]) != SCIL_NO_ERR)
+        {
+            scilU_workspace_release(ws, mark);
+            return SCIL_BUFFER_ERR;
+        }
+    }
+    scilU_workspace_release(ws, mark);
+
+    // the codes must not exceed the input
+    if(r.pos * 8 - r.count > r.size * 8)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    return SCIL_NO_ERR;
+}
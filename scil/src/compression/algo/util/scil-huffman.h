@@ -0,0 +1,74 @@
+#ifndef SCIL_HUFFMAN_H
+#define SCIL_HUFFMAN_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <scil.h>
+
+/**
+ * \file
+ * \brief Canonical Huffman coding of integers, e.g., of quantized values.
+ *
+ * The code lengths are computed from the frequencies with a binary heap and limited to a maximum length.
+ * Only the lengths are stored, the codes are assigned canonically in the order of length and value.
+ * The decoder uses a lookup table that yields up to two values per lookup, longer codes are decoded
+ * by their length.
+ */
+
+// the number of distinct values that can be coded, i.e., values must be smaller
+#define SCIL_HUFFMAN_MAX_SYMBOLS 65536
+
+// the longest code scil_huffman_compress() uses
+#define SCIL_HUFFMAN_MAX_LENGTH 24
+
+/**
+ * \brief Compute the code lengths of a prefix code for the frequencies, no code is longer than max_length bits.
+ * A symbol with frequency 0 gets length 0, a single used symbol gets length 1.
+ * \param lengths_out The length of each symbol
+ * \param frequencies The number of occurrences of each symbol
+ * \param symbols The number of symbols, at most SCIL_HUFFMAN_MAX_SYMBOLS
+ * \param max_length The maximum code length, at most SCIL_HUFFMAN_MAX_LENGTH
+ * \return SCIL_EINVAL if the used symbols cannot be coded with max_length bits
+ */
+int scil_huffman_code_lengths(uint8_t* restrict lengths_out,
+                              const uint64_t* restrict frequencies,
+                              const uint32_t symbols,
+                              const uint8_t max_length);
+
+/**
+ * \brief Assign the canonical codes for the lengths, the codes of the same length are consecutive in the order of the symbols.
+ * \param codes_out The code of each symbol, its lengths[i] lowest bits are used
+ */
+void scil_huffman_canonical_codes(uint32_t* restrict codes_out,
+                                  const uint8_t* restrict lengths,
+                                  const uint32_t symbols);
+
+/**
+ * \brief The worst case size of scil_huffman_compress() for count values.
+ */
+size_t scil_huffman_compress_bound(const size_t count);
+
+/**
+ * \brief Code the values with a Huffman code built for their frequencies, the code is stored before the data.
+ * \param buf_out Destination, it must hold scil_huffman_compress_bound() bytes
+ * \param out_size The number of bytes written
+ * \param buf_in The values, each must be smaller than SCIL_HUFFMAN_MAX_SYMBOLS
+ * \param count The number of values
+ * \return SCIL_EINVAL if a value is too large
+ */
+int scil_huffman_compress(byte* restrict buf_out,
+                          size_t* restrict out_size,
+                          const uint64_t* restrict buf_in,
+                          const size_t count);
+
+/**
+ * \brief Decode count values written by scil_huffman_compress().
+ * \return SCIL_BUFFER_ERR if the input is corrupt
+ */
+int scil_huffman_decompress(uint64_t* restrict buf_out,
+                            const size_t count,
+                            const byte* restrict buf_in,
+                            const size_t in_size);
+
+#endif /* SCIL_HUFFMAN_H */
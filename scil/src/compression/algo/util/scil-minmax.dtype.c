@@ -0,0 +1,49 @@
+#include <scil-minmax.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <string.h>
+
+static int same_value(double a, double b){
+    return a <= b && a >= b;
+}
+
+static int cache_matches(const scilC_minmax_cache_t* cache, size_t count, double ignore_up_to, double ignore_from, double fill_value){
+    return cache->valid && cache->count == count &&
+        same_value(cache->ignore_up_to, ignore_up_to) && same_value(cache->ignore_from, ignore_from) && same_value(cache->fill_value, fill_value);
+}
+
+//Supported datatypes: int8_t int16_t int32_t int64_t float double
+// Repeat for each data type
+
+void scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>(const scil_context_t* ctx, const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double ignore_up_to, double ignore_from, double fill_value){
+    assert(ctx != NULL);
+
+    // the cache is no part of the configuration, it may change with a const context
+    scilC_minmax_cache_t* cache = (scilC_minmax_cache_t*) & ctx->minmax_cache;
+    if (buffer == ctx->input && cache_matches(cache, count, ignore_up_to, ignore_from, fill_value)){
+      memcpy(minimum, cache->minimum, sizeof(<DATATYPE>));
+      memcpy(maximum, cache->maximum, sizeof(<DATATYPE>));
+      return;
+    }
+
+    scilU_find_minimum_maximum_parallel_<DATATYPE>(buffer, count, minimum, maximum, ignore_up_to, ignore_from, fill_value, ctx->hints.parallel_threads);
+
+    // intermediate buffers of the chain are not cached, their content changes
+    if (buffer == ctx->input){
+      cache->count = count;
+      cache->ignore_up_to = ignore_up_to;
+      cache->ignore_from = ignore_from;
+      cache->fill_value = fill_value;
+      memcpy(cache->minimum, minimum, sizeof(<DATATYPE>));
+      memcpy(cache->maximum, maximum, sizeof(<DATATYPE>));
+      cache->valid = 1;
+    }
+}
+
+void scilC_find_minimum_maximum_<DATATYPE>(const scil_context_t* ctx, const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum){
+    scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>(ctx, buffer, count, minimum, maximum, -DBL_MAX, DBL_MAX, DBL_MAX);
+}
+
+// End repeat
@@ -0,0 +1,35 @@
+#ifndef SCIL_MINMAX_H_
+#define SCIL_MINMAX_H_
+
+#include <scil-context-impl.h>
+
+#include <stdlib.h>
+#include <stdint.h>
+
+//Supported datatypes: int8_t int16_t int32_t int64_t float double
+// Repeat for each data type
+
+/**
+ * \brief Determines the minimum and maximum like scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>().
+ * The result for the input buffer of the context is computed once and kept in the context,
+ * large buffers are processed by the number of threads given in the hints.
+ */
+void scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>(const scil_context_t* ctx,
+                                          const <DATATYPE>* restrict buffer,
+                                          size_t count,
+                                          <DATATYPE>* minimum,
+                                          <DATATYPE>* maximum,
+                                          double ignore_up_to, double ignore_from, double fill_value);
+
+/**
+ * \brief Determines the minimum and maximum of all values, see scilC_find_minimum_maximum_with_excluded_points_<DATATYPE>().
+ */
+void scilC_find_minimum_maximum_<DATATYPE>(const scil_context_t* ctx,
+                                          const <DATATYPE>* restrict buffer,
+                                          size_t count,
+                                          <DATATYPE>* minimum,
+                                          <DATATYPE>* maximum);
+
+// End repeat
+
+#endif
@@ -0,0 +1,358 @@
+#include <scil-rans.h>
+#include <scil-swager.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <string.h>
+
+/*
+ * The format written by scil_rans_compress():
+ * uint16_t symbols // the largest coded symbol + 1, 0 if there are no values
+ * uint16_t the frequency of each symbol
+ * uint64_t escapes // the number of values >= SCIL_RANS_ESCAPE
+ * if escapes > 0: uint8_t bits per escaped value, then the escaped values - SCIL_RANS_ESCAPE bit-packed
+ * uint32_t the final state of each coder
+ * uint64_t words // the number of 16 bit words
+ * the words in the order the decoder reads them
+ *
+ * The encoder runs backwards over the values, value i is coded by state i % SCIL_RANS_STREAMS.
+ */
+
+#define PROB_SCALE (1u << SCIL_RANS_PROB_BITS)
+
+#define SYMBOLS (SCIL_RANS_ESCAPE + 1)
+
+// a normalized state is in [RANS_L, RANS_L << 16), it is renormalized by one word at a time
+#define RANS_L (1u << 16)
+
+#define HEADER_MAX (2 + 2 * SYMBOLS + 8 + 1 + 4 * SCIL_RANS_STREAMS + 8)
+
+size_t scil_rans_compress_bound(const size_t count)
+{
+    // an escaped value takes at most 64 bits, a value emits at most one word
+    return HEADER_MAX + count * 8 + count * 2;
+}
+
+static inline void store16(byte* out, uint16_t word)
+{
+    memcpy(out, &word, sizeof(uint16_t));
+}
+
+static inline uint32_t load16(const byte* in)
+{
+    uint16_t word;
+    memcpy(&word, in, sizeof(uint16_t));
+    return word;
+}
+
+static uint8_t bits_needed(uint64_t value)
+{
+    uint8_t bits = 1;
+    while(bits < 64 && value >> bits)
+    {
+        bits++;
+    }
+    return bits;
+}
+
+// scale the histogram to PROB_SCALE, every used symbol keeps a frequency of at least 1
+static void normalize_frequencies(uint32_t* restrict freq, const uint64_t* restrict histogram, uint32_t symbols, size_t count)
+{
+    uint32_t sum = 0;
+    uint32_t largest = 0;
+    if(symbols == 0)
+    {
+        return;
+    }
+    for(uint32_t s = 0; s < symbols; s++)
+    {
+        freq[s] = 0;
+        if(histogram[s] == 0)
+        {
+            continue;
+        }
+        const uint32_t f = (uint32_t) ((double) histogram[s] * PROB_SCALE / count);
+        freq[s] = f < 1 ? 1 : f;
+        sum += freq[s];
+        if(histogram[s] > histogram[largest])
+        {
+            largest = s;
+        }
+    }
+    // the most frequent symbol absorbs the rounding error, it changes the coded size the least
+    if(sum < PROB_SCALE)
+    {
+        freq[largest] += PROB_SCALE - sum;
+        return;
+    }
+    while(sum > PROB_SCALE)
+    {
+        uint32_t m = 0;
+        for(uint32_t s = 1; s < symbols; s++)
+        {
+            if(freq[s] > freq[m])
+            {
+                m = s;
+            }
+        }
+        const uint32_t take = sum - PROB_SCALE < freq[m] / 2 ? sum - PROB_SCALE : freq[m] / 2;
+        freq[m] -= take;
+        sum -= take;
+    }
+}
+
+int scil_rans_compress(byte* restrict buf_out,
+                       size_t* restrict out_size,
+                       const uint64_t* restrict buf_in,
+                       const size_t count)
+{
+    byte* out = buf_out;
+
+    uint64_t histogram[SYMBOLS] = {0};
+    for(size_t i = 0; i < count; i++)
+    {
+        const uint64_t v = buf_in[i];
+        histogram[v < SCIL_RANS_ESCAPE ? v : SCIL_RANS_ESCAPE]++;
+    }
+    uint16_t symbols = SYMBOLS;
+    while(symbols > 0 && histogram[symbols - 1] == 0)
+    {
+        symbols--;
+    }
+
+    uint32_t freq[SYMBOLS];
+    uint32_t start[SYMBOLS];
+    uint64_t x_max[SYMBOLS];
+    normalize_frequencies(freq, histogram, symbols, count);
+
+    memcpy(out, &symbols, sizeof(uint16_t));
+    out += 2;
+    uint32_t cumulative = 0;
+    for(uint32_t s = 0; s < symbols; s++)
+    {
+        store16(out, (uint16_t) freq[s]);
+        out += 2;
+        start[s] = cumulative;
+        cumulative += freq[s];
+        // a state at or above this bound would overflow after coding the symbol
+        x_max[s] = ((uint64_t) (RANS_L >> SCIL_RANS_PROB_BITS) << 16) * freq[s];
+    }
+
+    const uint64_t escapes = symbols == SYMBOLS ? histogram[SCIL_RANS_ESCAPE] : 0;
+    memcpy(out, &escapes, sizeof(uint64_t));
+    out += 8;
+    if(escapes > 0)
+    {
+        uint64_t largest = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            if(buf_in[i] >= SCIL_RANS_ESCAPE && buf_in[i] - SCIL_RANS_ESCAPE > largest)
+            {
+                largest = buf_in[i] - SCIL_RANS_ESCAPE;
+            }
+        }
+        const uint8_t bits = bits_needed(largest);
+        *out++ = bits;
+        size_t bit_index = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            if(buf_in[i] >= SCIL_RANS_ESCAPE)
+            {
+                scil_swage_value(out, buf_in[i] - SCIL_RANS_ESCAPE, bits, &bit_index);
+            }
+        }
+        out += (bit_index + 7) / 8;
+    }
+
+    byte* states = out;
+    out += 4 * SCIL_RANS_STREAMS + 8;
+
+    // the words are emitted backwards at the end of the buffer, the header cannot reach them
+    byte* const end = buf_out + scil_rans_compress_bound(count);
+    byte* ptr = end;
+    uint32_t state[SCIL_RANS_STREAMS];
+    for(int j = 0; j < SCIL_RANS_STREAMS; j++)
+    {
+        state[j] = RANS_L;
+    }
+    for(size_t i = count; i-- > 0;)
+    {
+        const uint64_t v = buf_in[i];
+        const uint32_t s = v < SCIL_RANS_ESCAPE ? (uint32_t) v : SCIL_RANS_ESCAPE;
+        uint32_t x = state[i % SCIL_RANS_STREAMS];
+        if(x >= x_max[s])
+        {
+            ptr -= 2;
+            store16(ptr, (uint16_t) x);
+            x >>= 16;
+        }
+        state[i % SCIL_RANS_STREAMS] = ((x / freq[s]) << SCIL_RANS_PROB_BITS) + (x % freq[s]) + start[s];
+    }
+
+    const uint64_t words = (uint64_t) (end - ptr) / 2;
+    memcpy(states, state, sizeof(state));
+    memcpy(states + sizeof(state), &words, sizeof(uint64_t));
+    memmove(out, ptr, words * 2);
+    *out_size = (size_t) (out - buf_out) + words * 2;
+    return SCIL_NO_ERR;
+}
+
+int scil_rans_decompress(uint64_t* restrict buf_out,
+                         const size_t count,
+                         const byte* restrict buf_in,
+                         const size_t in_size)
+{
+    const byte* in = buf_in;
+    const byte* const in_end = buf_in + in_size;
+
+    uint16_t symbols;
+    if(in_size < 2)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(&symbols, in, sizeof(uint16_t));
+    in += 2;
+    if(symbols > SYMBOLS || (symbols == 0 && count > 0) || (size_t) (in_end - in) < 2u * symbols + 8)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    if(count == 0)
+    {
+        return SCIL_NO_ERR;
+    }
+
+    // the frequency and the offset into the symbol's range for each slot, the state update needs a single lookup
+    uint32_t slot_entry[PROB_SCALE];
+    uint8_t slot_symbol[PROB_SCALE];
+    uint32_t cumulative = 0;
+    for(uint32_t s = 0; s < symbols; s++)
+    {
+        const uint32_t f = load16(in);
+        in += 2;
+        if(cumulative + f > PROB_SCALE)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        for(uint32_t slot = cumulative; slot < cumulative + f; slot++)
+        {
+            slot_entry[slot] = f | (slot - cumulative) << 16;
+            slot_symbol[slot] = (uint8_t) s;
+        }
+        cumulative += f;
+    }
+    if(cumulative != PROB_SCALE)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+
+    uint64_t escapes;
+    memcpy(&escapes, in, sizeof(uint64_t));
+    in += 8;
+    const byte* escape_data = NULL;
+    uint8_t escape_bits = 0;
+    if(escapes > 0)
+    {
+        if(escapes > count || in == in_end)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        escape_bits = *in++;
+        const uint64_t bytes = (escapes * escape_bits + 7) / 8;
+        if(escape_bits == 0 || escape_bits > 64 || (uint64_t) (in_end - in) < bytes)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+        escape_data = in;
+        in += bytes;
+    }
+
+    uint32_t state[SCIL_RANS_STREAMS];
+    uint64_t words;
+    if((size_t) (in_end - in) < sizeof(state) + 8)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(state, in, sizeof(state));
+    in += sizeof(state);
+    memcpy(&words, in, sizeof(uint64_t));
+    in += 8;
+    if(words > (uint64_t) (in_end - in) / 2)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    for(int j = 0; j < SCIL_RANS_STREAMS; j++)
+    {
+        if(state[j] < RANS_L)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+    }
+
+    const byte* ptr = in;
+    const byte* const ptr_end = in + words * 2;
+    // the states depend only on their own previous values, the updates of a round overlap in the pipeline
+    for(size_t i = 0; i < count; i += SCIL_RANS_STREAMS)
+    {
+        const int n = count - i < SCIL_RANS_STREAMS ? (int) (count - i) : SCIL_RANS_STREAMS;
+        for(int j = 0; j < n; j++)
+        {
+            uint32_t x = state[j];
+            const uint32_t slot = x & (PROB_SCALE - 1);
+            const uint32_t e = slot_entry[slot];
+            buf_out[i + j] = slot_symbol[slot];
+            x = (e & 0xFFFF) * (x >> SCIL_RANS_PROB_BITS) + (e >> 16);
+            if(x < RANS_L)
+            {
+                if(ptr == ptr_end)
+                {
+                    return SCIL_BUFFER_ERR;
+                }
+                x = (x << 16) | load16(ptr);
+                ptr += 2;
+            }
+            state[j] = x;
+        }
+    }
+
+    // the coder ends in its initial state if all words have been consumed
+    if(ptr != ptr_end)
+    {
+        return SCIL_BUFFER_ERR;
+    }
+    for(int j = 0; j < SCIL_RANS_STREAMS; j++)
+    {
+        if(state[j] != RANS_L)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+    }
+
+    if(escapes > 0)
+    {
+        size_t bit_index = 0;
+        uint64_t found = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            if(buf_out[i] == SCIL_RANS_ESCAPE)
+            {
+                if(++found > escapes)
+                {
+                    return SCIL_BUFFER_ERR;
+                }
+                uint64_t value;
+                scil_unswage_value(&value, escape_data, escape_bits, &bit_index);
+                buf_out[i] = SCIL_RANS_ESCAPE + value;
+            }
+        }
+        if(found != escapes)
+        {
+            return SCIL_BUFFER_ERR;
+        }
+    }
+    else if(symbols == SYMBOLS)
+    {
+        // the escape symbol is only in the model if it is used
+        return SCIL_BUFFER_ERR;
+    }
+    return SCIL_NO_ERR;
+}
@@ -0,0 +1,55 @@
+#ifndef SCIL_RANS_H
+#define SCIL_RANS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <scil.h>
+
+/**
+ * \file
+ * \brief Interleaved rANS coding of integers, e.g., of the residuals of quantized values.
+ *
+ * Values below SCIL_RANS_ESCAPE are coded with a static model of their frequencies scaled to 2^SCIL_RANS_PROB_BITS.
+ * Larger values code the escape symbol and are stored bit-packed after the model.
+ * SCIL_RANS_STREAMS states code the values round robin and share one stream of 16 bit words,
+ * the decoder updates the states independently of each other.
+ */
+
+// the number of interleaved coder states
+#define SCIL_RANS_STREAMS 8
+
+// the frequencies of the model sum up to 1 << SCIL_RANS_PROB_BITS
+#define SCIL_RANS_PROB_BITS 12
+
+// the symbol that marks a value that is not coded by the model
+#define SCIL_RANS_ESCAPE 255
+
+/**
+ * \brief The worst case size of scil_rans_compress() for count values.
+ */
+size_t scil_rans_compress_bound(const size_t count);
+
+/**
+ * \brief Code the values with a model built for their frequencies, the model is stored before the data.
+ * \param buf_out Destination, it must hold scil_rans_compress_bound() bytes
+ * \param out_size The number of bytes written
+ * \param buf_in The values
+ * \param count The number of values
+ * \return Success state of the compression
+ */
+int scil_rans_compress(byte* restrict buf_out,
+                       size_t* restrict out_size,
+                       const uint64_t* restrict buf_in,
+                       const size_t count);
+
+/**
+ * \brief Decode count values written by scil_rans_compress().
+ * \return SCIL_BUFFER_ERR if the input is corrupt
+ */
+int scil_rans_decompress(uint64_t* restrict buf_out,
+                         const size_t count,
+                         const byte* restrict buf_in,
+                         const size_t in_size);
+
+#endif /* SCIL_RANS_H */
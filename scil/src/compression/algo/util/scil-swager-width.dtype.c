@@ -0,0 +1,74 @@
+#include <scil-swager-width.h>
+
+// the bits_per_value argument is a constant in every caller, hence these are specialised after inlining
+
+// append a value to the left aligned bits of the word and write the word once it is full
+#define SWAGE_VALUE(value)                          \
+    if(bits < free_bits)                            \
+    {                                               \
+        free_bits -= bits;                          \
+        word |= (value) << free_bits;               \
+    }                                               \
+    else                                            \
+    {                                               \
+        const int rest = bits - free_bits;          \
+        word |= (value) >> rest;                    \
+        scil_store_be64(out, word);                 \
+        out += 8;                                   \
+        word = rest == 0 ? 0 : (value) << (64 - rest); \
+        free_bits = 64 - rest;                      \
+    }
+
+static inline __attribute__((always_inline)) void swage_group(byte* restrict out, const uint64_t* restrict in, const int bits)
+{
+    uint64_t word = 0;
+    int free_bits = 64;
+    // unrolled by hand, so that free_bits is a constant in every step
+    SWAGE_VALUE(in[0])
+    SWAGE_VALUE(in[1])
+    SWAGE_VALUE(in[2])
+    SWAGE_VALUE(in[3])
+    SWAGE_VALUE(in[4])
+    SWAGE_VALUE(in[5])
+    SWAGE_VALUE(in[6])
+    SWAGE_VALUE(in[7])
+    if(free_bits < 64)
+    {
+        scil_store_be64(out, word);
+    }
+}
+
+static inline __attribute__((always_inline)) void unswage_group(uint64_t* restrict out, const byte* restrict in, const int bits)
+{
+    for(int i = 0; i < SCIL_SWAGE_GROUP; ++i)
+    {
+        const int offset = (i * bits) % 8;
+        const byte* start = in + (i * bits) / 8;
+        uint64_t word = scil_load_be64(start) << offset;
+        if(offset + bits > 64)
+        {
+            word |= start[8] >> (8 - offset);
+        }
+        out[i] = word >> (64 - bits);
+    }
+}
+
+// Repeat for each bit width
+static void swage_group_<BITS>(byte* restrict out, const uint64_t* restrict in)
+{
+    swage_group(out, in, <BITS>);
+}
+
+static void unswage_group_<BITS>(uint64_t* restrict out, const byte* restrict in)
+{
+    unswage_group(out, in, <BITS>);
+}
+// End repeat
+
+const scil_swage_group_func_t scil_swage_group_functions[64] = {
+      CREATE_BIT_WIDTH_INITIALIZER(swage_group)
+};
+
+const scil_unswage_group_func_t scil_unswage_group_functions[64] = {
+      CREATE_BIT_WIDTH_INITIALIZER(unswage_group)
+};
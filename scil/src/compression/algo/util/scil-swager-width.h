@@ -0,0 +1,52 @@
+#ifndef SCIL_SWAGER_WIDTH_H
+#define SCIL_SWAGER_WIDTH_H
+
+/**
+ * \file
+ * \brief Packing kernels specialised for each bit width, the shifts and masks are compile-time constants.
+ *
+ * A kernel processes a group of 8 values which occupy exactly bits_per_value bytes,
+ * hence every group starts at a byte boundary.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <scil.h>
+
+#define SCIL_SWAGE_GROUP 8
+
+/**
+ * \brief Pack a group, the last word written may exceed the bits_per_value bytes of the group by up to 7 bytes.
+ */
+typedef void (*scil_swage_group_func_t)(byte* restrict buf_out, const uint64_t* restrict buf_in);
+
+/**
+ * \brief Unpack a group, reads up to 8 bytes after the bits_per_value bytes of the group.
+ */
+typedef void (*scil_unswage_group_func_t)(uint64_t* restrict buf_out, const byte* restrict buf_in);
+
+// indexed by bits_per_value - 1
+extern const scil_swage_group_func_t scil_swage_group_functions[64];
+extern const scil_unswage_group_func_t scil_unswage_group_functions[64];
+
+static inline uint64_t scil_load_be64(const byte* in)
+{
+    uint64_t word;
+    memcpy(&word, in, sizeof(uint64_t));
+#ifdef SCIL_BIG_ENDIAN
+    return word;
+#else
+    return __builtin_bswap64(word);
+#endif
+}
+
+static inline void scil_store_be64(byte* out, uint64_t word)
+{
+#ifndef SCIL_BIG_ENDIAN
+    word = __builtin_bswap64(word);
+#endif
+    memcpy(out, &word, sizeof(uint64_t));
+}
+
+#endif /* SCIL_SWAGER_WIDTH_H */
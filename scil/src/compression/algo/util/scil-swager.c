@@ -1,74 +1,420 @@
 #include <scil-swager.h>
+#include <scil-swager-width.h>
+#include <scil-error.h>
 
+#include <pthread.h>
+#include <string.h>
 
-static uint8_t start_mask[9] = {
-    255, //0b11111111
-    127, //0b01111111
-    63,  //0b00111111
-    31,  //0b00011111
-    15,  //0b00001111
-    7,   //0b00000111
-    3,   //0b00000011
-    1,   //0b00000001
-    0    //0b00000000
-};
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SWAGE_X86_KERNELS
+#endif
 
-static uint8_t end_mask[9] = {
-    0,         //0b00000000
-    255 - 127, //0b10000000
-    255 - 63,  //0b11000000
-    255 - 31,  //0b11100000
-    255 - 15,  //0b11110000
-    255 - 7,   //0b11111000
-    255 - 3,   //0b11111100
-    255 - 1,   //0b11111110
-    255        //0b11111111
-};
+/*
+ * The packed format is big-endian: the values are stored one after another starting with the most
+ * significant bit of the first byte. The kernels below move 64 bit words at once, the words are
+ * byte swapped on little-endian systems.
+ */
 
-// Can do negative right shifts!! (left shifts)
-static byte right_shift_64(uint64_t value, int amount){
-    return (byte)(amount >= 0 ?
-        value >> amount :
-        value << -amount);
+static inline size_t packed_size(const size_t count, const uint8_t bits_per_value)
+{
+    return (count * bits_per_value + 7) / 8;
 }
-static uint64_t right_shift_8(byte value, int amount){
-    return (amount >= 0 ?
-        ((uint64_t)value) >> amount :
-        ((uint64_t)value) << -amount);
+
+// read a value that may end within the last 8 bytes of the input, one byte at a time
+static uint64_t read_value_bytewise(const byte* restrict buf_in, size_t bit_index, const uint8_t bits_per_value)
+{
+    if(bits_per_value > 56)
+    {
+        // the value and its bit offset may exceed 64 bits, read it in two parts
+        const uint64_t high = read_value_bytewise(buf_in, bit_index, bits_per_value - 32);
+        return (high << 32) | read_value_bytewise(buf_in, bit_index + bits_per_value - 32, 32);
+    }
+    const byte* in = buf_in + bit_index / 8;
+    int bits = bits_per_value + (int)(bit_index % 8);
+    uint64_t value = *in++ & (0xFF >> (bit_index % 8));
+    bits -= 8;
+    while(bits > 0)
+    {
+        value = (value << 8) | *in++;
+        bits -= 8;
+    }
+    return value >> -bits;
 }
 
-int scil_swage(byte* restrict buf_out,
-               const uint64_t* restrict buf_in,
-               const size_t count,
-               const uint8_t bits_per_value)
+// ==================== scalar kernels ========================================
+
+static void swage_scalar(byte* restrict buf_out,
+                         const uint64_t* restrict buf_in,
+                         const size_t count,
+                         const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
+    // the bits are collected left aligned in the word and written once it is full
+    uint64_t word = 0;
+    int free_bits = 64;
+    byte* out = buf_out;
     for(size_t i = 0; i < count; ++i)
     {
-        size_t start_byte = bit_index / 8;
-        size_t end_byte   = (bit_index + bits_per_value) / 8;
-        uint8_t bit_offset = bit_index % 8;
+        const uint64_t value = buf_in[i];
+        if(bits_per_value < free_bits)
+        {
+            free_bits -= bits_per_value;
+            word |= value << free_bits;
+            continue;
+        }
+        const int rest = bits_per_value - free_bits;
+        word |= value >> rest;
+        scil_store_be64(out, word);
+        out += 8;
+        word = rest == 0 ? 0 : value << (64 - rest);
+        free_bits = 64 - rest;
+    }
+    const size_t tail = (64 - free_bits + 7) / 8;
+    if(tail > 0)
+    {
+        byte last[8];
+        scil_store_be64(last, word);
+        memcpy(out, last, tail);
+    }
+}
+
+static void unswage_scalar_from(uint64_t* restrict buf_out,
+                                const byte* restrict buf_in,
+                                size_t start,
+                                const size_t count,
+                                const uint8_t bits_per_value)
+{
+    const size_t in_size = packed_size(count, bits_per_value);
+    const int shift_back = 64 - bits_per_value;
+    size_t i = start;
+    size_t bit_index = i * bits_per_value;
+    // whole words can be loaded while 9 bytes are available
+    for(; i < count && bit_index / 8 + 9 <= in_size; ++i, bit_index += bits_per_value)
+    {
+        const byte* in = buf_in + bit_index / 8;
+        const int offset = bit_index % 8;
+        uint64_t word = scil_load_be64(in) << offset;
+        if(offset + bits_per_value > 64)
+        {
+            word |= in[8] >> (8 - offset);
+        }
+        buf_out[i] = word >> shift_back;
+    }
+    for(; i < count; ++i, bit_index += bits_per_value)
+    {
+        buf_out[i] = read_value_bytewise(buf_in, bit_index, bits_per_value);
+    }
+}
+
+static void unswage_scalar(uint64_t* restrict buf_out,
+                           const byte* restrict buf_in,
+                           const size_t count,
+                           const uint8_t bits_per_value)
+{
+    unswage_scalar_from(buf_out, buf_in, 0, count, bits_per_value);
+}
+
+// ==================== kernels specialised per bit width =====================
+
+static void swage_unrolled(byte* restrict buf_out,
+                           const uint64_t* restrict buf_in,
+                           const size_t count,
+                           const uint8_t bits_per_value)
+{
+    const scil_swage_group_func_t func = scil_swage_group_functions[bits_per_value - 1];
+    const size_t out_size = packed_size(count, bits_per_value);
+    const size_t groups = count / SCIL_SWAGE_GROUP;
+    size_t g = 0;
+    // a group may write up to 7 bytes beyond its end
+    for(; g < groups && (g + 1) * bits_per_value + 8 <= out_size; ++g)
+    {
+        func(buf_out + g * bits_per_value, buf_in + g * SCIL_SWAGE_GROUP);
+    }
+    swage_scalar(buf_out + g * bits_per_value, buf_in + g * SCIL_SWAGE_GROUP, count - g * SCIL_SWAGE_GROUP, bits_per_value);
+}
+
+static void unswage_unrolled(uint64_t* restrict buf_out,
+                             const byte* restrict buf_in,
+                             const size_t count,
+                             const uint8_t bits_per_value)
+{
+    const scil_unswage_group_func_t func = scil_unswage_group_functions[bits_per_value - 1];
+    const size_t in_size = packed_size(count, bits_per_value);
+    const size_t groups = count / SCIL_SWAGE_GROUP;
+    size_t g = 0;
+    // a group may read 8 bytes beyond its end
+    for(; g < groups && (g + 1) * bits_per_value + 8 <= in_size; ++g)
+    {
+        func(buf_out + g * SCIL_SWAGE_GROUP, buf_in + g * bits_per_value);
+    }
+    unswage_scalar_from(buf_out, buf_in, g * SCIL_SWAGE_GROUP, count, bits_per_value);
+}
+
+// ==================== BMI2 / AVX2 kernels ===================================
+
+#ifdef SWAGE_X86_KERNELS
+
+/*
+ * For up to 32 bits per value, a group of 64 / lane_bits values is extracted from a single word:
+ * pdep deposits the values into lanes of 8, 16 or 32 bits, which are widened to 64 bits with AVX2.
+ */
+typedef struct {
+    int lane_bits;
+    int group;          // number of values per word
+    uint64_t lane_mask; // the lowest bits_per_value bits of each lane
+} group_layout_t;
+
+static int gcd(int a, int b)
+{
+    while(b != 0)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int group_layout(group_layout_t* layout, const uint8_t bits_per_value)
+{
+    if(bits_per_value == 0 || bits_per_value > 32)
+    {
+        return 0;
+    }
+    layout->lane_bits = bits_per_value <= 8 ? 8 : (bits_per_value <= 16 ? 16 : 32);
+    layout->group = 64 / layout->lane_bits;
+
+    // the group must fit into the word for every bit offset it can start at
+    const int group_bits = layout->group * bits_per_value;
+    const int max_offset = 8 - gcd(group_bits, 8);
+    if(group_bits + max_offset > 64)
+    {
+        return 0;
+    }
+    const uint64_t lane = (((uint64_t) 1) << bits_per_value) - 1;
+    layout->lane_mask = 0;
+    for(int i = 0; i < layout->group; i++)
+    {
+        layout->lane_mask |= lane << (i * layout->lane_bits);
+    }
+    return 1;
+}
+
+// narrow the values of a group into lanes, the first value ends up in the most significant lane
+__attribute__((target("bmi2,avx2")))
+static inline uint64_t group_to_lanes(const uint64_t* restrict buf_in, const int lane_bits)
+{
+    const __m256i even_dwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    uint64_t lanes;
+    switch(lane_bits)
+    {
+    case 8:
+    {
+        const __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) buf_in), even_dwords);
+        const __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(buf_in + 4)), even_dwords);
+        // the 32 bit lanes v0..v7 are narrowed per 128 bit half, v0..v3 and v4..v7
+        __m256i v = _mm256_permute2x128_si256(a, b, 0x20);
+        v = _mm256_packus_epi32(v, v);
+        v = _mm256_packus_epi16(v, v);
+        lanes = (uint32_t) _mm256_extract_epi32(v, 0) | ((uint64_t)(uint32_t) _mm256_extract_epi32(v, 4) << 32);
+        return __builtin_bswap64(lanes);
+    }
+    case 16:
+    {
+        __m256i v = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) buf_in), even_dwords);
+        v = _mm256_packus_epi32(v, v);
+        lanes = (uint64_t) _mm256_extract_epi64(v, 0);
+        lanes = (lanes >> 32) | (lanes << 32);
+        return ((lanes >> 16) & 0x0000FFFF0000FFFFULL) | ((lanes & 0x0000FFFF0000FFFFULL) << 16);
+    }
+    default:
+        return (buf_in[0] << 32) | buf_in[1];
+    }
+}
+
+/*
+ * The inverse of the unpacking: the values of a group are narrowed into lanes with AVX2, pext
+ * compacts the lanes into the bits of the group which are appended to a word like in swage_scalar.
+ */
+__attribute__((target("bmi2,avx2")))
+static void swage_bmi2_avx2(byte* restrict buf_out,
+                            const uint64_t* restrict buf_in,
+                            const size_t count,
+                            const uint8_t bits_per_value)
+{
+    // with 16 and 32 bit lanes the unrolled kernel packs faster, a group holds only 4 or 2 values
+    group_layout_t layout;
+    if(! group_layout(& layout, bits_per_value) || layout.lane_bits != 8)
+    {
+        swage_unrolled(buf_out, buf_in, count, bits_per_value);
+        return;
+    }
+    const int group_bits = layout.group * bits_per_value;
+    uint64_t word = 0;
+    int free_bits = 64;
+    byte* out = buf_out;
+    size_t i = 0;
+    for(; i + layout.group <= count; i += layout.group)
+    {
+        const uint64_t bits = _pext_u64(group_to_lanes(buf_in + i, layout.lane_bits), layout.lane_mask);
+        if(group_bits < free_bits)
+        {
+            free_bits -= group_bits;
+            word |= bits << free_bits;
+            continue;
+        }
+        const int rest = group_bits - free_bits;
+        word |= bits >> rest;
+        scil_store_be64(out, word);
+        out += 8;
+        word = rest == 0 ? 0 : bits << (64 - rest);
+        free_bits = 64 - rest;
+    }
+    // the pending bits are byte aligned only in some cases, the scalar kernel packs the rest bytewise
+    size_t bit_index = (size_t)(out - buf_out) * 8 + (64 - free_bits);
+    byte last[8];
+    scil_store_be64(last, word);
+    memcpy(out, last, (64 - free_bits + 7) / 8);
+    for(; i < count; ++i)
+    {
+        scil_swage_value(buf_out, buf_in[i], bits_per_value, & bit_index);
+    }
+}
+
+__attribute__((target("bmi2,avx2")))
+static void unswage_bmi2_avx2(uint64_t* restrict buf_out,
+                              const byte* restrict buf_in,
+                              const size_t count,
+                              const uint8_t bits_per_value)
+{
+    group_layout_t layout;
+    if(! group_layout(& layout, bits_per_value))
+    {
+        unswage_unrolled(buf_out, buf_in, count, bits_per_value);
+        return;
+    }
+    const size_t in_size = packed_size(count, bits_per_value);
+    const int group_bits = layout.group * bits_per_value;
+    size_t i = 0;
+    size_t bit_index = 0;
+    for(; i + layout.group <= count && bit_index / 8 + 8 <= in_size; i += layout.group, bit_index += group_bits)
+    {
+        // the first value of the group ends up in the most significant lane
+        const uint64_t bits = (scil_load_be64(buf_in + bit_index / 8) << (bit_index % 8)) >> (64 - group_bits);
+        uint64_t lanes = _pdep_u64(bits, layout.lane_mask);
+        switch(layout.lane_bits)
+        {
+        case 8:
+            lanes = __builtin_bswap64(lanes);
+            _mm256_storeu_si256((__m256i*)(buf_out + i), _mm256_cvtepu8_epi64(_mm_cvtsi64_si128(lanes)));
+            _mm256_storeu_si256((__m256i*)(buf_out + i + 4), _mm256_cvtepu8_epi64(_mm_cvtsi64_si128(lanes >> 32)));
+            break;
+        case 16:
+            lanes = (lanes >> 32) | (lanes << 32);
+            lanes = ((lanes >> 16) & 0x0000FFFF0000FFFFULL) | ((lanes & 0x0000FFFF0000FFFFULL) << 16);
+            _mm256_storeu_si256((__m256i*)(buf_out + i), _mm256_cvtepu16_epi64(_mm_cvtsi64_si128(lanes)));
+            break;
+        default:
+            buf_out[i] = lanes >> 32;
+            buf_out[i + 1] = lanes & 0xFFFFFFFF;
+        }
+    }
+    unswage_scalar_from(buf_out, buf_in, i, count, bits_per_value);
+}
+
+#endif // SWAGE_X86_KERNELS
 
-        int8_t right_shifts = bits_per_value + bit_offset - 8;
+// ==================== dispatch ==============================================
 
-        // Write to first byte
+typedef struct {
+    const char* name;
+    int (*supported)();
+    void (*swage)(byte* restrict, const uint64_t* restrict, const size_t, const uint8_t);
+    void (*unswage)(uint64_t* restrict, const byte* restrict, const size_t, const uint8_t);
+} swage_kernel_t;
 
-        // Set remaining bits in start_byte to 0
-        buf_out[start_byte] &= end_mask[bit_offset];
-        // Write as much bits of number as possible to remaining bits
-        buf_out[start_byte] |= right_shift_64(buf_in[i], right_shifts);
+static int always_supported()
+{
+    return 1;
+}
+
+#ifdef SWAGE_X86_KERNELS
+static int bmi2_avx2_supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("avx2");
+}
+#endif
+
+// ordered from the slowest to the fastest kernel
+static const swage_kernel_t kernels[] = {
+    {"scalar", always_supported, swage_scalar, unswage_scalar},
+    {"unrolled", always_supported, swage_unrolled, unswage_unrolled},
+#ifdef SWAGE_X86_KERNELS
+    {"bmi2-avx2", bmi2_avx2_supported, swage_bmi2_avx2, unswage_bmi2_avx2},
+#endif
+};
+
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(swage_kernel_t))
+
+static const swage_kernel_t* kernel = NULL;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
 
-        // Write to following bytes
-        uint8_t k = 1;
-        for(uint64_t j = start_byte + 1; j <= end_byte; ++j)
+static void select_fastest_kernel()
+{
+    for(size_t i = 0; i < KERNEL_COUNT; ++i)
+    {
+        if(kernels[i].supported())
         {
-            buf_out[j] = right_shift_64(buf_in[i], right_shifts - k * 8);
-            ++k;
+            kernel = & kernels[i];
         }
+    }
+}
+
+static inline const swage_kernel_t* get_kernel()
+{
+    pthread_once(& kernel_once, select_fastest_kernel);
+    return kernel;
+}
+
+const char* scil_swage_kernel_name()
+{
+    return get_kernel()->name;
+}
 
-        bit_index += bits_per_value;
+int scil_swage_select_kernel(const char* name)
+{
+    pthread_once(& kernel_once, select_fastest_kernel);
+    if(name == NULL)
+    {
+        select_fastest_kernel();
+        return SCIL_NO_ERR;
     }
+    for(size_t i = 0; i < KERNEL_COUNT; ++i)
+    {
+        if(strcmp(kernels[i].name, name) == 0)
+        {
+            if(! kernels[i].supported())
+            {
+                return SCIL_EINVAL;
+            }
+            kernel = & kernels[i];
+            return SCIL_NO_ERR;
+        }
+    }
+    return SCIL_EINVAL;
+}
 
+int scil_swage(byte* restrict buf_out,
+               const uint64_t* restrict buf_in,
+               const size_t count,
+               const uint8_t bits_per_value)
+{
+    if(bits_per_value == 0)
+    {
+        return 0;
+    }
+    get_kernel()->swage(buf_out, buf_in, count, bits_per_value);
     return 0;
 }
 
@@ -77,37 +423,171 @@ int scil_unswage(uint64_t* restrict buf_out,
                  const size_t count,
                  const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
-    for(size_t i = 0; i < count; ++i)
+    if(bits_per_value == 0)
     {
-        size_t start_byte = bit_index / 8;                         // Index of starting byte of current value in swaged buffer
-        size_t end_byte   = (bit_index + bits_per_value) / 8;      // Index of ending byte of current value in swaged buffer
+        memset(buf_out, 0, count * sizeof(uint64_t));
+        return 0;
+    }
+    get_kernel()->unswage(buf_out, buf_in, count, bits_per_value);
+    return 0;
+}
 
-        uint8_t bit_offset = bit_index % 8;                        // Index of current bit in byte [0-7]
-        uint8_t end_byte_bits = (bit_index + bits_per_value) % 8;  // Number of bits in end_byte occupied by current value
+// ==================== single values =========================================
 
-        int8_t right_shifts = 8 - bits_per_value - bit_offset;
+void scil_swage_value(byte* restrict buf_out,
+                      const uint64_t value,
+                      const uint8_t bits_per_value,
+                      size_t* bit_index)
+{
+    byte* out = buf_out + *bit_index / 8;
+    const int offset = *bit_index % 8;
+    int bits = bits_per_value + offset;
 
-        // Read from start_byte
-        uint64_t intermed = right_shift_8(buf_in[start_byte] & start_mask[bit_offset], right_shifts); // Masks away first value-unrelated bits in start_byte and shifts related bits to final position
-        // Read from intermediate bytes
-        uint8_t k = 1;
-        for(uint64_t j = start_byte + 1; j < end_byte; ++j)
+    // keep the bits of the previous values in the first byte
+    uint64_t rest = value;
+    if(bits <= 8)
+    {
+        *out = (byte)((*out & (0xFF00 >> offset)) | (rest << (8 - bits)));
+    }
+    else
+    {
+        bits -= 8;
+        *out = (byte)((*out & (0xFF00 >> offset)) | (rest >> bits));
+        out++;
+        while(bits >= 8)
         {
-            intermed |= right_shift_8(buf_in[j], right_shifts + k * 8); // Shifts whole byte to final position and applies it
-            ++k;
+            bits -= 8;
+            *out++ = (byte)(rest >> bits);
         }
-        // Read from end_byte
-        if(start_byte != end_byte)
+        if(bits > 0)
         {
-            intermed |= right_shift_8(buf_in[end_byte], 8 - end_byte_bits); // Shifts out unrelated end bits in end_byte and applies value
+            *out = (byte)(rest << (8 - bits));
         }
+    }
+    *bit_index += bits_per_value;
+}
+
+void scil_unswage_value(uint64_t* value_out,
+                        const byte* restrict buf_in,
+                        const uint8_t bits_per_value,
+                        size_t* bit_index)
+{
+    *value_out = bits_per_value == 0 ? 0 : read_value_bytewise(buf_in, *bit_index, bits_per_value);
+    *bit_index += bits_per_value;
+}
 
-        // Write to output buffer
-        buf_out[i] = intermed;
+// ==================== streams ===============================================
 
-        bit_index += bits_per_value;
+void scil_swage_stream_begin(scil_swage_stream_t* stream, byte* restrict buf_out)
+{
+    stream->out = buf_out;
+    stream->bits = 0;
+    stream->bit_count = 0;
+}
+
+// append up to 56 bits, the most significant bits are written first
+static inline void stream_write(scil_swage_stream_t* stream, uint64_t value, uint8_t bits)
+{
+    stream->bits = (stream->bits << bits) | value;
+    stream->bit_count += bits;
+    while(stream->bit_count >= 8)
+    {
+        stream->bit_count -= 8;
+        *stream->out++ = (byte)(stream->bits >> stream->bit_count);
     }
+}
 
-    return 0;
+void scil_swage_stream_push(scil_swage_stream_t* stream,
+                            const uint64_t* restrict buf_in,
+                            const size_t count,
+                            const uint8_t bits_per_value)
+{
+    if(stream->bit_count == 0)
+    {
+        // byte aligned, use the kernel and keep the bits of an incomplete last byte pending
+        scil_swage(stream->out, buf_in, count, bits_per_value);
+        const size_t bits = count * bits_per_value;
+        stream->out += bits / 8;
+        stream->bit_count = bits % 8;
+        if(stream->bit_count > 0)
+        {
+            stream->bits = *stream->out >> (8 - stream->bit_count);
+        }
+        return;
+    }
+    if(bits_per_value <= 56)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            stream_write(stream, buf_in[i], bits_per_value);
+        }
+        return;
+    }
+    // the pending bits and the value would exceed the accumulator, split the value
+    for(size_t i = 0; i < count; ++i)
+    {
+        stream_write(stream, buf_in[i] >> 32, bits_per_value - 32);
+        stream_write(stream, buf_in[i] & 0xFFFFFFFF, 32);
+    }
+}
+
+size_t scil_swage_stream_end(scil_swage_stream_t* stream, byte* restrict buf_out)
+{
+    if(stream->bit_count > 0)
+    {
+        *stream->out++ = (byte)(stream->bits << (8 - stream->bit_count));
+        stream->bit_count = 0;
+    }
+    return (size_t)(stream->out - buf_out);
+}
+
+void scil_unswage_stream_begin(scil_unswage_stream_t* stream, const byte* restrict buf_in)
+{
+    stream->in = buf_in;
+    stream->bits = 0;
+    stream->bit_count = 0;
+}
+
+// read up to 56 bits, only the bytes that contain them are accessed
+static inline uint64_t stream_read(scil_unswage_stream_t* stream, uint8_t bits)
+{
+    while(stream->bit_count < bits)
+    {
+        stream->bits = (stream->bits << 8) | *stream->in++;
+        stream->bit_count += 8;
+    }
+    stream->bit_count -= bits;
+    return (stream->bits >> stream->bit_count) & ((((uint64_t)1) << bits) - 1);
+}
+
+void scil_unswage_stream_pull(scil_unswage_stream_t* stream,
+                              uint64_t* restrict buf_out,
+                              const size_t count,
+                              const uint8_t bits_per_value)
+{
+    if(stream->bit_count == 0)
+    {
+        scil_unswage(buf_out, stream->in, count, bits_per_value);
+        const size_t bits = count * bits_per_value;
+        stream->in += bits / 8;
+        if(bits % 8 > 0)
+        {
+            stream->bits = *stream->in++;
+            stream->bit_count = 8 - bits % 8;
+        }
+        return;
+    }
+    if(bits_per_value <= 56)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            buf_out[i] = stream_read(stream, bits_per_value);
+        }
+        return;
+    }
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint64_t high = stream_read(stream, bits_per_value - 32);
+        buf_out[i] = (high << 32) | stream_read(stream, 32);
+    }
 }
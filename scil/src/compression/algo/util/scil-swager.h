@@ -7,7 +7,8 @@
 #include <scil.h>
 
 /**
- * \brief Packs data in a given buffer bit-perfectly
+ * \brief Packs data in a given buffer bit-perfectly, the most significant bit of a value comes first.
+ * Exactly (count * bits_per_value + 7) / 8 bytes are written.
  * \param buf_out Destination buffer for packed data
  * \param buf_in Source buffer of unpacked data
  * \param count Element count in unpacked buffer
@@ -36,4 +37,75 @@ int scil_unswage(uint64_t* restrict buf_out,
                  const size_t count,
                  const uint8_t bits_per_value);
 
+/**
+ * \brief Pack a single value at the given bit position, the bits before it are kept.
+ * \param bit_index The position of the value in bits, it is advanced by bits_per_value
+ */
+void scil_swage_value(byte* restrict buf_out,
+                      const uint64_t value,
+                      const uint8_t bits_per_value,
+                      size_t* bit_index);
+
+/**
+ * \brief Unpack a single value at the given bit position.
+ * \param bit_index The position of the value in bits, it is advanced by bits_per_value
+ */
+void scil_unswage_value(uint64_t* value_out,
+                        const byte* restrict buf_in,
+                        const uint8_t bits_per_value,
+                        size_t* bit_index);
+
+/**
+ * \brief The name of the kernel scil_swage() and scil_unswage() use.
+ * The fastest kernel the CPU supports is selected at the first use.
+ */
+const char* scil_swage_kernel_name();
+
+/**
+ * \brief Select a kernel by name, e.g., "scalar" or "bmi2-avx2", NULL selects the fastest one.
+ * This is meant for testing and benchmarking, it must not be called while data is packed.
+ * \return SCIL_EINVAL if the kernel does not exist or is not supported by the CPU
+ */
+int scil_swage_select_kernel(const char* name);
+
+/**
+ * \brief State of a packing that is performed in several steps.
+ * The result is identical to a single call of scil_swage() with all values,
+ * but the unpacked values need to be available only for the current step.
+ */
+typedef struct {
+    byte* out;
+    uint64_t bits;      // pending bits that do not fill a byte yet
+    uint8_t bit_count;  // number of pending bits
+} scil_swage_stream_t;
+
+void scil_swage_stream_begin(scil_swage_stream_t* stream, byte* restrict buf_out);
+
+void scil_swage_stream_push(scil_swage_stream_t* stream,
+                            const uint64_t* restrict buf_in,
+                            const size_t count,
+                            const uint8_t bits_per_value);
+
+/**
+ * \brief Write the pending bits, unlike scil_swage() no byte after the packed data is touched.
+ * \return The number of bytes written in total
+ */
+size_t scil_swage_stream_end(scil_swage_stream_t* stream, byte* restrict buf_out);
+
+/**
+ * \brief State of an unpacking that is performed in several steps, the counterpart of scil_swage_stream_t.
+ */
+typedef struct {
+    const byte* in;
+    uint64_t bits;
+    uint8_t bit_count;
+} scil_unswage_stream_t;
+
+void scil_unswage_stream_begin(scil_unswage_stream_t* stream, const byte* restrict buf_in);
+
+void scil_unswage_stream_pull(scil_unswage_stream_t* stream,
+                              uint64_t* restrict buf_out,
+                              const size_t count,
+                              const uint8_t bits_per_value);
+
 #endif /* SCIL_SWAGER_H */
@@ -21,30 +21,36 @@
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_zstd11_compress(const scil_context_t* ctx, byte* restrict dest, size_t * restrict out_size, const byte*restrict source, const size_t source_size){
   size_t size;
-  // store the size of the data
-  *((size_t*) dest) = source_size;
-  // normal compression, not fast
-  //size = LZ4_compress_fast((const char *) (source), (char *) dest + 4, source_size, 2*source_size, 4);
-  size = ZSTD_compress (dest, 2*source_size, source, source_size, 11);
-  *out_size = size + 4;
-  if (size == 0){
+  // the zstd frame stores the size of the data
+  size = ZSTD_compress (dest, ZSTD_compressBound(source_size), source, source_size, 11);
+  if (ZSTD_isError(size)){
       return -1;
-    }
+  }
+  *out_size = size;
 
   return 0;
 }
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_zstd11_decompress(byte*restrict dest, size_t buff_size, const byte*restrict src, const size_t in_size, size_t * uncomp_size_out){
-  size_t size;
-  // retrieve the size of the uncompressed data
-  size = *((size_t *) src);
+  // older versions appended 4 bytes to the frame, they are ignored
+  size_t size = ZSTD_findFrameCompressedSize(src, in_size);
+  if (ZSTD_isError(size)){
+    return SCIL_BUFFER_ERR;
+  }
+  size = ZSTD_decompress(dest, buff_size, src, size);
+  if (ZSTD_isError(size)){
+    return SCIL_BUFFER_ERR;
+  }
   *uncomp_size_out = size;
-  //size = LZ4_decompress_fast((const char *) src + 4, (char *)  dest, size); // LZ4_decompress_safe (source, dest, source_size, exp_size);
-  size = ZSTD_decompress(dest, buff_size, src, in_size);
   return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static size_t scil_zstd11_compress_bound(SCIL_Datatype_t datatype, size_t count, size_t in_size){
+  return ZSTD_compressBound(in_size);
+}
+
 scilU_algorithm_t algo_zstd11 = {
     .c.Btype = {
         scil_zstd11_compress,
@@ -52,5 +58,7 @@ scilU_algorithm_t algo_zstd11 = {
     },
     "zstd-11",
     17,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_zstd11_compress_bound
 };
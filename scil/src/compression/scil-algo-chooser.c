@@ -15,15 +15,19 @@
 
 #include <scil-config.h>
 
+#include <scil.h>
 #include <scil-context-impl.h>
 #include <scil-algo-chooser.h>
 #include <scil-compression-chain.h>
-#include <scil-data-characteristics.h>
+#include <scil-block.h>
 #include <scil-error.h>
 #include <scil-hardware-limits.h>
+#include <scil-energy.h>
 #include <scil-debug.h>
+#include <scil-util.h>
 #include <scil-decision-tree.h>
 
+#include <float.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -33,6 +37,9 @@ typedef struct {
   float c_speed;
   float d_speed;
   float ratio;
+  float energy; // J/MiB, 0 if unknown
+  SCIL_Datatype_t datatype; // SCIL_TYPE_UNKNOWN if the entry applies to all
+  size_t size_class; // the entry applies to data up to this size in bytes and above half of it, 0 to all sizes
 } config_file_entry_t;
 
 static config_file_entry_t *config_list;
@@ -55,98 +62,6 @@ static void parse_losless_list() {
       (config_file_entry_t **) realloc(config_list_lossless, config_list_lossless_size * sizeof(void *));
 }
 
-static char** parse_array_chars(char* config){
-  int count_elements = 0;
-  for(unsigned int i=0; i<strlen(config); ++i){
-    if(config[i] == ';') ++count_elements;
-  }
-  count_elements += 1;
-  char** tree_classes = malloc(sizeof(char*)*count_elements);
-
-  char* item = strtok(config, ";");
-  int class_index = 0;
-  while(item != NULL){
-    tree_classes[class_index] = malloc(sizeof(char*)*(strlen(item)+1));
-    strcpy(tree_classes[class_index], item);
-    item = strtok(NULL, ";");
-    ++class_index;
-  }
-  return tree_classes;
-}
-
-
-static double* parse_array_double(char* config){
-  int count_elements = 0;
-  for(unsigned int i=0; i<strlen(config); ++i){
-    if(config[i] == ';') ++count_elements;
-  }
-  count_elements += 1;
-  double* tree_classes = malloc(sizeof(double*)*count_elements);
-
-  char* item = strtok(config, ";");
-  int class_index = 0;
-  while(item != NULL){
-    tree_classes[class_index] = atof(item);
-    item = strtok(NULL, ";");
-    ++class_index;
-  }
-  return tree_classes;
-}
-
-static int* parse_array_int(char* config){
-  int count_elements = 0;
-  for(unsigned int i=0; i<strlen(config); ++i){
-    if(config[i] == ';') ++count_elements;
-  }
-  count_elements += 1;
-  int* tree_classes = malloc(sizeof(int*)*count_elements);
-
-  char* item = strtok(config, ";");
-  int class_index = 0;
-  while(item != NULL){
-    tree_classes[class_index] = atoi(item);
-    item = strtok(NULL, ";");
-    ++class_index;
-  }
-  return tree_classes;
-}
-
-static int** parse_array_values(char* config, int *column_size){
-  int count_classes = 0;
-  for(unsigned int i=0; i<strlen(config); ++i){
-    if(config[i] == ';') ++count_classes;
-  }
-  count_classes += 1;
-  int firstpass = 1;
-
-  int** values = malloc(sizeof(int*)*count_classes);
-  char* item = strtok(config, ";");
-  int index = 0;
-  int size_2d = 0;
-  while(item != NULL){
-    // Count size of second dimension on the first pass
-    if(firstpass){
-      for(unsigned int i=0; i<strlen(item); ++i){
-        if(item[i] == '.') ++size_2d;
-      }
-      firstpass = 0;
-      *column_size = size_2d;
-    }
-    values[index] = malloc(sizeof(int*)*size_2d);
-    char* saveptr;
-    char* item_value;
-    item_value = strtok_r(item, ".", &saveptr);
-    for (int i = 0; i < size_2d; ++i) {
-      values[index][i] = atoi(item_value);
-      item_value = strtok_r(NULL, ".", &saveptr);
-    }
-    item = strtok(NULL, ";");
-    ++index;
-  }
-  return values;
-}
-
-
 void scilC_algo_chooser_initialize() {
   int ret;
 
@@ -190,46 +105,11 @@ void scilC_algo_chooser_initialize() {
    */
   char *decision_tree_file = getenv("SCIL_DECISION_TREE_FILE");
   if (decision_tree_file) {
-    printf("Using decision tree: %s\n", decision_tree_file);
-    FILE *decision_tree_data = fopen(decision_tree_file, "r");
-    if (decision_tree_data == NULL) {
-      critical("Could not open decision tree file %s\n", decision_tree_file);
-    }
-    char* line = NULL;
-    size_t len = 0;
-    char** tree_class_names = NULL;
-    int* tree_left = NULL;
-    int* tree_right = NULL;
-    double* tree_thresholds = NULL;
-    int** tree_classes = NULL;
-    int* tree_indices = NULL;
-    int column_size = 0;
-    while (getline(&line, &len, decision_tree_data) != -1) {
-      if (line[0] == '#'){ // Type descriptor
-        if(strstr(line, "classes") != NULL){
-          getline(&line, &len, decision_tree_data); // Work on next line
-          tree_class_names = parse_array_chars(line);
-        }else if(strstr(line, "left") != NULL){
-          getline(&line, &len, decision_tree_data);
-          tree_left = parse_array_int(line);
-        }else if(strstr(line, "right") != NULL){
-          getline(&line, &len, decision_tree_data);
-          tree_right = parse_array_int(line);
-        }else if(strstr(line, "thresholds") != NULL){
-          getline(&line, &len, decision_tree_data);
-          tree_thresholds = parse_array_double(line);
-        }else if(strstr(line, "indices") != NULL){
-          getline(&line, &len, decision_tree_data);
-          tree_indices = parse_array_int(line);
-        }else if(strstr(line, "values")){
-          getline(&line, &len, decision_tree_data);
-          tree_classes = parse_array_values(line, &column_size);
-        }
-      }
+    debug("Using decision tree: %s\n", decision_tree_file);
+    decision_tree = scilU_tree_load(decision_tree_file);
+    if (decision_tree == NULL) {
+      critical("Could not load decision tree file %s\n", decision_tree_file);
     }
-    fclose(decision_tree_data);
-    decision_tree = scilU_tree_create(tree_left, tree_right, tree_thresholds, tree_indices, tree_classes, tree_class_names, column_size);
-    //scilU_tree_remove(decision_tree);
   }
 
   /*
@@ -281,27 +161,67 @@ void scilC_algo_chooser_initialize() {
       continue;
     }
 
+    // randomness; [dtype=datatype; size=size class;] chain; c_speed; d_speed; ratio[; energy]
+    // the algorithms of the chain may be separated by ";" as well
     config_file_entry_t *e = &config_list[config_list_size];
-    char name[100];
-    char pattern_name[100];
-    int tokens =
-        sscanf(buff, "%f; %s %s %f; %f; %f", &e->randomness, pattern_name, name, &e->c_speed, &e->d_speed, &e->ratio);
-    if (tokens != 6) {
+    char *fields[PRECONDITIONER_LIMIT * 2 + 7];
+    int tokens = 0;
+    char *saveptr;
+    for (char *token = strtok_r(buff, ";", &saveptr); token != NULL && tokens < (int) (sizeof(fields) / sizeof(char *));
+         token = strtok_r(NULL, ";", &saveptr)) {
+      while (*token == ' ' || *token == '\t') token++;
+      fields[tokens++] = token;
+    }
+    if (tokens < 5) {
       warn("Parsing configuration line \"%s\" returned an error after token %d\n", buff, tokens);
       continue;
     }
-    name[strlen(name) - 1] = 0;
+    // the names of the chain are not numbers, the energy follows the ratio if there are four numbers at the end
+    int numbers = 0;
+    while (numbers < 4 && numbers < tokens - 2) {
+      char *end;
+      strtod(fields[tokens - 1 - numbers], &end);
+      while (*end == ' ' || *end == '\t') end++;
+      if (end == fields[tokens - 1 - numbers] || *end != 0) {
+        break;
+      }
+      numbers++;
+    }
+    numbers = numbers == 4 ? 4 : 3;
+    e->randomness = (float) atof(fields[0]);
+    e->c_speed = (float) atof(fields[tokens - numbers]);
+    e->d_speed = (float) atof(fields[tokens - numbers + 1]);
+    e->ratio = (float) atof(fields[tokens - numbers + 2]);
+    e->energy = numbers == 4 ? (float) atof(fields[tokens - 1]) : 0.0f;
+    e->datatype = SCIL_TYPE_UNKNOWN;
+    e->size_class = 0;
+    char name[1024] = "";
+    for (int i = 1; i < tokens - numbers; i++) {
+      char *end = fields[i] + strlen(fields[i]);
+      while (end > fields[i] && (end[-1] == ' ' || end[-1] == '\t')) *--end = 0;
+      if (strncmp(fields[i], "dtype=", 6) == 0) {
+        e->datatype = scil_str_to_datatype(fields[i] + 6);
+        continue;
+      }
+      if (strncmp(fields[i], "size=", 5) == 0) {
+        e->size_class = (size_t) atoll(fields[i] + 5);
+        continue;
+      }
+      if (name[0] != 0) strncat(name, ",", sizeof(name) - strlen(name) - 1);
+      strncat(name, fields[i], sizeof(name) - strlen(name) - 1);
+    }
     ret = scilU_chain_create(&e->chain, name);
     if (ret != SCIL_NO_ERR) {
-      warn("Parsing configuration line \"%s\"; could not parse compressor chain \"%s\"\n", buff, name);
+      warn("Parsing configuration line; could not parse compressor chain \"%s\"\n", name);
       continue;
     }
-    debug("Configuration line %.3f; %s; %.1f; %.1f; %.3f\n",
+    debug("Configuration line %.3f; %s; %.1f; %.1f; %.3f; %.3f\n",
           (double) e->randomness,
           name,
           (double) e->c_speed,
           (double) e->d_speed,
-          (double) e->ratio);
+          (double) e->ratio,
+          (double) e->energy);
 
     config_list_size++;
     if (config_list_size >= config_list_capacity) {
@@ -319,13 +239,279 @@ void scilC_algo_chooser_initialize() {
   parse_losless_list();
 }
 
+// the chains that are always tried besides the entries of the configuration file
+static const char *default_lossless_chains[] = {"memcopy", "lz4", "zstd", NULL};
+
+// the data is sampled by up to SAMPLE_BLOCKS contiguous blocks of about SAMPLE_BLOCK_SIZE bytes
+#define SAMPLE_BLOCKS 4
+#define SAMPLE_BLOCK_SIZE (64 * 1024)
+
+static int is_lossless_forced() {
+  const char *chainEnv = getenv("SCIL_FORCE_COMPRESSION_CHAIN");
+  return chainEnv != NULL && strcmp(chainEnv, "lossless") == 0;
+}
+
+// lossy chains are only tried if the hints define which error is tolerable
+static int lossy_allowed(const scil_context_t *ctx) {
+  const scil_user_hints_t *h = &ctx->hints;
+  if (ctx->lossless_compression_needed || is_lossless_forced()) {
+    return 0;
+  }
+  return h->absolute_tolerance > 0.0 || h->relative_tolerance_percent > 0.0 || h->significant_bits > 0 ||
+         h->significant_digits > 0;
+}
+
+static int add_candidate(const scil_context_t *ctx,
+                         const scil_compression_chain_t *chain,
+                         scil_compression_chain_t *out_chains,
+                         int count) {
+  if (count >= SCIL_CHOOSER_CANDIDATES_MAX || (chain->is_lossy && !lossy_allowed(ctx)) ||
+      scilU_chain_is_applicable(chain, ctx->datatype) != SCIL_NO_ERR) {
+    return count;
+  }
+  uint8_t ids[2 * PRECONDITIONER_LIMIT + 3];
+  uint8_t other_ids[2 * PRECONDITIONER_LIMIT + 3];
+  const int id_count = scilU_chain_get_ids(chain, ids);
+  for (int i = 0; i < count; i++) {
+    if (scilU_chain_get_ids(&out_chains[i], other_ids) == id_count && memcmp(ids, other_ids, id_count) == 0) {
+      return count;
+    }
+  }
+  out_chains[count] = *chain;
+  return count + 1;
+}
+
+static int add_candidate_by_name(const scil_context_t *ctx,
+                                 const char *name,
+                                 scil_compression_chain_t *out_chains,
+                                 int count) {
+  scil_compression_chain_t chain;
+  if (scilU_chain_create(&chain, name) != SCIL_NO_ERR) {
+    return count;
+  }
+  return add_candidate(ctx, &chain, out_chains, count);
+}
+
+int scilC_algo_chooser_candidates(const scil_context_t *ctx,
+                                  const scil_dims_t *dims,
+                                  scil_compression_chain_t *out_chains) {
+  // must mirror the decisions of scilC_algo_chooser_execute()
+  char *chainEnv = getenv("SCIL_FORCE_COMPRESSION_CHAIN");
+  if (chainEnv != NULL && !is_lossless_forced()) {
+    if (scilU_chain_create(&out_chains[0], chainEnv) != SCIL_NO_ERR) {
+      return 0;
+    }
+    return 1;
+  }
+  scilU_chain_create(&out_chains[0], "memcopy");
+  if (scil_dims_get_count(dims) < 10) {
+    return 1;
+  }
+  int count = 1;
+  for (const char **name = default_lossless_chains; *name != NULL; name++) {
+    count = add_candidate_by_name(ctx, *name, out_chains, count);
+  }
+  if (ctx->hints.absolute_tolerance > 0.0) {
+    count = add_candidate_by_name(ctx, "abstol,lz4", out_chains, count);
+  }
+  if (ctx->hints.significant_bits > 0 || ctx->hints.relative_tolerance_percent > 0.0) {
+    count = add_candidate_by_name(ctx, "sigbits,lz4", out_chains, count);
+  }
+  // the entries measured for the datatype and the size of the data, the entries of all sizes if none matches
+  const size_t size = scil_dims_get_size(dims, ctx->datatype);
+  int size_matched = 0;
+  for (int i = 0; i < config_list_size; i++) {
+    const config_file_entry_t *e = &config_list[i];
+    size_matched |= (e->datatype == SCIL_TYPE_UNKNOWN || e->datatype == ctx->datatype) && e->size_class != 0 &&
+                    size <= e->size_class && size > e->size_class / 2;
+  }
+  for (int i = 0; i < config_list_size; i++) {
+    const config_file_entry_t *e = &config_list[i];
+    if (e->datatype != SCIL_TYPE_UNKNOWN && e->datatype != ctx->datatype) {
+      continue;
+    }
+    if (size_matched && e->size_class != 0 && (size > e->size_class || size <= e->size_class / 2)) {
+      continue;
+    }
+    count = add_candidate(ctx, &e->chain, out_chains, count);
+  }
+  return count;
+}
+
+// the throughput in MiB/s a performance hint requires, 0 if it does not matter
+static double performance_hint_to_mib(scil_performance_hint_t hint) {
+  const double multiplier = (double) hint.multiplier;
+  switch (hint.unit) {
+    case (SCIL_PERFORMANCE_MIB):
+      return multiplier;
+    case (SCIL_PERFORMANCE_GIB):
+      return multiplier * 1024;
+    case (SCIL_PERFORMANCE_NETWORK):
+      return multiplier * (double) scilU_get_hardware_limit(NETWORK);
+    case (SCIL_PERFORMANCE_NODELOCAL_STORAGE):
+    case (SCIL_PERFORMANCE_SINGLESTREAM_SHARED_STORAGE):
+      return multiplier * (double) scilU_get_hardware_limit(STORAGE);
+    default:
+      return 0;
+  }
+}
+
+// the throughput in MiB/s assumed for the transfer of the compressed data if no hardware limit is configured
+#define DEFAULT_TRANSFER_BANDWIDTH 1024.0
+
+// the slowest of the configured limits the compressed data is moved with
+static double transfer_bandwidth() {
+  const double network = (double) scilU_get_hardware_limit(NETWORK);
+  const double storage = (double) scilU_get_hardware_limit(STORAGE);
+  if (network > 0 && storage > 0) {
+    return network < storage ? network : storage;
+  }
+  if (network > 0 || storage > 0) {
+    return network > 0 ? network : storage;
+  }
+  return DEFAULT_TRANSFER_BANDWIDTH;
+}
+
+/*
+ * Split the data into blocks spread evenly over the buffer and return their number.
+ * A block is contiguous and keeps the shape of the fastest dimensions that fit into it.
+ */
+static int sample_blocks(const scil_dims_t *dims, SCIL_Datatype_t datatype, scil_dims_t *out_dims, size_t *out_offsets) {
+  const size_t type_size = DATATYPE_LENGTH(datatype);
+  const size_t count = scil_dims_get_count(dims);
+  if (count * type_size <= SAMPLE_BLOCKS * SAMPLE_BLOCK_SIZE) {
+    scil_dims_copy(out_dims, dims);
+    out_offsets[0] = 0;
+    return 1;
+  }
+  int inner_dims = 0;
+  size_t inner = 1;
+  while (inner_dims < dims->dims - 1 && inner * dims->length[inner_dims] * type_size <= SAMPLE_BLOCK_SIZE) {
+    inner *= dims->length[inner_dims];
+    inner_dims++;
+  }
+  // the remaining dimensions are treated as one, the data holds more than SAMPLE_BLOCKS blocks of its rows
+  const size_t rows = count / inner;
+  const size_t block_rows = SAMPLE_BLOCK_SIZE / type_size / inner;
+
+  size_t length[SCIL_DIMS_MAX];
+  memcpy(length, dims->length, inner_dims * sizeof(size_t));
+  length[inner_dims] = block_rows;
+  scil_dims_initialize_array(out_dims, inner_dims + 1, length);
+  for (int i = 0; i < SAMPLE_BLOCKS; i++) {
+    out_offsets[i] = i * (rows - block_rows) / (SAMPLE_BLOCKS - 1) * inner;
+  }
+  return SAMPLE_BLOCKS;
+}
+
+// compress and decompress the sample blocks with the chain, lossy chains must meet the accuracy of the hints
+static int trial_chain(scil_context_t *ctx,
+                       const scil_compression_chain_t *chain,
+                       const byte *source,
+                       const scil_dims_t *block_dims,
+                       const size_t *offsets,
+                       int blocks,
+                       scilC_chooser_estimate_t *out) {
+  scil_context_t trial = *ctx;
+  scilC_context_set_chain(&trial, chain);
+  // the trials are accounted as time of the chooser
+  trial.statistics = NULL;
+
+  const size_t type_size = DATATYPE_LENGTH(ctx->datatype);
+  const size_t block_size = scil_dims_get_size(block_dims, ctx->datatype);
+  const size_t bound = scilU_chain_compress_bound(chain, ctx->datatype, block_dims);
+
+  const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+  byte *compressed = (byte *) scilU_workspace_alloc(ctx->workspace, bound);
+  byte *decompressed = (byte *) scilU_workspace_alloc(ctx->workspace, block_size);
+  byte *buff_tmp = (byte *) scilU_workspace_alloc(ctx->workspace, scilC_decompress_chain_tmp_size(block_size));
+
+  // the fastest block is used as estimate, an interrupted measurement would distort the decision otherwise
+  double compression_time = DBL_MAX;
+  double decompression_time = DBL_MAX;
+  size_t compressed_size = 0;
+  double busy_time = 0;
+  double joules = 0;
+  int ret = compressed == NULL || decompressed == NULL || buff_tmp == NULL ? SCIL_MEMORY_ERR : SCIL_NO_ERR;
+  for (int i = 0; i < blocks && ret == SCIL_NO_ERR; i++) {
+    byte *block = (byte *) source + offsets[i] * type_size;
+    scil_dims_t dims;
+    scil_dims_copy(&dims, block_dims);
+    scilC_context_set_input(&trial, block);
+
+    size_t size;
+    scil_timer timer;
+    scilU_energy_mark_t energy;
+    scilU_energy_start(&energy);
+    scilU_start_timer(&timer);
+    ret = scilC_compress_chain(compressed, bound, block, &dims, &size, &trial);
+    double t = scilU_stop_timer(timer);
+    joules += scilU_energy_stop(&energy);
+    busy_time += t;
+    compression_time = t < compression_time ? t : compression_time;
+    if (ret != SCIL_NO_ERR) {
+      break;
+    }
+    scilU_energy_start(&energy);
+    scilU_start_timer(&timer);
+    ret = scilC_decompress_chain(ctx->datatype, decompressed, &dims, compressed, size, buff_tmp);
+    t = scilU_stop_timer(timer);
+    joules += scilU_energy_stop(&energy);
+    busy_time += t;
+    decompression_time = t < decompression_time ? t : decompression_time;
+    if (ret != SCIL_NO_ERR) {
+      break;
+    }
+    if (chain->is_lossy) {
+      scil_user_hints_t accuracy;
+      scil_validate_params_t validation;
+      scil_determine_accuracy(ctx->datatype, decompressed, block, &dims, ctx->hints.relative_err_finest_abs_tolerance,
+                              &accuracy, &validation);
+      ret = scilC_check_accuracy(ctx->datatype, &ctx->hints, &accuracy);
+    }
+    compressed_size += size;
+  }
+  scilU_workspace_release(ctx->workspace, mark);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+
+  // the timer resolution limits the throughput of tiny samples
+  const double mib = (double) block_size / 1024.0 / 1024.0;
+  out->ratio = (double) compressed_size / (double) (block_size * blocks);
+  out->compression_speed = mib / (compression_time > 1e-9 ? compression_time : 1e-9);
+  out->decompression_speed = mib / (decompression_time > 1e-9 ? decompression_time : 1e-9);
+
+  const double bandwidth = transfer_bandwidth();
+  out->expected_time = 1.0 / out->compression_speed + 1.0 / out->decompression_speed + out->ratio / bandwidth;
+
+  // a meter updated less often than the trial takes cannot measure it, the model estimates the energy then
+  if (busy_time < 10 * scilU_energy_get_meter()->resolution) {
+    joules = scilU_energy_model(busy_time, 0);
+  }
+  out->energy = joules / (mib * blocks) + scilU_energy_model(0, out->ratio / bandwidth);
+  return SCIL_NO_ERR;
+}
+
+// the value the chooser minimizes
+static double objective_cost(const scil_context_t *ctx, const scilC_chooser_estimate_t *estimate) {
+  switch (ctx->hints.objective) {
+    case (SCIL_OBJECTIVE_RATIO):
+      return estimate->ratio;
+    case (SCIL_OBJECTIVE_ENERGY):
+      return estimate->energy;
+    default:
+      return estimate->expected_time;
+  }
+}
+
 void scilC_algo_chooser_execute(const void *restrict source,
                                 const scil_dims_t *dims,
                                 scil_context_t *ctx) {
   scil_compression_chain_t *chain = &ctx->chain;
   int ret;
 
-  // at the moment we only set the compression algorith once
+  // a chain is already selected, the decisions are cached by scil_compress(), see scil-decision-cache.h
   if (chain->total_size != 0) {
     return;
   }
@@ -349,25 +535,46 @@ void scilC_algo_chooser_execute(const void *restrict source,
     return;
   }
 
-  size_t out_size = 15000;
-  byte buffer[15000];
-  size_t in_size = 10000;
-  if (count < in_size) {
-    in_size = count;
-  }
-
-  float r = scilU_get_data_randomness(source, in_size, buffer, out_size);
-  if (ctx->lossless_compression_needed) {
-    // we can only select byte compressors compress because data must be accurate!
+  scil_compression_chain_t candidates[SCIL_CHOOSER_CANDIDATES_MAX];
+  const int candidate_count = scilC_algo_chooser_candidates(ctx, dims, candidates);
+
+  scil_dims_t block_dims;
+  size_t offsets[SAMPLE_BLOCKS];
+  const int blocks = sample_blocks(dims, ctx->datatype, &block_dims, offsets);
+
+  // minimize the objective, chains that are slower than the hints demand are only used if no chain is fast enough
+  const double c_speed = performance_hint_to_mib(ctx->hints.comp_speed);
+  const double d_speed = performance_hint_to_mib(ctx->hints.decomp_speed);
+  int best = -1;
+  int best_is_fast_enough = 0;
+  scilC_chooser_estimate_t best_estimate;
+  for (int i = 0; i < candidate_count; i++) {
+    scilC_chooser_estimate_t estimate;
+    ret = trial_chain(ctx, &candidates[i], source, &block_dims, offsets, blocks, &estimate);
+    if (ret != SCIL_NO_ERR) {
+      debug("Chooser: chain %d is not usable, error %d\n", i, ret);
+      continue;
+    }
+    const int fast_enough = estimate.compression_speed >= c_speed && estimate.decompression_speed >= d_speed;
+    debug("Chooser: chain %d ratio %.3f compression %.1f MiB/s decompression %.1f MiB/s expected %f s/MiB %f J/MiB\n",
+          i, estimate.ratio, estimate.compression_speed, estimate.decompression_speed, estimate.expected_time,
+          estimate.energy);
+    if (best == -1 || fast_enough > best_is_fast_enough ||
+        (fast_enough == best_is_fast_enough && objective_cost(ctx, &estimate) < objective_cost(ctx, &best_estimate))) {
+      best = i;
+      best_is_fast_enough = fast_enough;
+      best_estimate = estimate;
+    }
   }
-  // TODO: pick the best algorithm for the settings given in ctx...
 
-  if (r > 95) {
+  if (best == -1) {
     ret = scilU_chain_create(chain, "memcopy");
-  } else {
-    ret = scilU_chain_create(chain, "lz4");
+    assert(ret == SCIL_NO_ERR);
+    return;
   }
-  assert(ret == SCIL_NO_ERR);
+  *chain = candidates[best];
+  ctx->chooser_estimate = best_estimate;
+  ctx->chooser_estimate_valid = 1;
 }
 
 
@@ -17,6 +17,7 @@
 #define SCIL_ALGO_CHOOSER_H
 
 #include <scil-context.h>
+#include <scil-compression-chain.h>
 #include <scil-dims.h>
 #include <scil-dict.h>
 #include <scil-decision-tree.h>
@@ -30,4 +31,13 @@ void scilC_algo_chooser_execute(const void* restrict source,
                                 const scil_dims_t* dims,
                                 scil_context_t* ctx);
 
+// the maximum number of chains the chooser selects from
+#define SCIL_CHOOSER_CANDIDATES_MAX 16
+
+/*
+ * Store the chains that scilC_algo_chooser_execute() may select for the dims and the hints of the context,
+ * returns the number of chains. The first chain is memcopy unless a chain is forced by the environment.
+ */
+int scilC_algo_chooser_candidates(const scil_context_t* ctx, const scil_dims_t* dims, scil_compression_chain_t* out_chains);
+
 #endif // SCIL_ALGO_CHOOSER_H
@@ -0,0 +1,140 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * The asynchronous compression executes scil_compress() as a task of the thread pool of the library.
+ * A compression that splits its data into blocks joins the pool from the worker, hence the blocks
+ * of concurrent requests share the threads.
+ */
+
+#include <scil.h>
+#include <scil-thread-pool.h>
+#include <scil-debug.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct scil_request {
+    byte *dest;
+    size_t dest_size;
+    void *source;
+    scil_dims_t dims;
+    scil_context_t *ctx;
+    scil_compress_callback_t callback;
+    void *user_ptr;
+    // the request is freed after the callback, nobody waits for it
+    int detached;
+
+    int done;
+    int ret;
+    size_t out_size;
+};
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t finished = PTHREAD_COND_INITIALIZER;
+static int in_flight = 0;
+static int queue_depth = 0;
+
+static int get_queue_depth() {
+    if (queue_depth == 0) {
+        const char *env = getenv("SCIL_ASYNC_QUEUE_DEPTH");
+        queue_depth = env != NULL && atoi(env) > 0 ? atoi(env) : 2 * scilU_get_default_thread_count();
+        debug("Async queue depth: %d\n", queue_depth);
+    }
+    return queue_depth;
+}
+
+static void compress_task(void *user_ptr, size_t task, int slot) {
+    scil_request_t *request = (scil_request_t *) user_ptr;
+    request->ret = scil_compress(request->dest, request->dest_size, request->source, &request->dims,
+                                 &request->out_size, request->ctx);
+    if (request->callback != NULL) {
+        request->callback(request->user_ptr, request->ret, request->out_size);
+    }
+
+    const int detached = request->detached;
+    pthread_mutex_lock(&lock);
+    in_flight--;
+    request->done = 1;
+    pthread_cond_broadcast(&finished);
+    pthread_mutex_unlock(&lock);
+    if (detached) {
+        free(request);
+    }
+}
+
+int scil_compress_async(byte *dest,
+                        size_t dest_size,
+                        void *source,
+                        scil_dims_t *dims,
+                        scil_context_t *ctx,
+                        scil_compress_callback_t callback,
+                        void *user_ptr,
+                        scil_request_t **out_request) {
+    assert(ctx != NULL);
+    assert(dest != NULL);
+    assert(source != NULL);
+
+    scil_request_t *request = (scil_request_t *) scilU_safe_malloc(sizeof(scil_request_t));
+    memset(request, 0, sizeof(scil_request_t));
+    request->dest = dest;
+    request->dest_size = dest_size;
+    request->source = source;
+    scil_dims_copy(&request->dims, dims);
+    request->ctx = ctx;
+    request->callback = callback;
+    request->user_ptr = user_ptr;
+    request->detached = out_request == NULL;
+    if (out_request != NULL) {
+        *out_request = request;
+    }
+
+    // backpressure, the caller cannot queue more data than the threads process
+    pthread_mutex_lock(&lock);
+    const int depth = get_queue_depth();
+    while (in_flight >= depth) {
+        pthread_cond_wait(&finished, &lock);
+    }
+    in_flight++;
+    pthread_mutex_unlock(&lock);
+
+    scilU_thread_pool_submit(scilU_get_thread_pool(), compress_task, request);
+    return SCIL_NO_ERR;
+}
+
+int scil_wait(scil_request_t *request, size_t *out_size) {
+    pthread_mutex_lock(&lock);
+    while (!request->done) {
+        pthread_cond_wait(&finished, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+
+    const int ret = request->ret;
+    if (out_size != NULL) {
+        *out_size = request->out_size;
+    }
+    free(request);
+    return ret;
+}
+
+int scil_test(scil_request_t *request, int *out_done) {
+    pthread_mutex_lock(&lock);
+    *out_done = request->done;
+    pthread_mutex_unlock(&lock);
+    return SCIL_NO_ERR;
+}
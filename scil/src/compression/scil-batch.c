@@ -0,0 +1,169 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * The batch is executed as a single job of the thread pool, every item is a task.
+ * The pool hands out the next task to the thread that becomes idle, hence a thread that compresses
+ * a large variable does not delay the small ones. The tasks are ordered by size, largest first,
+ * so that no large variable is left for the end of the job.
+ *
+ * Items with the same datatype and hints pointer form a group. Every thread slot creates one context
+ * per group on first use and all contexts of a slot use the workspace of the slot.
+ */
+
+#include <scil.h>
+#include <scil-block.h>
+#include <scil-context-impl.h>
+#include <scil-thread-pool.h>
+#include <scil-debug.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    SCIL_Datatype_t datatype;
+    const scil_user_hints_t *hints;
+} group_t;
+
+typedef struct {
+    size_t size;
+    size_t item;
+} order_t;
+
+typedef struct {
+    scil_batch_item_t *items;
+    order_t *order;
+    size_t *item_group;
+    group_t *groups;
+    size_t group_count;
+    scil_user_hints_t default_hints;
+
+    // slots * group_count contexts, created by the slot on first use
+    scil_context_t **contexts;
+    scilU_workspace_t **workspaces;
+} batch_t;
+
+static int compare_size_descending(const void *a, const void *b) {
+    const order_t *x = (const order_t *) a;
+    const order_t *y = (const order_t *) b;
+    if (x->size != y->size) {
+        return x->size < y->size ? 1 : -1;
+    }
+    // keep the order of the items for equal sizes
+    return x->item < y->item ? -1 : (x->item > y->item);
+}
+
+static scil_context_t *get_context(batch_t *batch, size_t group, int slot, int *out_ret) {
+    scil_context_t **ctx = &batch->contexts[slot * batch->group_count + group];
+    *out_ret = SCIL_NO_ERR;
+    if (*ctx != NULL) {
+        return *ctx;
+    }
+    const group_t *g = &batch->groups[group];
+    const scil_user_hints_t *hints = g->hints != NULL ? g->hints : &batch->default_hints;
+    *out_ret = scil_context_create(ctx, g->datatype, 0, NULL, hints);
+    if (*out_ret != SCIL_NO_ERR) {
+        return NULL;
+    }
+    if (batch->workspaces[slot] == NULL) {
+        batch->workspaces[slot] = scilU_workspace_create();
+    }
+    scilU_workspace_destroy((*ctx)->workspace);
+    (*ctx)->workspace = batch->workspaces[slot];
+    return *ctx;
+}
+
+static void compress_item(void *user_ptr, size_t task, int slot) {
+    batch_t *batch = (batch_t *) user_ptr;
+    const size_t i = batch->order[task].item;
+    scil_batch_item_t *item = &batch->items[i];
+
+    item->out_size = 0;
+    scil_context_t *ctx = get_context(batch, batch->item_group[i], slot, &item->ret);
+    if (ctx == NULL) {
+        return;
+    }
+    item->ret = scilC_compress(item->dest, item->dest_size, item->source, &item->dims, &item->out_size, ctx, item->name);
+}
+
+int scil_compress_batch(scil_batch_item_t *items, size_t count) {
+    assert(items != NULL || count == 0);
+    if (count == 0) {
+        return SCIL_NO_ERR;
+    }
+
+    batch_t batch;
+    memset(&batch, 0, sizeof(batch_t));
+    batch.items = items;
+    scil_user_hints_initialize(&batch.default_hints);
+
+    batch.order = (order_t *) scilU_safe_malloc(count * sizeof(order_t));
+    batch.item_group = (size_t *) scilU_safe_malloc(count * sizeof(size_t));
+    batch.groups = (group_t *) scilU_safe_malloc(count * sizeof(group_t));
+    for (size_t i = 0; i < count; i++) {
+        assert(items[i].source != NULL && items[i].dest != NULL);
+        batch.order[i].size = scil_dims_get_size(&items[i].dims, items[i].datatype);
+        batch.order[i].item = i;
+
+        size_t g;
+        for (g = 0; g < batch.group_count; g++) {
+            if (batch.groups[g].datatype == items[i].datatype && batch.groups[g].hints == items[i].hints) {
+                break;
+            }
+        }
+        if (g == batch.group_count) {
+            batch.groups[g].datatype = items[i].datatype;
+            batch.groups[g].hints = items[i].hints;
+            batch.group_count++;
+        }
+        batch.item_group[i] = g;
+    }
+    qsort(batch.order, count, sizeof(order_t), compare_size_descending);
+
+    scilU_thread_pool_t *pool = scilU_get_thread_pool();
+    const int slots = count < (size_t) scilU_thread_pool_size(pool) ? (int) count : scilU_thread_pool_size(pool);
+    batch.contexts = (scil_context_t **) scilU_safe_malloc(slots * batch.group_count * sizeof(scil_context_t *));
+    memset(batch.contexts, 0, slots * batch.group_count * sizeof(scil_context_t *));
+    batch.workspaces = (scilU_workspace_t **) scilU_safe_malloc(slots * sizeof(scilU_workspace_t *));
+    memset(batch.workspaces, 0, slots * sizeof(scilU_workspace_t *));
+    debug("Batch of %zu items in %zu groups with %d threads\n", count, batch.group_count, slots);
+
+    scilU_thread_pool_run(pool, count, slots, compress_item, &batch);
+
+    for (size_t c = 0; c < slots * batch.group_count; c++) {
+        if (batch.contexts[c] != NULL) {
+            // the workspace belongs to the slot
+            batch.contexts[c]->workspace = NULL;
+            scil_destroy_context(batch.contexts[c]);
+        }
+    }
+    for (int s = 0; s < slots; s++) {
+        scilU_workspace_destroy(batch.workspaces[s]);
+    }
+    free(batch.contexts);
+    free(batch.workspaces);
+    free(batch.groups);
+    free(batch.item_group);
+    free(batch.order);
+
+    for (size_t i = 0; i < count; i++) {
+        if (items[i].ret != SCIL_NO_ERR) {
+            return items[i].ret;
+        }
+    }
+    return SCIL_NO_ERR;
+}
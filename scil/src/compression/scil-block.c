@@ -0,0 +1,548 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-block.h>
+#include <scil-stream.h>
+#include <scil-error.h>
+#include <scil-debug.h>
+#include <scil-dict.h>
+#include <scil-util.h>
+#include <scil-thread-pool.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define BLOCK_HEADER_SIZE(block_count) (1 + 2 * sizeof(uint64_t) + (block_count) * sizeof(uint64_t))
+
+size_t scilC_block_count(const scil_dims_t *dims, SCIL_Datatype_t datatype, size_t block_size, size_t *out_rows_per_block) {
+    if (block_size == 0) {
+        block_size = SCIL_BLOCK_DEFAULT_SIZE;
+    }
+    if (dims->dims == 0) {
+        return 0;
+    }
+    const size_t rows = dims->length[dims->dims - 1];
+    const size_t size = scil_dims_get_size(dims, datatype);
+    if (rows == 0 || size == 0) {
+        return 0;
+    }
+    const size_t row_size = size / rows;
+    size_t rows_per_block = block_size / row_size;
+    if (rows_per_block == 0) {
+        rows_per_block = 1;
+    }
+    if (out_rows_per_block != NULL) {
+        *out_rows_per_block = rows_per_block;
+    }
+    return (rows + rows_per_block - 1) / rows_per_block;
+}
+
+int scilC_is_block_container(const byte *source, size_t source_size) {
+    return source_size >= BLOCK_HEADER_SIZE(0) && source[0] == SCIL_BLOCK_CONTAINER_MAGIC;
+}
+
+// the dims of the block with the given number
+static void block_dims(scil_dims_t *out, const scil_dims_t *dims, size_t rows_per_block, size_t block) {
+    const size_t remaining = dims->length[dims->dims - 1] - block * rows_per_block;
+    scil_dims_copy(out, dims);
+    out->length[dims->dims - 1] = remaining < rows_per_block ? remaining : rows_per_block;
+}
+
+size_t scilC_block_compress_bound(const scil_dims_t *dims, const scil_context_t *ctx) {
+    size_t rows_per_block;
+    const size_t block_count = scilC_block_count(dims, ctx->datatype, ctx->hints.parallel_block_size, &rows_per_block);
+    if (block_count == 0) {
+        return BLOCK_HEADER_SIZE(0);
+    }
+    scil_dims_t first, last;
+    block_dims(&first, dims, rows_per_block, 0);
+    block_dims(&last, dims, rows_per_block, block_count - 1);
+
+    return BLOCK_HEADER_SIZE(block_count) +
+           (block_count - 1) * scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &first) +
+           scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &last);
+}
+
+static int pick_thread_count(size_t block_count) {
+    int threads = scilU_thread_pool_size(scilU_get_thread_pool());
+    if ((size_t) threads > block_count) {
+        threads = (int) block_count;
+    }
+    return threads;
+}
+
+typedef struct {
+    scil_context_t *ctx;
+    byte *source;
+    const scil_dims_t *dims;
+    size_t rows_per_block;
+    size_t row_size;
+
+    // each block is compressed into dest at a provisional offset, the container is compacted afterwards
+    byte *dest;
+    size_t block_bound;
+    size_t last_block_bound;
+    size_t block_count;
+
+    size_t *sizes;
+    int *rets;
+} block_compress_job_t;
+
+static void compress_block(void *user_ptr, size_t block, int slot) {
+    block_compress_job_t *job = (block_compress_job_t *) user_ptr;
+
+    scil_dims_t dims;
+    block_dims(&dims, job->dims, job->rows_per_block, block);
+
+    // algorithms may store intermediate parameters in the context, hence each thread slot needs its own
+    scil_context_t ctx = *job->ctx;
+    ctx.workspace = job->ctx->block_workspaces[slot];
+    ctx.pipeline_params = job->ctx->block_pipeline_params[slot];
+    if (ctx.statistics != NULL) {
+        ctx.statistics = &job->ctx->block_statistics[slot];
+    }
+    // the blocks already occupy the threads
+    ctx.hints.parallel_threads = 1;
+
+    byte *src = job->source + block * job->rows_per_block * job->row_size;
+    scilC_context_set_input(&ctx, src);
+    byte *dst = job->dest + block * job->block_bound;
+    const size_t dst_size = block == job->block_count - 1 ? job->last_block_bound : job->block_bound;
+    job->rets[block] = scilC_compress_chain(dst, dst_size, src, &dims, &job->sizes[block], &ctx);
+}
+
+// make sure the context holds the per slot state for the given number of threads, it is kept between calls
+static int prepare_slots(scil_context_t *ctx, int threads) {
+    if (threads <= ctx->block_slot_count) {
+        return SCIL_NO_ERR;
+    }
+    // the arrays that could be grown are kept, they are freed with the slots
+    scilU_workspace_t **workspaces = (scilU_workspace_t **) realloc(ctx->block_workspaces, threads * sizeof(scilU_workspace_t *));
+    if (workspaces != NULL) {
+        ctx->block_workspaces = workspaces;
+    }
+    scilU_dict_t **params = (scilU_dict_t **) realloc(ctx->block_pipeline_params, threads * sizeof(scilU_dict_t *));
+    if (params != NULL) {
+        ctx->block_pipeline_params = params;
+    }
+    scil_statistics_t *statistics = (scil_statistics_t *) realloc(ctx->block_statistics, threads * sizeof(scil_statistics_t));
+    if (statistics != NULL) {
+        ctx->block_statistics = statistics;
+    }
+    if (workspaces == NULL || params == NULL || statistics == NULL) {
+        return SCIL_MEMORY_ERR;
+    }
+    for (int i = ctx->block_slot_count; i < threads; i++) {
+        ctx->block_workspaces[i] = scilU_workspace_create();
+        ctx->block_pipeline_params[i] = scilU_dict_create(30);
+        memset(&ctx->block_statistics[i], 0, sizeof(scil_statistics_t));
+    }
+    ctx->block_slot_count = threads;
+    return SCIL_NO_ERR;
+}
+
+void scilC_block_destroy_slots(scil_context_t *ctx) {
+    for (int i = 0; i < ctx->block_slot_count; i++) {
+        scilU_workspace_destroy(ctx->block_workspaces[i]);
+        scilU_dict_destroy(ctx->block_pipeline_params[i]);
+    }
+    free(ctx->block_workspaces);
+    free(ctx->block_pipeline_params);
+    free(ctx->block_statistics);
+    ctx->block_workspaces = NULL;
+    ctx->block_pipeline_params = NULL;
+    ctx->block_statistics = NULL;
+    ctx->block_slot_count = 0;
+}
+
+int scilC_block_compress(byte *restrict dest,
+                         size_t dest_size,
+                         void *restrict source,
+                         scil_dims_t *dims,
+                         size_t *restrict out_size,
+                         scil_context_t *ctx) {
+    size_t rows_per_block;
+    const size_t block_count = scilC_block_count(dims, ctx->datatype, ctx->hints.parallel_block_size, &rows_per_block);
+    const size_t header_size = BLOCK_HEADER_SIZE(block_count);
+    if (dest_size < header_size) {
+        return SCIL_BUFFER_ERR;
+    }
+
+    scilU_thread_pool_t *pool = scilU_get_thread_pool();
+    int threads = pick_thread_count(block_count);
+    if (threads > ctx->hints.parallel_threads) {
+        threads = ctx->hints.parallel_threads > 1 ? ctx->hints.parallel_threads : 1;
+    }
+
+    scil_dims_t first, last;
+    block_dims(&first, dims, rows_per_block, 0);
+    block_dims(&last, dims, rows_per_block, block_count - 1);
+
+    block_compress_job_t job;
+    job.ctx = ctx;
+    job.source = (byte *) source;
+    job.dims = dims;
+    job.rows_per_block = rows_per_block;
+    job.row_size = scil_dims_get_size(dims, ctx->datatype) / dims->length[dims->dims - 1];
+    job.dest = dest + header_size;
+    job.block_bound = scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &first);
+    job.last_block_bound = scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &last);
+    job.block_count = block_count;
+
+    // the provisional layout requires the worst case size, see scilC_block_compress_bound()
+    if (dest_size - header_size < (block_count - 1) * job.block_bound + job.last_block_bound) {
+        return SCIL_MEMORY_ERR;
+    }
+
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    job.sizes = (size_t *) scilU_workspace_alloc(ctx->workspace, block_count * sizeof(size_t));
+    job.rets = (int *) scilU_workspace_alloc(ctx->workspace, block_count * sizeof(int));
+    if (job.sizes == NULL || job.rets == NULL || prepare_slots(ctx, threads) != SCIL_NO_ERR) {
+        scilU_workspace_release(ctx->workspace, mark);
+        return SCIL_MEMORY_ERR;
+    }
+
+    scilU_thread_pool_run(pool, block_count, threads, compress_block, &job);
+    if (ctx->statistics != NULL) {
+        for (int i = 0; i < threads; i++) {
+            scilC_statistics_add(ctx->statistics, &ctx->block_statistics[i]);
+            memset(&ctx->block_statistics[i], 0, sizeof(scil_statistics_t));
+        }
+    }
+
+    // assemble the container, the blocks move only towards the front
+    int ret = SCIL_NO_ERR;
+    dest[0] = SCIL_BLOCK_CONTAINER_MAGIC;
+    uint64_t value = rows_per_block;
+    memcpy(dest + 1, &value, sizeof(uint64_t));
+    value = block_count;
+    memcpy(dest + 1 + sizeof(uint64_t), &value, sizeof(uint64_t));
+
+    byte *offsets = dest + 1 + 2 * sizeof(uint64_t);
+    size_t pos = header_size;
+    for (size_t i = 0; i < block_count; i++) {
+        if (job.rets[i] != SCIL_NO_ERR) {
+            ret = job.rets[i];
+            goto end;
+        }
+        memmove(dest + pos, job.dest + i * job.block_bound, job.sizes[i]);
+        pos += job.sizes[i];
+        value = pos - header_size;
+        memcpy(offsets + i * sizeof(uint64_t), &value, sizeof(uint64_t));
+    }
+    *out_size = pos;
+    debug("Compressed %zu blocks with %d threads\n", block_count, threads);
+
+    end:
+    scilU_workspace_release(ctx->workspace, mark);
+    return ret;
+}
+
+// the parsed header of a block container
+typedef struct {
+    uint64_t rows_per_block;
+    uint64_t block_count;
+    const byte *offsets;
+    byte *blocks;
+} block_container_t;
+
+static int read_container(block_container_t *c, SCIL_Datatype_t datatype, const scil_dims_t *dims,
+                          byte *source, size_t source_size) {
+    memcpy(&c->rows_per_block, source + 1, sizeof(uint64_t));
+    memcpy(&c->block_count, source + 1 + sizeof(uint64_t), sizeof(uint64_t));
+
+    const size_t header_size = BLOCK_HEADER_SIZE(c->block_count);
+    if (c->rows_per_block == 0 || c->block_count == 0 || header_size > source_size) {
+        return SCIL_BUFFER_ERR;
+    }
+    // the blocks must match the dims provided by the caller
+    if (dims->dims == 0 || scil_dims_get_size(dims, datatype) == 0 ||
+        (dims->length[dims->dims - 1] + c->rows_per_block - 1) / c->rows_per_block != c->block_count) {
+        return SCIL_BUFFER_ERR;
+    }
+    c->offsets = source + 1 + 2 * sizeof(uint64_t);
+    c->blocks = source + header_size;
+
+    // every block must end at or after the previous one and within the source
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < c->block_count; i++) {
+        uint64_t end;
+        memcpy(&end, c->offsets + i * sizeof(uint64_t), sizeof(uint64_t));
+        if (end < previous || end > source_size - header_size) {
+            return SCIL_BUFFER_ERR;
+        }
+        previous = end;
+    }
+    return SCIL_NO_ERR;
+}
+
+static int decompress_container_block(const block_container_t *c,
+                                      SCIL_Datatype_t datatype,
+                                      void *dest,
+                                      const scil_dims_t *dims,
+                                      size_t block,
+                                      byte *tmp) {
+    uint64_t start = 0;
+    uint64_t end;
+    if (block > 0) {
+        memcpy(&start, c->offsets + (block - 1) * sizeof(uint64_t), sizeof(uint64_t));
+    }
+    memcpy(&end, c->offsets + block * sizeof(uint64_t), sizeof(uint64_t));
+
+    scil_dims_t bdims;
+    block_dims(&bdims, dims, c->rows_per_block, block);
+    return scilC_decompress_chain(datatype, dest, &bdims, c->blocks + start, end - start, tmp);
+}
+
+typedef struct {
+    SCIL_Datatype_t datatype;
+    byte *dest;
+    const scil_dims_t *dims;
+    size_t row_size;
+    block_container_t container;
+
+    size_t scratch_size;
+
+    int *rets;
+} block_decompress_job_t;
+
+static void decompress_block(void *user_ptr, size_t block, int slot) {
+    block_decompress_job_t *job = (block_decompress_job_t *) user_ptr;
+
+    // the decompression has no context, the scratch memory is taken from the arena of the thread
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte *tmp = (byte *) scilU_workspace_alloc(ws, job->scratch_size);
+    if (tmp == NULL) {
+        job->rets[block] = SCIL_MEMORY_ERR;
+        return;
+    }
+
+    byte *dst = job->dest + block * job->container.rows_per_block * job->row_size;
+    job->rets[block] = decompress_container_block(&job->container, job->datatype, dst, job->dims, block, tmp);
+    scilU_workspace_release(ws, mark);
+}
+
+int scilC_block_decompress(SCIL_Datatype_t datatype,
+                           void *restrict dest,
+                           scil_dims_t *dims,
+                           byte *restrict source,
+                           const size_t source_size) {
+    block_decompress_job_t job;
+    int ret = read_container(&job.container, datatype, dims, source, source_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    const size_t block_count = job.container.block_count;
+
+    job.datatype = datatype;
+    job.dest = (byte *) dest;
+    job.dims = dims;
+    job.row_size = scil_dims_get_size(dims, datatype) / dims->length[dims->dims - 1];
+
+    const int threads = pick_thread_count(block_count);
+
+    scil_dims_t first;
+    block_dims(&first, dims, job.container.rows_per_block, 0);
+    job.scratch_size = scilC_decompress_chain_tmp_size(scil_dims_get_size(&first, datatype));
+
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    job.rets = (int *) scilU_workspace_alloc(ws, block_count * sizeof(int));
+    if (job.rets == NULL) {
+        scilU_workspace_release(ws, mark);
+        return SCIL_MEMORY_ERR;
+    }
+
+    scilU_thread_pool_run(scilU_get_thread_pool(), block_count, threads, decompress_block, &job);
+
+    for (size_t i = 0; i < block_count; i++) {
+        if (job.rets[i] != SCIL_NO_ERR) {
+            ret = job.rets[i];
+            break;
+        }
+    }
+
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+
+typedef struct {
+    SCIL_Datatype_t datatype;
+    size_t elem_size;
+    byte *dest;
+
+    const scil_dims_t *full_dims;
+    const scil_dims_t *offset;
+    const scil_dims_t *count;
+
+    // the container uses the dims with at most 4 dimensions
+    const scil_dims_t *resized_dims;
+    block_container_t container;
+    size_t first_block;
+    size_t block_elements;
+
+    size_t block_size;
+    size_t scratch_size;
+
+    int *rets;
+} region_job_t;
+
+/*
+ * Copy the part of the region that is contained in data into the region buffer.
+ * data holds the elements [data_start, data_end) of the full array, the region is copied row by row
+ * along the fastest varying dimension, a row may be split between blocks for 1D data.
+ */
+static void copy_region(const region_job_t *job, const byte *data, size_t data_start, size_t data_end) {
+    const scil_dims_t *count = job->count;
+    const int dims = count->dims;
+    const size_t run = count->length[0];
+
+    scil_dims_t pos;
+    scil_dims_copy(&pos, job->offset);
+
+    // iterate over all rows of the region, their position in the full array increases monotonically
+    size_t out_row = 0;
+    while (1) {
+        const size_t index = scilU_data_pos(&pos, job->full_dims);
+        if (index >= data_end) {
+            return;
+        }
+        const size_t first = index > data_start ? index : data_start;
+        const size_t last = index + run < data_end ? index + run : data_end;
+        if (first < last) {
+            memcpy(job->dest + (out_row * run + first - index) * job->elem_size,
+                   data + (first - data_start) * job->elem_size,
+                   (last - first) * job->elem_size);
+        }
+        out_row++;
+
+        int d = 1;
+        for (; d < dims; d++) {
+            pos.length[d]++;
+            if (pos.length[d] < job->offset->length[d] + count->length[d]) {
+                break;
+            }
+            pos.length[d] = job->offset->length[d];
+        }
+        if (d >= dims) {
+            return;
+        }
+    }
+}
+
+static void decompress_region_block(void *user_ptr, size_t task, int slot) {
+    region_job_t *job = (region_job_t *) user_ptr;
+    const size_t block = job->first_block + task;
+
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte *data = (byte *) scilU_workspace_alloc(ws, job->scratch_size);
+    if (data == NULL) {
+        job->rets[task] = SCIL_MEMORY_ERR;
+        return;
+    }
+
+    job->rets[task] = decompress_container_block(&job->container, job->datatype, data, job->resized_dims, block,
+                                                 data + job->block_size);
+    if (job->rets[task] == SCIL_NO_ERR) {
+        const size_t start = block * job->block_elements;
+        copy_region(job, data, start, start + job->block_elements);
+    }
+    scilU_workspace_release(ws, mark);
+}
+
+int scilC_decompress_region(SCIL_Datatype_t datatype,
+                            void *restrict dest,
+                            const scil_dims_t *full_dims,
+                            scil_dims_t *resized_dims,
+                            const scil_dims_t *offset,
+                            const scil_dims_t *count,
+                            byte *restrict source,
+                            const size_t source_size) {
+    region_job_t job;
+    job.datatype = datatype;
+    job.elem_size = DATATYPE_LENGTH(datatype);
+    job.dest = (byte *) dest;
+    job.full_dims = full_dims;
+    job.offset = offset;
+    job.count = count;
+    job.resized_dims = resized_dims;
+
+    int ret;
+    if (!scilC_is_block_container(source, source_size)) {
+        // no index available, decompress everything and extract the region
+        const size_t size = scil_dims_get_size(resized_dims, datatype);
+        scilU_workspace_t *ws = scilU_get_thread_workspace();
+        const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+        byte *data = (byte *) scilU_workspace_alloc(ws, size + scilC_decompress_chain_tmp_size(size));
+        if (data == NULL) {
+            ret = SCIL_MEMORY_ERR;
+        } else if (scilC_is_stream_container(source, source_size)) {
+            ret = scilC_stream_decompress(datatype, data, resized_dims, source, source_size);
+        } else {
+            ret = scilC_decompress_chain(datatype, data, resized_dims, source, source_size, data + size);
+        }
+        if (ret == SCIL_NO_ERR) {
+            copy_region(&job, data, 0, scil_dims_get_count(resized_dims));
+        }
+        scilU_workspace_release(ws, mark);
+        return ret;
+    }
+
+    ret = read_container(&job.container, datatype, resized_dims, source, source_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    // determine the blocks overlapping the first and last element of the region
+    job.block_elements = job.container.rows_per_block *
+                         (scil_dims_get_count(resized_dims) / resized_dims->length[resized_dims->dims - 1]);
+    scil_dims_t last;
+    scil_dims_copy(&last, offset);
+    for (int i = 0; i < last.dims; i++) {
+        last.length[i] += count->length[i] - 1;
+    }
+    job.first_block = scilU_data_pos(offset, full_dims) / job.block_elements;
+    const size_t blocks = scilU_data_pos(&last, full_dims) / job.block_elements - job.first_block + 1;
+    debug("Region overlaps %zu of %llu blocks\n", blocks, (long long unsigned) job.container.block_count);
+
+    const int threads = pick_thread_count(blocks);
+
+    scil_dims_t first;
+    block_dims(&first, resized_dims, job.container.rows_per_block, 0);
+    job.block_size = scil_dims_get_size(&first, datatype);
+    job.scratch_size = job.block_size + scilC_decompress_chain_tmp_size(job.block_size);
+
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    job.rets = (int *) scilU_workspace_alloc(ws, blocks * sizeof(int));
+    if (job.rets == NULL) {
+        scilU_workspace_release(ws, mark);
+        return SCIL_MEMORY_ERR;
+    }
+
+    scilU_thread_pool_run(scilU_get_thread_pool(), blocks, threads, decompress_region_block, &job);
+
+    for (size_t i = 0; i < blocks; i++) {
+        if (job.rets[i] != SCIL_NO_ERR) {
+            ret = job.rets[i];
+            break;
+        }
+    }
+
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
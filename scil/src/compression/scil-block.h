@@ -0,0 +1,121 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_BLOCK_H
+#define SCIL_BLOCK_H
+
+/**
+ * \file
+ * \brief Block container, the data is split along the slowest varying dimension
+ * into blocks that are compressed independently, possibly in parallel.
+ *
+ * The container is formatted as follows:
+ * byte SCIL_BLOCK_CONTAINER_MAGIC // distinguishes the container from a chain length
+ * uint64_t rows_per_block // number of elements of the last dimension in a block
+ * uint64_t block_count
+ * uint64_t block_end[block_count] // end offset of each block relative to the first block
+ * byte * blocks // each block is the output of a regular compression chain
+ */
+
+#include <scil-context-impl.h>
+#include <scil-dims.h>
+
+#define SCIL_BLOCK_CONTAINER_MAGIC 255
+
+// the default size of a block in bytes
+#define SCIL_BLOCK_DEFAULT_SIZE (8 * 1024 * 1024)
+
+/**
+ * \brief Compute the number of blocks for the data, the partitioning depends only on the dims and block size.
+ * \param block_size the target size of a block in bytes, 0 uses SCIL_BLOCK_DEFAULT_SIZE
+ * \param out_rows_per_block if not NULL, it is set to the number of rows of the slowest dimension per block
+ */
+size_t scilC_block_count(const scil_dims_t *dims, SCIL_Datatype_t datatype, size_t block_size, size_t *out_rows_per_block);
+
+int scilC_is_block_container(const byte *source, size_t source_size);
+
+/**
+ * \brief The worst case size of the container for the data using the chain of the context.
+ */
+size_t scilC_block_compress_bound(const scil_dims_t *dims, const scil_context_t *ctx);
+
+int scilC_block_compress(byte *restrict dest,
+                         size_t dest_size,
+                         void *restrict source,
+                         scil_dims_t *dims,
+                         size_t *restrict out_size,
+                         scil_context_t *ctx);
+
+/**
+ * \brief Free the per thread slot state the block compression keeps in the context.
+ */
+void scilC_block_destroy_slots(scil_context_t *ctx);
+
+int scilC_block_decompress(SCIL_Datatype_t datatype,
+                           void *restrict dest,
+                           scil_dims_t *dims,
+                           byte *restrict source,
+                           const size_t source_size);
+
+/**
+ * \brief Decompress the region [offset, offset + count) of the data into dest.
+ * If the data is a block container, only the blocks overlapping the region are decompressed.
+ * \param full_dims the dims of the complete data
+ * \param resized_dims the full dims folded into at most 4 dimensions
+ */
+int scilC_decompress_region(SCIL_Datatype_t datatype,
+                            void *restrict dest,
+                            const scil_dims_t *full_dims,
+                            scil_dims_t *resized_dims,
+                            const scil_dims_t *offset,
+                            const scil_dims_t *count,
+                            byte *restrict source,
+                            const size_t source_size);
+
+// Fold more than four dimensions into the fourth dimension as the algorithms support up to 4D, implemented in scil.c
+void scilC_resize_dims(scil_dims_t *resized_dims, const scil_dims_t *dims);
+
+// scil_compress() of the variable with the given name, the name identifies the decisions of the chooser, may be NULL
+int scilC_compress(byte *restrict dest,
+                   size_t dest_size,
+                   void *restrict source,
+                   scil_dims_t *dims,
+                   size_t *restrict out_size,
+                   scil_context_t *ctx,
+                   const char *name);
+
+// The execution of a single compression chain, implemented in scil.c, dims must have at most 4 dimensions
+
+int scilC_compress_chain(byte *restrict dest,
+                         size_t dest_size,
+                         void *restrict source,
+                         scil_dims_t *dims,
+                         size_t *restrict out_size,
+                         scil_context_t *ctx);
+
+int scilC_decompress_chain(SCIL_Datatype_t datatype,
+                           void *restrict dest,
+                           scil_dims_t *dims,
+                           byte *restrict source,
+                           const size_t source_size,
+                           byte *restrict buff_tmp);
+
+// the size of buff_tmp needed by scilC_decompress_chain() for data of the given size
+size_t scilC_decompress_chain_tmp_size(size_t uncompressed_size);
+
+// returns SCIL_PRECISION_ERR if the accuracy achieved does not meet the required hints, see scil_determine_accuracy()
+int scilC_check_accuracy(SCIL_Datatype_t datatype, const scil_user_hints_t *required, const scil_user_hints_t *achieved);
+
+#endif // SCIL_BLOCK_H
@@ -1,6 +1,7 @@
 #include <scil-compression-chain.h>
 
 #include <scil-compressor.h>
+#include <scil-dispatch.h>
 #include <scil-error.h>
 #include <scil-debug.h>
 
@@ -13,6 +14,7 @@ int scilU_chain_create(scil_compression_chain_t* chain, const char* str_in)
     strncpy(str, str_in, 4096);
     token = strtok_r(str, ",", &saveptr);
 
+    memset(chain, 0, sizeof(scil_compression_chain_t));
     int stage                   = 0; // first pre-conditioner
     chain->precond_first_count  = 0;
     chain->precond_second_count = 0;
@@ -81,85 +83,76 @@ int scilU_chain_create(scil_compression_chain_t* chain, const char* str_in)
     return SCIL_NO_ERR;
 }
 
-int scilU_chain_is_applicable(const scil_compression_chain_t* chain, SCIL_Datatype_t datatype){
-  // TODO complete me
-  if(chain->data_compressor){
-    scilU_algorithm_t* algo = chain->data_compressor;
-    switch (datatype) {
-      case (SCIL_TYPE_FLOAT):
-        if ( ! algo->c.DNtype.compress_float ){
-          return SCIL_EINVAL;
-        }
-        break;
-      case (SCIL_TYPE_DOUBLE):
-        if ( ! algo->c.DNtype.compress_double ){
-          return SCIL_EINVAL;
-        }
-        break;
-      case (SCIL_TYPE_INT8) :
-        if ( ! algo->c.DNtype.compress_int8 ){
-          return SCIL_EINVAL;
-        }
-        break;
-      case(SCIL_TYPE_INT16) :
-        if ( ! algo->c.DNtype.compress_int16){
-          return SCIL_EINVAL;
-        }
-        break;
-      case(SCIL_TYPE_INT32) :
-        if ( ! algo->c.DNtype.compress_int32 ){
-          return SCIL_EINVAL;
-        }
-        break;
-      case(SCIL_TYPE_INT64) :
-        if ( ! algo->c.DNtype.compress_int64 ){
-          return SCIL_EINVAL;
+int scilU_chain_get_ids(const scil_compression_chain_t* chain, uint8_t* out_ids){
+    int count = 0;
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        out_ids[count++] = chain->pre_cond_first[i]->compressor_id;
+    }
+    if (chain->converter) {
+        out_ids[count++] = chain->converter->compressor_id;
+    }
+    for (int i = 0; i < chain->precond_second_count; i++) {
+        out_ids[count++] = chain->pre_cond_second[i]->compressor_id;
+    }
+    if (chain->data_compressor) {
+        out_ids[count++] = chain->data_compressor->compressor_id;
+    }
+    if (chain->byte_compressor) {
+        out_ids[count++] = chain->byte_compressor->compressor_id;
+    }
+    return count;
+}
+
+// keep track of the largest intermediate result
+#define UPDATE_PEAK(size) if ((size) > peak) { peak = (size); }
+
+size_t scilU_chain_compress_bound(const scil_compression_chain_t* chain, SCIL_Datatype_t datatype, const scil_dims_t* dims){
+    const size_t count = scil_dims_get_count(dims);
+    const size_t data_size = scil_dims_get_size(dims, datatype);
+    // size covers the data, the headers that are carried along and the compressor IDs, as arranged by the chain
+    size_t size = data_size;
+    size_t peak = size;
+
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        size += scilU_algorithm_compress_bound(chain->pre_cond_first[i], datatype, count, data_size) - data_size + 1;
+        UPDATE_PEAK(size)
+    }
+    if (chain->converter) {
+        size = scilU_algorithm_compress_bound(chain->converter, datatype, count, data_size) + (size - data_size) + 1;
+        UPDATE_PEAK(size)
+    }
+    if (chain->precond_second_count > 0) {
+        const size_t int_size = count * sizeof(int64_t);
+        size += data_size;
+        for (int i = 0; i < chain->precond_second_count; i++) {
+            size += scilU_algorithm_compress_bound(chain->pre_cond_second[i], SCIL_TYPE_INT64, count, int_size) - int_size + 1;
+            UPDATE_PEAK(size)
         }
-        break;
-      case(SCIL_TYPE_UNKNOWN) :
-      case(SCIL_TYPE_BINARY) :
-      case(SCIL_TYPE_STRING) :
-        return SCIL_EINVAL;
-      }
-  }else if (chain->converter){
-    // elementary datatype must be supported.
-    scilU_algorithm_t* algo = chain->converter;
-    switch (datatype) {
-    case (SCIL_TYPE_FLOAT):
-      if ( ! algo->c.Ctype.compress_float ){
-        return SCIL_EINVAL;
-      }
-      break;
-    case (SCIL_TYPE_DOUBLE):
-      if ( ! algo->c.Ctype.compress_double ){
-        return SCIL_EINVAL;
-      }
-      break;
-    case (SCIL_TYPE_INT8) :
-      if ( ! algo->c.Ctype.compress_int8 ){
-        return SCIL_EINVAL;
-      }
-      break;
-    case(SCIL_TYPE_INT16) :
-      if ( ! algo->c.Ctype.compress_int16){
-        return SCIL_EINVAL;
-      }
-      break;
-    case(SCIL_TYPE_INT32) :
-      if ( ! algo->c.Ctype.compress_int32 ){
-        return SCIL_EINVAL;
-      }
-      break;
-    case(SCIL_TYPE_INT64) :
-      if ( ! algo->c.Ctype.compress_int64 ){
-        return SCIL_EINVAL;
-      }
-      break;
-    case(SCIL_TYPE_UNKNOWN) :
-    case(SCIL_TYPE_BINARY) :
-    case(SCIL_TYPE_STRING) :
+    }
+    if (chain->data_compressor) {
+        size = scilU_algorithm_compress_bound(chain->data_compressor, datatype, count, data_size) + (size - data_size) + 1;
+        UPDATE_PEAK(size)
+    }
+    if (chain->byte_compressor) {
+        size = scilU_algorithm_compress_bound(chain->byte_compressor, datatype, size, size) + 1;
+        UPDATE_PEAK(size)
+    }
+    // the length of the chain
+    return peak + 1;
+}
+
+int scilU_chain_is_applicable(const scil_compression_chain_t* chain, SCIL_Datatype_t datatype){
+  // every stage that depends on the datatype must support it, see scilC_plan_create()
+  for(int i=0; i < chain->precond_first_count; i++){
+    if ( ! scilC_precond_first_compress_func(chain->pre_cond_first[i], datatype) ){
       return SCIL_EINVAL;
     }
   }
+  if (chain->converter && ! scilC_converter_compress_func(chain->converter, datatype)){
+    return SCIL_EINVAL;
+  }
+  if (chain->data_compressor && ! scilC_data_compress_func(chain->data_compressor, datatype)){
+    return SCIL_EINVAL;
+  }
   return SCIL_NO_ERR;
 }
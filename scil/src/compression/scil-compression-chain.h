@@ -29,6 +29,18 @@ typedef struct scil_compression_chain {
 
 int scilU_chain_create(scil_compression_chain_t* chain, const char* str_in);
 
+/*
+ * Store the compressor IDs of the chain in the order of application, returns the number of IDs.
+ * out_ids must hold at least 2 * PRECONDITIONER_LIMIT + 3 entries.
+ */
+int scilU_chain_get_ids(const scil_compression_chain_t* chain, uint8_t* out_ids);
+
+/*
+ * The worst case size of the output of scilC_compress_chain() for data of the given dims, it is also the
+ * largest intermediate result of the chain.
+ */
+size_t scilU_chain_compress_bound(const scil_compression_chain_t* chain, SCIL_Datatype_t datatype, const scil_dims_t* dims);
+
 int scilU_chain_is_applicable(const scil_compression_chain_t* chain, SCIL_Datatype_t datatype);
 
 #endif // SCIL_CCA_H
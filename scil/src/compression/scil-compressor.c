@@ -21,6 +21,10 @@
 #include <algo/precond-delta.h>
 #include <algo/precond-fp-delta.h>
 #include <algo/blosc.h>
+#include <algo/algo-rans.h>
+#include <algo/precond-lorenzo.h>
+#include <algo/algo-predquant.h>
+#include <algo/algo-huffman.h>
 
 #include <scil-debug.h>
 
@@ -49,6 +53,10 @@ static scilU_algorithm_t* algo_array[] = {
   	& algo_zstd11,
   	& algo_zstd22,
   	& algo_blosc,
+  	& algo_rans, // 20
+  	& algo_precond_lorenzo, // 21
+  	& algo_predquant, // 22
+  	& algo_huffman, // 23
 	NULL
 };
 
@@ -72,6 +80,14 @@ scilU_algorithm_t* scil_get_compressor(int number){
 	return algo_array[number];
 }
 
+size_t scilU_algorithm_compress_bound(const scilU_algorithm_t* algo, SCIL_Datatype_t datatype, size_t count, size_t in_size)
+{
+	if (algo->compress_bound != NULL){
+		return algo->compress_bound(datatype, count, in_size);
+	}
+	return 2 * in_size + SCIL_ALGO_HEADER_MAX_SIZE;
+}
+
 
 int scilU_get_available_compressor_count()
 {
@@ -12,8 +12,13 @@ enum compressor_type{
 };
 
 /*
- An algorithm implementation can be sure that the compression output buffer is at least 2x the size of the input data.
+ An algorithm implementation can be sure that the compression output buffer is at least as large as its compress_bound,
+ or 2x the size of the input data plus SCIL_ALGO_HEADER_MAX_SIZE if it does not provide compress_bound.
  */
+
+// the space an algorithm without compress_bound may use for its header
+#define SCIL_ALGO_HEADER_MAX_SIZE 64
+
 typedef struct scil_compression_algorithm {
   union{
     struct{
@@ -104,11 +109,21 @@ typedef struct scil_compression_algorithm {
 
   enum compressor_type type;
   char is_lossy; // byte compressors are expected to be lossless anyway
+
+  // the worst case output size of the compression of count elements with in_size bytes, including the header of the algorithm.
+  // For a preconditioner, the output size is the size of the data plus the header.
+  // count is only meaningful for datatype algorithms, NULL means 2 * in_size + SCIL_ALGO_HEADER_MAX_SIZE.
+  size_t (*compress_bound)(SCIL_Datatype_t datatype, size_t count, size_t in_size);
 } scilU_algorithm_t;
 
 void scil_initialize_compressors();
 
 scilU_algorithm_t* scil_get_compressor(int number);
+
+/*
+ \brief Returns the worst case output size of the algorithm, see compress_bound.
+ */
+size_t scilU_algorithm_compress_bound(const scilU_algorithm_t* algo, SCIL_Datatype_t datatype, size_t count, size_t in_size);
 scilU_algorithm_t* scilU_find_compressor_by_name(const char* name);
 
 /*
@@ -3,6 +3,33 @@
 
 #include <scil-context.h>
 #include <scil-compression-chain.h>
+#include <scil-dispatch.h>
+#include <scil-workspace.h>
+#include <scil-data-characteristics.h>
+
+/** \brief The minimum and maximum of the input data, several algorithms and the chooser need them */
+typedef struct {
+  size_t count;
+  int valid;
+  double ignore_up_to;
+  double ignore_from;
+  double fill_value;
+  byte minimum[8];
+  byte maximum[8];
+} scilC_minmax_cache_t;
+
+/** \brief What the chooser expects from the chain it selected, as measured on samples of the data */
+typedef struct {
+  /** \brief The compressed size divided by the original size */
+  double ratio;
+  /** \brief In MiB/s of uncompressed data */
+  double compression_speed;
+  double decompression_speed;
+  /** \brief Seconds to compress, transfer and decompress one MiB */
+  double expected_time;
+  /** \brief Joules to compress, transfer and decompress one MiB */
+  double energy;
+} scilC_chooser_estimate_t;
 
 struct scil_context {
   int lossless_compression_needed;
@@ -15,9 +42,63 @@ struct scil_context {
 
   /** \brief The last compressor used, could be used for debugging */
   scil_compression_chain_t chain;
+  /** \brief The functions of the chain resolved for the datatype, see scilC_context_set_chain() */
+  scilC_plan_t plan;
+
+  /** \brief Set when the chooser selected the chain, the decision is kept for the following calls */
+  int chooser_estimate_valid;
+  scilC_chooser_estimate_t chooser_estimate;
 
   /** \brief Dictionary for pipeline internal parameters */
   scilU_dict_t *pipeline_params;
+
+  /** \brief Scratch memory for the compression, it is kept between calls */
+  scilU_workspace_t *workspace;
+
+  /** \brief The workspace and pipeline parameters of each thread slot that compresses blocks */
+  int block_slot_count;
+  scilU_workspace_t **block_workspaces;
+  scilU_dict_t **block_pipeline_params;
+  scil_statistics_t *block_statistics;
+
+  /** \brief The counters of the stages, NULL if the statistics are disabled */
+  scil_statistics_t *statistics;
+  /** \brief Kept while the statistics are disabled */
+  scil_statistics_t *statistics_buffer;
+
+  /** \brief The buffer that is currently compressed, the results below are cached for it */
+  const void *input;
+  scilC_minmax_cache_t minmax_cache;
+  int characteristics_valid;
+  scil_data_characteristics_t characteristics;
 };
 
+/**
+ * \brief Invalidates the results cached for the input, from now on they are cached for the given buffer.
+ * \param input The buffer to compress, may be NULL to disable the caches
+ */
+void scilC_context_set_input(scil_context_t *ctx, const void *input);
+
+/** \brief Set the chain of the context and resolve its plan */
+void scilC_context_set_chain(scil_context_t *ctx, const scil_compression_chain_t *chain);
+
+/** \brief Takes the start time of a stage, a disabled statistics costs just the test of the pointer */
+static inline void scilC_stage_start(const scil_context_t *ctx, scil_timer *start) {
+  if (ctx->statistics != NULL) {
+    scilU_start_timer(start);
+  }
+}
+
+void scilC_stage_add(scil_statistics_t *statistics, enum scil_stage stage, scil_timer start, size_t bytes_in, size_t bytes_out);
+
+/** \brief Adds one execution of the stage to the statistics if they are enabled */
+static inline void scilC_stage_stop(const scil_context_t *ctx, enum scil_stage stage, scil_timer start, size_t bytes_in, size_t bytes_out) {
+  if (ctx->statistics != NULL) {
+    scilC_stage_add(ctx->statistics, stage, start, bytes_in, bytes_out);
+  }
+}
+
+/** \brief Adds the counters of other to statistics, e.g., the ones of the threads compressing blocks */
+void scilC_statistics_add(scil_statistics_t *statistics, const scil_statistics_t *other);
+
 #endif // SCIL_CONTEXT_H
@@ -2,6 +2,8 @@
 
 #include <scil-compressor.h>
 #include <scil-algo-chooser.h>
+#include <scil-decision-cache.h>
+#include <scil-block.h>
 #include <scil-compression-chain.h>
 #include <scil-hardware-limits.h>
 #include <scil-debug.h>
@@ -12,6 +14,8 @@
 #include <stdio.h>
 #include <string.h>
 
+const char *scil_stage_names[] = {"preconditioner", "converter", "data_compressor", "byte_compressor", "chooser", NULL};
+
 static int initialized = 0;
 
 static void initialize() {
@@ -22,6 +26,7 @@ static void initialize() {
 
   scilU_initialize_hardware_limits();
   scilC_algo_chooser_initialize();
+  scilC_decision_cache_initialize();
   initialized = 1;
 }
 
@@ -66,6 +71,7 @@ int scil_context_create(scil_context_t **out_ctx,
   memset(ctx, 0, sizeof(scil_context_t));
 
   ctx->pipeline_params = scilU_dict_create(30);
+  ctx->workspace = scilU_workspace_create();
 
   ctx->datatype = datatype;
   ctx->special_values_count = special_values_count;
@@ -136,6 +142,7 @@ int scil_context_create(scil_context_t **out_ctx,
       ret = scilU_chain_is_applicable(&ctx->chain, datatype);
       if (ret == SCIL_NO_ERR) {
         oh->force_compression_methods = strdup(oh->force_compression_methods);
+        scilC_plan_create(&ctx->plan, &ctx->chain, datatype);
       }
     }
   }
@@ -143,14 +150,31 @@ int scil_context_create(scil_context_t **out_ctx,
   if (ret == SCIL_NO_ERR) {
     *out_ctx = ctx;
   } else {
+    scilU_workspace_destroy(ctx->workspace);
+    scilU_dict_destroy(ctx->pipeline_params);
     free(ctx);
   }
 
   return ret;
 }
 
+void scilC_context_set_chain(scil_context_t *ctx, const scil_compression_chain_t *chain) {
+  ctx->chain = *chain;
+  scilC_plan_create(&ctx->plan, chain, ctx->datatype);
+}
+
+void scilC_context_set_input(scil_context_t *ctx, const void *input) {
+  ctx->input = input;
+  ctx->minmax_cache.valid = 0;
+  ctx->characteristics_valid = 0;
+}
+
 int scil_destroy_context(scil_context_t *out_ctx) {
+  scilC_block_destroy_slots(out_ctx);
+  scilU_workspace_destroy(out_ctx->workspace);
+  scilU_dict_destroy(out_ctx->pipeline_params);
   free(out_ctx->hints.force_compression_methods);
+  free(out_ctx->statistics_buffer);
   free(out_ctx);
   out_ctx = NULL;
 
@@ -160,3 +184,46 @@ int scil_destroy_context(scil_context_t *out_ctx) {
 scil_user_hints_t scil_get_effective_hints(const scil_context_t *ctx) {
   return ctx->hints;
 }
+
+void scil_context_enable_statistics(scil_context_t *ctx, int enable) {
+  if (enable && ctx->statistics_buffer == NULL) {
+    ctx->statistics_buffer = (scil_statistics_t *) scilU_safe_malloc(sizeof(scil_statistics_t));
+    memset(ctx->statistics_buffer, 0, sizeof(scil_statistics_t));
+  }
+  ctx->statistics = enable ? ctx->statistics_buffer : NULL;
+}
+
+int scil_context_get_statistics(const scil_context_t *ctx, scil_statistics_t *out) {
+  if (ctx->statistics_buffer == NULL) {
+    memset(out, 0, sizeof(scil_statistics_t));
+    return SCIL_EINVAL;
+  }
+  *out = *ctx->statistics_buffer;
+  return SCIL_NO_ERR;
+}
+
+void scil_context_reset_statistics(scil_context_t *ctx) {
+  if (ctx->statistics_buffer != NULL) {
+    memset(ctx->statistics_buffer, 0, sizeof(scil_statistics_t));
+  }
+}
+
+void scilC_stage_add(scil_statistics_t *statistics, enum scil_stage stage, scil_timer start, size_t bytes_in, size_t bytes_out) {
+  scil_timer end;
+  scilU_start_timer(&end);
+  const scil_timer diff = scilU_time_diff(end, start);
+  scil_stage_statistics_t *s = &statistics->stage[stage];
+  s->calls++;
+  s->ns += (uint64_t) diff.tv_sec * 1000000000ull + (uint64_t) diff.tv_nsec;
+  s->bytes_in += bytes_in;
+  s->bytes_out += bytes_out;
+}
+
+void scilC_statistics_add(scil_statistics_t *statistics, const scil_statistics_t *other) {
+  for (int i = 0; i < SCIL_STAGE_LAST; i++) {
+    statistics->stage[i].calls += other->stage[i].calls;
+    statistics->stage[i].ns += other->stage[i].ns;
+    statistics->stage[i].bytes_in += other->stage[i].bytes_in;
+    statistics->stage[i].bytes_out += other->stage[i].bytes_out;
+  }
+}
@@ -28,4 +28,44 @@ int scil_destroy_context(scil_context_t *out_ctx);
 
 scil_user_hints_t scil_get_effective_hints(const scil_context_t *ctx);
 
+/** \brief The stages of a compression chain, the time of the automatic chain selection is accounted as chooser */
+enum scil_stage {
+  SCIL_STAGE_PRECONDITIONER = 0,
+  SCIL_STAGE_CONVERTER,
+  SCIL_STAGE_DATA_COMPRESSOR,
+  SCIL_STAGE_BYTE_COMPRESSOR,
+  SCIL_STAGE_CHOOSER,
+  SCIL_STAGE_LAST
+};
+
+extern const char *scil_stage_names[];
+
+typedef struct {
+  /** \brief The number of times the stage was executed, each preconditioner of a chain counts */
+  uint64_t calls;
+  /** \brief The cumulative wall clock time in ns, for blocks compressed in parallel the time of all threads */
+  uint64_t ns;
+  /** \brief The bytes the stage consumed and produced, the chooser does not produce any */
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+} scil_stage_statistics_t;
+
+typedef struct {
+  scil_stage_statistics_t stage[SCIL_STAGE_LAST];
+} scil_statistics_t;
+
+/**
+ * \brief Accounts the time and data of each stage of the compressions with the context, it is off by default.
+ * Disabling keeps the counters, enabling it again continues them.
+ */
+void scil_context_enable_statistics(scil_context_t *ctx, int enable);
+
+/**
+ * \brief Copies the counters accumulated since the statistics were enabled or reset.
+ * \return SCIL_EINVAL if the statistics were never enabled, out is zeroed then
+ */
+int scil_context_get_statistics(const scil_context_t *ctx, scil_statistics_t *out);
+
+void scil_context_reset_statistics(scil_context_t *ctx);
+
 #endif // SCIL_CONTEXT_H
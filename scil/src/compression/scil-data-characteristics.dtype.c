@@ -0,0 +1,331 @@
+#include <scil-data-characteristics.h>
+#include <scil-context-impl.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+// this is an exception to the rule that there shall not be any dependency
+#include <compression/algo/lz4fast.h>
+
+// the values are processed in tiles that stay in the cache while all statistics are gathered
+#define TILE_COUNT 1024
+// the byte histogram is the most expensive part, it considers every n-th tile only
+#define HISTOGRAM_TILE_STRIDE 16
+
+#define LANES 8
+
+#define IS_FLOAT_float 1
+#define IS_FLOAT_double 1
+#define IS_FLOAT_int8_t 0
+#define IS_FLOAT_int16_t 0
+#define IS_FLOAT_int32_t 0
+#define IS_FLOAT_int64_t 0
+
+typedef struct {
+  size_t valid_count;
+  double mean;
+  double m2;
+  double gradient_sum;
+  size_t gradient_count;
+  double gradient_maximum;
+  size_t histogram[256];
+} accumulator_t;
+
+// merges the mean and the sum of squared deviations of a tile, see Chan et al.
+static void merge_moments(accumulator_t* acc, size_t n, double mean, double m2){
+  if (n == 0){
+    return;
+  }
+  const size_t total = acc->valid_count + n;
+  const double delta = mean - acc->mean;
+  acc->mean += delta * n / total;
+  acc->m2 += m2 + delta * delta * acc->valid_count * n / total;
+  acc->valid_count = total;
+}
+
+static void finish(accumulator_t* acc, scil_data_characteristics_t* out, double minimum, double maximum, double closest_to_zero_positive, double closest_to_zero_negative){
+  out->mean = acc->valid_count > 0 ? acc->mean : 0;
+  out->variance = acc->valid_count > 0 ? acc->m2 / acc->valid_count : 0;
+  out->gradient_mean = acc->gradient_count > 0 ? acc->gradient_sum / acc->gradient_count : 0;
+  out->gradient_maximum = acc->gradient_maximum;
+
+  if (acc->valid_count > 0){
+    out->minimum = minimum;
+    out->maximum = maximum;
+    const double largest = fabs(minimum) > fabs(maximum) ? fabs(minimum) : fabs(maximum);
+    const double smallest = closest_to_zero_positive < -closest_to_zero_negative ? closest_to_zero_positive : -closest_to_zero_negative;
+    if (largest > 0){
+      out->exponent_minimum = isinf(smallest) ? DBL_MAX_EXP : ilogb(smallest);
+      out->exponent_maximum = isinf(largest) ? DBL_MAX_EXP : ilogb(largest);
+    }
+  }
+
+  size_t bytes = 0;
+  for(int i = 0; i < 256; ++i){
+    bytes += acc->histogram[i];
+  }
+  double entropy = 0;
+  for(int i = 0; i < 256; ++i){
+    if (acc->histogram[i] > 0){
+      const double p = (double) acc->histogram[i] / bytes;
+      entropy -= p * log2(p);
+    }
+  }
+  out->byte_entropy = entropy;
+}
+
+//Supported datatypes: int8_t int16_t int32_t int64_t float double
+// Repeat for each data type
+
+static inline int is_nan_<DATATYPE>(<DATATYPE> v){
+  return IS_FLOAT_<DATATYPE> && isnan((double) v);
+}
+
+/*
+ * Excluded values become 0 with a weight of 0, all statistics are then computed with vectorisable loops.
+ * The conditions are doubles as well, mixing them with integers prevents the vectorisation.
+ * Without a fill value the fill_value is NaN which matches no value.
+ */
+static inline void weigh_<DATATYPE>(<DATATYPE> v, double fill_value, double* x, double* w, double* nans){
+  const double d = (double) v;
+  const double keep = is_nan_<DATATYPE>(v) ? 0.0 : 1.0;
+  const double weight = fabs(d - fill_value) < (double) FLT_EPSILON ? 0.0 : keep;
+  *x = weight > 0 ? d : 0.0;
+  *w = weight;
+  *nans += 1.0 - keep;
+}
+
+SCILU_VECTOR_CLONES
+static void characteristics_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, size_t row_length, double fill_value, size_t max_samples,
+    scil_data_characteristics_t* out, <DATATYPE>* typed_minimum, <DATATYPE>* typed_maximum){
+  const double fill = fill_value < DBL_MAX ? fill_value : (double) NAN;
+  const size_t tiles = (count + TILE_COUNT - 1) / TILE_COUNT;
+  size_t tile_stride = 1;
+  if (max_samples > 0 && max_samples < count){
+    const size_t sampled_tiles = (max_samples + TILE_COUNT - 1) / TILE_COUNT;
+    tile_stride = tiles / sampled_tiles;
+  }
+
+  accumulator_t acc;
+  memset(&acc, 0, sizeof(acc));
+  <DATATYPE> min = INFINITY_<DATATYPE>;
+  <DATATYPE> max = NINFINITY_<DATATYPE>;
+  double closest_positive = INFINITY;
+  double closest_negative = -INFINITY;
+  size_t nans = 0;
+  size_t negatives = 0;
+  size_t processed = 0;
+
+  // the first element holds the value preceding the tile
+  double x[TILE_COUNT + 1];
+  double w[TILE_COUNT + 1];
+  // the weight of the gradient between a value and its predecessor
+  double pw[TILE_COUNT + 1];
+
+  for(size_t t = 0; t < tiles; t += tile_stride){
+    const size_t start = t * TILE_COUNT;
+    const size_t n = count - start < TILE_COUNT ? count - start : TILE_COUNT;
+    const <DATATYPE>* tile = buffer + start;
+    processed += n;
+
+    <DATATYPE> tile_min, tile_max;
+    scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(tile, n, & tile_min, & tile_max, -DBL_MAX, DBL_MAX, fill_value);
+    min = tile_min < min ? tile_min : min;
+    max = tile_max > max ? tile_max : max;
+
+    double nan[LANES] = {0};
+    if (start > 0){
+      double ignored = 0;
+      weigh_<DATATYPE>(tile[-1], fill, & x[0], & w[0], & ignored);
+    }else{
+      x[0] = 0;
+      w[0] = 0;
+    }
+    size_t i = 0;
+    for(; i + LANES <= n; i += LANES){
+      for(int k = 0; k < LANES; ++k){
+        weigh_<DATATYPE>(tile[i + k], fill, & x[i + k + 1], & w[i + k + 1], & nan[k]);
+      }
+    }
+    for(; i < n; ++i){
+      weigh_<DATATYPE>(tile[i], fill, & x[i + 1], & w[i + 1], & nan[0]);
+    }
+    for(int k = 0; k < LANES; ++k){
+      nans += (size_t) nan[k];
+    }
+
+    // the sums use one accumulator per lane, the partial tile is padded with excluded values
+    const size_t padded = (n + LANES - 1) / LANES * LANES;
+    for(i = n + 1; i <= padded; ++i){
+      x[i] = 0;
+      w[i] = 0;
+    }
+    for(i = 1; i <= padded; ++i){
+      pw[i] = w[i] * w[i - 1];
+    }
+    // the gradient follows the fastest dimension, the first value of a row has no predecessor
+    for(size_t row_start = (start + row_length - 1) / row_length * row_length; row_start < start + n; row_start += row_length){
+      pw[row_start - start + 1] = 0;
+    }
+    double sum[LANES] = {0}, valid[LANES] = {0}, negative[LANES] = {0};
+    double positive_min[LANES], negative_max[LANES];
+    double gradient_sum[LANES] = {0}, gradient_max[LANES] = {0}, gradient_count[LANES] = {0};
+    for(int k = 0; k < LANES; ++k){
+      positive_min[k] = INFINITY;
+      negative_max[k] = -INFINITY;
+    }
+    for(i = 1; i <= padded; i += LANES){
+      for(int k = 0; k < LANES; ++k){
+        const double v = x[i + k];
+        const double pair = pw[i + k];
+        const double g = fabs(v - x[i + k - 1]) * pair;
+        sum[k] += v;
+        valid[k] += w[i + k];
+        negative[k] += v < 0 ? 1.0 : 0.0;
+        positive_min[k] = v > 0 && v < positive_min[k] ? v : positive_min[k];
+        negative_max[k] = v < 0 && v > negative_max[k] ? v : negative_max[k];
+        gradient_sum[k] += g;
+        gradient_max[k] = g > gradient_max[k] ? g : gradient_max[k];
+        gradient_count[k] += pair;
+      }
+    }
+    double tile_sum = 0, tile_valid = 0;
+    for(int k = 0; k < LANES; ++k){
+      tile_sum += sum[k];
+      tile_valid += valid[k];
+      negatives += (size_t) negative[k];
+      closest_positive = positive_min[k] < closest_positive ? positive_min[k] : closest_positive;
+      closest_negative = negative_max[k] > closest_negative ? negative_max[k] : closest_negative;
+      acc.gradient_sum += gradient_sum[k];
+      acc.gradient_maximum = gradient_max[k] > acc.gradient_maximum ? gradient_max[k] : acc.gradient_maximum;
+      acc.gradient_count += (size_t) gradient_count[k];
+    }
+
+    // the squared deviations from the mean of the tile
+    const double tile_mean = tile_valid > 0 ? tile_sum / tile_valid : 0;
+    double m2[LANES] = {0};
+    for(i = 1; i <= padded; i += LANES){
+      for(int k = 0; k < LANES; ++k){
+        const double d = (x[i + k] - tile_mean) * w[i + k];
+        m2[k] += d * d;
+      }
+    }
+    double tile_m2 = 0;
+    for(int k = 0; k < LANES; ++k){
+      tile_m2 += m2[k];
+    }
+    merge_moments(&acc, (size_t) tile_valid, tile_mean, tile_m2);
+    out->fill_count += n - (size_t) tile_valid;
+
+    if ((t / tile_stride) % HISTOGRAM_TILE_STRIDE == 0){
+      const byte* bytes = (const byte*) tile;
+      for(size_t i = 0; i < n * sizeof(<DATATYPE>); ++i){
+        acc.histogram[bytes[i]]++;
+      }
+    }
+  }
+
+  out->fill_count -= nans;
+  out->nan_count = nans;
+  out->negative_count = negatives;
+  out->count = count;
+  out->processed_count = processed;
+  finish(&acc, out, (double) min, (double) max, closest_positive, closest_negative);
+
+  *typed_minimum = min;
+  *typed_maximum = max;
+}
+
+// End repeat
+
+static int compute(SCIL_Datatype_t datatype, const void* source, const scil_dims_t* dims, double fill_value, size_t max_samples, scil_data_characteristics_t* out, byte* minimum, byte* maximum){
+  memset(out, 0, sizeof(scil_data_characteristics_t));
+  const size_t count = scil_dims_get_count(dims);
+  const size_t row_length = dims->length[0];
+  switch(datatype){
+    case(SCIL_TYPE_FLOAT):
+      characteristics_float((const float*) source, count, row_length, fill_value, max_samples, out, (float*) minimum, (float*) maximum);
+      break;
+    case(SCIL_TYPE_DOUBLE):
+      characteristics_double((const double*) source, count, row_length, fill_value, max_samples, out, (double*) minimum, (double*) maximum);
+      break;
+    case(SCIL_TYPE_INT8):
+    // other data is considered as bytes
+    case(SCIL_TYPE_BINARY):
+    case(SCIL_TYPE_STRING):
+      characteristics_int8_t((const int8_t*) source, count, row_length, fill_value, max_samples, out, (int8_t*) minimum, (int8_t*) maximum);
+      break;
+    case(SCIL_TYPE_INT16):
+      characteristics_int16_t((const int16_t*) source, count, row_length, fill_value, max_samples, out, (int16_t*) minimum, (int16_t*) maximum);
+      break;
+    case(SCIL_TYPE_INT32):
+      characteristics_int32_t((const int32_t*) source, count, row_length, fill_value, max_samples, out, (int32_t*) minimum, (int32_t*) maximum);
+      break;
+    case(SCIL_TYPE_INT64):
+      characteristics_int64_t((const int64_t*) source, count, row_length, fill_value, max_samples, out, (int64_t*) minimum, (int64_t*) maximum);
+      break;
+    default:
+      return SCIL_EINVAL;
+  }
+  return SCIL_NO_ERR;
+}
+
+int scil_compute_data_characteristics(SCIL_Datatype_t datatype, const void* source, const scil_dims_t* dims, double fill_value, size_t max_samples, scil_data_characteristics_t* out){
+  assert(source != NULL);
+  assert(dims != NULL);
+  assert(out != NULL);
+
+  byte minimum[8];
+  byte maximum[8];
+  return compute(datatype, source, dims, fill_value, max_samples, out, minimum, maximum);
+}
+
+const scil_data_characteristics_t* scilC_get_data_characteristics(const scil_context_t* const_ctx, const void* source, const scil_dims_t* dims){
+  assert(const_ctx != NULL);
+
+  // the caches are no part of the configuration, they may change with a const context
+  scil_context_t* ctx = (scil_context_t*) const_ctx;
+  if (ctx->characteristics_valid && source == ctx->input){
+    return & ctx->characteristics;
+  }
+
+  const size_t count = scil_dims_get_count(dims);
+  byte minimum[8];
+  byte maximum[8];
+  int ret = compute(ctx->datatype, source, dims, ctx->hints.fill_value, 0, & ctx->characteristics, minimum, maximum);
+  assert(ret == SCIL_NO_ERR);
+  if (source != ctx->input){
+    ctx->characteristics_valid = 0;
+    return & ctx->characteristics;
+  }
+  ctx->characteristics_valid = 1;
+
+  // the extrema without a lossless range are exactly those the algorithms determine
+  scilC_minmax_cache_t* cache = & ctx->minmax_cache;
+  if (! cache->valid){
+    cache->count = count;
+    cache->ignore_up_to = -DBL_MAX;
+    cache->ignore_from = DBL_MAX;
+    cache->fill_value = ctx->hints.fill_value;
+    memcpy(cache->minimum, minimum, sizeof(minimum));
+    memcpy(cache->maximum, maximum, sizeof(maximum));
+    cache->valid = 1;
+  }
+  return & ctx->characteristics;
+}
+
+float scilU_get_data_randomness(const void* source, size_t in_size, byte* restrict buffer, size_t buffer_size)
+{
+    // We may want to use https://en.wikipedia.org/wiki/Randomness_tests
+    int ret = scil_lz4fast_compress(NULL, buffer, &buffer_size, source, in_size);
+    if (ret == 0){
+        double rnd = buffer_size * 100.0 / in_size;
+        return rnd;
+    }else{
+        critical("lz4fast error to determine randomness: %d\n", ret);
+    }
+}
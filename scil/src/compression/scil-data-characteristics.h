@@ -2,9 +2,62 @@
 #define SCIL_DATA_CHARACTERISTICS_H
 
 #include <scil-datatypes.h>
+#include <scil-dims.h>
+#include <scil-context.h>
 
 #include <stdlib.h>
 
+/**
+ * \brief Statistics of a buffer that guide the choice and configuration of the compression.
+ * NaN and fill values are excluded from all statistics but their counts.
+ */
+typedef struct {
+  /** \brief The number of values in the buffer and how many of them were inspected */
+  size_t count;
+  size_t processed_count;
+
+  size_t fill_count;
+  size_t nan_count;
+  size_t negative_count;
+
+  double minimum;
+  double maximum;
+
+  /** \brief The range of the binary exponents of the non-zero values, see ilogb() */
+  int exponent_minimum;
+  int exponent_maximum;
+
+  double mean;
+  double variance;
+
+  /** \brief The absolute difference of neighbouring values in the fastest dimension */
+  double gradient_mean;
+  double gradient_maximum;
+
+  /** \brief An estimate of the Shannon entropy of the bytes in bits per byte, 8 for random data */
+  double byte_entropy;
+} scil_data_characteristics_t;
+
+/**
+ * \brief Determines the characteristics of the data in a single pass.
+ * \param fill_value The value to exclude, DBL_MAX if there is none
+ * \param max_samples If larger than 0 and the number of values, only the given number
+ *        of values spread over the buffer in contiguous tiles is processed
+ * \return SCIL error code
+ */
+int scil_compute_data_characteristics(SCIL_Datatype_t datatype,
+                                      const void* source,
+                                      const scil_dims_t* dims,
+                                      double fill_value,
+                                      size_t max_samples,
+                                      scil_data_characteristics_t* out);
+
+/**
+ * \brief Returns the characteristics of the buffer to compress with the fill value of the hints.
+ * They are determined once per call of scil_compress() and shared by the chooser and the algorithms.
+ */
+const scil_data_characteristics_t* scilC_get_data_characteristics(const scil_context_t* ctx, const void* source, const scil_dims_t* dims);
+
 float scilU_get_data_randomness(const void* source, size_t in_size, byte* restrict buffer, size_t buffer_size);
 
 #endif // SCIL_DATA_CHARACTERISTICS_H
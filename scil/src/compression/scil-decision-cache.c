@@ -0,0 +1,229 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-decision-cache.h>
+#include <scil-debug.h>
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUCKETS 64
+
+typedef struct decision_entry {
+  struct decision_entry *next;
+  char *name;
+  double values[SCILC_DECISION_KEY_VALUES];
+  uint64_t hash;
+
+  scilC_decision_t decision;
+  int valid;
+  size_t uses;
+  /** \brief The value of use_clock when the entry was used last, the least recently used entry is evicted */
+  uint64_t last_use;
+  /** \brief The ratio of the first compression with the decision */
+  int reference_known;
+  double reference_ratio;
+} decision_entry_t;
+
+static decision_entry_t *buckets[BUCKETS];
+static size_t entry_count = 0;
+static uint64_t use_clock = 0;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static scilC_decision_policy_t policy = {
+  .revalidate_interval = 100,
+  .ratio_drift = 0.5
+};
+
+void scilC_decision_cache_initialize() {
+  const char *interval = getenv("SCIL_DECISION_REVALIDATE_INTERVAL");
+  const char *drift = getenv("SCIL_DECISION_RATIO_DRIFT");
+  pthread_mutex_lock(&lock);
+  if (interval != NULL) {
+    policy.revalidate_interval = (size_t) atoll(interval);
+  }
+  if (drift != NULL) {
+    policy.ratio_drift = atof(drift);
+  }
+  pthread_mutex_unlock(&lock);
+  debug("Decision cache revalidates after %zu compressions or a ratio drift of %f\n",
+        policy.revalidate_interval, policy.ratio_drift);
+}
+
+void scilC_decision_cache_set_policy(const scilC_decision_policy_t *new_policy) {
+  pthread_mutex_lock(&lock);
+  policy = *new_policy;
+  pthread_mutex_unlock(&lock);
+}
+
+void scilC_decision_cache_get_policy(scilC_decision_policy_t *out_policy) {
+  pthread_mutex_lock(&lock);
+  *out_policy = policy;
+  pthread_mutex_unlock(&lock);
+}
+
+void scilC_decision_cache_clear() {
+  pthread_mutex_lock(&lock);
+  for (int i = 0; i < BUCKETS; i++) {
+    decision_entry_t *e = buckets[i];
+    while (e != NULL) {
+      decision_entry_t *next = e->next;
+      free(e->name);
+      free(e);
+      e = next;
+    }
+    buckets[i] = NULL;
+  }
+  entry_count = 0;
+  pthread_mutex_unlock(&lock);
+}
+
+size_t scilC_decision_cache_size() {
+  pthread_mutex_lock(&lock);
+  const size_t count = entry_count;
+  pthread_mutex_unlock(&lock);
+  return count;
+}
+
+// FNV-1a
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+  const byte *bytes = (const byte *) data;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+void scilC_decision_key_init(scilC_decision_key_t *key, const scil_context_t *ctx, const char *name, const scil_dims_t *dims) {
+  const scil_user_hints_t *h = &ctx->hints;
+  memset(key, 0, sizeof(scilC_decision_key_t));
+  key->name = name != NULL ? name : "";
+
+  double *v = key->values;
+  *v++ = ctx->datatype;
+  *v++ = dims->dims;
+  for (int i = 0; i < SCIL_DIMS_MAX; i++) {
+    *v++ = i < dims->dims ? (double) dims->length[i] : 0;
+  }
+  *v++ = h->relative_tolerance_percent;
+  *v++ = h->relative_err_finest_abs_tolerance;
+  *v++ = h->absolute_tolerance;
+  *v++ = h->significant_digits;
+  *v++ = h->significant_bits;
+  *v++ = h->lossless_data_range_up_to;
+  *v++ = h->lossless_data_range_from;
+  *v++ = h->fill_value;
+  *v++ = h->field_max_steepness;
+  *v++ = h->comp_speed.unit;
+  *v++ = (double) h->comp_speed.multiplier;
+  *v++ = h->decomp_speed.unit;
+  *v++ = (double) h->decomp_speed.multiplier;
+  *v++ = h->objective;
+  *v++ = ctx->lossless_compression_needed;
+  assert(v == key->values + SCILC_DECISION_KEY_VALUES);
+
+  uint64_t hash = 14695981039346656037ull;
+  hash = hash_bytes(hash, key->name, strlen(key->name));
+  key->hash = hash_bytes(hash, key->values, sizeof(key->values));
+}
+
+// must be called with the lock held
+static decision_entry_t *find(const scilC_decision_key_t *key) {
+  for (decision_entry_t *e = buckets[key->hash % BUCKETS]; e != NULL; e = e->next) {
+    if (e->hash == key->hash && memcmp(e->values, key->values, sizeof(key->values)) == 0 &&
+        strcmp(e->name, key->name) == 0) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+// must be called with the lock held
+static void evict_least_recently_used() {
+  decision_entry_t **oldest = NULL;
+  for (int i = 0; i < BUCKETS; i++) {
+    for (decision_entry_t **link = &buckets[i]; *link != NULL; link = &(*link)->next) {
+      if (oldest == NULL || (*link)->last_use < (*oldest)->last_use) {
+        oldest = link;
+      }
+    }
+  }
+  if (oldest == NULL) {
+    return;
+  }
+  decision_entry_t *e = *oldest;
+  *oldest = e->next;
+  debug("Decision cache: evicting \"%s\"\n", e->name);
+  free(e->name);
+  free(e);
+  entry_count--;
+}
+
+int scilC_decision_cache_get(const scilC_decision_key_t *key, scilC_decision_t *out_decision) {
+  pthread_mutex_lock(&lock);
+  decision_entry_t *e = find(key);
+  const int found = e != NULL && e->valid;
+  if (found) {
+    *out_decision = e->decision;
+    e->last_use = ++use_clock;
+  }
+  pthread_mutex_unlock(&lock);
+  return found;
+}
+
+void scilC_decision_cache_put(const scilC_decision_key_t *key, const scilC_decision_t *decision) {
+  pthread_mutex_lock(&lock);
+  decision_entry_t *e = find(key);
+  if (e == NULL) {
+    if (entry_count >= SCILC_DECISION_CACHE_ENTRIES) {
+      evict_least_recently_used();
+    }
+    e = (decision_entry_t *) malloc(sizeof(decision_entry_t));
+    e->name = strdup(key->name);
+    memcpy(e->values, key->values, sizeof(key->values));
+    e->hash = key->hash;
+    e->next = buckets[key->hash % BUCKETS];
+    buckets[key->hash % BUCKETS] = e;
+    entry_count++;
+  }
+  e->decision = *decision;
+  e->last_use = ++use_clock;
+  e->valid = 1;
+  e->uses = 0;
+  e->reference_known = 0;
+  pthread_mutex_unlock(&lock);
+}
+
+void scilC_decision_cache_report(const scilC_decision_key_t *key, double ratio) {
+  pthread_mutex_lock(&lock);
+  decision_entry_t *e = find(key);
+  if (e != NULL && e->valid) {
+    e->uses++;
+    if (!e->reference_known) {
+      e->reference_known = 1;
+      e->reference_ratio = ratio;
+    } else if (policy.ratio_drift > 0 && fabs(ratio - e->reference_ratio) > policy.ratio_drift * e->reference_ratio) {
+      debug("Decision cache: ratio %f drifted from %f for \"%s\"\n", ratio, e->reference_ratio, e->name);
+      e->valid = 0;
+    }
+    if (policy.revalidate_interval > 0 && e->uses >= policy.revalidate_interval) {
+      e->valid = 0;
+    }
+  }
+  pthread_mutex_unlock(&lock);
+}
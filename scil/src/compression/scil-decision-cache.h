@@ -0,0 +1,118 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_DECISION_CACHE_H
+#define SCIL_DECISION_CACHE_H
+
+/**
+ * \file
+ * \brief Process wide cache of the chains selected by the variable mapping, the decision tree or the chooser.
+ * A variable is usually written chunk by chunk, the chain is selected for its first chunk and reused for
+ * the following ones until the policy demands to select it again.
+ * A reused lossy chain is validated on every chunk by scil_compress() and the streams, it is replaced by a
+ * lossless chain if it misses the hints.
+ * The cache holds up to SCILC_DECISION_CACHE_ENTRIES decisions, the least recently used one is evicted.
+ */
+
+#include <scil-context-impl.h>
+#include <scil-dims.h>
+
+/** \brief When a cached decision is taken again */
+typedef struct {
+  /** \brief Number of compressions after which the decision is taken again, 0 never */
+  size_t revalidate_interval;
+  /** \brief Take the decision again if the compression ratio differs by more than this fraction from
+   * the ratio achieved first, 0 disables the check */
+  double ratio_drift;
+} scilC_decision_policy_t;
+
+// the maximum number of decisions kept
+#define SCILC_DECISION_CACHE_ENTRIES 1024
+
+// the number of values besides the name that identify a decision
+#define SCILC_DECISION_KEY_VALUES (2 + SCIL_DIMS_MAX + 15)
+
+/** \brief Identifies the data a decision applies to, see scilC_decision_key_init() */
+typedef struct {
+  const char *name;
+  double values[SCILC_DECISION_KEY_VALUES];
+  uint64_t hash;
+} scilC_decision_key_t;
+
+typedef struct {
+  scil_compression_chain_t chain;
+  /** \brief The data is stored without compression and frame */
+  int uncompressed;
+  int chooser_estimate_valid;
+  scilC_chooser_estimate_t chooser_estimate;
+} scilC_decision_t;
+
+/**
+ * \brief Reads the policy from the environment variables SCIL_DECISION_REVALIDATE_INTERVAL and
+ * SCIL_DECISION_RATIO_DRIFT.
+ */
+void scilC_decision_cache_initialize();
+
+void scilC_decision_cache_set_policy(const scilC_decision_policy_t *policy);
+
+void scilC_decision_cache_get_policy(scilC_decision_policy_t *out_policy);
+
+/**
+ * \brief Forget all decisions, e.g., after the hardware limits changed.
+ */
+void scilC_decision_cache_clear();
+
+/**
+ * \brief The number of decisions cached.
+ */
+size_t scilC_decision_cache_size();
+
+/**
+ * \brief The key consists of the variable name, the datatype, the dims and the hints that influence the decision.
+ * \param name The name of the variable, NULL if it is unknown. It must remain valid while the key is used.
+ */
+void scilC_decision_key_init(scilC_decision_key_t *key, const scil_context_t *ctx, const char *name, const scil_dims_t *dims);
+
+/**
+ * \brief Copies the decision for the key into out_decision.
+ * \return 1 if the decision is cached and valid, 0 if it must be taken (again)
+ */
+int scilC_decision_cache_get(const scilC_decision_key_t *key, scilC_decision_t *out_decision);
+
+/**
+ * \brief Store the decision for the key, a previous decision is replaced.
+ */
+void scilC_decision_cache_put(const scilC_decision_key_t *key, const scilC_decision_t *decision);
+
+/**
+ * \brief Account a compression that used the decision for the key, the policy may invalidate it.
+ * \param ratio The compressed size divided by the uncompressed size
+ */
+void scilC_decision_cache_report(const scilC_decision_key_t *key, double ratio);
+
+/**
+ * \brief Set the chain of the context to the cached decision for the key, or select it for the data and cache it.
+ * Implemented in scil.c as it uses the variable mapping and decision tree of scil_compress().
+ * \param out_uncompressed Set to 1 if the data is better stored uncompressed, the chain of the context is not set then
+ * \return SCIL_EINVAL if the chain of the variable mapping or decision tree does not support the datatype
+ */
+int scilC_decide_chain(scil_context_t *ctx,
+                       const scilC_decision_key_t *key,
+                       void *restrict source,
+                       const scil_dims_t *dims,
+                       scil_dims_t *resized_dims,
+                       int *out_uncompressed);
+
+#endif // SCIL_DECISION_CACHE_H
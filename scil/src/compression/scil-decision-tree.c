@@ -1,46 +1,368 @@
+#include <scil-decision-tree.h>
+#include <scil-data-characteristics.h>
+#include <scil-context-impl.h>
+#include <scil-debug.h>
+#include <scil-util.h>
+
+#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+/*
+ * The binary format is little endian:
+ * char magic[8] // TREE_MAGIC
+ * uint32_t version, node_count, feature_count, class_count
+ * feature_count + class_count names, each a uint16_t length followed by the characters
+ * int32_t left[node_count], right[node_count], feature[node_count] // feature indexes the names above
+ * double threshold[node_count]
+ * int32_t prediction[node_count]
+ */
+#define TREE_MAGIC "SCILTREE"
+#define TREE_VERSION 1
+
+// the limits of a model, they keep the counts of a damaged file within int and the name arrays
+#define TREE_MAX_NODES (1 << 24)
+#define TREE_MAX_NAMES 1024
 
-#include "scil-decision-tree.h"
-
-scilU_decision_tree* scilU_tree_create(int* left, int* right, double* thresholds, int* indices, int** classes, char** class_names, int amount_classes){
-  scilU_decision_tree* tree = malloc(sizeof(scilU_decision_tree));
-  tree->left_children = left;
-  tree->right_children = right;
-  tree->thresholds = thresholds;
-  tree->indices = indices;
-  tree->classes = classes;
-  tree->class_names = class_names;
-  tree->amount_classes = amount_classes;
+const char *scilU_tree_feature_names[SCILU_TREE_FEATURE_COUNT] = {
+  "Storage_Size",
+  "Number_of_Elements",
+  "Array_Dimension",
+  "DM1",
+  "DM2",
+  "DM3",
+  "DM4",
+  "Data_Type_DOUBLE",
+  "Data_Type_FLOAT",
+  "Minimum",
+  "Maximum",
+  "Mean",
+  "Standard_Deviation",
+  "Gradient_Mean",
+  "Gradient_Maximum",
+  "Byte_Entropy",
+  "Fill_Ratio",
+  "Exponent_Span",
+  "Smoothness"
+};
+
+static scilU_decision_tree* tree_allocate(int node_count, int class_count) {
+  scilU_decision_tree *tree = (scilU_decision_tree *) calloc(1, sizeof(scilU_decision_tree));
+  if (tree == NULL) {
+    return NULL;
+  }
+  tree->node_count = node_count;
+  tree->left = (int32_t *) calloc(node_count, sizeof(int32_t));
+  tree->right = (int32_t *) calloc(node_count, sizeof(int32_t));
+  tree->feature = (int32_t *) calloc(node_count, sizeof(int32_t));
+  tree->threshold = (double *) calloc(node_count, sizeof(double));
+  tree->prediction = (int32_t *) calloc(node_count, sizeof(int32_t));
+  tree->class_count = class_count;
+  tree->class_names = (char **) calloc(class_count, sizeof(char *));
+  if (tree->left == NULL || tree->right == NULL || tree->feature == NULL || tree->threshold == NULL ||
+      tree->prediction == NULL || tree->class_names == NULL) {
+    scilU_tree_remove(tree);
+    return NULL;
+  }
   return tree;
 }
 
-int scilU_tree_findMax(int* classes, int amount_classes){
-  int index = 0;
-  for (int i = 0; i < amount_classes; i++) {
-    index = classes[i] > classes[index] ? i : index;
+void scilU_tree_remove(scilU_decision_tree *tree) {
+  if (tree == NULL) {
+    return;
+  }
+  free(tree->left);
+  free(tree->right);
+  free(tree->feature);
+  free(tree->threshold);
+  free(tree->prediction);
+  for (int i = 0; tree->class_names != NULL && i < tree->class_count; i++) {
+    free(tree->class_names[i]);
   }
-  return index;
+  free(tree->class_names);
+  free(tree);
 }
 
-char* scilU_tree_predict(scilU_decision_tree* tree, int node, double*features){
-  if (tree->thresholds[node] <= -2.0) {
-    if (features[tree->indices[node]] <= tree->thresholds[node]) {
-      return scilU_tree_predict(tree, tree->left_children[node], features);
-    } else {
-      return scilU_tree_predict(tree, tree->right_children[node], features);
+static int feature_by_name(const char *name) {
+  for (int i = 0; i < SCILU_TREE_FEATURE_COUNT; i++) {
+    if (strcmp(scilU_tree_feature_names[i], name) == 0) {
+      return i;
     }
   }
-  return tree->class_names[scilU_tree_findMax(tree->classes[node], tree->amount_classes)];
+  return -1;
 }
 
-void scilU_tree_remove(scilU_decision_tree* tree){
-  free(tree->left_children);
-  free(tree->right_children);
-  free(tree->thresholds);
-  free(tree->classes);
-  free(tree->class_names);
+// map the columns of the model to the features and check the structure, returns 0 if the tree is unusable
+static int tree_finalize(scilU_decision_tree *tree, const int *column_features, int column_count) {
+  for (int n = 0; n < tree->node_count; n++) {
+    if (tree->left[n] < 0) {
+      if (tree->prediction[n] < 0 || tree->prediction[n] >= tree->class_count) {
+        return 0;
+      }
+      continue;
+    }
+    if (tree->left[n] >= tree->node_count || tree->right[n] < 0 || tree->right[n] >= tree->node_count ||
+        tree->left[n] <= n || tree->right[n] <= n ||
+        tree->feature[n] < 0 || tree->feature[n] >= column_count) {
+      return 0;
+    }
+    const int feature = column_features[tree->feature[n]];
+    if (feature < 0) {
+      return 0;
+    }
+    tree->feature[n] = feature;
+    tree->uses_data_features |= feature >= SCILU_TREE_FIRST_DATA_FEATURE;
+  }
+  return tree->node_count > 0;
+}
 
-  free(tree);
+static int read_name(FILE *f, char *out, size_t size) {
+  uint16_t length;
+  if (fread(&length, sizeof(length), 1, f) != 1 || length >= size || fread(out, 1, length, f) != length) {
+    return 0;
+  }
+  out[length] = 0;
+  return 1;
 }
 
+static scilU_decision_tree* load_binary(FILE *f) {
+  uint32_t header[4];
+  if (fread(header, sizeof(uint32_t), 4, f) != 4 || header[0] != TREE_VERSION ||
+      header[1] == 0 || header[1] > TREE_MAX_NODES || header[2] > TREE_MAX_NAMES ||
+      header[3] == 0 || header[3] > TREE_MAX_NAMES) {
+    return NULL;
+  }
+  const int node_count = (int) header[1];
+  const int column_count = (int) header[2];
+  scilU_decision_tree *tree = tree_allocate(node_count, (int) header[3]);
+  if (tree == NULL) {
+    return NULL;
+  }
+  int column_features[TREE_MAX_NAMES];
+  char name[1024];
+  int ok = 1;
+  for (int i = 0; i < column_count && ok; i++) {
+    ok = read_name(f, name, sizeof(name));
+    column_features[i] = feature_by_name(name);
+    if (ok && column_features[i] < 0) {
+      warn("The decision tree uses the unknown feature %s\n", name);
+    }
+  }
+  for (int i = 0; i < tree->class_count && ok; i++) {
+    ok = read_name(f, name, sizeof(name));
+    tree->class_names[i] = ok ? strdup(name) : NULL;
+    ok = ok && tree->class_names[i] != NULL;
+  }
+  ok = ok && fread(tree->left, sizeof(int32_t), node_count, f) == (size_t) node_count;
+  ok = ok && fread(tree->right, sizeof(int32_t), node_count, f) == (size_t) node_count;
+  ok = ok && fread(tree->feature, sizeof(int32_t), node_count, f) == (size_t) node_count;
+  ok = ok && fread(tree->threshold, sizeof(double), node_count, f) == (size_t) node_count;
+  ok = ok && fread(tree->prediction, sizeof(int32_t), node_count, f) == (size_t) node_count;
+  if (!ok || !tree_finalize(tree, column_features, column_count)) {
+    scilU_tree_remove(tree);
+    return NULL;
+  }
+  return tree;
+}
 
+// split the line at the delimiters into at most max_count tokens, returns the number of tokens
+static int split(char *line, const char *delimiters, char **out_tokens, int max_count) {
+  int count = 0;
+  char *saveptr;
+  for (char *token = strtok_r(line, delimiters, &saveptr); token != NULL && count < max_count;
+       token = strtok_r(NULL, delimiters, &saveptr)) {
+    out_tokens[count++] = token;
+  }
+  return count;
+}
+
+// the text format consists of lines starting with "#" naming the array stored ";" separated in the following line
+static scilU_decision_tree* load_text(FILE *f) {
+  char *line = NULL;
+  size_t len = 0;
+  char *sections[7] = {NULL};
+  const char *section_names[7] = {"classes", "columns", "left", "right", "thresholds", "indices", "values"};
+  while (getline(&line, &len, f) != -1) {
+    if (line[0] != '#') {
+      continue;
+    }
+    for (int s = 0; s < 7; s++) {
+      if (strncmp(line + 1, section_names[s], strlen(section_names[s])) == 0 && sections[s] == NULL) {
+        char *content = NULL;
+        size_t content_len = 0;
+        if (getline(&content, &content_len, f) != -1) {
+          content[strcspn(content, "\r\n")] = 0;
+          sections[s] = content;
+        } else {
+          free(content);
+        }
+        break;
+      }
+    }
+  }
+  free(line);
+
+  scilU_decision_tree *tree = NULL;
+  int ok = sections[0] && sections[2] && sections[3] && sections[4] && sections[5] && sections[6];
+  if (ok) {
+    int node_count = 1;
+    for (const char *c = sections[2]; *c; c++) {
+      node_count += *c == ';';
+    }
+    char **tokens = (char **) malloc(sizeof(char *) * (node_count > TREE_MAX_NAMES ? node_count : TREE_MAX_NAMES));
+    const int class_count = tokens != NULL ? split(sections[0], ";", tokens, TREE_MAX_NAMES) : 0;
+    if (node_count <= TREE_MAX_NODES && class_count > 0) {
+      tree = tree_allocate(node_count, class_count);
+    }
+    ok = tree != NULL;
+    for (int i = 0; ok && i < class_count; i++) {
+      tree->class_names[i] = strdup(tokens[i]);
+      ok = tree->class_names[i] != NULL;
+    }
+
+    // models without columns were trained with the shape features in their order
+    int column_features[TREE_MAX_NAMES];
+    int column_count = SCILU_TREE_FIRST_DATA_FEATURE;
+    for (int i = 0; i < column_count; i++) {
+      column_features[i] = i;
+    }
+    if (ok && sections[1] != NULL) {
+      column_count = split(sections[1], ";", tokens, TREE_MAX_NAMES);
+      for (int i = 0; i < column_count; i++) {
+        column_features[i] = feature_by_name(tokens[i]);
+        if (column_features[i] < 0) {
+          warn("The decision tree uses the unknown feature %s\n", tokens[i]);
+        }
+      }
+    }
+
+    ok = ok && split(sections[2], ";", tokens, node_count) == node_count;
+    for (int n = 0; ok && n < node_count; n++) {
+      tree->left[n] = atoi(tokens[n]);
+    }
+    ok = ok && split(sections[3], ";", tokens, node_count) == node_count;
+    for (int n = 0; ok && n < node_count; n++) {
+      tree->right[n] = atoi(tokens[n]);
+    }
+    ok = ok && split(sections[4], ";", tokens, node_count) == node_count;
+    for (int n = 0; ok && n < node_count; n++) {
+      tree->threshold[n] = atof(tokens[n]);
+    }
+    ok = ok && split(sections[5], ";", tokens, node_count) == node_count;
+    for (int n = 0; ok && n < node_count; n++) {
+      tree->feature[n] = atoi(tokens[n]);
+    }
+    // the class counts or fractions of each node, the leaf predicts the largest
+    ok = ok && split(sections[6], ";", tokens, node_count) == node_count;
+    for (int n = 0; ok && n < node_count; n++) {
+      char *pos = tokens[n];
+      double best = -1;
+      for (int c = 0; c < class_count; c++) {
+        char *end;
+        const double value = strtod(pos, &end);
+        if (end == pos) {
+          ok = 0;
+          break;
+        }
+        if (value > best) {
+          best = value;
+          tree->prediction[n] = c;
+        }
+        pos = end;
+        // the values are separated by whitespace, older exports end each value with "."
+        while (*pos == ' ' || *pos == '.') pos++;
+      }
+    }
+    ok = ok && tree_finalize(tree, column_features, column_count);
+    free(tokens);
+  }
+  for (int s = 0; s < 7; s++) {
+    free(sections[s]);
+  }
+  if (!ok) {
+    scilU_tree_remove(tree);
+    return NULL;
+  }
+  return tree;
+}
+
+scilU_decision_tree* scilU_tree_load(const char *filename) {
+  FILE *f = fopen(filename, "rb");
+  if (f == NULL) {
+    return NULL;
+  }
+  char magic[8];
+  scilU_decision_tree *tree;
+  if (fread(magic, 1, 8, f) == 8 && memcmp(magic, TREE_MAGIC, 8) == 0) {
+    tree = load_binary(f);
+  } else {
+    rewind(f);
+    tree = load_text(f);
+  }
+  fclose(f);
+  return tree;
+}
+
+static double env_dim(const char *name, const scil_dims_t *dims, int dim) {
+  const char *value = getenv(name);
+  if (value != NULL) {
+    return atof(value);
+  }
+  return dims->dims > dim ? (double) dims->length[dim] : 0;
+}
+
+void scilU_tree_compute_features(const scilU_decision_tree *tree,
+                                 const scil_context_t *ctx,
+                                 const void *source,
+                                 const scil_dims_t *dims,
+                                 const scil_dims_t *resized_dims,
+                                 double *f) {
+  memset(f, 0, sizeof(double) * SCILU_TREE_FEATURE_COUNT);
+
+  // the models were trained with the shape of the variable that h5repack provides in the environment
+  double dim[4];
+  dim[0] = env_dim("H5REPACK_DIM_0", dims, 0);
+  dim[1] = env_dim("H5REPACK_DIM_1", dims, 1);
+  dim[2] = env_dim("H5REPACK_DIM_2", dims, 2);
+  dim[3] = env_dim("H5REPACK_DIM_3", dims, 3);
+  // INFO: Chunking QuickFix
+  if ((int) dim[0] == 1 && dims->dims > 1) {
+    dim[0] = (double) dims->length[1];
+  }
+  double elements = 1;
+  for (int i = 0; i < 4; i++) {
+    f[SCILU_TREE_DM1 + i] = dim[i];
+    elements *= dim[i] > 1 ? dim[i] : 1;
+  }
+  f[SCILU_TREE_NUMBER_OF_ELEMENTS] = elements;
+  f[SCILU_TREE_STORAGE_SIZE] = elements * DATATYPE_LENGTH(ctx->datatype);
+  f[SCILU_TREE_ARRAY_DIMENSION] = dims->dims;
+  f[SCILU_TREE_DATA_TYPE_DOUBLE] = ctx->datatype == SCIL_TYPE_DOUBLE;
+  f[SCILU_TREE_DATA_TYPE_FLOAT] = ctx->datatype == SCIL_TYPE_FLOAT;
+
+  if (!tree->uses_data_features) {
+    return;
+  }
+  const scil_data_characteristics_t *c = scilC_get_data_characteristics(ctx, source, resized_dims);
+  const double range = c->maximum - c->minimum;
+  f[SCILU_TREE_MINIMUM] = c->minimum;
+  f[SCILU_TREE_MAXIMUM] = c->maximum;
+  f[SCILU_TREE_MEAN] = c->mean;
+  f[SCILU_TREE_STANDARD_DEVIATION] = sqrt(c->variance);
+  f[SCILU_TREE_GRADIENT_MEAN] = c->gradient_mean;
+  f[SCILU_TREE_GRADIENT_MAXIMUM] = c->gradient_maximum;
+  f[SCILU_TREE_BYTE_ENTROPY] = c->byte_entropy;
+  f[SCILU_TREE_FILL_RATIO] = c->count > 0 ? (double) c->fill_count / (double) c->count : 0;
+  f[SCILU_TREE_EXPONENT_SPAN] = c->exponent_maximum >= c->exponent_minimum ? c->exponent_maximum - c->exponent_minimum : 0;
+  // 1 for constant data, 0 if neighbours differ by the range on average
+  f[SCILU_TREE_SMOOTHNESS] = range > 0 ? 1 - fmin(1, c->gradient_mean / range) : 1;
+}
+
+const char* scilU_tree_predict(const scilU_decision_tree *tree, const double *features) {
+  int node = 0;
+  while (tree->left[node] >= 0) {
+    node = features[tree->feature[node]] <= tree->threshold[node] ? tree->left[node] : tree->right[node];
+  }
+  return tree->class_names[tree->prediction[node]];
+}
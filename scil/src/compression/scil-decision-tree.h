@@ -1,19 +1,82 @@
 #ifndef SCIL_DECISION_TREE_H
 #define SCIL_DECISION_TREE_H
 
+#include <scil-context.h>
+#include <scil-dims.h>
+
+#include <stdint.h>
+
+/**
+ * \brief The features a tree may test, a model refers to them by the names of its columns.
+ * The shape features come first, the others are determined from the data.
+ */
+enum scilU_tree_feature {
+  SCILU_TREE_STORAGE_SIZE = 0,
+  SCILU_TREE_NUMBER_OF_ELEMENTS,
+  SCILU_TREE_ARRAY_DIMENSION,
+  SCILU_TREE_DM1,
+  SCILU_TREE_DM2,
+  SCILU_TREE_DM3,
+  SCILU_TREE_DM4,
+  SCILU_TREE_DATA_TYPE_DOUBLE,
+  SCILU_TREE_DATA_TYPE_FLOAT,
+  SCILU_TREE_MINIMUM,
+  SCILU_TREE_MAXIMUM,
+  SCILU_TREE_MEAN,
+  SCILU_TREE_STANDARD_DEVIATION,
+  SCILU_TREE_GRADIENT_MEAN,
+  SCILU_TREE_GRADIENT_MAXIMUM,
+  SCILU_TREE_BYTE_ENTROPY,
+  SCILU_TREE_FILL_RATIO,
+  SCILU_TREE_EXPONENT_SPAN,
+  SCILU_TREE_SMOOTHNESS,
+  SCILU_TREE_FEATURE_COUNT
+};
+
+// the first feature that requires to inspect the data
+#define SCILU_TREE_FIRST_DATA_FEATURE SCILU_TREE_MINIMUM
+
+extern const char *scilU_tree_feature_names[SCILU_TREE_FEATURE_COUNT];
+
+/**
+ * \brief A flattened tree, node 0 is the root.
+ * An inner node sends features[feature[n]] <= threshold[n] to left[n], other values to right[n].
+ */
 typedef struct {
-  int* left_children;
-  int* right_children;
-  double* thresholds;
-  int* indices;
-  int** classes;
-  int amount_classes;
-  char** class_names;
+  int node_count;
+  int32_t *left; // -1 for a leaf
+  int32_t *right;
+  int32_t *feature; // enum scilU_tree_feature
+  double *threshold;
+  int32_t *prediction; // the class of a leaf
+
+  int class_count;
+  char **class_names;
+
+  /** \brief Set if a feature of the tree must be determined from the data */
+  int uses_data_features;
 } scilU_decision_tree;
 
-scilU_decision_tree* scilU_tree_create(int* left, int* right, double* thresholds, int* indices, int** classes, char** class_names, int amount_classes);
-void scilU_tree_remove(scilU_decision_tree* tree);
-int scilU_tree_findMax(int* classes, int amount_classes);
-char* scilU_tree_predict(scilU_decision_tree* tree, int node, double* features);
-#endif //SCIL_DECISION_TREE_H
+/**
+ * \brief Load a tree as exported by decision-tree/scil_decision_tree.py, the binary and the text format are supported.
+ * \return NULL if the file cannot be read or refers to an unknown feature
+ */
+scilU_decision_tree* scilU_tree_load(const char *filename);
+
+void scilU_tree_remove(scilU_decision_tree *tree);
 
+/**
+ * \brief Determine the features of the data to compress, the data features only if the tree uses them.
+ * \param dims The dims as given by the user, H5REPACK_DIM_* override them for the shape features
+ * \param out_features SCILU_TREE_FEATURE_COUNT values
+ */
+void scilU_tree_compute_features(const scilU_decision_tree *tree,
+                                 const scil_context_t *ctx,
+                                 const void *source,
+                                 const scil_dims_t *dims,
+                                 const scil_dims_t *resized_dims,
+                                 double *out_features);
+
+const char* scilU_tree_predict(const scilU_decision_tree *tree, const double *features);
+
+#endif //SCIL_DECISION_TREE_H
@@ -0,0 +1,184 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-dispatch.h>
+
+#include <string.h>
+
+// The thunks call the function of an algorithm for one datatype with the pointers converted to the element type,
+// a function is never called through a pointer of a different type.
+#define PRECOND_THUNKS(type, T, ctype)                                                                                       \
+    static int type##_compress_##T(const scilU_algorithm_t *algo, const scil_context_t *ctx, void *restrict data_out,     \
+                                   byte *restrict header, int *header_size_out, void *restrict data_in,                   \
+                                   const scil_dims_t *dims) {                                                             \
+        return algo->c.type.compress_##T(ctx, (ctype *) data_out, header, header_size_out, (ctype *) data_in, dims);      \
+    }                                                                                                                      \
+    static int type##_decompress_##T(const scilU_algorithm_t *algo, void *restrict data_out, scil_dims_t *dims,           \
+                                     void *restrict compressed_buf_in, byte *restrict header_end,                         \
+                                     int *header_parsed_out) {                                                            \
+        return algo->c.type.decompress_##T((ctype *) data_out, dims, (ctype *) compressed_buf_in, header_end,             \
+                                           header_parsed_out);                                                            \
+    }
+
+// the converters write int64_t, the data compressors bytes
+#define DATA_THUNKS(type, T, ctype, out_type)                                                                                \
+    static int type##_compress_##T(const scilU_algorithm_t *algo, const scil_context_t *ctx,                              \
+                                   void *restrict compressed_buf_in_out, size_t *restrict out_size,                       \
+                                   void *restrict data_in, const scil_dims_t *dims) {                                     \
+        return algo->c.type.compress_##T(ctx, (out_type *) compressed_buf_in_out, out_size, (ctype *) data_in, dims);     \
+    }                                                                                                                      \
+    static int type##_decompress_##T(const scilU_algorithm_t *algo, void *restrict data_out, scil_dims_t *dims,           \
+                                     void *restrict compressed_buf_in, const size_t in_size) {                            \
+        return algo->c.type.decompress_##T((ctype *) data_out, dims, (out_type *) compressed_buf_in, in_size);            \
+    }
+
+#define ALL_THUNKS(T, ctype)                \
+    PRECOND_THUNKS(PFtype, T, ctype)        \
+    DATA_THUNKS(Ctype, T, ctype, int64_t)   \
+    DATA_THUNKS(DNtype, T, ctype, byte)
+
+ALL_THUNKS(float, float)
+ALL_THUNKS(double, double)
+ALL_THUNKS(int8, int8_t)
+ALL_THUNKS(int16, int16_t)
+ALL_THUNKS(int32, int32_t)
+ALL_THUNKS(int64, int64_t)
+
+// the second preconditioners process int64_t independent of the datatype
+static int PStype_compress(const scilU_algorithm_t *algo, const scil_context_t *ctx, void *restrict data_out,
+                           byte *restrict header, int *header_size_out, void *restrict data_in, const scil_dims_t *dims) {
+    return algo->c.PStype.compress(ctx, (int64_t *) data_out, header, header_size_out, (int64_t *) data_in, dims);
+}
+
+// the thunk of a stage type for the datatype, NULL if the algorithm does not provide the function
+#define SELECT_BY_DATATYPE(algo, type, stage, datatype)                                       \
+    switch (datatype) {                                                                       \
+        case (SCIL_TYPE_FLOAT):                                                               \
+            return algo->c.type.stage##_float != NULL ? type##_##stage##_float : NULL;        \
+        case (SCIL_TYPE_DOUBLE):                                                              \
+            return algo->c.type.stage##_double != NULL ? type##_##stage##_double : NULL;      \
+        case (SCIL_TYPE_INT8):                                                                \
+            return algo->c.type.stage##_int8 != NULL ? type##_##stage##_int8 : NULL;          \
+        case (SCIL_TYPE_INT16):                                                               \
+            return algo->c.type.stage##_int16 != NULL ? type##_##stage##_int16 : NULL;        \
+        case (SCIL_TYPE_INT32):                                                               \
+            return algo->c.type.stage##_int32 != NULL ? type##_##stage##_int32 : NULL;        \
+        case (SCIL_TYPE_INT64):                                                               \
+            return algo->c.type.stage##_int64 != NULL ? type##_##stage##_int64 : NULL;        \
+        default:                                                                              \
+            return NULL;                                                                      \
+    }
+
+scilC_precond_compress_func_t scilC_precond_first_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, PFtype, compress, datatype)
+}
+
+scilC_precond_decompress_func_t scilC_precond_first_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, PFtype, decompress, datatype)
+}
+
+scilC_data_compress_func_t scilC_converter_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, Ctype, compress, datatype)
+}
+
+scilC_data_decompress_func_t scilC_converter_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, Ctype, decompress, datatype)
+}
+
+scilC_data_compress_func_t scilC_data_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, DNtype, compress, datatype)
+}
+
+scilC_data_decompress_func_t scilC_data_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype) {
+    SELECT_BY_DATATYPE(algo, DNtype, decompress, datatype)
+}
+
+// the buffers of stage of scilC_compress_chain(), the stages alternate such that the last one writes into dest
+static byte source_buffer(int stage, int total) {
+    if (stage == 0) {
+        return SCILC_BUFFER_SOURCE;
+    }
+    return (total - stage) % 2 == 1 ? SCILC_BUFFER_TMP : SCILC_BUFFER_DEST;
+}
+
+static byte dest_buffer(int stage, int total) {
+    return (total - stage) % 2 == 0 ? SCILC_BUFFER_TMP : SCILC_BUFFER_DEST;
+}
+
+static void add_stage(scilC_plan_t *plan, int *stage, const scilU_algorithm_t *algo) {
+    scilC_plan_stage_t *s = &plan->stages[*stage];
+    s->algo = algo;
+    s->src = source_buffer(*stage, plan->chain.total_size);
+    s->dst = dest_buffer(*stage, plan->chain.total_size);
+    switch (algo->type) {
+        case (SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST):
+            s->compress.precond = scilC_precond_first_compress_func(algo, plan->datatype);
+            break;
+        case (SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_SECOND):
+            s->compress.precond = algo->c.PStype.compress != NULL ? PStype_compress : NULL;
+            break;
+        case (SCIL_COMPRESSOR_TYPE_DATATYPES_CONVERTER):
+            s->compress.data = scilC_converter_compress_func(algo, plan->datatype);
+            break;
+        case (SCIL_COMPRESSOR_TYPE_DATATYPES):
+            s->compress.data = scilC_data_compress_func(algo, plan->datatype);
+            break;
+        case (SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES):
+            // byte compressors do not depend on the datatype
+            s->compress.data = NULL;
+            break;
+    }
+    (*stage)++;
+}
+
+void scilC_plan_create(scilC_plan_t *plan, const scil_compression_chain_t *chain, SCIL_Datatype_t datatype) {
+    memset(plan, 0, sizeof(scilC_plan_t));
+    plan->chain = *chain;
+    plan->datatype = datatype;
+
+    int stage = 0;
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        add_stage(plan, &stage, chain->pre_cond_first[i]);
+    }
+    if (stage > 0) {
+        plan->precond_first_header = plan->stages[stage - 1].dst;
+    }
+    if (chain->converter != NULL) {
+        add_stage(plan, &stage, chain->converter);
+    }
+    for (int i = 0; i < chain->precond_second_count; i++) {
+        add_stage(plan, &stage, chain->pre_cond_second[i]);
+    }
+    if (chain->precond_second_count > 0) {
+        plan->precond_second_header = plan->stages[stage - 1].dst;
+    }
+    if (chain->data_compressor != NULL) {
+        add_stage(plan, &stage, chain->data_compressor);
+    }
+    if (chain->byte_compressor != NULL) {
+        add_stage(plan, &stage, chain->byte_compressor);
+    }
+}
+
+int scilC_plan_matches(const scilC_plan_t *plan, const scil_compression_chain_t *chain, SCIL_Datatype_t datatype) {
+    const scil_compression_chain_t *c = &plan->chain;
+    return plan->datatype == datatype && c->total_size == chain->total_size &&
+           c->precond_first_count == chain->precond_first_count &&
+           c->precond_second_count == chain->precond_second_count &&
+           c->converter == chain->converter && c->data_compressor == chain->data_compressor &&
+           c->byte_compressor == chain->byte_compressor &&
+           memcmp(c->pre_cond_first, chain->pre_cond_first, sizeof(c->pre_cond_first)) == 0 &&
+           memcmp(c->pre_cond_second, chain->pre_cond_second, sizeof(c->pre_cond_second)) == 0;
+}
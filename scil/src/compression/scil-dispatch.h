@@ -0,0 +1,96 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_DISPATCH_H
+#define SCIL_DISPATCH_H
+
+/**
+ * \file
+ * \brief The functions of the algorithms resolved for a datatype.
+ *
+ * The datatype specific functions of an algorithm only differ in the type of the data pointers,
+ * the functions below select a thunk with the datatype erased that calls the function of the algorithm
+ * with the typed pointers. This is the only place that maps a datatype to the function of an algorithm,
+ * a new datatype has to be added here.
+ *
+ * A plan resolves all functions of a chain for a datatype together with the buffers each stage
+ * reads from and writes to. The context keeps the plan of its chain, see scilC_context_set_chain().
+ */
+
+#include <scil-compression-chain.h>
+
+// the functions are called with the algorithm they are resolved for
+typedef int (*scilC_precond_compress_func_t)(const scilU_algorithm_t *algo, const scil_context_t *ctx, void *restrict data_out,
+                                             byte *restrict header, int *header_size_out, void *restrict data_in,
+                                             const scil_dims_t *dims);
+typedef int (*scilC_precond_decompress_func_t)(const scilU_algorithm_t *algo, void *restrict data_out, scil_dims_t *dims,
+                                               void *restrict compressed_buf_in, byte *restrict header_end,
+                                               int *header_parsed_out);
+// converters and data compressors
+typedef int (*scilC_data_compress_func_t)(const scilU_algorithm_t *algo, const scil_context_t *ctx,
+                                          void *restrict compressed_buf_in_out, size_t *restrict out_size,
+                                          void *restrict data_in, const scil_dims_t *dims);
+typedef int (*scilC_data_decompress_func_t)(const scilU_algorithm_t *algo, void *restrict data_out, scil_dims_t *dims,
+                                            void *restrict compressed_buf_in, const size_t in_size);
+
+// NULL if the algorithm does not support the datatype
+scilC_precond_compress_func_t scilC_precond_first_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+scilC_precond_decompress_func_t scilC_precond_first_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+scilC_data_compress_func_t scilC_converter_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+scilC_data_decompress_func_t scilC_converter_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+scilC_data_compress_func_t scilC_data_compress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+scilC_data_decompress_func_t scilC_data_decompress_func(const scilU_algorithm_t *algo, SCIL_Datatype_t datatype);
+
+/** \brief The buffers of scilC_compress_chain() */
+enum scilC_buffer {
+    SCILC_BUFFER_SOURCE = 0,
+    SCILC_BUFFER_DEST,
+    SCILC_BUFFER_TMP
+};
+
+typedef struct {
+    const scilU_algorithm_t *algo;
+    // NULL if the algorithm does not support the datatype, then the chain is not applicable
+    union {
+        scilC_precond_compress_func_t precond;
+        scilC_data_compress_func_t data;
+    } compress;
+    // the enum scilC_buffer the stage reads and writes
+    byte src;
+    byte dst;
+} scilC_plan_stage_t;
+
+typedef struct {
+    /** \brief The chain and datatype the plan is resolved for */
+    scil_compression_chain_t chain;
+    SCIL_Datatype_t datatype;
+
+    /** \brief The stages in the order of application */
+    scilC_plan_stage_t stages[2 * PRECONDITIONER_LIMIT + 3];
+    /** \brief The buffers holding the headers of the first and second preconditioners */
+    byte precond_first_header;
+    byte precond_second_header;
+} scilC_plan_t;
+
+/**
+ * \brief Resolve the functions and the buffers of the chain for the datatype.
+ * The stages alternate between dest and the scratch buffer, such that the last stage writes into dest.
+ */
+void scilC_plan_create(scilC_plan_t *plan, const scil_compression_chain_t *chain, SCIL_Datatype_t datatype);
+
+/** \brief Whether the plan is resolved for the chain and datatype */
+int scilC_plan_matches(const scilC_plan_t *plan, const scil_compression_chain_t *chain, SCIL_Datatype_t datatype);
+
+#endif // SCIL_DISPATCH_H
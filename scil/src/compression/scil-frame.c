@@ -0,0 +1,185 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-frame.h>
+#include <scil-block.h>
+#include <scil-stream.h>
+#include <scil-compression-chain.h>
+#include <scil-error.h>
+#include <scil-debug.h>
+#include <scil-util.h>
+
+#include <string.h>
+#include <zlib.h>
+
+#define FRAME_FIXED_SIZE 5
+
+static uint32_t checksum(const byte *data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    // crc32 processes at most 4 GiB at once
+    while (size > 0) {
+        const uInt len = size > (1u << 30) ? (1u << 30) : (uInt) size;
+        crc = crc32(crc, data, len);
+        data += len;
+        size -= len;
+    }
+    return (uint32_t) crc;
+}
+
+size_t scilC_frame_header_size(const scil_context_t *ctx, const scil_dims_t *dims) {
+    uint8_t ids[2 * PRECONDITIONER_LIMIT + 3];
+    const int chain_length = scilU_chain_get_ids(&ctx->chain, ids);
+
+    return FRAME_FIXED_SIZE + (dims->dims + 1) * sizeof(uint64_t) + 1 + chain_length +
+           (ctx->hints.checksum != 0 ? sizeof(uint32_t) : 0);
+}
+
+int scilC_frame_write_header(byte *dest, size_t dest_size, const scil_context_t *ctx, const scil_dims_t *dims,
+                             size_t *out_header_size) {
+    uint8_t ids[2 * PRECONDITIONER_LIMIT + 3];
+    const int chain_length = scilU_chain_get_ids(&ctx->chain, ids);
+    const int use_checksum = ctx->hints.checksum != 0;
+
+    const size_t header_size = scilC_frame_header_size(ctx, dims);
+    if (dest_size < header_size) {
+        return SCIL_BUFFER_ERR;
+    }
+
+    byte *pos = dest;
+    *pos++ = SCIL_FRAME_MAGIC;
+    *pos++ = SCIL_FRAME_VERSION;
+    *pos++ = use_checksum ? SCIL_FRAME_FLAG_CHECKSUM : 0;
+    *pos++ = (byte) ctx->datatype;
+    *pos++ = dims->dims;
+    for (int i = 0; i < dims->dims; i++) {
+        uint64_t length = dims->length[i];
+        memcpy(pos, &length, sizeof(uint64_t));
+        pos += sizeof(uint64_t);
+    }
+    uint64_t size = scil_dims_get_size(dims, ctx->datatype);
+    memcpy(pos, &size, sizeof(uint64_t));
+    pos += sizeof(uint64_t);
+    *pos++ = chain_length;
+    memcpy(pos, ids, chain_length);
+    pos += chain_length;
+    if (use_checksum) {
+        memset(pos, 0, sizeof(uint32_t));
+    }
+
+    *out_header_size = header_size;
+    return SCIL_NO_ERR;
+}
+
+void scilC_frame_finish(byte *dest, size_t header_size, size_t payload_size) {
+    if (!(dest[2] & SCIL_FRAME_FLAG_CHECKSUM)) {
+        return;
+    }
+    const uint32_t crc = checksum(dest + header_size, payload_size);
+    memcpy(dest + header_size - sizeof(uint32_t), &crc, sizeof(uint32_t));
+}
+
+int scilC_is_frame(const byte *source, size_t source_size) {
+    return source_size >= FRAME_FIXED_SIZE && source[0] == SCIL_FRAME_MAGIC;
+}
+
+size_t scilC_frame_required_size(const byte *source, size_t available) {
+    if (available < FRAME_FIXED_SIZE) {
+        return FRAME_FIXED_SIZE;
+    }
+    const size_t fixed = FRAME_FIXED_SIZE + (source[4] + 1) * sizeof(uint64_t) + 1;
+    if (available < fixed) {
+        return fixed;
+    }
+    return fixed + source[fixed - 1] + ((source[2] & SCIL_FRAME_FLAG_CHECKSUM) ? sizeof(uint32_t) : 0);
+}
+
+static int parse_header(const byte *source, size_t source_size, scil_frame_header_t *h) {
+    if (!scilC_is_frame(source, source_size)) {
+        return SCIL_EINVAL;
+    }
+    memset(h, 0, sizeof(scil_frame_header_t));
+    h->version = source[1];
+    if (h->version != SCIL_FRAME_VERSION) {
+        return SCIL_EINVAL;
+    }
+    const byte flags = source[2];
+    h->datatype = (SCIL_Datatype_t) source[3];
+    h->dims.dims = source[4];
+    if (h->dims.dims > SCIL_DIMS_MAX || h->datatype > SCIL_TYPE_STRING) {
+        return SCIL_BUFFER_ERR;
+    }
+
+    const byte *pos = source + FRAME_FIXED_SIZE;
+    const byte *end = source + source_size;
+    if (pos + (h->dims.dims + 1) * sizeof(uint64_t) + 1 > end) {
+        return SCIL_BUFFER_ERR;
+    }
+    for (int i = 0; i < h->dims.dims; i++) {
+        uint64_t length;
+        memcpy(&length, pos, sizeof(uint64_t));
+        h->dims.length[i] = length;
+        pos += sizeof(uint64_t);
+    }
+    memcpy(&h->uncompressed_size, pos, sizeof(uint64_t));
+    pos += sizeof(uint64_t);
+
+    h->chain_length = *pos++;
+    if (h->chain_length > SCIL_FRAME_CHAIN_MAX || pos + h->chain_length > end) {
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(h->chain, pos, h->chain_length);
+    pos += h->chain_length;
+
+    if (flags & SCIL_FRAME_FLAG_CHECKSUM) {
+        if (pos + sizeof(uint32_t) > end) {
+            return SCIL_BUFFER_ERR;
+        }
+        h->has_checksum = 1;
+        memcpy(&h->checksum, pos, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+    }
+    h->header_size = pos - source;
+    if (scil_dims_get_size(&h->dims, h->datatype) != h->uncompressed_size) {
+        return SCIL_BUFFER_ERR;
+    }
+
+    // the chain decompression requires two intermediate buffers, blocks and streams use internal memory
+    if (scilC_is_block_container(pos, end - pos) || scilC_is_stream_container(pos, end - pos)) {
+        h->tmp_buffer_size = 0;
+    } else {
+        h->tmp_buffer_size = scilC_decompress_chain_tmp_size(h->uncompressed_size);
+    }
+    return SCIL_NO_ERR;
+}
+
+int scil_peek_header(const byte *source, size_t source_size, scil_frame_header_t *out_header) {
+    return parse_header(source, source_size, out_header);
+}
+
+int scilC_frame_open(byte *source, size_t source_size, scil_frame_header_t *out_header, byte **out_payload,
+                     size_t *out_payload_size) {
+    int ret = parse_header(source, source_size, out_header);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    *out_payload = source + out_header->header_size;
+    *out_payload_size = source_size - out_header->header_size;
+
+    if (out_header->has_checksum && checksum(*out_payload, *out_payload_size) != out_header->checksum) {
+        debug("Checksum mismatch of the compressed data\n");
+        return SCIL_BUFFER_ERR;
+    }
+    return SCIL_NO_ERR;
+}
@@ -0,0 +1,73 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_FRAME_H
+#define SCIL_FRAME_H
+
+/**
+ * \file
+ * \brief The self-describing frame that precedes the compressed data.
+ *
+ * byte SCIL_FRAME_MAGIC
+ * byte version
+ * byte flags // SCIL_FRAME_FLAG_CHECKSUM
+ * byte datatype
+ * byte dims
+ * uint64_t length[dims]
+ * uint64_t uncompressed size in bytes
+ * byte chain length
+ * byte compressor_id[chain length] // in the order of application
+ * uint32_t crc32 of the payload // only with SCIL_FRAME_FLAG_CHECKSUM
+ * byte * payload // a compression chain or a block container
+ */
+
+#include <scil.h>
+#include <scil-context-impl.h>
+
+#define SCIL_FRAME_MAGIC 254
+
+#define SCIL_FRAME_FLAG_CHECKSUM 1
+
+// the size of the largest valid header
+#define SCIL_FRAME_MAX_HEADER_SIZE (5 + (SCIL_DIMS_MAX + 1) * sizeof(uint64_t) + 1 + SCIL_FRAME_CHAIN_MAX + sizeof(uint32_t))
+
+/**
+ * \brief The size of the frame header for the data and the chain of the context.
+ */
+size_t scilC_frame_header_size(const scil_context_t *ctx, const scil_dims_t *dims);
+
+/**
+ * \brief Write the frame header for the data, the checksum is set by scilC_frame_finish().
+ */
+int scilC_frame_write_header(byte *dest, size_t dest_size, const scil_context_t *ctx, const scil_dims_t *dims,
+                             size_t *out_header_size);
+
+void scilC_frame_finish(byte *dest, size_t header_size, size_t payload_size);
+
+int scilC_is_frame(const byte *source, size_t source_size);
+
+/**
+ * \brief The size of the header that starts with the available bytes, for reading it piece by piece.
+ * \return The number of bytes needed to determine the size further if fewer are available, otherwise the size
+ */
+size_t scilC_frame_required_size(const byte *source, size_t available);
+
+/**
+ * \brief Parse the header and verify the checksum if present.
+ */
+int scilC_frame_open(byte *source, size_t source_size, scil_frame_header_t *out_header, byte **out_payload,
+                     size_t *out_payload_size);
+
+#endif // SCIL_FRAME_H
@@ -0,0 +1,499 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-stream.h>
+#include <scil-algo-chooser.h>
+#include <scil-block.h>
+#include <scil-frame.h>
+#include <scil-decision-cache.h>
+#include <scil-compression-chain.h>
+#include <scil-context-impl.h>
+#include <scil-error.h>
+#include <scil-debug.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <string.h>
+
+struct scil_stream {
+    scil_context_t *ctx;
+    scil_dims_t dims;
+    scil_dims_t resized_dims;
+    scil_stream_write_func_t write;
+    void *user_ptr;
+
+    size_t rows_per_block;
+    size_t block_count;
+    size_t row_size;
+
+    size_t total_size;
+    size_t pushed;
+    size_t next_block;
+    size_t written;
+
+    // the data of the incomplete block
+    byte *buffer;
+    size_t buffered;
+
+    // the size of the next block followed by its compressed data
+    byte *compressed;
+    size_t compressed_size;
+
+    int use_decision_cache;
+    scilC_decision_key_t key;
+    int ret;
+};
+
+struct scil_stream_reader {
+    scil_stream_read_func_t read;
+    void *user_ptr;
+    scil_frame_header_t header;
+    scil_dims_t resized_dims;
+
+    size_t rows_per_block;
+    size_t block_count;
+    size_t row_size;
+    size_t next_block;
+
+    byte *compressed;
+    size_t compressed_capacity;
+    byte *data;
+    byte *tmp;
+};
+
+int scilC_is_stream_container(const byte *source, size_t source_size) {
+    return source_size >= SCIL_STREAM_HEADER_SIZE && source[0] == SCIL_STREAM_CONTAINER_MAGIC;
+}
+
+// the dims of the block with the given number, see scil-block.c
+static void block_dims(scil_dims_t *out, const scil_dims_t *dims, size_t rows_per_block, size_t block) {
+    const size_t remaining = dims->length[dims->dims - 1] - block * rows_per_block;
+    scil_dims_copy(out, dims);
+    out->length[dims->dims - 1] = remaining < rows_per_block ? remaining : rows_per_block;
+}
+
+// the blocks of the container must match the dims
+static int read_container_header(const byte *source, const scil_dims_t *dims, uint64_t *rows_per_block,
+                                 uint64_t *block_count) {
+    memcpy(rows_per_block, source + 1, sizeof(uint64_t));
+    memcpy(block_count, source + 1 + sizeof(uint64_t), sizeof(uint64_t));
+    if (*rows_per_block == 0 || dims->dims == 0 ||
+        (dims->length[dims->dims - 1] + *rows_per_block - 1) / *rows_per_block != *block_count) {
+        return SCIL_BUFFER_ERR;
+    }
+    return SCIL_NO_ERR;
+}
+
+int scilC_stream_decompress(SCIL_Datatype_t datatype,
+                            void *restrict dest,
+                            const scil_dims_t *dims,
+                            const byte *restrict source,
+                            const size_t source_size) {
+    uint64_t rows_per_block, block_count;
+    int ret = read_container_header(source, dims, &rows_per_block, &block_count);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    const size_t row_size = scil_dims_get_size(dims, datatype) / dims->length[dims->dims - 1];
+
+    scil_dims_t first;
+    block_dims(&first, dims, rows_per_block, 0);
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte *tmp = (byte *) scilU_workspace_alloc(ws, scilC_decompress_chain_tmp_size(scil_dims_get_size(&first, datatype)));
+    if (tmp == NULL) {
+        ret = SCIL_MEMORY_ERR;
+    }
+
+    size_t pos = SCIL_STREAM_HEADER_SIZE;
+    for (size_t i = 0; i < block_count && ret == SCIL_NO_ERR; i++) {
+        uint64_t size;
+        if (pos + sizeof(uint64_t) > source_size) {
+            ret = SCIL_BUFFER_ERR;
+            break;
+        }
+        memcpy(&size, source + pos, sizeof(uint64_t));
+        pos += sizeof(uint64_t);
+        if (size == 0 || size > source_size - pos) {
+            ret = SCIL_BUFFER_ERR;
+            break;
+        }
+        scil_dims_t bdims;
+        block_dims(&bdims, dims, rows_per_block, i);
+        byte *dst = (byte *) dest + i * rows_per_block * row_size;
+        ret = scilC_decompress_chain(datatype, dst, &bdims, (byte *) source + pos, size, tmp);
+        if (ret != SCIL_NO_ERR) {
+            break;
+        }
+        pos += size;
+    }
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+
+static int write_data(scil_stream_t *stream, const byte *data, size_t size) {
+    stream->written += size;
+    return stream->write(stream->user_ptr, data, size);
+}
+
+// select the chain with the first block and write the headers
+static int start(scil_stream_t *stream, void *data, scil_dims_t *dims) {
+    scil_context_t *ctx = stream->ctx;
+    if (stream->use_decision_cache) {
+        int uncompressed;
+        const int ret = scilC_decide_chain(ctx, &stream->key, data, dims, dims, &uncompressed);
+        if (ret != SCIL_NO_ERR) {
+            return ret;
+        }
+        if (uncompressed) {
+            // the stream consists of blocks, storing them uncompressed requires a chain
+            scil_compression_chain_t memcopy;
+            scilU_chain_create(&memcopy, "memcopy");
+            scilC_context_set_chain(ctx, &memcopy);
+        }
+    }
+
+    scil_dims_t first;
+    block_dims(&first, &stream->resized_dims, stream->rows_per_block, 0);
+    stream->compressed_size = sizeof(uint64_t) + scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &first);
+    stream->compressed = (byte *) scilU_safe_malloc(stream->compressed_size);
+
+    // the checksum of the payload is not known when the header is written
+    scil_context_t frame_ctx = *ctx;
+    frame_ctx.hints.checksum = 0;
+    byte header[SCIL_FRAME_MAX_HEADER_SIZE + SCIL_STREAM_HEADER_SIZE];
+    size_t header_size;
+    int ret = scilC_frame_write_header(header, SCIL_FRAME_MAX_HEADER_SIZE, &frame_ctx, &stream->dims, &header_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    byte *pos = header + header_size;
+    *pos = SCIL_STREAM_CONTAINER_MAGIC;
+    uint64_t value = stream->rows_per_block;
+    memcpy(pos + 1, &value, sizeof(uint64_t));
+    value = stream->block_count;
+    memcpy(pos + 1 + sizeof(uint64_t), &value, sizeof(uint64_t));
+    return write_data(stream, header, header_size + SCIL_STREAM_HEADER_SIZE);
+}
+
+// returns SCIL_PRECISION_ERR if the compressed block misses the accuracy of the hints
+static int check_block(scil_context_t *ctx, const void *data, scil_dims_t *dims, byte *compressed, size_t size) {
+    const size_t block_size = scil_dims_get_size(dims, ctx->datatype);
+    scilU_workspace_t *ws = scilU_get_thread_workspace();
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte *decompressed = (byte *) scilU_workspace_alloc(ws, block_size);
+    byte *tmp = (byte *) scilU_workspace_alloc(ws, scilC_decompress_chain_tmp_size(block_size));
+    int ret = SCIL_MEMORY_ERR;
+    if (decompressed != NULL && tmp != NULL) {
+        ret = scilC_decompress_chain(ctx->datatype, decompressed, dims, compressed, size, tmp);
+    }
+    if (ret == SCIL_NO_ERR) {
+        scil_user_hints_t accuracy;
+        scil_validate_params_t validation;
+        scil_determine_accuracy(ctx->datatype, decompressed, data, dims, ctx->hints.relative_err_finest_abs_tolerance,
+                                &accuracy, &validation);
+        ret = scilC_check_accuracy(ctx->datatype, &ctx->hints, &accuracy);
+    }
+    scilU_workspace_release(ws, mark);
+    return ret;
+}
+
+// select a lossless chain with the block for it and the remaining blocks, it replaces the cached decision
+static int fall_back_to_lossless(scil_stream_t *stream, void *data, scil_dims_t *dims) {
+    scil_context_t *ctx = stream->ctx;
+    debug("Stream: the lossy chain misses the hints on block %zu, falling back to a lossless chain\n",
+          stream->next_block);
+    const int lossless_compression_needed = ctx->lossless_compression_needed;
+    ctx->lossless_compression_needed = 1;
+    memset(&ctx->chain, 0, sizeof(scil_compression_chain_t));
+    ctx->chooser_estimate_valid = 0;
+    scilC_algo_chooser_execute(data, dims, ctx);
+    ctx->lossless_compression_needed = lossless_compression_needed;
+    // a chain forced by the environment is used regardless
+    if (ctx->chain.is_lossy) {
+        return SCIL_PRECISION_ERR;
+    }
+
+    scilC_decision_t decision;
+    memset(&decision, 0, sizeof(scilC_decision_t));
+    decision.chain = ctx->chain;
+    decision.chooser_estimate_valid = ctx->chooser_estimate_valid;
+    decision.chooser_estimate = ctx->chooser_estimate;
+    scilC_decision_cache_put(&stream->key, &decision);
+    scilC_context_set_chain(ctx, &decision.chain);
+
+    // the buffer must hold the worst case of the new chain
+    scil_dims_t first;
+    block_dims(&first, &stream->resized_dims, stream->rows_per_block, 0);
+    const size_t compressed_size = sizeof(uint64_t) + scilU_chain_compress_bound(&ctx->chain, ctx->datatype, &first);
+    if (compressed_size > stream->compressed_size) {
+        free(stream->compressed);
+        stream->compressed_size = compressed_size;
+        stream->compressed = (byte *) scilU_safe_malloc(compressed_size);
+    }
+    return SCIL_NO_ERR;
+}
+
+static int emit_block(scil_stream_t *stream, void *data) {
+    scil_context_t *ctx = stream->ctx;
+    scil_dims_t dims;
+    block_dims(&dims, &stream->resized_dims, stream->rows_per_block, stream->next_block);
+
+    // the extrema and characteristics are determined for the block
+    scilC_context_set_input(ctx, data);
+    int ret = SCIL_NO_ERR;
+    if (stream->next_block == 0) {
+        ret = start(stream, data, &dims);
+    }
+    size_t size;
+    if (ret == SCIL_NO_ERR) {
+        ret = scilC_compress_chain(stream->compressed + sizeof(uint64_t), stream->compressed_size - sizeof(uint64_t),
+                                   data, &dims, &size, ctx);
+    }
+    // the lossy chain was selected with another block or the samples of the first one
+    if (ret == SCIL_NO_ERR && stream->use_decision_cache && ctx->chain.is_lossy) {
+        ret = check_block(ctx, data, &dims, stream->compressed + sizeof(uint64_t), size);
+        if (ret == SCIL_PRECISION_ERR) {
+            ret = fall_back_to_lossless(stream, data, &dims);
+            if (ret == SCIL_NO_ERR) {
+                ret = scilC_compress_chain(stream->compressed + sizeof(uint64_t),
+                                           stream->compressed_size - sizeof(uint64_t), data, &dims, &size, ctx);
+            }
+        }
+    }
+    scilC_context_set_input(ctx, NULL);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    const uint64_t value = size;
+    memcpy(stream->compressed, &value, sizeof(uint64_t));
+    stream->next_block++;
+    return write_data(stream, stream->compressed, sizeof(uint64_t) + size);
+}
+
+// the size of the block that is currently filled
+static size_t current_block_size(const scil_stream_t *stream) {
+    if (stream->next_block == stream->block_count - 1) {
+        return stream->total_size - stream->next_block * stream->rows_per_block * stream->row_size;
+    }
+    return stream->rows_per_block * stream->row_size;
+}
+
+int scil_stream_begin(scil_stream_t **out_stream,
+                      scil_context_t *ctx,
+                      const scil_dims_t *dims,
+                      scil_stream_write_func_t write,
+                      void *user_ptr) {
+    assert(ctx != NULL);
+    assert(write != NULL);
+    *out_stream = NULL;
+
+    scil_stream_t *stream = (scil_stream_t *) scilU_safe_malloc(sizeof(scil_stream_t));
+    memset(stream, 0, sizeof(scil_stream_t));
+    stream->ctx = ctx;
+    stream->write = write;
+    stream->user_ptr = user_ptr;
+    scil_dims_copy(&stream->dims, dims);
+    scilC_resize_dims(&stream->resized_dims, dims);
+
+    stream->total_size = scil_dims_get_size(&stream->resized_dims, ctx->datatype);
+    stream->block_count = scilC_block_count(&stream->resized_dims, ctx->datatype, ctx->hints.parallel_block_size,
+                                            &stream->rows_per_block);
+    if (stream->total_size == 0 || stream->block_count == 0) {
+        free(stream);
+        return SCIL_EINVAL;
+    }
+    stream->row_size = stream->total_size / stream->resized_dims.length[stream->resized_dims.dims - 1];
+    stream->buffer = (byte *) scilU_safe_malloc(current_block_size(stream));
+
+    // the chain is selected once for the complete data
+    stream->use_decision_cache = ctx->hints.force_compression_methods == NULL;
+    if (stream->use_decision_cache) {
+        scilC_decision_key_init(&stream->key, ctx, getenv("H5REPACK_VARIABLE"), &stream->dims);
+    }
+    *out_stream = stream;
+    return SCIL_NO_ERR;
+}
+
+int scil_stream_push(scil_stream_t *stream, const void *data, size_t count) {
+    if (stream->ret != SCIL_NO_ERR) {
+        return stream->ret;
+    }
+    size_t size = count * DATATYPE_LENGTH(stream->ctx->datatype);
+    if (size > stream->total_size - stream->pushed) {
+        return SCIL_EINVAL;
+    }
+    stream->pushed += size;
+
+    // the algorithms do not modify their input
+    byte *pos = (byte *) data;
+    while (size > 0) {
+        const size_t block_size = current_block_size(stream);
+        if (stream->buffered == 0 && size >= block_size) {
+            // complete blocks are compressed without copying them
+            stream->ret = emit_block(stream, pos);
+            if (stream->ret != SCIL_NO_ERR) {
+                return stream->ret;
+            }
+            pos += block_size;
+            size -= block_size;
+            continue;
+        }
+        const size_t len = block_size - stream->buffered < size ? block_size - stream->buffered : size;
+        memcpy(stream->buffer + stream->buffered, pos, len);
+        stream->buffered += len;
+        pos += len;
+        size -= len;
+        if (stream->buffered == block_size) {
+            stream->buffered = 0;
+            stream->ret = emit_block(stream, stream->buffer);
+            if (stream->ret != SCIL_NO_ERR) {
+                return stream->ret;
+            }
+        }
+    }
+    return SCIL_NO_ERR;
+}
+
+int scil_stream_end(scil_stream_t *stream, size_t *out_size) {
+    int ret = stream->ret;
+    if (ret == SCIL_NO_ERR && stream->pushed != stream->total_size) {
+        ret = SCIL_EINVAL;
+    }
+    if (ret == SCIL_NO_ERR && stream->use_decision_cache) {
+        scilC_decision_cache_report(&stream->key, (double) stream->written / (double) stream->total_size);
+    }
+    if (out_size != NULL) {
+        *out_size = stream->written;
+    }
+    debug("Stream of %zu blocks: %zu -> %zu bytes\n", stream->block_count, stream->total_size, stream->written);
+    free(stream->buffer);
+    free(stream->compressed);
+    free(stream);
+    return ret;
+}
+
+int scil_stream_open(scil_stream_reader_t **out_reader,
+                     scil_stream_read_func_t read,
+                     void *user_ptr,
+                     scil_frame_header_t *out_header) {
+    assert(read != NULL);
+    *out_reader = NULL;
+
+    // the header is read in pieces until its size is known
+    byte header[SCIL_FRAME_MAX_HEADER_SIZE + SCIL_STREAM_HEADER_SIZE];
+    size_t available = 0;
+    size_t required;
+    while ((required = scilC_frame_required_size(header, available)) > available) {
+        if (required > SCIL_FRAME_MAX_HEADER_SIZE) {
+            return SCIL_EINVAL;
+        }
+        int ret = read(user_ptr, header + available, required - available);
+        if (ret != SCIL_NO_ERR) {
+            return ret;
+        }
+        available = required;
+        if (!scilC_is_frame(header, available) || header[4] > SCIL_DIMS_MAX) {
+            return SCIL_EINVAL;
+        }
+    }
+    int ret = read(user_ptr, header + available, SCIL_STREAM_HEADER_SIZE);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    scil_frame_header_t frame;
+    ret = scil_peek_header(header, available + SCIL_STREAM_HEADER_SIZE, &frame);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    const byte *container = header + frame.header_size;
+    if (frame.has_checksum || !scilC_is_stream_container(container, SCIL_STREAM_HEADER_SIZE)) {
+        return SCIL_EINVAL;
+    }
+
+    scil_stream_reader_t *reader = (scil_stream_reader_t *) scilU_safe_malloc(sizeof(scil_stream_reader_t));
+    memset(reader, 0, sizeof(scil_stream_reader_t));
+    reader->read = read;
+    reader->user_ptr = user_ptr;
+    reader->header = frame;
+    scilC_resize_dims(&reader->resized_dims, &frame.dims);
+
+    uint64_t rows_per_block, block_count;
+    ret = read_container_header(container, &reader->resized_dims, &rows_per_block, &block_count);
+    if (ret != SCIL_NO_ERR) {
+        free(reader);
+        return ret;
+    }
+    reader->rows_per_block = rows_per_block;
+    reader->block_count = block_count;
+    reader->row_size = frame.uncompressed_size / reader->resized_dims.length[reader->resized_dims.dims - 1];
+
+    scil_dims_t first;
+    block_dims(&first, &reader->resized_dims, rows_per_block, 0);
+    const size_t block_size = scil_dims_get_size(&first, frame.datatype);
+    reader->data = (byte *) scilU_safe_malloc(block_size);
+    reader->tmp = (byte *) scilU_safe_malloc(scilC_decompress_chain_tmp_size(block_size));
+
+    if (out_header != NULL) {
+        *out_header = frame;
+    }
+    *out_reader = reader;
+    return SCIL_NO_ERR;
+}
+
+int scil_stream_pull(scil_stream_reader_t *reader, const void **out_data, size_t *out_count) {
+    *out_data = reader->data;
+    *out_count = 0;
+    if (reader->next_block == reader->block_count) {
+        return SCIL_NO_ERR;
+    }
+
+    uint64_t size;
+    int ret = reader->read(reader->user_ptr, (byte *) &size, sizeof(uint64_t));
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    // a compressed block cannot exceed the bound of the chain for the first block
+    if (size == 0 || size > scilC_decompress_chain_tmp_size(reader->rows_per_block * reader->row_size)) {
+        return SCIL_BUFFER_ERR;
+    }
+    if (size > reader->compressed_capacity) {
+        free(reader->compressed);
+        reader->compressed = (byte *) scilU_safe_malloc(size);
+        reader->compressed_capacity = size;
+    }
+    ret = reader->read(reader->user_ptr, reader->compressed, size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    scil_dims_t dims;
+    block_dims(&dims, &reader->resized_dims, reader->rows_per_block, reader->next_block);
+    ret = scilC_decompress_chain(reader->header.datatype, reader->data, &dims, reader->compressed, size, reader->tmp);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    reader->next_block++;
+    *out_count = scil_dims_get_count(&dims);
+    return SCIL_NO_ERR;
+}
+
+int scil_stream_close(scil_stream_reader_t *reader) {
+    free(reader->compressed);
+    free(reader->data);
+    free(reader->tmp);
+    free(reader);
+    return SCIL_NO_ERR;
+}
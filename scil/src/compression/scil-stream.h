@@ -0,0 +1,54 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_STREAM_H
+#define SCIL_STREAM_H
+
+/**
+ * \file
+ * \brief Stream container, the payload of the frame written by scil_stream_begin() and scil_stream_end().
+ *
+ * Like the block container the data is split along the slowest varying dimension into blocks, but as the blocks
+ * are written as soon as they are compressed, each block is preceded by its size instead of an index:
+ * byte SCIL_STREAM_CONTAINER_MAGIC
+ * uint64_t rows_per_block // number of elements of the last dimension in a block
+ * uint64_t block_count
+ * block_count times:
+ *   uint64_t size
+ *   byte * block // the output of a regular compression chain
+ *
+ * The frame of a stream has no checksum as the header is written before the payload.
+ */
+
+#include <scil.h>
+#include <scil-dims.h>
+
+#define SCIL_STREAM_CONTAINER_MAGIC 253
+
+#define SCIL_STREAM_HEADER_SIZE (1 + 2 * sizeof(uint64_t))
+
+int scilC_is_stream_container(const byte *source, size_t source_size);
+
+/**
+ * \brief Decompress a complete stream container, the blocks are decompressed one after another.
+ * \param dims the dims of the data folded into at most 4 dimensions
+ */
+int scilC_stream_decompress(SCIL_Datatype_t datatype,
+                            void *restrict dest,
+                            const scil_dims_t *dims,
+                            const byte *restrict source,
+                            const size_t source_size);
+
+#endif // SCIL_STREAM_H
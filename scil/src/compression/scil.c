@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
 #include <scil-algo-chooser.h>
+#include <scil-decision-cache.h>
 #include <scil-error.h>
 #include <scil-hardware-limits.h>
 #include <scil-debug.h>
@@ -20,6 +21,9 @@
 
 #include <scil-compressor.h>
 #include <scil-compression-chain.h>
+#include <scil-block.h>
+#include <scil-frame.h>
+#include <scil-stream.h>
 
 #include <ctype.h>
 #include <float.h>
@@ -89,6 +93,154 @@ static inline void *pick_buffer(int is_src,
     }
 }
 
+/*
+ * Fold more than four dimensions into the fourth dimension as the algorithms support up to 4D.
+ */
+void scilC_resize_dims(scil_dims_t *resized_dims, const scil_dims_t *dims) {
+    memset(resized_dims, 0, sizeof(scil_dims_t));
+
+    if (dims->dims > 4) {
+        resized_dims->dims = 4;
+        for (int i = 0; i < dims->dims; i++) {
+            if (i > 3) {
+                resized_dims->length[3] *= dims->length[i];
+            } else {
+                resized_dims->length[i] = dims->length[i];
+            }
+        }
+    } else {
+        resized_dims->dims = dims->dims;
+        for (int i = 0; i < dims->dims; i++) {
+            resized_dims->length[i] = dims->length[i];
+        }
+    }
+}
+
+// whether scil_compress() splits the data into a block container
+static int use_blocks(const scil_context_t *ctx, const scil_dims_t *resized_dims) {
+    return (ctx->hints.parallel_threads > 1 || ctx->hints.parallel_block_size > 0) &&
+           scilC_block_count(resized_dims, ctx->datatype, ctx->hints.parallel_block_size, NULL) > 1;
+}
+
+// the worst case size of the frame and payload using the chain of the context
+static size_t frame_bound(const scil_context_t *ctx, const scil_dims_t *resized_dims, const scil_dims_t *dims) {
+    size_t payload;
+    if (use_blocks(ctx, resized_dims)) {
+        payload = scilC_block_compress_bound(resized_dims, ctx);
+    } else {
+        payload = scilU_chain_compress_bound(&ctx->chain, ctx->datatype, resized_dims);
+    }
+    return scilC_frame_header_size(ctx, dims) + payload;
+}
+
+size_t scil_compress_bound(const scil_context_t *ctx, const scil_dims_t *dims) {
+    assert(ctx != NULL);
+
+    scil_dims_t resized_dims;
+    scilC_resize_dims(&resized_dims, dims);
+    if (scil_dims_get_size(&resized_dims, ctx->datatype) == 0) {
+        return 1;
+    }
+
+    // other chains may be selected again for the following calls
+    if (ctx->hints.force_compression_methods != NULL) {
+        return frame_bound(ctx, &resized_dims, dims);
+    }
+    if (variable_dict != NULL || decision_tree != NULL) {
+        // the chain is picked from the mapping, any algorithm may be used
+        return scil_get_compressed_data_size_limit(&resized_dims, ctx->datatype);
+    }
+
+    // the worst case of all chains the chooser may select
+    scil_compression_chain_t candidates[SCIL_CHOOSER_CANDIDATES_MAX];
+    const int count = scilC_algo_chooser_candidates(ctx, &resized_dims, candidates);
+    if (count == 0) {
+        return scil_get_compressed_data_size_limit(&resized_dims, ctx->datatype);
+    }
+    size_t bound = 0;
+    for (int i = 0; i < count; i++) {
+        scil_context_t tmp = *ctx;
+        tmp.chain = candidates[i];
+        const size_t cur = frame_bound(&tmp, &resized_dims, dims);
+        bound = cur > bound ? cur : bound;
+    }
+    return bound;
+}
+
+// Select the chain by the variable mapping, the decision tree or the chooser
+static void select_chain(void *restrict source,
+                         const scil_dims_t *dims,
+                         scil_dims_t *resized_dims,
+                         const char *name,
+                         scil_context_t *ctx,
+                         scilC_decision_t *out_decision) {
+    memset(out_decision, 0, sizeof(scilC_decision_t));
+    memset(&ctx->chain, 0, sizeof(scil_compression_chain_t));
+    ctx->chooser_estimate_valid = 0;
+
+    // Check for variable - compressor mapping
+    if (variable_dict != NULL) {
+        if (name != NULL && strlen(name) > 0) {
+            scilU_dict_element_t *element = scilU_dict_get(variable_dict, name);
+            if (element != NULL) {
+                if (scilU_chain_create(&ctx->chain, element->value) != SCIL_NO_ERR) {
+                    memset(&ctx->chain, 0, sizeof(scil_compression_chain_t));
+                }
+                warn("H5: %s | compressor: %s\n", name, element->value);
+            }
+        }
+    } else if (decision_tree != NULL) {
+        double features[SCILU_TREE_FEATURE_COUNT];
+        scilU_tree_compute_features(decision_tree, ctx, source, dims, resized_dims, features);
+        const char *predicted = scilU_tree_predict(decision_tree, features);
+        debug("Predicted: %s %s\n", name, predicted);
+        if(strcmp(predicted, "NONE")==0){
+            out_decision->uncompressed = 1;
+            return;
+        }
+        if (scilU_chain_create(&ctx->chain, predicted) != SCIL_NO_ERR) {
+            memset(&ctx->chain, 0, sizeof(scil_compression_chain_t));
+        }
+    }
+
+    if (ctx->chain.total_size == 0) {
+        scilC_algo_chooser_execute(source, resized_dims, ctx);
+    }
+    out_decision->chain = ctx->chain;
+    out_decision->chooser_estimate_valid = ctx->chooser_estimate_valid;
+    out_decision->chooser_estimate = ctx->chooser_estimate;
+}
+
+int scilC_decide_chain(scil_context_t *ctx,
+                       const scilC_decision_key_t *key,
+                       void *restrict source,
+                       const scil_dims_t *dims,
+                       scil_dims_t *resized_dims,
+                       int *out_uncompressed) {
+    scilC_decision_t decision;
+    if (!scilC_decision_cache_get(key, &decision)) {
+        scil_timer chooser_start = {0, 0};
+        scilC_stage_start(ctx, &chooser_start);
+        select_chain(source, dims, resized_dims, key->name, ctx, &decision);
+        scilC_stage_stop(ctx, SCIL_STAGE_CHOOSER, chooser_start, scil_dims_get_size(resized_dims, ctx->datatype), 0);
+        scilC_decision_cache_put(key, &decision);
+    }
+    *out_uncompressed = decision.uncompressed;
+    if (decision.uncompressed) {
+        return SCIL_NO_ERR;
+    }
+    // the chooser only selects applicable chains, the variable mapping and the decision tree may name any chain
+    if (scilU_chain_is_applicable(&decision.chain, ctx->datatype) != SCIL_NO_ERR) {
+        warn("The chain selected for %s does not support the datatype %s\n", key->name != NULL ? key->name : "the variable",
+             scil_datatype_to_str(ctx->datatype));
+        return SCIL_EINVAL;
+    }
+    scilC_context_set_chain(ctx, &decision.chain);
+    ctx->chooser_estimate_valid = decision.chooser_estimate_valid;
+    ctx->chooser_estimate = decision.chooser_estimate;
+    return SCIL_NO_ERR;
+}
+
 /*
 A compression chain compresses data in multiple phases, i.e., applying algo 1,
 then algo 2 ...
@@ -122,41 +274,109 @@ the data.
 
 A datatype compressor terminates the chain of preconditioners.
  */
+// Write the frame header and the data compressed with the chain of the context
+static int compress_frame(byte *restrict dest,
+                          size_t in_dest_size,
+                          void *restrict source,
+                          const scil_dims_t *dims,
+                          scil_dims_t *resized_dims,
+                          size_t *restrict out_size_p,
+                          scil_context_t *ctx) {
+    // The algorithms do not check the space left in dest, the worst case must fit
+    if (in_dest_size < frame_bound(ctx, resized_dims, dims)) {
+        return SCIL_MEMORY_ERR;
+    }
+
+    // The frame describes the data and precedes the payload
+    size_t header_size;
+    int ret = scilC_frame_write_header(dest, in_dest_size, ctx, dims, &header_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    byte *payload = dest + header_size;
+    size_t payload_size;
+
+    // Split the data into independently compressed blocks if requested
+    if (use_blocks(ctx, resized_dims)) {
+        ret = scilC_block_compress(payload, in_dest_size - header_size, source, resized_dims, &payload_size, ctx);
+    } else {
+        ret = scilC_compress_chain(payload, in_dest_size - header_size, source, resized_dims, &payload_size, ctx);
+    }
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    scilC_frame_finish(dest, header_size, payload_size);
+    *out_size_p = header_size + payload_size;
+    return SCIL_NO_ERR;
+}
+
+// Validate data compressed with a selected lossy chain, compress it again losslessly if it misses the hints
+static int ensure_accuracy(byte *restrict dest,
+                           size_t in_dest_size,
+                           void *restrict source,
+                           scil_dims_t *dims,
+                           scil_dims_t *resized_dims,
+                           size_t *restrict out_size_p,
+                           scil_context_t *ctx,
+                           const scilC_decision_key_t *key) {
+    scil_user_hints_t accuracy;
+    scil_validate_params_t validation;
+    int ret = scil_validate_compression(ctx->datatype, source, dims, dest, *out_size_p, ctx, &accuracy, &validation);
+    if (ret != SCIL_PRECISION_ERR) {
+        return ret;
+    }
+    debug("The selected lossy chain misses the hints, falling back to a lossless chain\n");
+
+    const int lossless_compression_needed = ctx->lossless_compression_needed;
+    ctx->lossless_compression_needed = 1;
+    memset(&ctx->chain, 0, sizeof(scil_compression_chain_t));
+    ctx->chooser_estimate_valid = 0;
+    scilC_algo_chooser_execute(source, resized_dims, ctx);
+    ctx->lossless_compression_needed = lossless_compression_needed;
+    // a chain forced by the environment is used regardless
+    if (ctx->chain.is_lossy) {
+        return SCIL_PRECISION_ERR;
+    }
+
+    scilC_decision_t decision;
+    memset(&decision, 0, sizeof(scilC_decision_t));
+    decision.chain = ctx->chain;
+    decision.chooser_estimate_valid = ctx->chooser_estimate_valid;
+    decision.chooser_estimate = ctx->chooser_estimate;
+    scilC_decision_cache_put(key, &decision);
+    scilC_context_set_chain(ctx, &decision.chain);
+    return compress_frame(dest, in_dest_size, source, dims, resized_dims, out_size_p, ctx);
+}
+
 int scil_compress(byte *restrict dest,
                   size_t in_dest_size,
                   void *restrict source,
                   scil_dims_t *dims,
                   size_t *restrict out_size_p,
                   scil_context_t *ctx) {
+    return scilC_compress(dest, in_dest_size, source, dims, out_size_p, ctx, getenv("H5REPACK_VARIABLE"));
+}
+
+int scilC_compress(byte *restrict dest,
+                   size_t in_dest_size,
+                   void *restrict source,
+                   scil_dims_t *dims,
+                   size_t *restrict out_size_p,
+                   scil_context_t *ctx,
+                   const char *name) {
 
     assert(ctx != NULL);
     assert(dest != NULL);
     assert(out_size_p != NULL);
     assert(source != NULL);
 
-    int ret = SCIL_NO_ERR;
-    scil_dims_t *resized_dims = malloc(sizeof(scil_dims_t));
-    memset(resized_dims, 0, sizeof(scil_dims_t));
-
-    if (dims->dims > 4) {
-        resized_dims->dims = 4;
-        for (int i = 0; i < dims->dims; i++) {
-            if (i > 3) {
-                resized_dims->length[3] *= dims->length[i];
-            } else {
-                resized_dims->length[i] = dims->length[i];
-            }
-        }
-    } else {
-        resized_dims->dims = dims->dims;
-        for (int i = 0; i < dims->dims; i++) {
-            resized_dims->length[i] = dims->length[i];
-        }
-    }
+    scil_dims_t resized_dims_buf;
+    scil_dims_t *resized_dims = &resized_dims_buf;
+    scilC_resize_dims(resized_dims, dims);
 
     // Get byte size of input data
-    size_t input_size = scil_dims_get_size(resized_dims, ctx->datatype);
-    const size_t datatypes_size = input_size;
+    const size_t datatypes_size = scil_dims_get_size(resized_dims, ctx->datatype);
 
     /*
      * TODO: Available information
@@ -174,300 +394,235 @@ int scil_compress(byte *restrict dest,
         return SCIL_NO_ERR;
     }
 
-    // Why? Factor 4 seems arbitrary
-    if (in_dest_size < 4 * datatypes_size) {
-        return SCIL_MEMORY_ERR;
-    }
-
-    // Check for variable - compressor mapping
-    if (variable_dict != NULL) {
-        char *h5name = getenv("H5REPACK_VARIABLE");
-        if (strlen(h5name) > 0) {
-            scilU_dict_element_t *element = scilU_dict_get(variable_dict, h5name);
-            if (element != NULL) {
-                // TODO: Check existence? scilU_find_compressor_by_name
-                ctx->hints.force_compression_methods = element->value;
-                scilU_chain_create(&ctx->chain, element->value);
-                warn("H5: %s | compressor: %s\n", h5name, element->value);
-            }
+    // The extrema and characteristics of the input are determined at most once during this call
+    scilC_context_set_input(ctx, source);
+
+    // A chain forced by the hints is fixed, otherwise it is selected once per variable and kept in the decision cache
+    scilC_decision_key_t key;
+    const int use_decision_cache = ctx->hints.force_compression_methods == NULL;
+    if (use_decision_cache) {
+        scilC_decision_key_init(&key, ctx, name, dims);
+        int uncompressed;
+        int ret = scilC_decide_chain(ctx, &key, source, dims, resized_dims, &uncompressed);
+        if (ret != SCIL_NO_ERR) {
+            return ret;
         }
-    } else if (decision_tree != NULL) {
-        // TODO: Gather all required infos to apply to tree
-        double is_float = 0.0;
-        double is_double = 0.0;
-        if(ctx->datatype == SCIL_TYPE_FLOAT){
-            is_float = 1.0;
-        }else if(ctx->datatype == SCIL_TYPE_DOUBLE){
-            is_double = 1.0;
+        if (uncompressed) {
+            if (in_dest_size < datatypes_size) {
+                return SCIL_MEMORY_ERR;
+            }
+            memcpy(dest, source, datatypes_size);
+            *out_size_p = datatypes_size;
+            scilC_decision_cache_report(&key, 1.0);
+            return SCIL_NO_ERR;
         }
+    }
 
-        int dim_1 = getenv("H5REPACK_DIM_0") ? atoi(getenv("H5REPACK_DIM_0")) : (dims->dims > 0 ? dims->length[0] : 0);
-        int dim_2 = getenv("H5REPACK_DIM_1") ? atoi(getenv("H5REPACK_DIM_1")) : (dims->dims > 1 ? dims->length[1] : 0);
-        int dim_3 = getenv("H5REPACK_DIM_2") ? atoi(getenv("H5REPACK_DIM_2")) : (dims->dims > 2 ? dims->length[2] : 0);
-        int dim_4 = getenv("H5REPACK_DIM_3") ? atoi(getenv("H5REPACK_DIM_3")) : (dims->dims > 3 ? dims->length[3] : 0);
-        // INFO: Chunking QuickFix        
-        if(dim_1 == 1){
-            dim_1 = dims->length[1];
+    int ret = compress_frame(dest, in_dest_size, source, dims, resized_dims, out_size_p, ctx);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    // The chooser judges lossy chains by samples, a selected lossy chain must meet the hints on all data
+    if (use_decision_cache && ctx->chain.is_lossy) {
+        ret = ensure_accuracy(dest, in_dest_size, source, dims, resized_dims, out_size_p, ctx, &key);
+        if (ret != SCIL_NO_ERR) {
+            return ret;
         }
+    }
+    if (use_decision_cache) {
+        scilC_decision_cache_report(&key, (double) *out_size_p / (double) datatypes_size);
+    }
+    return SCIL_NO_ERR;
+}
+
+// a converter or data compressor, the headers of the preconditioners applied before are preserved behind its output
+static int compress_data_stage(scil_context_t *ctx,
+                               const scilC_plan_stage_t *stage,
+                               void **buffers,
+                               enum scil_stage statistics_stage,
+                               scil_dims_t *resized_dims,
+                               size_t datatypes_size,
+                               size_t *input_size) {
+    void *src = buffers[stage->src];
+    void *dst = buffers[stage->dst];
+
+    // set the output size to the available buffer size
+    size_t out_size = scilU_algorithm_compress_bound(stage->algo, ctx->datatype, scil_dims_get_count(resized_dims),
+                                                     datatypes_size);
+    if (stage->compress.data == NULL) {
+        return SCIL_EINVAL;
+    }
+    scil_timer stage_start = {0, 0};
+    scilC_stage_start(ctx, &stage_start);
+    int ret = stage->compress.data(stage->algo, ctx, dst, &out_size, src, resized_dims);
+    if (ret != 0) {
+        return ret;
+    }
+    scilC_stage_stop(ctx, statistics_stage, stage_start, datatypes_size, out_size);
+    // check if we have to preserve another header from the preconditioners
+    if (datatypes_size != *input_size) {
+        debugI("Preserving %lld %lld\n", (long long) datatypes_size, (long long) *input_size);
+        const int preserve = *input_size - datatypes_size;
+        memcpy((char *) dst + out_size, (char *) src + datatypes_size, preserve);
+        out_size += preserve;
+    }
 
-        int number_of_elements = max(dim_1, 1) * max(dim_2, 1) * max(dim_3, 1) * max(dim_4, 1);
-        int storage_size = number_of_elements * DATATYPE_LENGTH(ctx->datatype);
+    ((char *) dst)[out_size] = stage->algo->compressor_id;
+    debugI("C compressor ID %d at pos %llu\n", stage->algo->compressor_id, (long long unsigned) &((char *) dst)[out_size]);
+    *input_size = out_size + 1;
+    return SCIL_NO_ERR;
+}
 
-        printf("Storage_Size; %d, Number_of_Elements; %d, Fill_Value; %0.5E Array_Dimension; %d DM1; %d DM2; %d DM3; %d DM4; %d Data_Type_DOUBLE; %.0f Data_Type_FLOAT %.0f\n", storage_size, number_of_elements, ctx->special_values->fill_value, dims->dims, dim_1, dim_2, dim_3, dim_4, is_double, is_float);
-        double features[] = {storage_size, number_of_elements, dims->dims, dim_1, dim_2, dim_3, dim_4, is_double, is_float};
-        //double features[] = {9142272.0, 2285568.0, 3.0, 124.0, 96.0, 192.0, 0.0, 0.0, 1.0};
-        char *predicted = scilU_tree_predict(decision_tree, 0, features);
-        warn("Predicted: %s %s\n", getenv("H5REPACK_VARIABLE"), predicted);
-        if(strcmp(predicted, "NONE")==0){
-            memcpy(dest, source, in_dest_size);
-            *out_size_p = in_dest_size;
-            return SCIL_NO_ERR;
+// a group of preconditioners, their headers are appended to the data in the order of application
+static int compress_precond_stages(scil_context_t *ctx,
+                                   const scilC_plan_stage_t *stages,
+                                   int stage_count,
+                                   void **buffers,
+                                   byte header_buffer,
+                                   scil_dims_t *resized_dims,
+                                   size_t datatypes_size,
+                                   size_t *out_size) {
+    *out_size += datatypes_size;
+    byte *header = (byte *) buffers[header_buffer] + datatypes_size;
+    scil_timer stage_start = {0, 0};
+    for (int i = 0; i < stage_count; i++) {
+        const scilC_plan_stage_t *stage = &stages[i];
+        int header_size_out;
+        if (stage->compress.precond == NULL) {
+            return SCIL_EINVAL;
+        }
+        scilC_stage_start(ctx, &stage_start);
+        int ret = stage->compress.precond(stage->algo, ctx, buffers[stage->dst], header, &header_size_out, buffers[stage->src], resized_dims);
+        if (ret != 0) {
+            return ret;
         }
-        ctx->hints.force_compression_methods = predicted;
-        scilU_chain_create(&ctx->chain, predicted);
+        scilC_stage_stop(ctx, SCIL_STAGE_PRECONDITIONER, stage_start, datatypes_size, datatypes_size + header_size_out);
+        *out_size += header_size_out;
+        header += header_size_out;
+        *header = stage->algo->compressor_id;
+        debugI("C compressor ID %d at pos %llu\n", *header, (long long unsigned) header)
+        header++;
+        (*out_size)++;
     }
+    return SCIL_NO_ERR;
+}
 
-    // Set local references of hints and compression chain
-    const scil_user_hints_t *hints = &ctx->hints;
-    scil_compression_chain_t *chain = &ctx->chain;
+int scilC_compress_chain(byte *restrict dest,
+                         size_t in_dest_size,
+                         void *restrict source,
+                         scil_dims_t *resized_dims,
+                         size_t *restrict out_size_p,
+                         scil_context_t *ctx) {
+    int ret = SCIL_NO_ERR;
+    size_t input_size = scil_dims_get_size(resized_dims, ctx->datatype);
+    const size_t datatypes_size = input_size;
 
-    // Check whether automatic compressor decision can be skipped because of a user forced chain
-    if (hints->force_compression_methods == NULL) {
-        scilC_algo_chooser_execute(source, resized_dims, ctx);
+    // the plan is resolved when the chain is set, a chain assigned otherwise is resolved for this call
+    const scilC_plan_t *plan = &ctx->plan;
+    scilC_plan_t plan_buf;
+    if (!scilC_plan_matches(plan, &ctx->chain, ctx->datatype)) {
+        scilC_plan_create(&plan_buf, &ctx->chain, ctx->datatype);
+        plan = &plan_buf;
     }
-
+    const scil_compression_chain_t *chain = &plan->chain;
+    const scilC_plan_stage_t *stage = plan->stages;
     size_t out_size = 0;
 
+    // dest and the scratch buffer hold the intermediate results alternately
+    const size_t bound = scilU_chain_compress_bound(chain, ctx->datatype, resized_dims);
+    if (in_dest_size < bound) {
+        return SCIL_MEMORY_ERR;
+    }
+
     // Add the length of the algo chain to the output
-    int remaining_compressors = chain->total_size;
-    const int total_compressors = remaining_compressors;
+    const int total_compressors = chain->total_size;
     dest[0] = total_compressors;
     dest++;
 
-    // Process the compression pipeline
-    // we use 1.5 the memory buffer as intermediate location // no we don't, do we?
-    const size_t buffer_tmp_offset = 2 * datatypes_size + 10;
-    byte *restrict buff_tmp = &dest[buffer_tmp_offset];
+    // Process the compression pipeline, a single algorithm writes directly into dest
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    byte *restrict buff_tmp = NULL;
+    if (total_compressors > 1) {
+        buff_tmp = (byte *) scilU_workspace_alloc(ctx->workspace, bound);
+        if (buff_tmp == NULL) {
+            ret = SCIL_MEMORY_ERR;
+            goto end;
+        }
+    }
+    // indexed by enum scilC_buffer
+    void *buffers[] = {source, dest, buff_tmp};
 
-    // process the compression chain
     // apply the first pre-conditioners
     if (chain->precond_first_count > 0) {
-        out_size += datatypes_size;
-        // add the header at the end of the preconditioners
-        byte *header = datatypes_size +
-                       (byte *) pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_first_count,
-                                            source, dest, buff_tmp, dest);
-
-        for (int i = 0; i < chain->precond_first_count; i++) {
-            int header_size_out;
-            scilU_algorithm_t *algo = chain->pre_cond_first[i];
-            void *src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-            void *dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-
-            switch (ctx->datatype) {
-                case (SCIL_TYPE_FLOAT):
-                    ret = algo->c.PFtype.compress_float(ctx, (float *) dst, header, &header_size_out, src,
-                                                        resized_dims);
-                    break;
-                case (SCIL_TYPE_DOUBLE):
-                    ret = algo->c.PFtype.compress_double(ctx, (double *) dst, header, &header_size_out, src,
-                                                         resized_dims);
-                    break;
-                case (SCIL_TYPE_INT8) :
-                    ret = algo->c.PFtype.compress_int8(ctx, (int8_t *) dst, header, &header_size_out, src,
-                                                       resized_dims);
-                    break;
-                case (SCIL_TYPE_INT16) :
-                    ret = algo->c.PFtype.compress_int16(ctx, (int16_t *) dst, header, &header_size_out, src,
-                                                        resized_dims);
-                    break;
-                case (SCIL_TYPE_INT32) :
-                    ret = algo->c.PFtype.compress_int32(ctx, (int32_t *) dst, header, &header_size_out, src,
-                                                        resized_dims);
-                    break;
-                case (SCIL_TYPE_INT64) :
-                    ret = algo->c.PFtype.compress_int64(ctx, (int64_t *) dst, header, &header_size_out, src,
-                                                        resized_dims);
-                    break;
-                case (SCIL_TYPE_UNKNOWN) :
-                case (SCIL_TYPE_STRING) :
-                case (SCIL_TYPE_BINARY) :
-                    assert(0);
-                    break;
-            }
-
-            if (ret != 0) return ret;
-            remaining_compressors--;
-            out_size += header_size_out;
-            header += header_size_out;
-            *header = algo->compressor_id;
-            debugI(
-                    "C compressor ID %d at pos %llu\n", *header, (long long unsigned) header)
-            header++;
-            out_size++;
-
-            // scilU_print_buffer(dst, out_size);
-        }
+        ret = compress_precond_stages(ctx, stage, chain->precond_first_count, buffers, plan->precond_first_header,
+                                      resized_dims, datatypes_size, &out_size);
+        if (ret != 0) goto end;
+        stage += chain->precond_first_count;
         input_size = out_size;
     }
 
     // Apply the converter
     if (chain->converter) {
-        // we need to preserve the header of the pre-conditioners.
-        void *src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-        void *dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-
-        // set the output size to the expected buffer size
-        out_size = (size_t) (datatypes_size * 2);
-
-        scilU_algorithm_t *algo = chain->converter;
-        switch (ctx->datatype) {
-            case (SCIL_TYPE_FLOAT):
-                ret = algo->c.Ctype.compress_float(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_DOUBLE):
-                ret = algo->c.Ctype.compress_double(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT8) :
-                ret = algo->c.Ctype.compress_int8(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT16) :
-                ret = algo->c.Ctype.compress_int16(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT32) :
-                ret = algo->c.Ctype.compress_int32(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT64) :
-                ret = algo->c.Ctype.compress_int64(ctx, (int64_t *) dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_UNKNOWN) :
-            case (SCIL_TYPE_BINARY) :
-            case (SCIL_TYPE_STRING) :
-                assert(0);
-                break;
-        }
-        if (ret != 0) return ret;
-        // check if we have to preserve another header from the preconditioners
-        if (datatypes_size != input_size) {
-            // we have to copy some header.
-            debugI("Preserving %lld %lld\n", (long long) datatypes_size, (long long) input_size);
-            const int preserve = input_size - datatypes_size;
-            memcpy((char *) dst + out_size, (char *) src + datatypes_size, preserve); // TODO: potential error
-            out_size += preserve;
-            scilU_print_buffer(dst, out_size);
-        }
-
-        remaining_compressors--;
-        ((char *) dst)[out_size] = algo->compressor_id;
-        debugI("C compressor ID %d at pos %llu\n", algo->compressor_id, (long long unsigned) &((char *) dst)[out_size]);
-
-        out_size++;
-        input_size = out_size;
+        ret = compress_data_stage(ctx, stage++, buffers, SCIL_STAGE_CONVERTER, resized_dims, datatypes_size, &input_size);
+        if (ret != 0) goto end;
+        out_size = input_size;
     }
 
     // apply the second pre-conditioners
     if (chain->precond_second_count > 0) {
-        out_size += datatypes_size;
-        // add the header at the end of the preconditioners
-        byte *header = datatypes_size +
-                       (byte *) pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_second_count,
-                                            source, dest, buff_tmp, dest);
-
-        for (int i = 0; i < chain->precond_second_count; i++) {
-            int header_size_out;
-            scilU_algorithm_t *algo = chain->pre_cond_second[i];
-            void *src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-            void *dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-
-            ret = algo->c.PStype.compress(ctx, (int64_t *) dst, header, &header_size_out, src, resized_dims);
-
-            if (ret != 0) return ret;
-            remaining_compressors--;
-            out_size += header_size_out;
-            header += header_size_out;
-
-            *header = algo->compressor_id;
-            debugI("C compressor ID %d at pos %llu\n", *header, (long long unsigned) header)
-            header++;
-            out_size++;
-
-            // scilU_print_buffer(dst, out_size);
-        }
+        ret = compress_precond_stages(ctx, stage, chain->precond_second_count, buffers, plan->precond_second_header,
+                                      resized_dims, datatypes_size, &out_size);
+        if (ret != 0) goto end;
+        stage += chain->precond_second_count;
         input_size = out_size;
     }
 
     // Apply the data compressor
     if (chain->data_compressor) {
-        // we need to preserve the header of the pre-conditioners.
-        void *src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-        void *dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-
-        // set the output size to the expected buffer size
-        out_size = (size_t) (datatypes_size * 2);
-
-        scilU_algorithm_t *algo = chain->data_compressor;
-        switch (ctx->datatype) {
-            case (SCIL_TYPE_FLOAT):
-                ret = algo->c.DNtype.compress_float(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_DOUBLE):
-                ret = algo->c.DNtype.compress_double(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT8) :
-                ret = algo->c.DNtype.compress_int8(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT16) :
-                ret = algo->c.DNtype.compress_int16(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT32) :
-                ret = algo->c.DNtype.compress_int32(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_INT64) :
-                ret = algo->c.DNtype.compress_int64(ctx, dst, &out_size, src, resized_dims);
-                break;
-            case (SCIL_TYPE_UNKNOWN) :
-            case (SCIL_TYPE_BINARY) :
-            case (SCIL_TYPE_STRING) :
-                assert(0);
-                break;
-        }
-        if (ret != 0) return ret;
-        // check if we have to preserve another header from the preconditioners
-        if (datatypes_size != input_size) {
-            // we have to copy some header.
-            debugI("Preserving %lld %lld\n", (long long) datatypes_size, (long long) input_size);
-            const int preserve = input_size - datatypes_size;
-            memcpy((char *) dst + out_size, (char *) src + datatypes_size, preserve);
-            out_size += preserve;
-            //scilU_print_buffer(dst, out_size);
-        }
-
-        remaining_compressors--;
-        ((char *) dst)[out_size] = algo->compressor_id;
-        debugI("C compressor ID %d at pos %llu\n", algo->compressor_id, (long long unsigned) &((char *) dst)[out_size]);
-
-        out_size++;
-        input_size = out_size;
+        ret = compress_data_stage(ctx, stage++, buffers, SCIL_STAGE_DATA_COMPRESSOR, resized_dims, datatypes_size, &input_size);
+        if (ret != 0) goto end;
+        out_size = input_size;
     }
 
     // Apply byte compressor
     if (chain->byte_compressor) {
-        void *src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-
-        // scilU_print_buffer(src, input_size);
-
-        ret = chain->byte_compressor->c.Btype.compress(ctx, dest, &out_size, (byte *) src, input_size);
-        if (ret != 0) return ret;
-        dest[out_size] = chain->byte_compressor->compressor_id;
-        debugI("C compressor ID %d at pos %llu\n",
-               chain->byte_compressor->compressor_id,
-               (long long unsigned) &dest[out_size]);
+        const byte *src = (const byte *) buffers[stage->src];
+        out_size = scilU_algorithm_compress_bound(stage->algo, ctx->datatype, input_size, input_size);
+        scil_timer stage_start = {0, 0};
+        scilC_stage_start(ctx, &stage_start);
+        ret = stage->algo->c.Btype.compress(ctx, dest, &out_size, src, input_size);
+        if (ret != 0) goto end;
+        scilC_stage_stop(ctx, SCIL_STAGE_BYTE_COMPRESSOR, stage_start, input_size, out_size);
+        dest[out_size] = stage->algo->compressor_id;
+        debugI("C compressor ID %d at pos %llu\n", stage->algo->compressor_id, (long long unsigned) &dest[out_size]);
 
         out_size++;
-        // scilU_print_buffer(dest, out_size);
     }
 
     *out_size_p = out_size + 1; // for the length of the processing chain
+
+    end:
+    scilU_workspace_release(ctx->workspace, mark);
+    return ret;
+}
+
+/*
+ * Skip the frame header of the compressed data and check that it matches the expected data.
+ * Data compressed without frame is passed as is.
+ */
+static int open_frame(SCIL_Datatype_t datatype, const scil_dims_t *resized_dims, byte **source, size_t *source_size) {
+    if (!scilC_is_frame(*source, *source_size)) {
+        return SCIL_NO_ERR;
+    }
+    scil_frame_header_t header;
+    int ret = scilC_frame_open(*source, *source_size, &header, source, source_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+    if (header.datatype != datatype || header.uncompressed_size != scil_dims_get_size(resized_dims, datatype)) {
+        return SCIL_EINVAL;
+    }
     return SCIL_NO_ERR;
 }
 
@@ -484,27 +639,38 @@ int scil_decompress(SCIL_Datatype_t datatype,
 
     assert(dest != NULL);
     assert(source != NULL);
-    assert(buff_tmp1 != NULL);
 
-    scil_dims_t *resized_dims = malloc(sizeof(scil_dims_t));
-    memset(resized_dims, 0, sizeof(scil_dims_t));
+    scil_dims_t resized_dims;
+    scilC_resize_dims(&resized_dims, dims);
 
-    if (dims->dims > 4) {
-        resized_dims->dims = 4;
-        for (int i = 0; i < dims->dims; i++) {
-            if (i > 3) {
-                resized_dims->length[3] *= dims->length[i];
-            } else {
-                resized_dims->length[i] = dims->length[i];
-            }
-        }
-    } else {
-        resized_dims->dims = dims->dims;
-        for (int i = 0; i < dims->dims; i++) {
-            resized_dims->length[i] = dims->length[i];
-        }
+    byte *payload = source;
+    size_t payload_size = source_size;
+    int ret = open_frame(datatype, &resized_dims, &payload, &payload_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    if (scilC_is_block_container(payload, payload_size)) {
+        return scilC_block_decompress(datatype, dest, &resized_dims, payload, payload_size);
     }
+    if (scilC_is_stream_container(payload, payload_size)) {
+        return scilC_stream_decompress(datatype, dest, &resized_dims, payload, payload_size);
+    }
+    assert(buff_tmp1 != NULL);
+    return scilC_decompress_chain(datatype, dest, &resized_dims, payload, payload_size, buff_tmp1);
+}
+
+size_t scilC_decompress_chain_tmp_size(size_t uncompressed_size) {
+    // two buffers for the intermediate results
+    return 2 * (2 * uncompressed_size + 10);
+}
 
+int scilC_decompress_chain(SCIL_Datatype_t datatype,
+                           void *restrict dest,
+                           scil_dims_t *resized_dims,
+                           byte *restrict source,
+                           const size_t source_size,
+                           byte *restrict buff_tmp1) {
     // Read compressor ID (algorithm id) from header
     const int total_compressors = (uint8_t) source[0];
     int remaining_compressors = total_compressors;
@@ -514,7 +680,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
     int ret;
 
     const size_t output_size = scil_dims_get_size(resized_dims, datatype);
-    byte *restrict buff_tmp2 = &buff_tmp1[(int) (output_size * 2 + 10)];
+    byte *restrict buff_tmp2 = &buff_tmp1[output_size * 2 + 10];
 
     // for(int i=0; i < chain_size; i++){
     src_size--;
@@ -531,7 +697,9 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void *src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void *dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
-        ret = algo->c.Btype.decompress(dst, output_size * 2 + 10, (byte *) src, src_size, &src_size);
+        // the final result is written into dest that has just the size of the data
+        const size_t dst_size = dst == dest ? output_size : output_size * 2 + 10;
+        ret = algo->c.Btype.decompress(dst, dst_size, (byte *) src, src_size, &src_size);
         if (ret != 0) return ret;
         remaining_compressors--;
 
@@ -557,31 +725,11 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void *src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void *dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
-        switch (datatype) {
-            case (SCIL_TYPE_FLOAT):
-                ret = algo->c.DNtype.decompress_float(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_DOUBLE):
-                ret = algo->c.DNtype.decompress_double(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT8) :
-                ret = algo->c.DNtype.decompress_int8(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT16) :
-                ret = algo->c.DNtype.decompress_int16(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT32) :
-                ret = algo->c.DNtype.decompress_int32(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT64) :
-                ret = algo->c.DNtype.decompress_int64(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_UNKNOWN) :
-            case (SCIL_TYPE_BINARY) :
-            case (SCIL_TYPE_STRING) :
-                assert(0);
-                break;
+        const scilC_data_decompress_func_t decompress = scilC_data_decompress_func(algo, datatype);
+        if (decompress == NULL) {
+            return SCIL_BUFFER_ERR;
         }
+        ret = decompress(algo, dst, resized_dims, src, src_size);
 
         if (ret != 0) return ret;
         remaining_compressors--;
@@ -618,31 +766,11 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void *src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void *dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
-        switch (datatype) {
-            case (SCIL_TYPE_FLOAT):
-                ret = algo->c.Ctype.decompress_float(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_DOUBLE):
-                ret = algo->c.Ctype.decompress_double(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT8) :
-                ret = algo->c.Ctype.decompress_int8(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT16) :
-                ret = algo->c.Ctype.decompress_int16(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT32) :
-                ret = algo->c.Ctype.decompress_int32(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_INT64) :
-                ret = algo->c.Ctype.decompress_int64(dst, resized_dims, src, src_size);
-                break;
-            case (SCIL_TYPE_UNKNOWN) :
-            case (SCIL_TYPE_BINARY) :
-            case (SCIL_TYPE_STRING) :
-                assert(0);
-                break;
+        const scilC_data_decompress_func_t decompress = scilC_converter_decompress_func(algo, datatype);
+        if (decompress == NULL) {
+            return SCIL_BUFFER_ERR;
         }
+        ret = decompress(algo, dst, resized_dims, src, src_size);
 
         if (ret != 0) return ret;
         remaining_compressors--;
@@ -665,31 +793,11 @@ int scil_decompress(SCIL_Datatype_t datatype,
             return SCIL_BUFFER_ERR;
         }
 
-        switch (datatype) {
-            case (SCIL_TYPE_FLOAT):
-                ret = algo->c.PFtype.decompress_float(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_DOUBLE):
-                ret = algo->c.PFtype.decompress_double(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_INT8) :
-                ret = algo->c.PFtype.decompress_int8(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_INT16) :
-                ret = algo->c.PFtype.decompress_int16(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_INT32) :
-                ret = algo->c.PFtype.decompress_int32(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_INT64) :
-                ret = algo->c.PFtype.decompress_int64(dst, resized_dims, src, header, &header_parsed);
-                break;
-            case (SCIL_TYPE_UNKNOWN) :
-            case (SCIL_TYPE_BINARY) :
-            case (SCIL_TYPE_STRING) :
-                assert(0);
-                break;
+        const scilC_precond_decompress_func_t decompress = scilC_precond_first_decompress_func(algo, datatype);
+        if (decompress == NULL) {
+            return SCIL_BUFFER_ERR;
         }
+        ret = decompress(algo, dst, resized_dims, src, header, &header_parsed);
         header -= header_parsed;
 
         if (ret != 0) return ret;
@@ -711,6 +819,38 @@ int scil_decompress(SCIL_Datatype_t datatype,
     return SCIL_NO_ERR;
 }
 
+int scil_decompress_region(SCIL_Datatype_t datatype,
+                           void *restrict dest,
+                           scil_dims_t *full_dims,
+                           scil_dims_t *offset,
+                           scil_dims_t *count,
+                           byte *restrict source,
+                           const size_t source_size) {
+    assert(dest != NULL);
+    assert(source != NULL);
+
+    if (offset->dims != full_dims->dims || count->dims != full_dims->dims || full_dims->dims == 0) {
+        return SCIL_EINVAL;
+    }
+    for (int i = 0; i < full_dims->dims; i++) {
+        if (count->length[i] == 0 || offset->length[i] + count->length[i] > full_dims->length[i]) {
+            return SCIL_EINVAL;
+        }
+    }
+
+    scil_dims_t resized_dims;
+    scilC_resize_dims(&resized_dims, full_dims);
+
+    byte *payload = source;
+    size_t payload_size = source_size;
+    int ret = open_frame(datatype, &resized_dims, &payload, &payload_size);
+    if (ret != SCIL_NO_ERR) {
+        return ret;
+    }
+
+    return scilC_decompress_region(datatype, dest, full_dims, &resized_dims, offset, count, payload, payload_size);
+}
+
 void scil_determine_accuracy(SCIL_Datatype_t datatype,
                              const void *restrict data_1,
                              const void *restrict data_2,
@@ -797,41 +937,70 @@ void scil_determine_accuracy(SCIL_Datatype_t datatype,
     *out_hints = a;
 }
 
+int scilC_check_accuracy(SCIL_Datatype_t datatype, const scil_user_hints_t *h, const scil_user_hints_t *a) {
+    // check if tolerance level is met:
+    int ret = SCIL_NO_ERR;
+    if (h->absolute_tolerance > 0.0 && a->absolute_tolerance > h->absolute_tolerance) {
+        if (datatype != SCIL_TYPE_FLOAT || (a->absolute_tolerance - h->absolute_tolerance) > FLT_FINEST_SUB_float) {
+            debug("Validation error absolute_tolerance %f > %f\n",
+                  a->absolute_tolerance,
+                  h->absolute_tolerance);
+            ret = SCIL_PRECISION_ERR;
+        }
+    }
+    if (h->relative_tolerance_percent > 0.0 && a->relative_tolerance_percent > h->relative_tolerance_percent) {
+        debug("Validation error relative_tolerance_percent %f > %f\n",
+              a->relative_tolerance_percent,
+              h->relative_tolerance_percent);
+        ret = SCIL_PRECISION_ERR;
+    }
+    if (h->relative_err_finest_abs_tolerance > 0.0 && a->relative_err_finest_abs_tolerance >
+                                                     h->relative_err_finest_abs_tolerance) {
+        debug(
+                "Validation error relative_err_finest_abs_tolerance %f > %f\n",
+                a->relative_err_finest_abs_tolerance,
+                h->relative_err_finest_abs_tolerance);
+        ret = SCIL_PRECISION_ERR;
+    }
+    if (a->significant_digits < h->significant_digits) {
+        debug("Validation error significant_digits %d < %d\n",
+              a->significant_digits,
+              h->significant_digits);
+        ret = SCIL_PRECISION_ERR;
+    }
+    if (a->significant_bits < h->significant_bits) {
+        debug("Validation error significant_bits %d < %d\n",
+              a->significant_bits,
+              h->significant_bits);
+        ret = SCIL_PRECISION_ERR;
+    }
+    return ret;
+}
+
 int scil_validate_compression(SCIL_Datatype_t datatype, const void *restrict data_uncompressed, scil_dims_t *dims,
                               byte *restrict data_compressed, const size_t compressed_size, const scil_context_t *ctx,
                               scil_user_hints_t *out_accuracy, scil_validate_params_t *out_validation) {
-    scil_dims_t *resized_dims = malloc(sizeof(scil_dims_t));
-    memset(resized_dims, 0, sizeof(scil_dims_t));
+    scil_dims_t resized_dims_buf;
+    scil_dims_t *resized_dims = &resized_dims_buf;
+    scilC_resize_dims(resized_dims, dims);
 
     scil_validate_params_t validation_params;
-
-    if (dims->dims > 4) {
-        resized_dims->dims = 4;
-        for (int i = 0; i < dims->dims; i++) {
-            if (i > 3) {
-                resized_dims->length[3] *= dims->length[i];
-            } else {
-                resized_dims->length[i] = dims->length[i];
-            }
-        }
-    } else {
-        resized_dims->dims = dims->dims;
-        for (int i = 0; i < dims->dims; i++) {
-            resized_dims->length[i] = dims->length[i];
-        }
-    }
-    const uint64_t length = scil_get_compressed_data_size_limit(resized_dims, datatype);
-    byte *data_out = (byte *) malloc(length);
-    if (data_out == NULL) {
-        return SCIL_MEMORY_ERR;
-    }
+    const size_t length = scil_dims_get_size(resized_dims, datatype);
+    const scilU_workspace_mark_t mark = scilU_workspace_mark(ctx->workspace);
+    byte *data_out = (byte *) scilU_workspace_alloc(ctx->workspace, length);
+    byte *buff_tmp = (byte *) scilU_workspace_alloc(ctx->workspace, scilC_decompress_chain_tmp_size(length));
     scil_user_hints_t a;
     scil_user_hints_initialize(&a);
+    memset(&validation_params, 0, sizeof(validation_params));
 
+    int ret;
+    if (data_out == NULL || buff_tmp == NULL) {
+        ret = SCIL_MEMORY_ERR;
+        goto end;
+    }
     memset(data_out, -1, length);
 
-    int ret = scil_decompress(datatype, data_out, resized_dims, data_compressed, compressed_size,
-                              &data_out[length / 2]);
+    ret = scil_decompress(datatype, data_out, resized_dims, data_compressed, compressed_size, buff_tmp);
     if (ret != 0) {
         goto end;
     }
@@ -854,47 +1023,10 @@ int scil_validate_compression(SCIL_Datatype_t datatype, const void *restrict dat
         scil_determine_accuracy(datatype, data_out, data_uncompressed, resized_dims,
                                 ctx->hints.relative_err_finest_abs_tolerance, &a, &validation_params);
 
-        const scil_user_hints_t h = ctx->hints;
-
-        // check if tolerance level is met:
-        ret = SCIL_NO_ERR;
-        if (h.absolute_tolerance > 0.0 && a.absolute_tolerance > h.absolute_tolerance) {
-            if (datatype != SCIL_TYPE_FLOAT || (a.absolute_tolerance - h.absolute_tolerance) > FLT_FINEST_SUB_float) {
-                debug("Validation error absolute_tolerance %f > %f\n",
-                      a.absolute_tolerance,
-                      h.absolute_tolerance);
-                ret = SCIL_PRECISION_ERR;
-            }
-        }
-        if (h.relative_tolerance_percent > 0.0 && a.relative_tolerance_percent > h.relative_tolerance_percent) {
-            debug("Validation error relative_tolerance_percent %f > %f\n",
-                  a.relative_tolerance_percent,
-                  h.relative_tolerance_percent);
-            ret = SCIL_PRECISION_ERR;
-        }
-        if (h.relative_err_finest_abs_tolerance > 0.0 && a.relative_err_finest_abs_tolerance >
-                                                         h.relative_err_finest_abs_tolerance) {
-            debug(
-                    "Validation error relative_err_finest_abs_tolerance %f > %f\n",
-                    a.relative_err_finest_abs_tolerance,
-                    h.relative_err_finest_abs_tolerance);
-            ret = SCIL_PRECISION_ERR;
-        }
-        if (a.significant_digits < h.significant_digits) {
-            debug("Validation error significant_digits %d < %d\n",
-                  a.significant_digits,
-                  h.significant_digits);
-            ret = SCIL_PRECISION_ERR;
-        }
-        if (a.significant_bits < h.significant_bits) {
-            debug("Validation error significant_bits %d < %d\n",
-                  a.significant_bits,
-                  h.significant_bits);
-            ret = SCIL_PRECISION_ERR;
-        }
+        ret = scilC_check_accuracy(datatype, &ctx->hints, &a);
     }
     end:
-    free(data_out);
+    scilU_workspace_release(ctx->workspace, mark);
     *out_validation = validation_params;
     *out_accuracy = a;
 
@@ -349,20 +349,64 @@ folder "Install directory"{
 
 #include <scil-datatypes.h>
 
+// the version of the frame written by scil_compress()
+#define SCIL_FRAME_VERSION 1
+
+// the maximum length of a compression chain
+#define SCIL_FRAME_CHAIN_MAX 23
+
+/**
+ * \brief The information stored in the header of compressed data.
+ */
+typedef struct {
+    uint8_t version;
+    SCIL_Datatype_t datatype;
+
+    /** \brief The dims of the uncompressed data as given to scil_compress() */
+    scil_dims_t dims;
+    uint64_t uncompressed_size;
+
+    /** \brief The compressor IDs in the order of application */
+    uint8_t chain_length;
+    uint8_t chain[SCIL_FRAME_CHAIN_MAX];
+
+    /** \brief CRC32 of the payload, enabled with the hint checksum */
+    int has_checksum;
+    uint32_t checksum;
+
+    /** \brief The size of the header, the payload follows it */
+    size_t header_size;
+
+    /** \brief The size of the tmp_buff required by scil_decompress(), 0 if NULL can be passed */
+    size_t tmp_buffer_size;
+} scil_frame_header_t;
+
 void scil_compression_sprint_last_algorithm_chain(scil_context_t* ctx,
                                                   char* out,
                                                   int buff_length);
 
+/**
+ * \brief The worst case size of the compressed data, i.e., the dest_size required by scil_compress().
+ * It accounts for the chain of the context, or all chains the automatic selection may pick if no chain is set yet.
+ * \param ctx Reference to the compression context
+ * \param dims The dims of the data to compress
+ * \return The size in bytes
+ */
+size_t scil_compress_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
 /**
  * \brief Method to compress a data buffer
  * \param dest Destination of the compressed buffer
- * \param dest_size Reference to the compressed buffer byte size, max size is
- * given as argument, if a pipeline is processed it should be 3x the memory size
- * of the input size + the HEADER.
+ * \param dest_size The size of dest, it must be at least scil_compress_bound(),
+ * otherwise SCIL_MEMORY_ERR is returned. Intermediate results are kept in internal memory.
  * \param source Source buffer of the data to compress
  * \param dims struct containing information about dimension count and length of
  * buffer in each dimension
  * \param ctx Reference to the compression context
+ * If the hint parallel_threads is larger than 1 or parallel_block_size is set,
+ * the data is split along the slowest varying dimension into blocks of
+ * parallel_block_size bytes that are compressed independently, using multiple
+ * threads if requested. The output does not depend on the number of threads.
  * \pre datatype == 0 || datatype == 1
  * \pre dest != NULL
  * \pre dest_size != NULL
@@ -377,6 +421,81 @@ int scil_compress(byte* restrict dest,
                   size_t* restrict out_size,
                   scil_context_t* ctx);
 
+/**
+ * \brief Called when an asynchronous compression is finished, it is executed by a thread of the library.
+ * \param ret The return value of scil_compress()
+ * \param out_size The size of the compressed data
+ */
+typedef void (*scil_compress_callback_t)(void* user_ptr, int ret, size_t out_size);
+
+struct scil_request;
+typedef struct scil_request scil_request_t;
+
+/**
+ * \brief Start scil_compress() on a thread of the library and return immediately.
+ * The buffers and ctx must not be used otherwise until the compression is finished, dims is copied,
+ * several requests can run concurrently if they use different contexts.
+ * If the number of unfinished requests reached the queue depth, the call waits for one of them first.
+ * The depth can be set by the environment variable SCIL_ASYNC_QUEUE_DEPTH, it is twice the number of threads by default.
+ * \param callback If not NULL, it is called once the compression is finished; it must not submit further requests
+ * \param out_request If not NULL, set to the handle that must be passed to scil_wait(),
+ * otherwise the request cannot be waited for and is freed after the callback
+ * \return SCIL_NO_ERR once the request is submitted, the result of the compression is reported later
+ */
+int scil_compress_async(byte* dest,
+                        size_t dest_size,
+                        void* source,
+                        scil_dims_t* dims,
+                        scil_context_t* ctx,
+                        scil_compress_callback_t callback,
+                        void* user_ptr,
+                        scil_request_t** out_request);
+
+/**
+ * \brief Wait for the request to finish and free it.
+ * \param out_size If not NULL, set to the size of the compressed data
+ * \return The return value of scil_compress()
+ */
+int scil_wait(scil_request_t* request, size_t* out_size);
+
+/**
+ * \brief Check whether the request is finished without waiting, it must still be passed to scil_wait().
+ * \param out_done Set to 1 if the request is finished, the callback has been executed then
+ */
+int scil_test(scil_request_t* request, int* out_done);
+
+/**
+ * \brief A variable compressed by scil_compress_batch()
+ */
+typedef struct {
+    void* source;
+    scil_dims_t dims;
+    SCIL_Datatype_t datatype;
+    /** \brief Items with the same hints pointer and datatype share a context, NULL uses the default hints */
+    const scil_user_hints_t* hints;
+    /** \brief Identifies the variable for the decisions of the chooser, may be NULL */
+    const char* name;
+    byte* dest;
+    /** \brief The size of dest, see scil_compress_bound() */
+    size_t dest_size;
+
+    /** \brief Set by scil_compress_batch(): the size of the compressed data */
+    size_t out_size;
+    /** \brief Set by scil_compress_batch(): the return value of the compression of this item */
+    int ret;
+} scil_batch_item_t;
+
+/**
+ * \brief Compress many variables with a single call, e.g., all variables of a time step.
+ * The items are distributed dynamically over the threads of the library, the largest items are started first.
+ * The contexts and the scratch memory are shared between the items compressed by the same thread,
+ * hence the cost per item is lower than that of individual calls to scil_compress().
+ * \param items The variables, their out_size and ret are set
+ * \param count The number of items
+ * \return SCIL_NO_ERR if all items are compressed, otherwise the error of the first failed item
+ */
+int scil_compress_batch(scil_batch_item_t* items, size_t count);
+
 /**
  * \brief Method to decompress a data buffer
  * \param datatype The datatype of the data (float, double, etc...)
@@ -387,7 +506,10 @@ int scil_compress(byte* restrict dest,
  * \pre datatype == 0 || datatype == 1
  * \pre dest != NULL
  * \pre source != NULL
- * \pre tmp_buff != NULL with a size of scil_get_compressed_data_size_limit() / 2
+ * \pre tmp_buff != NULL with a size of scil_get_compressed_data_size_limit() / 2,
+ * or the tmp_buffer_size reported by scil_peek_header()
+ * A block container is decompressed in parallel, the number of threads can be
+ * set using the environment variable SCIL_THREADS.
  * \return Success state of the decompression
  */
 int scil_decompress(SCIL_Datatype_t datatype,
@@ -397,6 +519,107 @@ int scil_decompress(SCIL_Datatype_t datatype,
                     const size_t source_size,
                     byte* restrict tmp_buff);
 
+/**
+ * \brief Read the header of compressed data without decompressing the payload
+ * \param source Source buffer of compressed data, at least the header must be available
+ * \param source_size Byte size of the source buffer
+ * \param out_header The information about the compressed data
+ * \return SCIL_EINVAL if the data has no frame header (e.g. written by an old version)
+ */
+int scil_peek_header(const byte* source, size_t source_size, scil_frame_header_t* out_header);
+
+/**
+ * \brief Method to decompress a hyperslab of a data buffer
+ * \param datatype The datatype of the data (float, double, etc...)
+ * \param dest Destination of the region, the data is stored densely with the dims count
+ * \param full_dims Dimensional information about the complete decompressed buffer
+ * \param offset The first element of the region in each dimension
+ * \param count The number of elements of the region in each dimension
+ * \param source Source buffer of data to decompress
+ * \param source_size Byte size of compressed data source buffer
+ * If the data has been compressed in blocks (see the hint parallel_block_size),
+ * only the blocks overlapping the region are decompressed.
+ * \return Success state of the decompression
+ */
+int scil_decompress_region(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           scil_dims_t* full_dims,
+                           scil_dims_t* offset,
+                           scil_dims_t* count,
+                           byte* restrict source,
+                           const size_t source_size);
+
+/**
+ * \brief Receives the compressed data of a stream in order.
+ * \return SCIL_NO_ERR, any other value aborts the stream and is returned by the stream function
+ */
+typedef int (*scil_stream_write_func_t)(void* user_ptr, const byte* data, size_t size);
+
+/**
+ * \brief Provides the next size bytes of a compressed stream.
+ * \return SCIL_NO_ERR if all size bytes have been read
+ */
+typedef int (*scil_stream_read_func_t)(void* user_ptr, byte* data, size_t size);
+
+struct scil_stream;
+typedef struct scil_stream scil_stream_t;
+
+struct scil_stream_reader;
+typedef struct scil_stream_reader scil_stream_reader_t;
+
+/**
+ * \brief Start the compression of data that is provided piece by piece with scil_stream_push().
+ * The data is split along the slowest varying dimension into blocks of parallel_block_size bytes,
+ * each block is compressed and written as soon as its data is complete, hence the memory needed
+ * depends on the block size but not the size of the data.
+ * Unless the chain is forced, it is selected for the first block and used for all blocks.
+ * If such a lossy chain misses the hints on a block, a lossless chain is used from that block on,
+ * the frame names the chain of the first block.
+ * The output is a frame without checksum that can be decompressed by scil_decompress() or scil_stream_open().
+ * \param ctx The context must not be used otherwise until scil_stream_end()
+ * \param dims The dims of the complete data
+ * \param write Receives the compressed data
+ * \return SCIL_EINVAL if the data is empty
+ */
+int scil_stream_begin(scil_stream_t** out_stream,
+                      scil_context_t* ctx,
+                      const scil_dims_t* dims,
+                      scil_stream_write_func_t write,
+                      void* user_ptr);
+
+/**
+ * \brief Append the next elements of the data in memory order, e.g., a level of the slowest varying dimension.
+ * \param count The number of elements in data, any number can be pushed at once
+ * \return SCIL_EINVAL if more elements are pushed than the dims hold
+ */
+int scil_stream_push(scil_stream_t* stream, const void* data, size_t count);
+
+/**
+ * \brief Finish the stream and free it, also if an error occurred before.
+ * \param out_size If not NULL, set to the number of bytes written
+ * \return SCIL_EINVAL if fewer elements were pushed than the dims hold, or the first error of the stream
+ */
+int scil_stream_end(scil_stream_t* stream, size_t* out_size);
+
+/**
+ * \brief Start to decompress a stream written by scil_stream_begin(), the frame header is read immediately.
+ * \param out_header If not NULL, set to the header of the stream, it provides datatype and dims
+ * \return SCIL_EINVAL if the data is not a stream
+ */
+int scil_stream_open(scil_stream_reader_t** out_reader,
+                     scil_stream_read_func_t read,
+                     void* user_ptr,
+                     scil_frame_header_t* out_header);
+
+/**
+ * \brief Read and decompress the next block of the stream.
+ * \param out_data Set to the decompressed elements that follow the previous block, they stay valid until the next call
+ * \param out_count Set to the number of elements, 0 after the last block
+ */
+int scil_stream_pull(scil_stream_reader_t* reader, const void** out_data, size_t* out_count);
+
+int scil_stream_close(scil_stream_reader_t* reader);
+
 void scil_determine_accuracy(SCIL_Datatype_t datatype,
                              const void* restrict data_1,
                              const void* restrict data_2,
@@ -0,0 +1,128 @@
+// Checks the streaming bit packing of abstol against scil_swage and the tiled abstol codec through the library.
+#include <scil.h>
+#include <scil-swager.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ABS_TOL 0.01
+
+static void check_stream(const uint64_t* values, size_t count, uint8_t bits, byte* expected, byte* packed, uint64_t* unpacked){
+    memset(expected, 0, count * 8 + 1);
+    scil_swage(expected, values, count, bits);
+
+    // push and pull the values in steps of varying length
+    scil_swage_stream_t stream;
+    scil_swage_stream_begin(&stream, packed);
+    for(size_t i = 0; i < count; ){
+        size_t n = 1 + rand() % 100;
+        n = n > count - i ? count - i : n;
+        scil_swage_stream_push(&stream, values + i, n, bits);
+        i += n;
+    }
+    const size_t size = scil_swage_stream_end(&stream, packed);
+    assert(size == (count * bits + 7) / 8);
+    assert(memcmp(expected, packed, size) == 0);
+
+    scil_unswage_stream_t in;
+    scil_unswage_stream_begin(&in, packed);
+    for(size_t i = 0; i < count; ){
+        size_t n = 1 + rand() % 100;
+        n = n > count - i ? count - i : n;
+        scil_unswage_stream_pull(&in, unpacked + i, n, bits);
+        i += n;
+    }
+    assert(in.in == packed + size);
+    assert(memcmp(values, unpacked, count * sizeof(uint64_t)) == 0);
+}
+
+static double value_at(SCIL_Datatype_t datatype, const void* data, size_t i){
+    return datatype == SCIL_TYPE_FLOAT ? (double) ((const float*) data)[i] : ((const double*) data)[i];
+}
+
+static void check_abstol(SCIL_Datatype_t datatype, size_t count, double fill_value){
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    void* data = malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        const double v = (i % 7 == 3 && fill_value < DBL_MAX) ? fill_value : (double) (i % 1000) * 0.013 - 5;
+        if(datatype == SCIL_TYPE_FLOAT){
+            ((float*) data)[i] = (float) v;
+        }else{
+            ((double*) data)[i] = v;
+        }
+    }
+
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = ABS_TOL;
+    hints.fill_value = fill_value;
+    hints.force_compression_methods = "abstol";
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    const size_t bound = scil_compress_bound(ctx, &dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t size;
+    ret = scil_compress(compressed, bound, data, &dims, &size, ctx);
+    assert(ret == SCIL_NO_ERR);
+
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, size, &header) == SCIL_NO_ERR);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    void* result = malloc(count * sizeof(double));
+    ret = scil_decompress(datatype, result, &dims, compressed, size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; i++){
+        const double expected = value_at(datatype, data, i);
+        const double got = value_at(datatype, result, i);
+        if(expected <= fill_value && expected >= fill_value){
+            assert(got <= fill_value && got >= fill_value);
+        }else{
+            assert(fabs(got - expected) <= ABS_TOL * 1.0001);
+        }
+    }
+
+    free(result);
+    free(tmp);
+    free(compressed);
+    free(data);
+    scil_destroy_context(ctx);
+}
+
+int main(void){
+    const size_t count = 1000;
+    uint64_t* values = (uint64_t*) malloc(count * sizeof(uint64_t));
+    uint64_t* unpacked = (uint64_t*) malloc(count * sizeof(uint64_t));
+    byte* expected = (byte*) malloc(count * 8 + 1);
+    byte* packed = (byte*) malloc(count * 8 + 1);
+
+    srand(1);
+    for(uint8_t bits = 1; bits <= 64; bits++){
+        const uint64_t mask = bits == 64 ? UINT64_MAX : (((uint64_t) 1) << bits) - 1;
+        for(size_t i = 0; i < count; i++){
+            values[i] = (((uint64_t) rand() << 40) ^ ((uint64_t) rand() << 20) ^ (uint64_t) rand()) & mask;
+        }
+        check_stream(values, count, bits, expected, packed, unpacked);
+    }
+    free(values);
+    free(unpacked);
+    free(expected);
+    free(packed);
+
+    // the tiled codec through the library, the counts cover partial tiles and the fill value
+    const size_t counts[] = {1, 255, 256, 257, 10007};
+    for(int c = 0; c < 5; c++){
+        check_abstol(SCIL_TYPE_DOUBLE, counts[c], DBL_MAX);
+        check_abstol(SCIL_TYPE_DOUBLE, counts[c], -999);
+        check_abstol(SCIL_TYPE_FLOAT, counts[c], DBL_MAX);
+        check_abstol(SCIL_TYPE_FLOAT, counts[c], -999);
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Checks that the trial chooser selects a usable chain, honours the accuracy hints and the hardware limits.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-algo-chooser.h>
+#include <scil-decision-cache.h>
+#include <scil-energy.h>
+#include <scil-hardware-limits.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// compress and decompress the data with a new context, returns the context for inspection
+static scil_context_t* roundtrip(const scil_user_hints_t* hints, double* data, scil_dims_t* dims){
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t size = scil_dims_get_size(dims, SCIL_TYPE_DOUBLE);
+    const size_t bound = scil_compress_bound(ctx, dims);
+    byte* compressed = (byte*) malloc(bound);
+    double* result = (double*) malloc(size);
+    byte* tmp = (byte*) malloc(scil_get_compressed_data_size_limit(dims, SCIL_TYPE_DOUBLE) * 2);
+
+    size_t compressed_size;
+    ret = scil_compress(compressed, bound, data, dims, &compressed_size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    assert(ctx->chain.total_size > 0);
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, result, dims, compressed, compressed_size, tmp);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t count = scil_dims_get_count(dims);
+    for(size_t i = 0; i < count; i++){
+        if(ctx->chain.is_lossy){
+            assert(fabs(result[i] - data[i]) <= hints->absolute_tolerance);
+        }else{
+            assert(result[i] == data[i]);
+        }
+    }
+
+    char name[1024];
+    scil_compression_sprint_last_algorithm_chain(ctx, name, sizeof(name));
+    printf("chain: %s ratio: %.3f (sampled %.3f) compression: %.1f MiB/s\n", name, (double) compressed_size / size,
+           ctx->chooser_estimate.ratio, ctx->chooser_estimate.compression_speed);
+    free(compressed);
+    free(result);
+    free(tmp);
+    return ctx;
+}
+
+int main(void){
+    const size_t count = 200 * 100 * 30;
+    double* data = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (double) (i % 1000);
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_3d(&dims, 200, 100, 30);
+
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+
+    // the candidates depend on the accuracy hints
+    scil_context_t* ctx;
+    scil_compression_chain_t candidates[SCIL_CHOOSER_CANDIDATES_MAX];
+    scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    const int lossless_count = scilC_algo_chooser_candidates(ctx, &dims, candidates);
+    assert(lossless_count >= 2);
+    for(int i = 0; i < lossless_count; i++){
+        assert(! candidates[i].is_lossy);
+    }
+    scil_destroy_context(ctx);
+
+    // the decision is taken once and kept for the following calls with the same variable
+    ctx = roundtrip(&hints, data, &dims);
+    assert(ctx->chooser_estimate_valid && ctx->chooser_estimate.ratio > 0);
+    const scilC_chooser_estimate_t estimate = ctx->chooser_estimate;
+    size_t size;
+    const size_t bound = scil_compress_bound(ctx, &dims);
+    byte* compressed = (byte*) malloc(bound);
+    assert(scil_compress(compressed, bound, data, &dims, &size, ctx) == SCIL_NO_ERR);
+    assert(memcmp(&estimate, &ctx->chooser_estimate, sizeof(estimate)) == 0);
+    free(compressed);
+    scil_destroy_context(ctx);
+
+    // a slow storage makes the ratio dominate the expected time
+    scilU_add_hardware_limit("storage", "1");
+    scilC_decision_cache_clear();
+    ctx = roundtrip(&hints, data, &dims);
+    assert(ctx->chooser_estimate.ratio < 0.5);
+    scil_destroy_context(ctx);
+    scilU_initialize_hardware_limits();
+
+    // the smallest size is selected regardless of the time
+    hints.objective = SCIL_OBJECTIVE_RATIO;
+    ctx = roundtrip(&hints, data, &dims);
+    assert(ctx->chooser_estimate.ratio <= estimate.ratio);
+    assert(ctx->chooser_estimate.ratio < 0.5);
+    scil_destroy_context(ctx);
+
+    // without energy to wait for the transfer the cheapest computation wins
+    assert(scilU_energy_select("model") == SCIL_NO_ERR);
+    scilU_add_hardware_limit("power_active", "100");
+    scilU_add_hardware_limit("power_idle", "0.000001");
+    hints.objective = SCIL_OBJECTIVE_ENERGY;
+    ctx = roundtrip(&hints, data, &dims);
+    assert(ctx->chooser_estimate.energy > 0);
+    char name[1024];
+    scil_compression_sprint_last_algorithm_chain(ctx, name, sizeof(name));
+    assert(strcmp(name, "memcopy") == 0);
+    scil_destroy_context(ctx);
+    scilU_initialize_hardware_limits();
+    hints.objective = SCIL_OBJECTIVE_TIME;
+
+    // lossy chains are validated on the samples
+    hints.absolute_tolerance = 0.5;
+    for(size_t i = 0; i < count; i++){
+        data[i] = sin(i * 0.001) * 100;
+    }
+    scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(scilC_algo_chooser_candidates(ctx, &dims, candidates) > lossless_count);
+    scil_destroy_context(ctx);
+    ctx = roundtrip(&hints, data, &dims);
+    scil_destroy_context(ctx);
+
+    // a lossy chain that meets the hints only on the samples is replaced by a lossless chain,
+    // the rows 100 to 900 are not sampled and their small values miss the relative tolerance of abstol
+    hints.relative_tolerance_percent = 1;
+    hints.objective = SCIL_OBJECTIVE_RATIO;
+    for(size_t i = 0; i < count; i++){
+        const size_t row = i / 200;
+        data[i] = row >= 100 && row < 900 ? 0.01 * (double) (1 + i % 7) : 1000 + sin(i * 0.001) * 100;
+    }
+    ctx = roundtrip(&hints, data, &dims);
+    {
+        const size_t bound = scil_compress_bound(ctx, &dims);
+        byte* compressed = (byte*) malloc(bound);
+        double* result = (double*) malloc(count * sizeof(double));
+        byte* tmp = (byte*) malloc(scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE) * 2);
+        assert(scil_compress(compressed, bound, data, &dims, &size, ctx) == SCIL_NO_ERR);
+        assert(scil_decompress(SCIL_TYPE_DOUBLE, result, &dims, compressed, size, tmp) == SCIL_NO_ERR);
+        for(size_t i = 0; i < count; i++){
+            assert(fabs(result[i] - data[i]) <= fabs(data[i]) * 0.01);
+        }
+        free(tmp);
+        free(result);
+        free(compressed);
+    }
+    scil_destroy_context(ctx);
+    hints.relative_tolerance_percent = 0;
+    hints.objective = SCIL_OBJECTIVE_TIME;
+
+    // the required compression speed cannot be met, the chooser still picks a chain
+    hints.comp_speed.unit = SCIL_PERFORMANCE_GIB;
+    hints.comp_speed.multiplier = 1e6f;
+    ctx = roundtrip(&hints, data, &dims);
+    scil_destroy_context(ctx);
+
+    scilU_initialize_hardware_limits();
+    free(data);
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+static size_t compress_with_threads(int threads, const char * chain, double * buffer_in, scil_dims_t * dims, byte * buffer_out, size_t compressed_size){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = (char*) chain;
+    hints.parallel_threads = threads;
+    hints.parallel_block_size = 10000;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    size_t out_size;
+    ret = scil_compress(buffer_out, compressed_size, buffer_in, dims, &out_size, context);
+    assert(ret == SCIL_NO_ERR);
+    scil_destroy_context(context);
+    return out_size;
+}
+
+int main(void){
+    scil_dims_t dims;
+    scil_dims_initialize_3d(&dims, 30, 20, 101);
+    const size_t count = scil_dims_get_count(&dims);
+
+    size_t uncompressed_size = scil_dims_get_size(&dims, SCIL_TYPE_DOUBLE);
+    size_t compressed_size   = scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
+
+    double* buffer_in  = (double*)malloc(uncompressed_size);
+    byte* buffer_ref   = (byte*)malloc(compressed_size);
+    byte* buffer_out   = (byte*)malloc(compressed_size);
+    byte* buffer_tmp   = (byte*)malloc(compressed_size);
+    double* buffer_end = (double*)malloc(uncompressed_size);
+
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (i % 1000) * 0.1 + ((double)rand()/RAND_MAX);
+    }
+
+    const char * chains[] = {"lz4", "abstol,lz4", NULL};
+    for(int c = 0; chains[c] != NULL; c++){
+        size_t ref_size = compress_with_threads(2, chains[c], buffer_in, &dims, buffer_ref, compressed_size);
+        // the block container is used
+        scil_frame_header_t header;
+        assert(scil_peek_header(buffer_ref, ref_size, &header) == SCIL_NO_ERR);
+        assert(header.tmp_buffer_size == 0);
+        assert(buffer_ref[header.header_size] == 255);
+
+        for(int threads = 3; threads <= 8; threads++){
+            size_t out_size = compress_with_threads(threads, chains[c], buffer_in, &dims, buffer_out, compressed_size);
+            // the output does not depend on the number of threads
+            assert(out_size == ref_size);
+            assert(memcmp(buffer_ref, buffer_out, out_size) == 0);
+        }
+
+        memset(buffer_end, 0, uncompressed_size);
+        int ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_end, &dims, buffer_ref, ref_size, buffer_tmp);
+        assert(ret == SCIL_NO_ERR);
+        for(size_t i = 0; i < count; ++i){
+            assert(buffer_end[i] - buffer_in[i] <= 0.01 && buffer_in[i] - buffer_end[i] <= 0.01);
+        }
+        printf("%s: %zu -> %zu\n", chains[c], uncompressed_size, ref_size);
+
+        // a block offset in the middle of the index that points beyond the data is rejected
+        memcpy(buffer_out, buffer_ref, ref_size);
+        const uint64_t beyond = ref_size;
+        memcpy(buffer_out + header.header_size + 1 + 2 * sizeof(uint64_t), &beyond, sizeof(uint64_t));
+        ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_end, &dims, buffer_out, ref_size, buffer_tmp);
+        assert(ret == SCIL_BUFFER_ERR);
+    }
+
+    free(buffer_in);
+    free(buffer_ref);
+    free(buffer_out);
+    free(buffer_tmp);
+    free(buffer_end);
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Checks that the chooser tries the chains of the system configuration for their datatype and size class.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-algo-chooser.h>
+#include <scil-compression-chain.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *conf =
+  "# randomness; dtype=datatype; size=size class in bytes; compressor chain; c; d; ratio; energy\n"
+  "!storage 100\n"
+  "1.0; dtype=float; size=4096; delta; zstd-11; 100.0; 200.0; 0.5; 0.1\n"
+  "1.0; dtype=float; size=1048576; abstol,gzip; 100.0; 200.0; 0.5; 0.1\n"
+  "1.0; dtype=double; delta,lz4; 100.0; 200.0; 0.5\n";
+
+static int contains(scil_compression_chain_t *chains, int count, const char *name){
+  scil_compression_chain_t chain;
+  assert(scilU_chain_create(&chain, name) == SCIL_NO_ERR);
+  uint8_t ids[2 * PRECONDITIONER_LIMIT + 3];
+  uint8_t other_ids[2 * PRECONDITIONER_LIMIT + 3];
+  const int id_count = scilU_chain_get_ids(&chain, ids);
+  for(int i = 0; i < count; i++){
+    if(scilU_chain_get_ids(&chains[i], other_ids) == id_count && memcmp(ids, other_ids, id_count) == 0){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int candidates(SCIL_Datatype_t datatype, size_t count, scil_compression_chain_t *out){
+  scil_user_hints_t hints;
+  scil_user_hints_initialize(&hints);
+  hints.absolute_tolerance = 0.1;
+  scil_context_t *ctx;
+  int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  scil_dims_t dims;
+  scil_dims_initialize_1d(&dims, count);
+  const int n = scilC_algo_chooser_candidates(ctx, &dims, out);
+  scil_destroy_context(ctx);
+  return n;
+}
+
+int main(void){
+  FILE *f = fopen("chooser-conf.conf", "w");
+  assert(f != NULL);
+  fputs(conf, f);
+  fclose(f);
+  setenv("SCIL_SYSTEM_CHARACTERISTICS_FILE", "chooser-conf.conf", 1);
+
+  scil_compression_chain_t chains[SCIL_CHOOSER_CANDIDATES_MAX];
+  // the entry of the size class of the data
+  int n = candidates(SCIL_TYPE_FLOAT, 1000, chains);
+  assert(contains(chains, n, "delta,zstd-11"));
+  assert(! contains(chains, n, "abstol,gzip"));
+  assert(! contains(chains, n, "delta,lz4"));
+
+  n = candidates(SCIL_TYPE_FLOAT, 200000, chains);
+  assert(! contains(chains, n, "delta,zstd-11"));
+  assert(contains(chains, n, "abstol,gzip"));
+
+  // no class matches, all entries of the datatype are tried
+  n = candidates(SCIL_TYPE_FLOAT, 10000000, chains);
+  assert(contains(chains, n, "delta,zstd-11"));
+  assert(contains(chains, n, "abstol,gzip"));
+
+  n = candidates(SCIL_TYPE_DOUBLE, 1000, chains);
+  assert(contains(chains, n, "delta,lz4"));
+  assert(! contains(chains, n, "delta,zstd-11"));
+
+  assert(scil_str_to_datatype("double") == SCIL_TYPE_DOUBLE);
+  assert(strcmp(scil_datatype_to_str(SCIL_TYPE_INT8), "int8") == 0);
+
+  remove("chooser-conf.conf");
+  printf("OK\n");
+  return 0;
+}
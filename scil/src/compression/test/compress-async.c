@@ -0,0 +1,118 @@
+// Checks that asynchronous compressions produce the output of scil_compress() and respect the queue depth.
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+#define REQUESTS 8
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int callbacks = 0;
+static size_t callback_sizes[REQUESTS];
+
+static void on_finished(void * user_ptr, int ret, size_t out_size){
+    assert(ret == SCIL_NO_ERR);
+    pthread_mutex_lock(&lock);
+    callback_sizes[(size_t) user_ptr] = out_size;
+    callbacks++;
+    pthread_mutex_unlock(&lock);
+}
+
+static scil_context_t* create(int threads){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = "abstol,lz4";
+    hints.parallel_threads = threads;
+    hints.parallel_block_size = 100000;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    return context;
+}
+
+int main(void){
+    setenv("SCIL_THREADS", "4", 1);
+    setenv("SCIL_ASYNC_QUEUE_DEPTH", "2", 1);
+
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 300, 1000);
+    const size_t count = scil_dims_get_count(&dims);
+    const size_t uncompressed_size = scil_dims_get_size(&dims, SCIL_TYPE_DOUBLE);
+
+    double* buffer_in[REQUESTS];
+    byte* buffer_out[REQUESTS];
+    scil_context_t* contexts[REQUESTS];
+    scil_request_t* requests[REQUESTS];
+    for(int r = 0; r < REQUESTS; r++){
+        buffer_in[r] = (double*) malloc(uncompressed_size);
+        for(size_t i = 0; i < count; ++i){
+            buffer_in[r][i] = (i % (100 + r)) * 0.1;
+        }
+        contexts[r] = create(r % 2 == 0 ? 1 : 2);
+        buffer_out[r] = (byte*) malloc(scil_compress_bound(contexts[r], &dims));
+    }
+
+    for(int r = 0; r < REQUESTS; r++){
+        const size_t bound = scil_compress_bound(contexts[r], &dims);
+        int ret = scil_compress_async(buffer_out[r], bound, buffer_in[r], &dims, contexts[r], on_finished, (void*) (size_t) r, &requests[r]);
+        assert(ret == SCIL_NO_ERR);
+        // at most the queue depth of requests is unfinished
+        pthread_mutex_lock(&lock);
+        assert(r + 1 - callbacks <= 2);
+        pthread_mutex_unlock(&lock);
+    }
+
+    int done = 0;
+    while(! done){
+        assert(scil_test(requests[REQUESTS - 1], &done) == SCIL_NO_ERR);
+    }
+
+    byte* expected = (byte*) malloc(scil_compress_bound(contexts[0], &dims));
+    for(int r = 0; r < REQUESTS; r++){
+        size_t size;
+        assert(scil_wait(requests[r], &size) == SCIL_NO_ERR);
+        assert(size == callback_sizes[r]);
+
+        size_t expected_size;
+        int ret = scil_compress(expected, scil_compress_bound(contexts[r], &dims), buffer_in[r], &dims, &expected_size, contexts[r]);
+        assert(ret == SCIL_NO_ERR);
+        assert(size == expected_size);
+        assert(memcmp(expected, buffer_out[r], size) == 0);
+        printf("%d: %zu -> %zu\n", r, uncompressed_size, size);
+    }
+    assert(callbacks == REQUESTS);
+
+    // a request without handle is freed after the callback
+    callbacks = 0;
+    int ret = scil_compress_async(buffer_out[0], scil_compress_bound(contexts[0], &dims), buffer_in[0], &dims, contexts[0], on_finished, (void*) 0, NULL);
+    assert(ret == SCIL_NO_ERR);
+    while(1){
+        pthread_mutex_lock(&lock);
+        const int finished = callbacks;
+        pthread_mutex_unlock(&lock);
+        if(finished == 1){
+            break;
+        }
+    }
+
+    // an error of the compression is reported by the request
+    scil_request_t* request;
+    ret = scil_compress_async(buffer_out[0], 10, buffer_in[0], &dims, contexts[0], NULL, NULL, &request);
+    assert(ret == SCIL_NO_ERR);
+    assert(scil_wait(request, NULL) == SCIL_MEMORY_ERR);
+
+    for(int r = 0; r < REQUESTS; r++){
+        scil_destroy_context(contexts[r]);
+        free(buffer_in[r]);
+        free(buffer_out[r]);
+    }
+    free(expected);
+    printf("OK\n");
+    return 0;
+}
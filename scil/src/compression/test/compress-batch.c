@@ -0,0 +1,110 @@
+// Checks that a batch of variables of different sizes and types produces the output of scil_compress().
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+#define ITEMS 40
+
+static void compare(scil_batch_item_t * item, scil_context_t * context){
+    const size_t bound = scil_compress_bound(context, &item->dims);
+    byte* expected = (byte*) malloc(bound);
+    size_t expected_size;
+    int ret = scil_compress(expected, bound, item->source, &item->dims, &expected_size, context);
+    assert(ret == SCIL_NO_ERR);
+    assert(item->out_size == expected_size);
+    assert(memcmp(expected, item->dest, expected_size) == 0);
+    free(expected);
+}
+
+int main(void){
+    setenv("SCIL_THREADS", "4", 1);
+
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = "abstol,lz4";
+
+    scil_user_hints_t lossless;
+    scil_user_hints_initialize(&lossless);
+    lossless.force_compression_methods = "delta,zstd";
+
+    scil_context_t * contexts[2][2];
+    for(int h = 0; h < 2; h++){
+        assert(scil_context_create(&contexts[h][0], SCIL_TYPE_DOUBLE, 0, NULL, h == 0 ? &hints : &lossless) == SCIL_NO_ERR);
+        assert(scil_context_create(&contexts[h][1], SCIL_TYPE_FLOAT, 0, NULL, h == 0 ? &hints : &lossless) == SCIL_NO_ERR);
+    }
+
+    // few large and many small variables
+    scil_batch_item_t items[ITEMS];
+    memset(items, 0, sizeof(items));
+    for(int i = 0; i < ITEMS; i++){
+        scil_batch_item_t * item = &items[i];
+        const size_t x = i % 10 == 0 ? 200000 : 100 + i;
+        scil_dims_initialize_2d(&item->dims, x, 3);
+        item->datatype = i % 3 == 0 ? SCIL_TYPE_FLOAT : SCIL_TYPE_DOUBLE;
+        item->hints = i % 2 == 0 ? &hints : &lossless;
+        const size_t count = scil_dims_get_count(&item->dims);
+        item->source = malloc(scil_dims_get_size(&item->dims, item->datatype));
+        for(size_t j = 0; j < count; j++){
+            const double value = (j % (50 + i)) * 0.1;
+            if(item->datatype == SCIL_TYPE_FLOAT){
+                ((float*) item->source)[j] = (float) value;
+            }else{
+                ((double*) item->source)[j] = value;
+            }
+        }
+        item->dest_size = scil_compress_bound(contexts[i % 2][item->datatype == SCIL_TYPE_FLOAT], &item->dims);
+        item->dest = (byte*) malloc(item->dest_size);
+        item->ret = -1;
+    }
+
+    int ret = scil_compress_batch(items, ITEMS);
+    assert(ret == SCIL_NO_ERR);
+    size_t total = 0;
+    for(int i = 0; i < ITEMS; i++){
+        assert(items[i].ret == SCIL_NO_ERR);
+        compare(&items[i], contexts[i % 2][items[i].datatype == SCIL_TYPE_FLOAT]);
+        total += items[i].out_size;
+    }
+    printf("%d items -> %zu\n", ITEMS, total);
+
+    // a failed item is reported without stopping the others
+    const size_t dest_size = items[5].dest_size;
+    items[5].dest_size = 10;
+    ret = scil_compress_batch(items, ITEMS);
+    assert(ret == SCIL_MEMORY_ERR);
+    assert(items[5].ret == SCIL_MEMORY_ERR);
+    assert(items[4].ret == SCIL_NO_ERR && items[6].ret == SCIL_NO_ERR);
+    compare(&items[6], contexts[0][items[6].datatype == SCIL_TYPE_FLOAT]);
+    items[5].dest_size = dest_size;
+
+    // without hints the chain is selected by the chooser
+    scil_user_hints_t defaults;
+    scil_user_hints_initialize(&defaults);
+    scil_context_t * context;
+    assert(scil_context_create(&context, items[1].datatype, 0, NULL, &defaults) == SCIL_NO_ERR);
+    items[1].hints = NULL;
+    items[1].dest_size = scil_compress_bound(context, &items[1].dims);
+    items[1].dest = (byte*) realloc(items[1].dest, items[1].dest_size);
+    ret = scil_compress_batch(&items[1], 1);
+    assert(ret == SCIL_NO_ERR);
+    compare(&items[1], context);
+    scil_destroy_context(context);
+
+    assert(scil_compress_batch(NULL, 0) == SCIL_NO_ERR);
+
+    for(int i = 0; i < ITEMS; i++){
+        free(items[i].source);
+        free(items[i].dest);
+    }
+    for(int h = 0; h < 2; h++){
+        scil_destroy_context(contexts[h][0]);
+        scil_destroy_context(contexts[h][1]);
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+// compress into a buffer of exactly scil_compress_bound() bytes and check the result
+static void test_chain(char* chain, double* buffer_in, scil_dims_t* dims, size_t block_size){
+    const size_t count = scil_dims_get_count(dims);
+    const size_t size = scil_dims_get_size(dims, SCIL_TYPE_DOUBLE);
+
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.5;
+    hints.force_compression_methods = chain;
+    hints.parallel_block_size = block_size;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t bound = scil_compress_bound(context, dims);
+    printf("%s block size %zu: data %zu bound %zu\n", chain ? chain : "(automatic)", block_size, size, bound);
+    // far less than the 4x that was required before
+    assert(bound < size + size / 10 + 1024);
+
+    byte* buffer_out = (byte*) malloc(bound);
+    size_t out_size;
+    if(chain != NULL){
+        // the automatic selection may pick a chain with a smaller bound
+        ret = scil_compress(buffer_out, bound - 1, buffer_in, dims, &out_size, context);
+        assert(ret == SCIL_MEMORY_ERR);
+    }
+    ret = scil_compress(buffer_out, bound, buffer_in, dims, &out_size, context);
+    assert(ret == SCIL_NO_ERR);
+    assert(out_size <= bound);
+
+    scil_frame_header_t header;
+    ret = scil_peek_header(buffer_out, out_size, &header);
+    assert(ret == SCIL_NO_ERR);
+    double* buffer_end = (double*) malloc(size);
+    byte* buffer_tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_end, dims, buffer_out, out_size, buffer_tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; ++i){
+        double diff = buffer_end[i] - buffer_in[i];
+        assert(diff <= 0.5 && diff >= -0.5);
+    }
+
+    free(buffer_tmp);
+    free(buffer_end);
+    free(buffer_out);
+}
+
+int main(void){
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 1000, 100);
+    const size_t count = scil_dims_get_count(&dims);
+
+    // random data is the worst case for the byte compressors
+    double* buffer_in = (double*) malloc(count * sizeof(double));
+    srand(1);
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (double) rand() / RAND_MAX * 1000.0;
+    }
+
+    test_chain("memcopy", buffer_in, &dims, 0);
+    test_chain("lz4", buffer_in, &dims, 0);
+    test_chain("zstd", buffer_in, &dims, 0);
+    test_chain("abstol", buffer_in, &dims, 0);
+    test_chain("abstol,lz4", buffer_in, &dims, 0);
+    test_chain("fpdelta,abstol,lz4", buffer_in, &dims, 0);
+    test_chain("lz4", buffer_in, &dims, 64 * 1024);
+    test_chain(NULL, buffer_in, &dims, 0);
+
+    // empty data needs a single byte
+    scil_dims_t empty;
+    scil_dims_initialize_1d(&empty, 0);
+    scil_context_t* context;
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    assert(scil_compress_bound(context, &empty) == 1);
+
+    free(buffer_in);
+    printf("OK\n");
+    return 0;
+}
@@ -51,7 +51,11 @@ void test(char * name, size_t expected_size, int check_compressed_output){
   assert(out_size <= expected_size + 2);
 
   if(check_compressed_output){
-    assert( memcmp(& buff[1], data, sizeof(data)) == 0);
+    // the payload follows the frame header and starts with the length of the chain
+    scil_frame_header_t header;
+    ret = scil_peek_header(buff, out_size, & header);
+    assert(ret == SCIL_NO_ERR);
+    assert( memcmp(& buff[header.header_size + 1], data, sizeof(data)) == 0);
   }
 
   ret = scil_destroy_context(ctx);
@@ -82,24 +86,26 @@ int main(){
   tmpBuff = malloc(size*10);
   assert(sizeof(data) == 80);
 
-  test("dummy-precond", 87, 1);
-  test("dummy-precond,dummy-precond", 93, 1);
-  test("dummy-precond,dummy-precond,dummy-precond,dummy-precond", 105, 1);
+  // the expected sizes include the frame header of 22 bytes and one byte per compressor of the chain
 
-  test("dummy-precond,lz4", 61, 0);
-  test("dummy-precond,dummy-precond,lz4", 67, 0);
-  test("dummy-precond,dummy-precond,dummy-precond,lz4", 75, 0);
+  test("dummy-precond", 110, 1);
+  test("dummy-precond,dummy-precond", 117, 1);
+  test("dummy-precond,dummy-precond,dummy-precond,dummy-precond", 131, 1);
 
-  test("lz4", 59, 0);
-  test("zfp-abstol", 106, 0);
+  test("dummy-precond,lz4", 85, 0);
+  test("dummy-precond,dummy-precond,lz4", 92, 0);
+  test("dummy-precond,dummy-precond,dummy-precond,lz4", 101, 0);
 
-  test("zfp-abstol,lz4", 53, 0);
+  test("lz4", 82, 0);
+  test("zfp-abstol", 129, 0);
 
-  test("dummy-precond,zfp-abstol", 112, 0);
-  test("dummy-precond,dummy-precond,zfp-abstol", 118, 0);
+  test("zfp-abstol,lz4", 77, 0);
 
-  test("dummy-precond,zfp-abstol,lz4", 55, 0);
-  test("dummy-precond,dummy-precond,zfp-abstol,lz4", 61, 0);
+  test("dummy-precond,zfp-abstol", 136, 0);
+  test("dummy-precond,dummy-precond,zfp-abstol", 143, 0);
+
+  test("dummy-precond,zfp-abstol,lz4", 80, 0);
+  test("dummy-precond,dummy-precond,zfp-abstol,lz4", 87, 0);
 
   free(buff);
 
@@ -0,0 +1,154 @@
+// Stresses concurrent compressions with one context per thread and reports the aggregate throughput for 1 to N threads.
+// Every thread must produce the output of a single threaded compression of its variable, this includes sz that shares process-global library state.
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-thread-pool.h>
+
+#define MAX_THREADS 8
+#define ROUNDS 3
+#define ABS_TOL 0.01
+
+typedef struct{
+    const char* chain;
+    double* data;
+    scil_dims_t dims;
+
+    // the output of a compression without concurrency
+    byte* reference;
+    size_t reference_size;
+} variable_t;
+
+static scil_context_t* create_context(const char* chain, int threads){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = ABS_TOL;
+    hints.force_compression_methods = (char*) chain;
+    hints.parallel_threads = threads;
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    return ctx;
+}
+
+static size_t compress(scil_context_t* ctx, variable_t* var, byte* out){
+    const size_t bound = scil_compress_bound(ctx, &var->dims);
+    size_t size;
+    int ret = scil_compress(out, bound, var->data, &var->dims, &size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    return size;
+}
+
+static void check_decompress(variable_t* var, byte* compressed, size_t size){
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, size, &header) == SCIL_NO_ERR);
+    const size_t count = scil_dims_get_count(&var->dims);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    double* result = (double*) malloc(count * sizeof(double));
+    int ret = scil_decompress(SCIL_TYPE_DOUBLE, result, &var->dims, compressed, size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; i++){
+        assert(fabs(result[i] - var->data[i]) <= ABS_TOL * 1.0001);
+    }
+    free(result);
+    free(tmp);
+}
+
+static void* run_variable(void* user_ptr){
+    variable_t* var = (variable_t*) user_ptr;
+    scil_context_t* ctx = create_context(var->chain, 1);
+    byte* out = (byte*) malloc(scil_compress_bound(ctx, &var->dims));
+    for(int r = 0; r < ROUNDS; r++){
+        const size_t size = compress(ctx, var, out);
+        assert(size == var->reference_size);
+        assert(memcmp(out, var->reference, size) == 0);
+        check_decompress(var, out, size);
+    }
+    free(out);
+    scil_destroy_context(ctx);
+    return NULL;
+}
+
+static void init_variable(variable_t* var, const char* chain, int seed){
+    var->chain = chain;
+    scil_dims_initialize_2d(&var->dims, 512, 256);
+    const size_t count = scil_dims_get_count(&var->dims);
+    var->data = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        var->data[i] = sin((i % 512) * 0.01 * (seed + 1)) * cos((i / 512) * 0.02) * 100 + (rand() % 100) * 0.001;
+    }
+    scil_context_t* ctx = create_context(chain, 1);
+    var->reference = (byte*) malloc(scil_compress_bound(ctx, &var->dims));
+    var->reference_size = compress(ctx, var, var->reference);
+    scil_destroy_context(ctx);
+}
+
+int main(void){
+    int max_threads = scilU_get_default_thread_count();
+    max_threads = max_threads < 4 ? 4 : (max_threads > MAX_THREADS ? MAX_THREADS : max_threads);
+
+    const char* chains[] = {"sz", "abstol,lz4", NULL};
+    for(int c = 0; chains[c] != NULL; c++){
+        variable_t vars[MAX_THREADS];
+        for(int t = 0; t < max_threads; t++){
+            init_variable(&vars[t], chains[c], t);
+        }
+
+        double single = 0;
+        for(int threads = 1; threads <= max_threads; threads++){
+            pthread_t ids[MAX_THREADS];
+            scil_timer timer;
+            scilU_start_timer(&timer);
+            for(int t = 0; t < threads; t++){
+                const int ret = pthread_create(&ids[t], NULL, run_variable, &vars[t]);
+                assert(ret == 0);
+            }
+            for(int t = 0; t < threads; t++){
+                pthread_join(ids[t], NULL);
+            }
+            const double elapsed = scilU_stop_timer(timer);
+            const double mib = threads * ROUNDS * scil_dims_get_size(&vars[0].dims, SCIL_TYPE_DOUBLE) / 1024.0 / 1024;
+            if(threads == 1){
+                single = mib / elapsed;
+            }
+            printf("%s: %d threads %.1f MiB/s, %.2fx of one thread\n", chains[c], threads, mib / elapsed, mib / elapsed / single);
+        }
+
+        // the block container compresses the blocks of a single variable in parallel
+        scil_dims_t dims;
+        scil_dims_initialize_2d(&dims, 512, 256 * max_threads);
+        variable_t large = {chains[c], NULL, dims, NULL, 0};
+        large.data = (double*) malloc(scil_dims_get_size(&dims, SCIL_TYPE_DOUBLE));
+        for(int t = 0; t < max_threads; t++){
+            memcpy(large.data + t * scil_dims_get_count(&vars[t].dims), vars[t].data, scil_dims_get_size(&vars[t].dims, SCIL_TYPE_DOUBLE));
+        }
+        scil_user_hints_t hints;
+        scil_user_hints_initialize(&hints);
+        hints.absolute_tolerance = ABS_TOL;
+        hints.force_compression_methods = (char*) chains[c];
+        hints.parallel_threads = max_threads;
+        hints.parallel_block_size = scil_dims_get_size(&vars[0].dims, SCIL_TYPE_DOUBLE) / 4;
+        scil_context_t* ctx;
+        const int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+        assert(ret == SCIL_NO_ERR);
+        byte* out = (byte*) malloc(scil_compress_bound(ctx, &dims));
+        const size_t size = compress(ctx, &large, out);
+        check_decompress(&large, out, size);
+        free(out);
+        free(large.data);
+        scil_destroy_context(ctx);
+
+        for(int t = 0; t < max_threads; t++){
+            free(vars[t].data);
+            free(vars[t].reference);
+        }
+    }
+    printf("OK\n");
+    return 0;
+}
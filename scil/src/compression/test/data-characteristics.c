@@ -0,0 +1,231 @@
+// Compares the single pass characteristics with separate loops over the data and reports the throughput.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-data-characteristics.h>
+#include <scil-minmax.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int close_to(double a, double b){
+    return fabs(a - b) <= 1e-9 * (fabs(a) + fabs(b) + 1);
+}
+
+static int excluded(double v, double fill_value){
+    return isnan(v) || (fill_value != DBL_MAX && fabs(v - fill_value) < FLT_EPSILON);
+}
+
+// the gradient is determined along the fastest dimension with rows of row_length values
+static void check_double(const double* data, size_t count, size_t row_length, double fill_value){
+    double min = INFINITY, max = -INFINITY, sum = 0, gradient_sum = 0, gradient_max = 0;
+    size_t valid = 0, gradients = 0, fills = 0, nans = 0, negatives = 0;
+    for(size_t i = 0; i < count; i++){
+        if(isnan(data[i])){
+            nans++;
+            continue;
+        }
+        if(excluded(data[i], fill_value)){
+            fills++;
+            continue;
+        }
+        min = data[i] < min ? data[i] : min;
+        max = data[i] > max ? data[i] : max;
+        negatives += data[i] < 0;
+        sum += data[i];
+        valid++;
+        if(i % row_length != 0 && ! excluded(data[i - 1], fill_value)){
+            const double g = fabs(data[i] - data[i - 1]);
+            gradient_sum += g;
+            gradient_max = g > gradient_max ? g : gradient_max;
+            gradients++;
+        }
+    }
+    const double mean = sum / valid;
+    double variance = 0;
+    for(size_t i = 0; i < count; i++){
+        if(! excluded(data[i], fill_value)){
+            variance += (data[i] - mean) * (data[i] - mean);
+        }
+    }
+    variance /= valid;
+
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, row_length, count / row_length);
+    scil_data_characteristics_t c;
+    int ret = scil_compute_data_characteristics(SCIL_TYPE_DOUBLE, data, &dims, fill_value, 0, &c);
+    assert(ret == SCIL_NO_ERR);
+    assert(c.count == count && c.processed_count == count);
+    assert(c.fill_count == fills && c.nan_count == nans && c.negative_count == negatives);
+    assert(c.minimum == min && c.maximum == max);
+    assert(close_to(c.mean, mean));
+    assert(close_to(c.variance, variance));
+    assert(close_to(c.gradient_mean, gradients > 0 ? gradient_sum / gradients : 0));
+    assert(c.gradient_maximum == gradient_max);
+    assert(c.exponent_maximum == ilogb(fabs(min) > fabs(max) ? fabs(min) : fabs(max)));
+}
+
+static void test_double(){
+    const size_t count = 10000;
+    double* data = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        data[i] = sin(i * 0.01) * 1000 + (rand() % 100) * 0.01;
+    }
+    check_double(data, count, count, DBL_MAX);
+    check_double(data, 1, 1, DBL_MAX);
+    check_double(data, 1031, 1031, DBL_MAX);
+    check_double(data, count, 100, DBL_MAX);
+    check_double(data, count, 1000, DBL_MAX);
+    check_double(data, count, 1, DBL_MAX);
+    for(size_t i = 0; i < count; i += 7){
+        data[i] = -9999;
+    }
+    data[5000] = NAN;
+    check_double(data, count, count, -9999);
+    check_double(data, count, 500, -9999);
+    free(data);
+}
+
+static void test_types(){
+    const size_t count = 3000;
+    int16_t* data = (int16_t*) malloc(count * sizeof(int16_t));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (int16_t) i - 1000;
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    scil_data_characteristics_t c;
+    scil_compute_data_characteristics(SCIL_TYPE_INT16, data, &dims, DBL_MAX, 0, &c);
+    assert(c.minimum == -1000 && c.maximum == 1999);
+    assert(c.negative_count == 1000);
+    assert(c.exponent_minimum == 0 && c.exponent_maximum == 10);
+    assert(c.gradient_mean == 1 && c.gradient_maximum == 1);
+    assert(close_to(c.mean, 499.5));
+
+    // a ramp in every row, the rows do not continue each other
+    for(size_t i = 0; i < count; i++){
+        data[i] = (int16_t) (i % 300);
+    }
+    scil_dims_initialize_2d(&dims, 300, 10);
+    scil_compute_data_characteristics(SCIL_TYPE_INT16, data, &dims, DBL_MAX, 0, &c);
+    assert(c.gradient_mean == 1 && c.gradient_maximum == 1);
+    scil_dims_initialize_1d(&dims, count);
+
+    // constant data has no entropy
+    memset(data, 0, count * sizeof(int16_t));
+    scil_compute_data_characteristics(SCIL_TYPE_INT16, data, &dims, DBL_MAX, 0, &c);
+    assert(c.byte_entropy == 0 && c.variance == 0);
+
+    // random bytes are close to 8 bits per byte
+    for(size_t i = 0; i < count; i++){
+        data[i] = (int16_t) rand();
+    }
+    scil_compute_data_characteristics(SCIL_TYPE_INT16, data, &dims, DBL_MAX, 0, &c);
+    assert(c.byte_entropy > 7.5);
+    free(data);
+    assert(scil_compute_data_characteristics(SCIL_TYPE_UNKNOWN, data, &dims, DBL_MAX, 0, &c) == SCIL_EINVAL);
+}
+
+static void test_sampling(){
+    const size_t count = 1000000;
+    float* data = (float*) malloc(count * sizeof(float));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (float) i;
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    scil_data_characteristics_t c;
+    scil_compute_data_characteristics(SCIL_TYPE_FLOAT, data, &dims, DBL_MAX, 100000, &c);
+    assert(c.count == count);
+    assert(c.processed_count >= 100000 && c.processed_count < 120000);
+    assert(c.minimum == 0 && c.maximum > 0.9 * count);
+    assert(c.gradient_maximum == 1);
+    free(data);
+}
+
+// the context determines the characteristics once and shares the extrema with the algorithms
+static void test_context(){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    double data[1000];
+    for(int i = 0; i < 1000; i++){
+        data[i] = i * 0.5;
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, 1000);
+    scilC_context_set_input(ctx, data);
+    const scil_data_characteristics_t* c = scilC_get_data_characteristics(ctx, data, &dims);
+    assert(c->maximum == 499.5);
+    assert(ctx->minmax_cache.valid);
+
+    data[0] = -1;
+    assert(scilC_get_data_characteristics(ctx, data, &dims)->minimum == 0);
+    double min, max;
+    scilC_find_minimum_maximum_double(ctx, data, 1000, &min, &max);
+    assert(min == 0 && max == 499.5);
+
+    scilC_context_set_input(ctx, data);
+    assert(scilC_get_data_characteristics(ctx, data, &dims)->minimum == -1);
+    scil_destroy_context(ctx);
+}
+
+static void benchmark(){
+    const size_t count = 16 * 1024 * 1024;
+    double* data = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (double) (i % 10000) * 0.001;
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+
+    // separate passes as done by the chooser data generator before
+    scil_timer timer;
+    scilU_start_timer(&timer);
+    double min, max, sum = 0, variance = 0, step = 0;
+    scilU_find_minimum_maximum_double(data, count, &min, &max);
+    for(size_t i = 0; i < count; i++){
+        sum += data[i];
+    }
+    const double mean = sum / count;
+    for(size_t i = 0; i < count; i++){
+        variance += (data[i] - mean) * (data[i] - mean);
+    }
+    for(size_t i = 1; i < count; i++){
+        const double s = fabs(data[i] - data[i - 1]);
+        step = s > step ? s : step;
+    }
+    const double t_separate = scilU_stop_timer(timer);
+
+    scil_data_characteristics_t c;
+    scilU_start_timer(&timer);
+    scil_compute_data_characteristics(SCIL_TYPE_DOUBLE, data, &dims, DBL_MAX, 0, &c);
+    const double t_fused = scilU_stop_timer(timer);
+    assert(c.minimum == min && c.maximum == max && close_to(c.mean, mean) && c.gradient_maximum == step);
+
+    scilU_start_timer(&timer);
+    scil_compute_data_characteristics(SCIL_TYPE_DOUBLE, data, &dims, DBL_MAX, 65536, &c);
+    const double t_sampled = scilU_stop_timer(timer);
+
+    const double mib = count * sizeof(double) / 1024.0 / 1024.0;
+    printf("separate passes: %.1f MiB/s fused: %.1f MiB/s sampled: %.1f MiB/s\n", mib / t_separate, mib / t_fused, mib / t_sampled);
+    free(data);
+}
+
+int main(void){
+    srand(1);
+    test_double();
+    test_types();
+    test_sampling();
+    test_context();
+    benchmark();
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,263 @@
+// Checks that the selected chains are reused per variable and taken again as demanded by the policy.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-compression-chain.h>
+#include <scil-decision-cache.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void compress(scil_context_t* ctx, double* data, scil_dims_t* dims){
+    const size_t bound = scil_compress_bound(ctx, dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t size;
+    int ret = scil_compress(compressed, bound, data, dims, &size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    free(compressed);
+}
+
+static void test_key(scil_context_t* ctx){
+    scil_dims_t dims, other_dims;
+    scil_dims_initialize_2d(&dims, 100, 10);
+    scil_dims_initialize_2d(&other_dims, 10, 100);
+    scilC_decision_key_t a, b;
+    scilC_decision_key_init(&a, ctx, "temperature", &dims);
+    scilC_decision_key_init(&b, ctx, "temperature", &dims);
+    assert(a.hash == b.hash);
+
+    scilC_decision_t decision, out;
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "zstd");
+    scilC_decision_cache_put(&a, &decision);
+    assert(scilC_decision_cache_get(&b, &out));
+    assert(out.chain.byte_compressor == decision.chain.byte_compressor);
+
+    // the name, the shape and the hints distinguish decisions
+    scilC_decision_key_init(&b, ctx, "pressure", &dims);
+    assert(! scilC_decision_cache_get(&b, &out));
+    scilC_decision_key_init(&b, ctx, "temperature", &other_dims);
+    assert(! scilC_decision_cache_get(&b, &out));
+    ctx->hints.absolute_tolerance = 0.1;
+    scilC_decision_key_init(&b, ctx, "temperature", &dims);
+    ctx->hints.absolute_tolerance = 0;
+    assert(! scilC_decision_cache_get(&b, &out));
+}
+
+// a chain taken from the variable mapping or the decision tree may not support the datatype
+static void test_not_applicable(void){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_INT32, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, 1000);
+    int32_t data[1000];
+    for(int i = 0; i < 1000; i++){
+        data[i] = i % 100;
+    }
+    scilC_decision_key_t key;
+    scilC_decision_key_init(&key, ctx, getenv("H5REPACK_VARIABLE"), &dims);
+    scilC_decision_t decision;
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "predquant");
+    assert(scilU_chain_is_applicable(&decision.chain, SCIL_TYPE_INT32) == SCIL_EINVAL);
+    scilC_decision_cache_put(&key, &decision);
+
+    const size_t bound = scil_compress_bound(ctx, &dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t size;
+    ret = scil_compress(compressed, bound, data, &dims, &size, ctx);
+    assert(ret == SCIL_EINVAL);
+    free(compressed);
+    scil_destroy_context(ctx);
+    scilC_decision_cache_clear();
+}
+
+// the least recently used decision is evicted once the cache is full
+static void test_eviction(scil_context_t* ctx){
+    scilC_decision_cache_clear();
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, 100);
+    char names[SCILC_DECISION_CACHE_ENTRIES + 1][16];
+    scilC_decision_t decision, out;
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "zstd");
+    scilC_decision_key_t key;
+    for(int i = 0; i <= SCILC_DECISION_CACHE_ENTRIES; i++){
+        snprintf(names[i], sizeof(names[i]), "v%d", i);
+        scilC_decision_key_init(&key, ctx, names[i], &dims);
+        scilC_decision_cache_put(&key, &decision);
+        if(i == SCILC_DECISION_CACHE_ENTRIES - 1){
+            // the first decision is used again and outlives the second one
+            scilC_decision_key_init(&key, ctx, names[0], &dims);
+            assert(scilC_decision_cache_get(&key, &out));
+        }
+    }
+    assert(scilC_decision_cache_size() == SCILC_DECISION_CACHE_ENTRIES);
+    scilC_decision_key_init(&key, ctx, names[0], &dims);
+    assert(scilC_decision_cache_get(&key, &out));
+    scilC_decision_key_init(&key, ctx, names[1], &dims);
+    assert(! scilC_decision_cache_get(&key, &out));
+    scilC_decision_key_init(&key, ctx, names[SCILC_DECISION_CACHE_ENTRIES], &dims);
+    assert(scilC_decision_cache_get(&key, &out));
+    scilC_decision_cache_clear();
+    assert(scilC_decision_cache_size() == 0);
+}
+
+typedef struct {
+    byte* data;
+    size_t size;
+} memory_t;
+
+static int memory_write(void* user_ptr, const byte* data, size_t size){
+    memory_t* m = (memory_t*) user_ptr;
+    m->data = (byte*) realloc(m->data, m->size + size);
+    memcpy(m->data + m->size, data, size);
+    m->size += size;
+    return SCIL_NO_ERR;
+}
+
+static void check_accuracy(const double* expected, const double* data, size_t count, const scil_user_hints_t* hints){
+    for(size_t i = 0; i < count; i++){
+        assert(fabs(data[i] - expected[i]) <= hints->absolute_tolerance);
+        assert(fabs(data[i] - expected[i]) <= fabs(expected[i]) * hints->relative_tolerance_percent / 100);
+    }
+}
+
+// a cached lossy chain is validated for the data it is reused for and replaced if it misses the hints
+static void test_lossy_reuse(void){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.5;
+    hints.relative_tolerance_percent = 1;
+    hints.parallel_block_size = 64 * 1024;
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    // the large values of the first block meet both tolerances with abstol, the small ones of the later blocks do not
+    const size_t count = 100000;
+    double* data = (double*) malloc(count * sizeof(double));
+    double* result = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        data[i] = i < 8192 ? 1000 + (double) (i % 100) : 0.01 * (double) (1 + i % 7);
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    scilC_decision_key_t key;
+    scilC_decision_key_init(&key, ctx, getenv("H5REPACK_VARIABLE"), &dims);
+    scilC_decision_t decision;
+
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "abstol,lz4");
+    scilC_decision_cache_put(&key, &decision);
+    memory_t out = {NULL, 0};
+    scil_stream_t* stream;
+    ret = scil_stream_begin(&stream, ctx, &dims, memory_write, &out);
+    assert(ret == SCIL_NO_ERR);
+    assert(scil_stream_push(stream, data, count) == SCIL_NO_ERR);
+    assert(scil_stream_end(stream, NULL) == SCIL_NO_ERR);
+    assert(scilC_decision_cache_get(&key, &decision));
+    assert(! decision.chain.is_lossy);
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, result, &dims, out.data, out.size, NULL);
+    assert(ret == SCIL_NO_ERR);
+    check_accuracy(data, result, count, &hints);
+    free(out.data);
+
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "abstol,lz4");
+    scilC_decision_cache_put(&key, &decision);
+    const size_t bound = scil_compress_bound(ctx, &dims);
+    byte* compressed = (byte*) malloc(bound);
+    byte* tmp = (byte*) malloc(scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE) * 2);
+    size_t size;
+    assert(scil_compress(compressed, bound, data, &dims, &size, ctx) == SCIL_NO_ERR);
+    assert(! ctx->chain.is_lossy);
+    assert(scilC_decision_cache_get(&key, &decision));
+    assert(! decision.chain.is_lossy);
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, result, &dims, compressed, size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    check_accuracy(data, result, count, &hints);
+
+    free(tmp);
+    free(compressed);
+    free(result);
+    free(data);
+    scil_destroy_context(ctx);
+    scilC_decision_cache_clear();
+}
+
+int main(void){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    scilC_decision_policy_t policy = {.revalidate_interval = 3, .ratio_drift = 0};
+    scilC_decision_cache_set_policy(&policy);
+    test_key(ctx);
+    test_not_applicable();
+    test_eviction(ctx);
+
+    const size_t count = 10000;
+    double* data = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (double) (i % 100);
+    }
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    scilC_decision_key_t key;
+    scilC_decision_key_init(&key, ctx, getenv("H5REPACK_VARIABLE"), &dims);
+    scilC_decision_t decision;
+
+    // a cached decision is used by every context
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "zstd");
+    scilC_decision_cache_put(&key, &decision);
+    compress(ctx, data, &dims);
+    assert(strcmp(ctx->chain.byte_compressor->name, "zstd") == 0);
+
+    // the decision expires after the interval and is taken again for the following call
+    compress(ctx, data, &dims);
+    assert(scilC_decision_cache_get(&key, &decision));
+    compress(ctx, data, &dims);
+    assert(! scilC_decision_cache_get(&key, &decision));
+    compress(ctx, data, &dims);
+    assert(scilC_decision_cache_get(&key, &decision));
+    assert(decision.chooser_estimate_valid);
+
+    // a changed compression ratio expires the decision
+    policy.revalidate_interval = 0;
+    policy.ratio_drift = 0.5;
+    scilC_decision_cache_set_policy(&policy);
+    memset(&decision, 0, sizeof(decision));
+    scilU_chain_create(&decision.chain, "zstd");
+    scilC_decision_cache_put(&key, &decision);
+    compress(ctx, data, &dims);
+    compress(ctx, data, &dims);
+    assert(scilC_decision_cache_get(&key, &decision));
+    for(size_t i = 0; i < count; i++){
+        data[i] = (double) rand() / RAND_MAX;
+    }
+    compress(ctx, data, &dims);
+    assert(! scilC_decision_cache_get(&key, &decision));
+    compress(ctx, data, &dims);
+    assert(scilC_decision_cache_get(&key, &decision));
+
+    scil_destroy_context(ctx);
+    scilC_decision_cache_clear();
+    free(data);
+
+    policy.revalidate_interval = 100;
+    scilC_decision_cache_set_policy(&policy);
+    test_lossy_reuse();
+    printf("OK\n");
+    return 0;
+}
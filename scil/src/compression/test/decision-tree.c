@@ -0,0 +1,146 @@
+// Checks that the decision trees are loaded from both formats and that the features are mapped by their names.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-decision-tree.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Fill_Ratio <= 0.5 ? (DM1 <= 100 ? zstd : lz4) : memcopy
+static const char *text_tree =
+  "#classes\n"
+  "lz4;memcopy;zstd\n"
+  "#columns\n"
+  "DM1;Fill_Ratio\n"
+  "#left\n"
+  "1;2;-1;-1;-1\n"
+  "#right\n"
+  "4;3;-1;-1;-1\n"
+  "#thresholds\n"
+  "0.5;100.0;-2.0;-2.0;-2.0\n"
+  "#indices\n"
+  "1;0;-2;-2;-2\n"
+  "#values\n"
+  "3.0 2.0 5.0;3.0 0.0 5.0;0.0 0.0 5.0;3.0 0.0 0.0;0.0 2.0 0.0\n";
+
+static void write_file(const char *name, const void *data, size_t size){
+  FILE *f = fopen(name, "wb");
+  assert(f != NULL);
+  assert(fwrite(data, 1, size, f) == size);
+  fclose(f);
+}
+
+static void write_name(FILE *f, const char *name){
+  const uint16_t length = (uint16_t) strlen(name);
+  fwrite(&length, sizeof(length), 1, f);
+  fwrite(name, 1, length, f);
+}
+
+// Smoothness <= 0.9 ? zstd : lz4
+static void write_binary_tree(const char *name){
+  FILE *f = fopen(name, "wb");
+  assert(f != NULL);
+  fwrite("SCILTREE", 1, 8, f);
+  const uint32_t header[] = {1, 3, 1, 2};
+  fwrite(header, sizeof(uint32_t), 4, f);
+  write_name(f, "Smoothness");
+  write_name(f, "zstd");
+  write_name(f, "lz4");
+  const int32_t left[] = {1, -1, -1};
+  const int32_t right[] = {2, -1, -1};
+  const int32_t feature[] = {0, -2, -2};
+  const double threshold[] = {0.9, -2, -2};
+  const int32_t prediction[] = {0, 0, 1};
+  fwrite(left, sizeof(int32_t), 3, f);
+  fwrite(right, sizeof(int32_t), 3, f);
+  fwrite(feature, sizeof(int32_t), 3, f);
+  fwrite(threshold, sizeof(double), 3, f);
+  fwrite(prediction, sizeof(int32_t), 3, f);
+  fclose(f);
+}
+
+// a header whose counts exceed the limits, the remaining file is missing
+static void write_binary_header(const char *name, uint32_t node_count, uint32_t class_count){
+  FILE *f = fopen(name, "wb");
+  assert(f != NULL);
+  fwrite("SCILTREE", 1, 8, f);
+  const uint32_t header[] = {1, node_count, 1, class_count};
+  fwrite(header, sizeof(uint32_t), 4, f);
+  fclose(f);
+}
+
+int main(void){
+  double features[SCILU_TREE_FEATURE_COUNT] = {0};
+
+  write_file("decision-tree.txt", text_tree, strlen(text_tree));
+  scilU_decision_tree *tree = scilU_tree_load("decision-tree.txt");
+  assert(tree != NULL);
+  assert(tree->uses_data_features);
+  features[SCILU_TREE_DM1] = 50;
+  assert(strcmp(scilU_tree_predict(tree, features), "zstd") == 0);
+  features[SCILU_TREE_DM1] = 200;
+  assert(strcmp(scilU_tree_predict(tree, features), "lz4") == 0);
+  features[SCILU_TREE_FILL_RATIO] = 0.9;
+  assert(strcmp(scilU_tree_predict(tree, features), "memcopy") == 0);
+  scilU_tree_remove(tree);
+
+  // a model referring to features SCIL does not determine is rejected
+  char *unknown = strdup(text_tree);
+  memcpy(strstr(unknown, "Fill_Ratio"), "Fill_Value", 10);
+  write_file("decision-tree.txt", unknown, strlen(unknown));
+  free(unknown);
+  assert(scilU_tree_load("decision-tree.txt") == NULL);
+
+  write_binary_header("decision-tree.bin", 0x80000000u, 2);
+  assert(scilU_tree_load("decision-tree.bin") == NULL);
+  write_binary_header("decision-tree.bin", 3, 0xFFFFFFFFu);
+  assert(scilU_tree_load("decision-tree.bin") == NULL);
+
+  write_binary_tree("decision-tree.bin");
+  tree = scilU_tree_load("decision-tree.bin");
+  assert(tree != NULL);
+
+  // the features of smooth and noisy data
+  const size_t count = 1000;
+  double *data = (double*) malloc(count * sizeof(double));
+  for(size_t i = 0; i < count; i++){
+    data[i] = (double) i;
+  }
+  scil_dims_t dims;
+  scil_dims_initialize_1d(&dims, count);
+  scil_user_hints_t hints;
+  scil_user_hints_initialize(&hints);
+  scil_context_t *ctx;
+  int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+
+  scilU_tree_compute_features(tree, ctx, data, &dims, &dims, features);
+  assert(features[SCILU_TREE_NUMBER_OF_ELEMENTS] == count);
+  assert(features[SCILU_TREE_STORAGE_SIZE] == count * sizeof(double));
+  assert(features[SCILU_TREE_DATA_TYPE_DOUBLE] == 1);
+  assert(features[SCILU_TREE_MAXIMUM] == count - 1);
+  assert(features[SCILU_TREE_SMOOTHNESS] > 0.9);
+  assert(features[SCILU_TREE_EXPONENT_SPAN] > 0);
+  assert(strcmp(scilU_tree_predict(tree, features), "lz4") == 0);
+
+  for(size_t i = 0; i < count; i++){
+    data[i] = (i % 2) * 100.0;
+  }
+  scil_destroy_context(ctx);
+  scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  scilU_tree_compute_features(tree, ctx, data, &dims, &dims, features);
+  assert(features[SCILU_TREE_SMOOTHNESS] < 0.1);
+  assert(strcmp(scilU_tree_predict(tree, features), "zstd") == 0);
+
+  scilU_tree_remove(tree);
+  scil_destroy_context(ctx);
+  free(data);
+  remove("decision-tree.txt");
+  remove("decision-tree.bin");
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+static void check_region(double * data, scil_dims_t * dims, byte * compressed, size_t compressed_size, scil_dims_t * offset, scil_dims_t * count){
+    double * region = (double*) malloc(scil_dims_get_size(count, SCIL_TYPE_DOUBLE));
+    int ret = scil_decompress_region(SCIL_TYPE_DOUBLE, region, dims, offset, count, compressed, compressed_size);
+    assert(ret == SCIL_NO_ERR);
+
+    // compare against the original data
+    scil_dims_t pos;
+    scil_dims_t rpos;
+    pos.dims = dims->dims;
+    rpos.dims = dims->dims;
+    size_t elements = scil_dims_get_count(count);
+    for(size_t i = 0; i < elements; i++){
+        size_t rem = i;
+        for(int d = 0; d < dims->dims; d++){
+            rpos.length[d] = rem % count->length[d];
+            rem /= count->length[d];
+            pos.length[d] = offset->length[d] + rpos.length[d];
+        }
+        assert(memcmp(&region[scilU_data_pos(&rpos, count)], &data[scilU_data_pos(&pos, dims)], sizeof(double)) == 0);
+    }
+    free(region);
+}
+
+static size_t compress(double * data, scil_dims_t * dims, byte * out, size_t out_size, size_t block_size){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.force_compression_methods = "lz4";
+    hints.parallel_block_size = block_size;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    size_t compressed_size;
+    ret = scil_compress(out, out_size, data, dims, &compressed_size, context);
+    assert(ret == SCIL_NO_ERR);
+    scil_destroy_context(context);
+    return compressed_size;
+}
+
+static void test_dims(scil_dims_t * dims, scil_dims_t * offset, scil_dims_t * count){
+    size_t elements = scil_dims_get_count(dims);
+    size_t limit = scil_get_compressed_data_size_limit(dims, SCIL_TYPE_DOUBLE);
+    double * data = (double*) malloc(elements * sizeof(double));
+    byte * compressed = (byte*) malloc(limit);
+    for(size_t i = 0; i < elements; i++){
+        data[i] = (double) i;
+    }
+
+    // block container with an index and a single compressed stream
+    size_t block_sizes[] = {4000, 0};
+    for(int b = 0; b < 2; b++){
+        size_t compressed_size = compress(data, dims, compressed, limit, block_sizes[b]);
+        scil_frame_header_t header;
+        assert(scil_peek_header(compressed, compressed_size, &header) == SCIL_NO_ERR);
+        assert((compressed[header.header_size] == 255) == (block_sizes[b] > 0));
+        check_region(data, dims, compressed, compressed_size, offset, count);
+
+        // the complete data
+        scil_dims_t zero;
+        scil_dims_copy(&zero, dims);
+        memset(zero.length, 0, sizeof(zero.length));
+        check_region(data, dims, compressed, compressed_size, &zero, dims);
+
+        // invalid regions
+        scil_dims_t invalid;
+        scil_dims_copy(&invalid, count);
+        invalid.length[0] = dims->length[0] + 1;
+        assert(scil_decompress_region(SCIL_TYPE_DOUBLE, data, dims, offset, &invalid, compressed, compressed_size) == SCIL_EINVAL);
+    }
+    free(data);
+    free(compressed);
+}
+
+int main(void){
+    scil_dims_t dims, offset, count;
+
+    scil_dims_initialize_1d(&dims, 10000);
+    scil_dims_initialize_1d(&offset, 1234);
+    scil_dims_initialize_1d(&count, 3000);
+    test_dims(&dims, &offset, &count);
+
+    scil_dims_initialize_3d(&dims, 40, 30, 50);
+    scil_dims_initialize_3d(&offset, 5, 3, 20);
+    scil_dims_initialize_3d(&count, 10, 20, 7);
+    test_dims(&dims, &offset, &count);
+
+    // a single level
+    scil_dims_initialize_3d(&offset, 0, 0, 49);
+    scil_dims_initialize_3d(&count, 40, 30, 1);
+    test_dims(&dims, &offset, &count);
+
+    scil_dims_initialize_5d(&dims, 7, 6, 5, 4, 3);
+    scil_dims_initialize_5d(&offset, 1, 2, 3, 1, 1);
+    scil_dims_initialize_5d(&count, 5, 3, 2, 2, 2);
+    test_dims(&dims, &offset, &count);
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+int main(void){
+    scil_dims_t dims;
+    scil_dims_initialize_3d(&dims, 20, 10, 7);
+    const size_t count = scil_dims_get_count(&dims);
+    const size_t uncompressed_size = scil_dims_get_size(&dims, SCIL_TYPE_FLOAT);
+    const size_t compressed_limit = scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_FLOAT);
+
+    float* buffer_in = (float*) malloc(uncompressed_size);
+    byte* buffer_out = (byte*) malloc(compressed_limit);
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (float) (i % 100);
+    }
+
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.1;
+    hints.force_compression_methods = "abstol,lz4";
+    hints.checksum = 1;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_FLOAT, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    size_t out_size;
+    ret = scil_compress(buffer_out, compressed_limit, buffer_in, &dims, &out_size, context);
+    assert(ret == SCIL_NO_ERR);
+
+    // the header can be read without the payload
+    scil_frame_header_t header;
+    ret = scil_peek_header(buffer_out, 64, &header);
+    assert(ret == SCIL_NO_ERR);
+    assert(header.version == SCIL_FRAME_VERSION);
+    assert(header.datatype == SCIL_TYPE_FLOAT);
+    assert(header.dims.dims == 3);
+    assert(header.dims.length[0] == 20 && header.dims.length[1] == 10 && header.dims.length[2] == 7);
+    assert(header.uncompressed_size == uncompressed_size);
+    assert(header.chain_length == 2);
+    assert(header.has_checksum);
+    assert(header.header_size < out_size);
+
+    // allocate exactly what is needed
+    float* buffer_end = (float*) malloc(header.uncompressed_size);
+    byte* buffer_tmp = (byte*) malloc(header.tmp_buffer_size);
+    ret = scil_decompress(header.datatype, buffer_end, &header.dims, buffer_out, out_size, buffer_tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; ++i){
+        assert(buffer_end[i] - buffer_in[i] <= 0.1f && buffer_in[i] - buffer_end[i] <= 0.1f);
+    }
+
+    // a mismatching datatype is detected
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_end, &header.dims, buffer_out, out_size, buffer_tmp);
+    assert(ret == SCIL_EINVAL);
+
+    // corrupted data is detected by the checksum
+    buffer_out[out_size - 3] ^= 0x10;
+    ret = scil_decompress(header.datatype, buffer_end, &header.dims, buffer_out, out_size, buffer_tmp);
+    assert(ret == SCIL_BUFFER_ERR);
+
+    // data without a frame
+    byte raw[] = {1, 0, 0};
+    assert(scil_peek_header(raw, sizeof(raw), &header) == SCIL_EINVAL);
+
+    scil_destroy_context(context);
+    free(buffer_in);
+    free(buffer_out);
+    free(buffer_end);
+    free(buffer_tmp);
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Checks the huffman algorithm through scil_compress() for all integer types, for data within and beyond its alphabet.
+#include <scil.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t check_round_trip(SCIL_Datatype_t datatype, const void* data, scil_dims_t* dims){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.force_compression_methods = "huffman";
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t bound = scil_compress_bound(ctx, dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t size;
+    ret = scil_compress(compressed, bound, (void*) data, dims, &size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    scil_destroy_context(ctx);
+
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, size, &header) == SCIL_NO_ERR);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    const size_t data_size = scil_dims_get_size(dims, datatype);
+    byte* decompressed = (byte*) malloc(data_size + 1);
+    ret = scil_decompress(datatype, decompressed, dims, compressed, size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    assert(memcmp(data, decompressed, data_size) == 0);
+
+    free(decompressed);
+    free(tmp);
+    free(compressed);
+    return size;
+}
+
+// values around offset that follow a geometric distribution, wide adds a few values that exceed the alphabet
+static void fill(SCIL_Datatype_t datatype, void* data, size_t count, int64_t offset, int wide){
+    for(size_t i = 0; i < count; i++){
+        int64_t v = offset;
+        while(rand() % 2 != 0 && v < offset + 100){
+            v++;
+        }
+        if(wide && i % 1000 == 7){
+            v = offset + 100000 + (int64_t) i;
+        }
+        switch(datatype){
+        case(SCIL_TYPE_INT8):
+            ((int8_t*) data)[i] = (int8_t) v;
+            break;
+        case(SCIL_TYPE_INT16):
+            ((int16_t*) data)[i] = (int16_t) v;
+            break;
+        case(SCIL_TYPE_INT32):
+            ((int32_t*) data)[i] = (int32_t) v;
+            break;
+        default:
+            ((int64_t*) data)[i] = v;
+        }
+    }
+}
+
+int main(void){
+    const SCIL_Datatype_t types[] = {SCIL_TYPE_INT8, SCIL_TYPE_INT16, SCIL_TYPE_INT32, SCIL_TYPE_INT64};
+    const size_t count = 100000;
+    void* data = malloc(count * sizeof(int64_t));
+    scil_dims_t dims;
+
+    for(int t = 0; t < 4; t++){
+        const int64_t offset = types[t] == SCIL_TYPE_INT8 ? -50 : -1000;
+        scil_dims_initialize_1d(&dims, count);
+        fill(types[t], data, count, offset, 0);
+        // about 2 bits per value
+        const size_t size = check_round_trip(types[t], data, &dims);
+        printf("%s: %zu bytes\n", scil_datatype_to_str(types[t]), size);
+        assert(size < count / 2);
+
+        scil_dims_initialize_2d(&dims, 1, 1);
+        check_round_trip(types[t], data, &dims);
+        scil_dims_initialize_1d(&dims, 1001);
+        fill(types[t], data, 1001, offset, 0);
+        check_round_trip(types[t], data, &dims);
+
+        if(types[t] != SCIL_TYPE_INT8 && types[t] != SCIL_TYPE_INT16){
+            // stored as is
+            scil_dims_initialize_1d(&dims, count);
+            fill(types[t], data, count, offset, 1);
+            check_round_trip(types[t], data, &dims);
+        }
+    }
+    int64_t* extremes = (int64_t*) data;
+    extremes[0] = INT64_MIN;
+    extremes[1] = INT64_MAX;
+    extremes[2] = 0;
+    scil_dims_initialize_1d(&dims, 3);
+    check_round_trip(SCIL_TYPE_INT64, extremes, &dims);
+
+    // the floating point types are not supported
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.force_compression_methods = "huffman";
+    scil_context_t* ctx;
+    assert(scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints) == SCIL_EINVAL);
+
+    free(data);
+    printf("OK\n");
+    return 0;
+}
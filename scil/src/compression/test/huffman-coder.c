@@ -0,0 +1,114 @@
+// Checks the canonical Huffman coder: optimal and limited code lengths, round trips for small and large alphabets.
+#include <scil-huffman.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t kraft_sum(const uint8_t* lengths, uint32_t symbols, uint8_t max_length){
+    uint64_t sum = 0;
+    for(uint32_t i = 0; i < symbols; i++){
+        if(lengths[i] > 0){
+            assert(lengths[i] <= max_length);
+            sum += ((uint64_t) 1) << (max_length - lengths[i]);
+        }
+    }
+    return sum;
+}
+
+static void check_round_trip(const uint64_t* values, size_t count){
+    byte* compressed = (byte*) malloc(scil_huffman_compress_bound(count));
+    uint64_t* decompressed = (uint64_t*) malloc(count * sizeof(uint64_t) + 1);
+    size_t size;
+    int ret = scil_huffman_compress(compressed, &size, values, count);
+    assert(ret == SCIL_NO_ERR);
+    assert(size <= scil_huffman_compress_bound(count));
+    ret = scil_huffman_decompress(decompressed, count, compressed, size);
+    assert(ret == SCIL_NO_ERR);
+    assert(count == 0 || memcmp(values, decompressed, count * sizeof(uint64_t)) == 0);
+
+    // a truncated input is detected
+    if(count > 1000){
+        assert(scil_huffman_decompress(decompressed, count, compressed, size / 2) == SCIL_BUFFER_ERR);
+    }
+    free(compressed);
+    free(decompressed);
+}
+
+int main(void){
+    // the lengths of the example of "Cormen, Leiserson - Introduction to Algorithms", chapter 16.3
+    uint64_t frequencies[] = {45, 13, 12, 16, 9, 5, 0};
+    uint8_t lengths[7];
+    uint32_t codes[7];
+    assert(scil_huffman_code_lengths(lengths, frequencies, 7, 8) == SCIL_NO_ERR);
+    const uint8_t expected[] = {1, 3, 3, 3, 4, 4, 0};
+    assert(memcmp(lengths, expected, 7) == 0);
+    scil_huffman_canonical_codes(codes, lengths, 7);
+    assert(codes[0] == 0 && codes[1] == 4 && codes[2] == 5 && codes[3] == 6 && codes[4] == 14 && codes[5] == 15);
+
+    // Fibonacci frequencies produce the deepest tree, the lengths are limited
+    uint64_t fibonacci[30];
+    uint8_t fib_lengths[30];
+    fibonacci[0] = fibonacci[1] = 1;
+    for(int i = 2; i < 30; i++){
+        fibonacci[i] = fibonacci[i - 1] + fibonacci[i - 2];
+    }
+    assert(scil_huffman_code_lengths(fib_lengths, fibonacci, 30, SCIL_HUFFMAN_MAX_LENGTH) == SCIL_NO_ERR);
+    assert(fib_lengths[29] == 1);
+    for(uint8_t max_length = 5; max_length <= SCIL_HUFFMAN_MAX_LENGTH; max_length++){
+        assert(scil_huffman_code_lengths(fib_lengths, fibonacci, 30, max_length) == SCIL_NO_ERR);
+        assert(kraft_sum(fib_lengths, 30, max_length) <= ((uint64_t) 1) << max_length);
+        // more frequent symbols never get longer codes
+        for(int i = 1; i < 30; i++){
+            assert(fib_lengths[i] <= fib_lengths[i - 1]);
+        }
+    }
+    // 30 symbols do not fit into 4 bits
+    assert(scil_huffman_code_lengths(fib_lengths, fibonacci, 30, 4) == SCIL_EINVAL);
+
+    // a single symbol gets a code of one bit
+    uint64_t single[] = {0, 0, 7};
+    assert(scil_huffman_code_lengths(lengths, single, 3, 8) == SCIL_NO_ERR);
+    assert(lengths[0] == 0 && lengths[1] == 0 && lengths[2] == 1);
+
+    const size_t count = 1000000;
+    uint64_t* values = (uint64_t*) malloc(count * sizeof(uint64_t));
+
+    // quantized values around the center of the range, as produced by a predictor
+    for(size_t i = 0; i < count; i++){
+        const double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+        const double offset = -log(u) * 3;
+        values[i] = (uint64_t) (32768 + (i % 2 ? offset : -offset));
+    }
+    scil_timer timer;
+    scilU_start_timer(&timer);
+    check_round_trip(values, count);
+    printf("geometric: %.3fs\n", scilU_stop_timer(timer));
+
+    // the full alphabet with long codes
+    for(size_t i = 0; i < count; i++){
+        values[i] = i % 7 == 0 ? (i * 2654435761u) % SCIL_HUFFMAN_MAX_SYMBOLS : i % 5;
+    }
+    check_round_trip(values, count);
+
+    // small inputs
+    check_round_trip(values, 0);
+    check_round_trip(values, 1);
+    values[0] = 65535;
+    check_round_trip(values, 1);
+    check_round_trip(values, 17);
+
+    // values that exceed the alphabet are rejected
+    byte out[64];
+    size_t size;
+    values[0] = SCIL_HUFFMAN_MAX_SYMBOLS;
+    assert(scil_huffman_compress(out, &size, values, 1) == SCIL_EINVAL);
+
+    free(values);
+    printf("OK\n");
+    return 0;
+}
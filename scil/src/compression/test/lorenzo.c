@@ -0,0 +1,118 @@
+// Checks that the lorenzo preconditioner is lossless for all datatypes and dimensions and that it reduces the size of smooth fields.
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+static size_t round_trip(const char* chain, SCIL_Datatype_t datatype, void* data, scil_dims_t* dims){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.force_compression_methods = chain;
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t size = scil_dims_get_size(dims, datatype);
+    const size_t bound = scil_compress_bound(ctx, dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t compressed_size;
+    ret = scil_compress(compressed, bound, data, dims, &compressed_size, ctx);
+    assert(ret == SCIL_NO_ERR);
+
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, compressed_size, &header) == SCIL_NO_ERR);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    byte* decompressed = (byte*) malloc(size + 1);
+    ret = scil_decompress(datatype, decompressed, dims, compressed, compressed_size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    assert(memcmp(decompressed, data, size) == 0);
+
+    free(decompressed);
+    free(tmp);
+    free(compressed);
+    scil_destroy_context(ctx);
+    return compressed_size;
+}
+
+// a smooth field, or blocks close to linear functions with some noise
+static double field(const size_t* x, int dims, int variant){
+    double v = 10;
+    double phase = 0;
+    for(int k = 0; k < dims; k++){
+        v += variant == 0 ? 0 : x[k] * (0.5 + k);
+        phase += x[k] * (0.0213 + 0.0137 * k * k);
+    }
+    if(variant == 0){
+        return v + sin(phase) * cos(x[0] * 0.013) * 20;
+    }
+    return v + (rand() % 100) * 0.001;
+}
+
+static void fill(SCIL_Datatype_t datatype, void* data, const scil_dims_t* dims, int variant){
+    const size_t count = scil_dims_get_count(dims);
+    for(size_t i = 0; i < count; i++){
+        size_t x[4] = {0};
+        size_t rest = i;
+        for(int k = 0; k < dims->dims; k++){
+            x[k] = rest % dims->length[k];
+            rest /= dims->length[k];
+        }
+        const double v = field(x, dims->dims, variant);
+        switch(datatype){
+            case SCIL_TYPE_FLOAT: ((float*) data)[i] = (float) v; break;
+            case SCIL_TYPE_DOUBLE: ((double*) data)[i] = v; break;
+            case SCIL_TYPE_INT8: ((int8_t*) data)[i] = (int8_t) (v * 3); break;
+            case SCIL_TYPE_INT16: ((int16_t*) data)[i] = (int16_t) (v * 100); break;
+            case SCIL_TYPE_INT32: ((int32_t*) data)[i] = (int32_t) (v * 1000); break;
+            case SCIL_TYPE_INT64: ((int64_t*) data)[i] = (int64_t) (v * 1e6); break;
+            default: assert(0);
+        }
+    }
+}
+
+int main(void){
+    const SCIL_Datatype_t types[] = {SCIL_TYPE_FLOAT, SCIL_TYPE_DOUBLE, SCIL_TYPE_INT8, SCIL_TYPE_INT16, SCIL_TYPE_INT32, SCIL_TYPE_INT64};
+    scil_dims_t shapes[5];
+    scil_dims_initialize_1d(&shapes[0], 100003);
+    scil_dims_initialize_2d(&shapes[1], 300, 201);
+    scil_dims_initialize_3d(&shapes[2], 50, 41, 33);
+    scil_dims_initialize_4d(&shapes[3], 17, 16, 9, 20);
+    // shapes without a full block
+    scil_dims_initialize_3d(&shapes[4], 1, 3, 7);
+
+    void* data = malloc(100003 * sizeof(double));
+    for(int s = 0; s < 5; s++){
+        for(int t = 0; t < 6; t++){
+            for(int variant = 0; variant < 2; variant++){
+                fill(types[t], data, &shapes[s], variant);
+                const size_t lorenzo = round_trip("lorenzo,zstd", types[t], data, &shapes[s]);
+                const size_t delta = round_trip("delta,zstd", types[t], data, &shapes[s]);
+                if(types[t] == SCIL_TYPE_DOUBLE && variant == 0){
+                    printf("%dD double: lorenzo,zstd %zu delta,zstd %zu\n", shapes[s].dims, lorenzo, delta);
+                }
+            }
+        }
+    }
+
+    // special values are preserved bit by bit
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 64, 64);
+    double* special = (double*) data;
+    fill(SCIL_TYPE_DOUBLE, special, &dims, 1);
+    special[5] = -0.0;
+    special[70] = NAN;
+    special[300] = INFINITY;
+    special[301] = -INFINITY;
+    special[1000] = -1e300;
+    special[1001] = 4.9e-324;
+    round_trip("lorenzo,zstd", SCIL_TYPE_DOUBLE, special, &dims);
+    round_trip("lorenzo", SCIL_TYPE_DOUBLE, special, &dims);
+
+    free(data);
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Checks the min/max reductions against a plain loop, the parallel variant, the context cache and reports the throughput.
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-minmax.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void reference_double(const double* buffer, size_t count, double* minimum, double* maximum, double ignore_up_to, double ignore_from, double fill_value){
+    double min = INFINITY;
+    double max = -INFINITY;
+    // with a fill value the lossless range is excluded only if both bounds are set
+    const int use_fill = fill_value < DBL_MAX;
+    const int use_range = ! use_fill || (ignore_up_to > -DBL_MAX && ignore_from < DBL_MAX);
+    for(size_t i = 0; i < count; i++){
+        if(use_fill && fabs(buffer[i] - fill_value) < FLT_EPSILON) continue;
+        if(use_range && (buffer[i] > ignore_from || buffer[i] < ignore_up_to)) continue;
+        if(buffer[i] < min) min = buffer[i];
+        if(buffer[i] > max) max = buffer[i];
+    }
+    *minimum = min;
+    *maximum = max;
+}
+
+static void check_double(const double* buffer, size_t count, double ignore_up_to, double ignore_from, double fill_value){
+    double min, max, emin, emax;
+    reference_double(buffer, count, &emin, &emax, ignore_up_to, ignore_from, fill_value);
+    scilU_find_minimum_maximum_with_excluded_points_double(buffer, count, &min, &max, ignore_up_to, ignore_from, fill_value);
+    assert(min == emin && max == emax);
+    scilU_find_minimum_maximum_parallel_double(buffer, count, &min, &max, ignore_up_to, ignore_from, fill_value, 4);
+    assert(min == emin && max == emax);
+}
+
+static void test_double(){
+    const size_t max_count = 1000;
+    double* buffer = (double*) malloc(max_count * sizeof(double));
+    for(size_t count = 1; count < max_count; count += 1 + count / 4){
+        for(size_t i = 0; i < count; i++){
+            buffer[i] = (rand() % 2001 - 1000) * 0.5;
+        }
+        buffer[rand() % count] = -99.5;
+        check_double(buffer, count, -DBL_MAX, DBL_MAX, DBL_MAX);
+        check_double(buffer, count, -DBL_MAX, DBL_MAX, -99.5);
+        check_double(buffer, count, -100, DBL_MAX, DBL_MAX);
+        check_double(buffer, count, -DBL_MAX, 100, DBL_MAX);
+        check_double(buffer, count, -100, 100, DBL_MAX);
+        // a fill value together with a single bound ignores the bound
+        check_double(buffer, count, -200, DBL_MAX, -99.5);
+        check_double(buffer, count, -DBL_MAX, 0, -99.5);
+
+        // NaN values are ignored
+        buffer[count / 2] = NAN;
+        check_double(buffer, count, -DBL_MAX, DBL_MAX, DBL_MAX);
+        check_double(buffer, count, -100, 100, -99.5);
+    }
+    free(buffer);
+}
+
+static void test_int(){
+    const size_t count = 777;
+    int8_t* i8 = (int8_t*) malloc(count);
+    int64_t* i64 = (int64_t*) malloc(count * sizeof(int64_t));
+    for(size_t i = 0; i < count; i++){
+        i8[i] = (int8_t) (i * 7);
+        i64[i] = ((int64_t) i - 300) * 1000000000000ll;
+    }
+    int8_t min8, max8;
+    scilU_find_minimum_maximum_int8_t(i8, count, &min8, &max8);
+    assert(min8 == INT8_MIN && max8 == INT8_MAX);
+    scilU_find_minimum_maximum_with_excluded_points_int8_t(i8, count, &min8, &max8, -10, 10, 0);
+    assert(min8 == -10 && max8 == 10);
+    scilU_find_minimum_maximum_with_excluded_points_int8_t(i8, count, &min8, &max8, -DBL_MAX, 10, 0);
+    assert(min8 == INT8_MIN && max8 == INT8_MAX);
+
+    int64_t min64, max64;
+    scilU_find_minimum_maximum_int64_t(i64, count, &min64, &max64);
+    assert(min64 == -300 * 1000000000000ll && max64 == 476 * 1000000000000ll);
+    free(i8);
+    free(i64);
+}
+
+static void test_cache(){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_FLOAT, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    float buffer[100];
+    for(int i = 0; i < 100; i++){
+        buffer[i] = (float) i;
+    }
+    float min, max;
+    scilC_context_set_input(ctx, buffer);
+    scilC_find_minimum_maximum_float(ctx, buffer, 100, &min, &max);
+    assert(min == 0 && max == 99);
+
+    // a cached result is returned while the context considers the buffer unchanged
+    buffer[0] = -1;
+    scilC_find_minimum_maximum_float(ctx, buffer, 100, &min, &max);
+    assert(min == 0);
+    // other parameters and buffers are determined again
+    scilC_find_minimum_maximum_with_excluded_points_float(ctx, buffer, 100, &min, &max, -DBL_MAX, 50, DBL_MAX);
+    assert(min == -1 && max == 50);
+    scilC_find_minimum_maximum_float(ctx, buffer + 1, 99, &min, &max);
+    assert(min == 1 && max == 99);
+    scilC_context_set_input(ctx, buffer);
+    scilC_find_minimum_maximum_float(ctx, buffer, 100, &min, &max);
+    assert(min == -1 && max == 99);
+
+    scil_destroy_context(ctx);
+}
+
+static void benchmark(){
+    const size_t count = 64 * 1024 * 1024;
+    double* buffer = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; i++){
+        buffer[i] = (double) (i % 10000) * 0.001;
+    }
+    double min, max, emin, emax;
+    scil_timer timer;
+    scilU_start_timer(&timer);
+    reference_double(buffer, count, &emin, &emax, -DBL_MAX, DBL_MAX, DBL_MAX);
+    const double t_reference = scilU_stop_timer(timer);
+
+    scilU_start_timer(&timer);
+    scilU_find_minimum_maximum_double(buffer, count, &min, &max);
+    const double t_plain = scilU_stop_timer(timer);
+    assert(min == emin && max == emax);
+
+    scilU_start_timer(&timer);
+    scilU_find_minimum_maximum_with_excluded_points_double(buffer, count, &min, &max, 1, 9, 5);
+    const double t_excluded = scilU_stop_timer(timer);
+
+    scilU_start_timer(&timer);
+    scilU_find_minimum_maximum_parallel_double(buffer, count, &min, &max, -DBL_MAX, DBL_MAX, DBL_MAX, 8);
+    const double t_parallel = scilU_stop_timer(timer);
+    assert(min == emin && max == emax);
+
+    const double mib = count * sizeof(double) / 1024.0 / 1024.0;
+    printf("min/max reference: %.1f MiB/s plain: %.1f MiB/s excluded points: %.1f MiB/s parallel: %.1f MiB/s\n",
+        mib / t_reference, mib / t_plain, mib / t_excluded, mib / t_parallel);
+    free(buffer);
+}
+
+int main(void){
+    srand(1);
+    test_double();
+    test_int();
+    test_cache();
+    benchmark();
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Checks that predquant keeps the error bound, fill values and special values and that its output does not depend on the threads.
+#include <scil.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t compress(const char* chain, SCIL_Datatype_t datatype, void* data, scil_dims_t* dims, double abs_tol, double fill_value, int threads, byte** out){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = abs_tol;
+    hints.fill_value = fill_value;
+    hints.parallel_threads = threads;
+    hints.force_compression_methods = (char*) chain;
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t bound = scil_compress_bound(ctx, dims);
+    *out = (byte*) malloc(bound);
+    size_t size;
+    ret = scil_compress(*out, bound, data, dims, &size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    scil_destroy_context(ctx);
+    return size;
+}
+
+static double value_at(SCIL_Datatype_t datatype, const void* data, size_t i){
+    return datatype == SCIL_TYPE_FLOAT ? (double) ((const float*) data)[i] : ((const double*) data)[i];
+}
+
+static size_t check_round_trip(const char* chain, SCIL_Datatype_t datatype, void* data, scil_dims_t* dims, double abs_tol, double fill_value){
+    byte* compressed;
+    const size_t size = compress(chain, datatype, data, dims, abs_tol, fill_value, 1, &compressed);
+
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, size, &header) == SCIL_NO_ERR);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    byte* decompressed = (byte*) malloc(scil_dims_get_size(dims, datatype) + 1);
+    int ret = scil_decompress(datatype, decompressed, dims, compressed, size, tmp);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t count = scil_dims_get_count(dims);
+    for(size_t i = 0; i < count; i++){
+        const double expected = value_at(datatype, data, i);
+        const double got = value_at(datatype, decompressed, i);
+        if(isnan(expected)){
+            assert(isnan(got));
+        }else if((expected <= fill_value && expected >= fill_value) || isinf(expected)){
+            assert(got <= expected && got >= expected);
+        }else{
+            assert(fabs(got - expected) <= abs_tol);
+        }
+    }
+
+    free(decompressed);
+    free(tmp);
+    free(compressed);
+    return size;
+}
+
+static void fill(SCIL_Datatype_t datatype, void* data, const scil_dims_t* dims){
+    const size_t count = scil_dims_get_count(dims);
+    for(size_t i = 0; i < count; i++){
+        double phase = 0;
+        size_t rest = i;
+        for(int k = 0; k < dims->dims; k++){
+            phase += (rest % dims->length[k]) * (0.0213 + 0.0137 * k * k);
+            rest /= dims->length[k];
+        }
+        const double v = 10 + sin(phase) * 20 + (rand() % 100) * 0.0001;
+        if(datatype == SCIL_TYPE_FLOAT){
+            ((float*) data)[i] = (float) v;
+        }else{
+            ((double*) data)[i] = v;
+        }
+    }
+}
+
+int main(void){
+    const SCIL_Datatype_t types[] = {SCIL_TYPE_FLOAT, SCIL_TYPE_DOUBLE};
+    scil_dims_t shapes[6];
+    scil_dims_initialize_1d(&shapes[0], 100003);
+    scil_dims_initialize_2d(&shapes[1], 300, 201);
+    scil_dims_initialize_3d(&shapes[2], 50, 41, 33);
+    scil_dims_initialize_4d(&shapes[3], 17, 16, 9, 20);
+    scil_dims_initialize_3d(&shapes[4], 1, 3, 7);
+    // several blocks
+    scil_dims_initialize_2d(&shapes[5], 1000, 700);
+
+    void* data = malloc(700000 * sizeof(double));
+    for(int s = 0; s < 6; s++){
+        for(int t = 0; t < 2; t++){
+            fill(types[t], data, &shapes[s]);
+            check_round_trip("predquant", types[t], data, &shapes[s], 0.01, DBL_MAX);
+            check_round_trip("predquant", types[t], data, &shapes[s], 1e-5, DBL_MAX);
+        }
+    }
+
+    // fill values, outliers and special values
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 300, 200);
+    double* d = (double*) data;
+    fill(SCIL_TYPE_DOUBLE, d, &dims);
+    for(size_t i = 0; i < 60000; i += 97){
+        d[i] = -999;
+    }
+    d[5] = 1e300;
+    d[6] = -1e300;
+    d[7] = NAN;
+    d[300] = INFINITY;
+    d[301] = -INFINITY;
+    d[1000] = 1e20;
+    check_round_trip("predquant", SCIL_TYPE_DOUBLE, d, &dims, 0.01, -999);
+    check_round_trip("predquant", SCIL_TYPE_DOUBLE, d, &dims, 1e-12, -999);
+    float* f = (float*) data;
+    fill(SCIL_TYPE_FLOAT, f, &dims);
+    for(size_t i = 0; i < 60000; i += 97){
+        f[i] = -999.0f;
+    }
+    f[7] = NAN;
+    f[300] = INFINITY;
+    f[2000] = 3e38f;
+    check_round_trip("predquant", SCIL_TYPE_FLOAT, f, &dims, 0.001, -999);
+
+    // the blocks are compressed in parallel, the result is the same for any number of threads
+    fill(SCIL_TYPE_DOUBLE, data, &shapes[5]);
+    byte* single;
+    const size_t single_size = compress("predquant", SCIL_TYPE_DOUBLE, data, &shapes[5], 0.01, DBL_MAX, 1, &single);
+    for(int threads = 2; threads <= 8; threads *= 2){
+        byte* parallel;
+        const size_t size = compress("predquant", SCIL_TYPE_DOUBLE, data, &shapes[5], 0.01, DBL_MAX, threads, &parallel);
+        assert(size == single_size);
+        assert(memcmp(single, parallel, size) == 0);
+        free(parallel);
+    }
+    free(single);
+
+    const char* chains[] = {"predquant", "rans", "abstol,zstd"};
+    for(int c = 0; c < 3; c++){
+        printf("%s: %zu bytes\n", chains[c], check_round_trip(chains[c], SCIL_TYPE_DOUBLE, data, &shapes[5], 0.01, DBL_MAX));
+    }
+
+    free(data);
+    printf("OK\n");
+    return 0;
+}
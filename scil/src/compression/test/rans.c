@@ -0,0 +1,203 @@
+// Checks the interleaved rANS coder and the rans algorithm that codes quantized values with it, including its exceptions.
+#include <scil-compressor.h>
+#include <scil-rans.h>
+#include <scil.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t check_round_trip(const uint64_t* values, size_t count){
+    byte* compressed = (byte*) malloc(scil_rans_compress_bound(count));
+    uint64_t* decompressed = (uint64_t*) malloc(count * sizeof(uint64_t) + 1);
+    size_t size;
+    int ret = scil_rans_compress(compressed, &size, values, count);
+    assert(ret == SCIL_NO_ERR);
+    assert(size <= scil_rans_compress_bound(count));
+    ret = scil_rans_decompress(decompressed, count, compressed, size);
+    assert(ret == SCIL_NO_ERR);
+    assert(count == 0 || memcmp(values, decompressed, count * sizeof(uint64_t)) == 0);
+
+    // a truncated or modified input is detected
+    if(count > 1000){
+        assert(scil_rans_decompress(decompressed, count, compressed, size / 2) == SCIL_BUFFER_ERR);
+        compressed[size - 3] ^= 0x10;
+        assert(scil_rans_decompress(decompressed, count, compressed, size) == SCIL_BUFFER_ERR);
+    }
+    free(compressed);
+    free(decompressed);
+    return size;
+}
+
+static size_t compress_chain(const char* chain, const scil_user_hints_t* base, double* data, scil_dims_t* dims, double* elapsed){
+    scil_user_hints_t hints = *base;
+    hints.force_compression_methods = (char*) chain;
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t count = scil_dims_get_count(dims);
+    const size_t bound = scil_compress_bound(ctx, dims);
+    byte* compressed = (byte*) malloc(bound);
+    size_t size;
+    scil_timer timer;
+    scilU_start_timer(&timer);
+    ret = scil_compress(compressed, bound, data, dims, &size, ctx);
+    *elapsed = scilU_stop_timer(timer);
+    assert(ret == SCIL_NO_ERR);
+
+    scil_frame_header_t header;
+    assert(scil_peek_header(compressed, size, &header) == SCIL_NO_ERR);
+    byte* tmp = (byte*) malloc(header.tmp_buffer_size + 1);
+    double* decompressed = (double*) malloc(count * sizeof(double));
+    scilU_start_timer(&timer);
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, decompressed, dims, compressed, size, tmp);
+    *elapsed += scilU_stop_timer(timer);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; i++){
+        const double v = data[i];
+        if(isnan(v)){
+            assert(isnan(decompressed[i]));
+        }else if((v <= hints.fill_value && v >= hints.fill_value) || v <= hints.lossless_data_range_up_to || v >= hints.lossless_data_range_from || isinf(v)){
+            assert(memcmp(&decompressed[i], &v, sizeof(double)) == 0);
+        }else{
+            assert(fabs(decompressed[i] - v) <= hints.absolute_tolerance * 1.0001);
+        }
+    }
+    free(decompressed);
+    free(tmp);
+    free(compressed);
+    scil_destroy_context(ctx);
+    return size;
+}
+
+// a stream of the first version of rans: the zigzag mapped differences of neighbouring bins without a predictor
+static void check_delta_version(void){
+    const size_t count = 10000;
+    uint64_t* deltas = (uint64_t*) malloc(count * sizeof(uint64_t));
+    int64_t previous = 0;
+    for(size_t i = 0; i < count; i++){
+        const int64_t bin = (int64_t) (i % 7);
+        const int64_t d = i == 0 ? bin : bin - previous;
+        deltas[i] = ((uint64_t) d << 1) ^ (uint64_t) (d >> 63);
+        previous = bin;
+    }
+    // the chain length, the version, the minimum and the tolerance, the coded bins and the id of rans
+    byte* chain = (byte*) malloc(18 + scil_rans_compress_bound(count) + 1);
+    chain[0] = 1;
+    chain[1] = 1;
+    const double minimum = 0;
+    const double abs_tol = 0.5;
+    memcpy(chain + 2, &minimum, sizeof(double));
+    memcpy(chain + 10, &abs_tol, sizeof(double));
+    size_t size;
+    int ret = scil_rans_compress(chain + 18, &size, deltas, count);
+    assert(ret == SCIL_NO_ERR);
+    chain[18 + size] = (byte) scilU_get_compressor_number("rans");
+
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, count);
+    double* decompressed = (double*) malloc(count * sizeof(double));
+    byte* tmp = (byte*) malloc(2 * (2 * count * sizeof(double) + 10));
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, decompressed, &dims, chain, 18 + size + 1, tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t i = 0; i < count; i++){
+        assert(fabs(decompressed[i] - (double) (i % 7)) <= abs_tol);
+    }
+
+    // an unknown version
+    chain[1] = 3;
+    assert(scil_decompress(SCIL_TYPE_DOUBLE, decompressed, &dims, chain, 18 + size + 1, tmp) == SCIL_BUFFER_ERR);
+    free(tmp);
+    free(decompressed);
+    free(chain);
+    free(deltas);
+}
+
+int main(void){
+    const size_t count = 1000000;
+    uint64_t* values = (uint64_t*) malloc(count * sizeof(uint64_t));
+
+    // zigzag mapped residuals of a predictor, few values escape the model
+    for(size_t i = 0; i < count; i++){
+        const double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+        values[i] = (uint64_t) (-log(u) * 6);
+    }
+    values[17] = UINT64_MAX;
+    values[18] = 255;
+    size_t size = check_round_trip(values, count);
+    printf("geometric: %zu -> %zu\n", count * sizeof(uint64_t), size);
+
+    // a single symbol costs no words
+    memset(values, 0, count * sizeof(uint64_t));
+    size = check_round_trip(values, count);
+    assert(size < 64);
+
+    // all values escape
+    for(size_t i = 0; i < count; i++){
+        values[i] = 1000 + i;
+    }
+    check_round_trip(values, count);
+
+    // small inputs that do not fill all interleaved states
+    for(size_t i = 0; i < 20; i++){
+        values[i] = i % 3;
+    }
+    for(size_t n = 0; n < 20; n++){
+        check_round_trip(values, n);
+    }
+
+    // the algorithm through the chain, a smooth field with noise
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 1000, 500);
+    double* data = (double*) malloc(scil_dims_get_count(&dims) * sizeof(double));
+    for(size_t i = 0; i < scil_dims_get_count(&dims); i++){
+        data[i] = sin(i * 0.0005) * 100 + (rand() / (double) RAND_MAX) * 0.1;
+    }
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    const char* chains[] = {"rans", "abstol,lz4", "abstol,zstd"};
+    size_t sizes[3];
+    for(int c = 0; c < 3; c++){
+        double elapsed;
+        sizes[c] = compress_chain(chains[c], &hints, data, &dims, &elapsed);
+        printf("%s: %zu bytes, %.4fs\n", chains[c], sizes[c], elapsed);
+    }
+    assert(sizes[0] <= sizes[1]);
+
+    // fill values, the lossless ranges and values that are not finite are kept exactly
+    for(size_t i = 0; i < scil_dims_get_count(&dims); i += 37){
+        data[i] = -999;
+    }
+    data[1] = NAN;
+    data[2] = INFINITY;
+    data[3] = -INFINITY;
+    data[4] = 1e300;
+    data[5000] = 1000.5;
+    data[5001] = -1000.5;
+    hints.fill_value = -999;
+    hints.lossless_data_range_up_to = -1000;
+    hints.lossless_data_range_from = 1000;
+    double elapsed;
+    size = compress_chain("rans", &hints, data, &dims, &elapsed);
+    printf("rans with exceptions: %zu bytes\n", size);
+    assert(size <= sizes[0] + sizes[0] / 2);
+
+    // only exceptions
+    scil_dims_initialize_1d(&dims, 1000);
+    for(size_t i = 0; i < 1000; i++){
+        data[i] = i % 2 ? -999 : NAN;
+    }
+    compress_chain("rans", &hints, data, &dims, &elapsed);
+
+    check_delta_version();
+
+    free(data);
+    free(values);
+    printf("OK\n");
+    return 0;
+}
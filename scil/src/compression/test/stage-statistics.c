@@ -0,0 +1,106 @@
+// Checks the counters of the compression stages of a context.
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+static void compress(scil_context_t* context, double * buffer_in, scil_dims_t * dims, byte * buffer_out, size_t compressed_size){
+    size_t out_size;
+    int ret = scil_compress(buffer_out, compressed_size, buffer_in, dims, &out_size, context);
+    assert(ret == SCIL_NO_ERR);
+}
+
+static scil_context_t* create(const char * chain, int threads, size_t block_size){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = (char*) chain;
+    hints.parallel_threads = threads;
+    hints.parallel_block_size = block_size;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    return context;
+}
+
+int main(void){
+    scil_dims_t dims;
+    scil_dims_initialize_1d(&dims, 100000);
+    const size_t count = scil_dims_get_count(&dims);
+    const size_t uncompressed_size = scil_dims_get_size(&dims, SCIL_TYPE_DOUBLE);
+    const size_t compressed_size = scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
+
+    double* buffer_in = (double*)malloc(uncompressed_size);
+    byte* buffer_out = (byte*)malloc(compressed_size);
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (i % 1000) * 0.1;
+    }
+
+    scil_statistics_t stats;
+    scil_context_t* context = create("delta,abstol,lz4", 1, 0);
+    // disabled by default
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    assert(scil_context_get_statistics(context, &stats) == SCIL_EINVAL);
+    assert(stats.stage[SCIL_STAGE_BYTE_COMPRESSOR].calls == 0);
+
+    scil_context_enable_statistics(context, 1);
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    assert(scil_context_get_statistics(context, &stats) == SCIL_NO_ERR);
+    for(int i = 0; i < SCIL_STAGE_LAST; i++){
+        printf("%s: %llu calls %llu ns %llu -> %llu\n", scil_stage_names[i], (unsigned long long) stats.stage[i].calls,
+               (unsigned long long) stats.stage[i].ns, (unsigned long long) stats.stage[i].bytes_in, (unsigned long long) stats.stage[i].bytes_out);
+    }
+    const scil_stage_statistics_t * precond = &stats.stage[SCIL_STAGE_PRECONDITIONER];
+    const scil_stage_statistics_t * data = &stats.stage[SCIL_STAGE_DATA_COMPRESSOR];
+    const scil_stage_statistics_t * bytes = &stats.stage[SCIL_STAGE_BYTE_COMPRESSOR];
+    assert(precond->calls == 2 && precond->bytes_in == 2 * uncompressed_size);
+    assert(data->calls == 2 && data->bytes_in == 2 * uncompressed_size);
+    assert(data->bytes_out < data->bytes_in);
+    assert(bytes->calls == 2 && bytes->bytes_in > data->bytes_out && bytes->bytes_out > 0);
+    assert(stats.stage[SCIL_STAGE_CONVERTER].calls == 0);
+    // the chain is forced
+    assert(stats.stage[SCIL_STAGE_CHOOSER].calls == 0);
+
+    // disabling keeps the counters
+    scil_context_enable_statistics(context, 0);
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    scil_statistics_t kept;
+    assert(scil_context_get_statistics(context, &kept) == SCIL_NO_ERR);
+    assert(kept.stage[SCIL_STAGE_BYTE_COMPRESSOR].calls == 2);
+
+    scil_context_reset_statistics(context);
+    assert(scil_context_get_statistics(context, &stats) == SCIL_NO_ERR);
+    assert(stats.stage[SCIL_STAGE_BYTE_COMPRESSOR].calls == 0 && stats.stage[SCIL_STAGE_BYTE_COMPRESSOR].ns == 0);
+    scil_destroy_context(context);
+
+    // the blocks compressed by the threads are added up
+    context = create("abstol,lz4", 4, 80000);
+    scil_context_enable_statistics(context, 1);
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    assert(scil_context_get_statistics(context, &stats) == SCIL_NO_ERR);
+    assert(stats.stage[SCIL_STAGE_DATA_COMPRESSOR].calls == 10);
+    assert(stats.stage[SCIL_STAGE_DATA_COMPRESSOR].bytes_in == uncompressed_size);
+    assert(stats.stage[SCIL_STAGE_BYTE_COMPRESSOR].calls == 10);
+    scil_destroy_context(context);
+
+    // the chooser is accounted when it selects the chain
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    assert(scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints) == SCIL_NO_ERR);
+    scil_context_enable_statistics(context, 1);
+    compress(context, buffer_in, &dims, buffer_out, compressed_size);
+    assert(scil_context_get_statistics(context, &stats) == SCIL_NO_ERR);
+    assert(stats.stage[SCIL_STAGE_CHOOSER].calls == 1 && stats.stage[SCIL_STAGE_CHOOSER].ns > 0);
+    assert(stats.stage[SCIL_STAGE_CHOOSER].bytes_in == uncompressed_size);
+    scil_destroy_context(context);
+
+    free(buffer_in);
+    free(buffer_out);
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Checks that data compressed slab by slab can be decompressed at once and block by block.
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+
+typedef struct {
+    byte * data;
+    size_t size;
+    size_t capacity;
+    size_t pos;
+    size_t largest_write;
+} memory_t;
+
+static int memory_write(void * user_ptr, const byte * data, size_t size){
+    memory_t * m = (memory_t*) user_ptr;
+    if(m->size + size > m->capacity){
+        m->capacity = 2 * (m->size + size);
+        m->data = (byte*) realloc(m->data, m->capacity);
+    }
+    memcpy(m->data + m->size, data, size);
+    m->size += size;
+    m->largest_write = size > m->largest_write ? size : m->largest_write;
+    return SCIL_NO_ERR;
+}
+
+static int memory_read(void * user_ptr, byte * data, size_t size){
+    memory_t * m = (memory_t*) user_ptr;
+    if(m->pos + size > m->size){
+        return SCIL_BUFFER_ERR;
+    }
+    memcpy(data, m->data + m->pos, size);
+    m->pos += size;
+    return SCIL_NO_ERR;
+}
+
+static scil_context_t* create(const char * chain){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = (char*) chain;
+    hints.parallel_block_size = 64 * 1024;
+
+    scil_context_t* context;
+    int ret = scil_context_create(&context, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    return context;
+}
+
+static void check(const double * expected, const double * data, size_t count){
+    for(size_t i = 0; i < count; ++i){
+        assert(data[i] - expected[i] <= 0.01 && expected[i] - data[i] <= 0.01);
+    }
+}
+
+// push the levels of the slowest dimension in slabs of varying size
+static void compress(scil_context_t * context, scil_dims_t * dims, const double * data, memory_t * out){
+    scil_stream_t * stream;
+    int ret = scil_stream_begin(&stream, context, dims, memory_write, out);
+    assert(ret == SCIL_NO_ERR);
+    const size_t level = dims->length[0] * dims->length[1];
+    const size_t levels = dims->length[2];
+    for(size_t l = 0; l < levels; ){
+        const size_t n = l % 3 + 1 < levels - l ? l % 3 + 1 : levels - l;
+        ret = scil_stream_push(stream, data + l * level, n * level);
+        assert(ret == SCIL_NO_ERR);
+        l += n;
+    }
+    // the dims are complete
+    assert(scil_stream_push(stream, data, 1) == SCIL_EINVAL);
+    size_t size;
+    ret = scil_stream_end(stream, &size);
+    assert(ret == SCIL_NO_ERR);
+    assert(size == out->size);
+}
+
+int main(void){
+    scil_dims_t dims;
+    scil_dims_initialize_3d(&dims, 30, 20, 101);
+    const size_t count = scil_dims_get_count(&dims);
+    const size_t uncompressed_size = scil_dims_get_size(&dims, SCIL_TYPE_DOUBLE);
+
+    double* buffer_in = (double*)malloc(uncompressed_size);
+    double* buffer_out = (double*)malloc(uncompressed_size);
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (i % 1000) * 0.1 + ((double)rand()/RAND_MAX);
+    }
+
+    const char * chains[] = {"abstol,lz4", "delta,zstd", NULL};
+    for(int c = 0; chains[c] != NULL; c++){
+        memory_t out = {0};
+        scil_context_t * context = create(chains[c]);
+        compress(context, &dims, buffer_in, &out);
+        scil_destroy_context(context);
+        printf("%s: %zu -> %zu, largest write %zu\n", chains[c], uncompressed_size, out.size, out.largest_write);
+        // the blocks are written individually
+        assert(out.largest_write < 64 * 1024);
+
+        scil_frame_header_t header;
+        assert(scil_peek_header(out.data, out.size, &header) == SCIL_NO_ERR);
+        assert(header.tmp_buffer_size == 0 && header.uncompressed_size == uncompressed_size);
+
+        memset(buffer_out, 0, uncompressed_size);
+        int ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_out, &dims, out.data, out.size, NULL);
+        assert(ret == SCIL_NO_ERR);
+        check(buffer_in, buffer_out, count);
+
+        // the region is extracted from the complete data
+        scil_dims_t offset, region;
+        scil_dims_initialize_3d(&offset, 5, 3, 40);
+        scil_dims_initialize_3d(&region, 10, 2, 30);
+        double region_out[10 * 2 * 30];
+        ret = scil_decompress_region(SCIL_TYPE_DOUBLE, region_out, &dims, &offset, &region, out.data, out.size);
+        assert(ret == SCIL_NO_ERR);
+        assert(region_out[0] - buffer_in[40 * 600 + 3 * 30 + 5] <= 0.01);
+
+        // pull the blocks one after another
+        scil_stream_reader_t * reader;
+        ret = scil_stream_open(&reader, memory_read, &out, &header);
+        assert(ret == SCIL_NO_ERR);
+        assert(header.datatype == SCIL_TYPE_DOUBLE && header.dims.length[2] == 101);
+        size_t pulled = 0;
+        while(1){
+            const void * data;
+            size_t n;
+            ret = scil_stream_pull(reader, &data, &n);
+            assert(ret == SCIL_NO_ERR);
+            if(n == 0){
+                break;
+            }
+            check(buffer_in + pulled, (const double*) data, n);
+            pulled += n;
+        }
+        assert(pulled == count);
+        assert(out.pos == out.size);
+        scil_stream_close(reader);
+        free(out.data);
+    }
+
+    // the chooser selects the chain with the first block
+    memory_t out = {0};
+    scil_context_t * context = create(NULL);
+    compress(context, &dims, buffer_in, &out);
+    scil_destroy_context(context);
+    int ret = scil_decompress(SCIL_TYPE_DOUBLE, buffer_out, &dims, out.data, out.size, NULL);
+    assert(ret == SCIL_NO_ERR);
+    check(buffer_in, buffer_out, count);
+
+    // a stream that ends early is incomplete
+    context = create("lz4");
+    scil_stream_t * stream;
+    out.size = 0;
+    assert(scil_stream_begin(&stream, context, &dims, memory_write, &out) == SCIL_NO_ERR);
+    assert(scil_stream_push(stream, buffer_in, count / 2) == SCIL_NO_ERR);
+    assert(scil_stream_end(stream, NULL) == SCIL_EINVAL);
+
+    // other data is not a stream
+    const size_t bound = scil_compress_bound(context, &dims);
+    out.data = (byte*) realloc(out.data, bound);
+    ret = scil_compress(out.data, bound, buffer_in, &dims, &out.size, context);
+    assert(ret == SCIL_NO_ERR);
+    out.pos = 0;
+    scil_stream_reader_t * reader;
+    assert(scil_stream_open(&reader, memory_read, &out, NULL) == SCIL_EINVAL);
+    free(out.data);
+    scil_destroy_context(context);
+
+    free(buffer_in);
+    free(buffer_out);
+    printf("OK\n");
+    return 0;
+}
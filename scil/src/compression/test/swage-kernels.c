@@ -0,0 +1,115 @@
+// Checks every packing kernel against a bit by bit reference and reports the throughput.
+#include <scil-swager.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* kernels[] = {"scalar", "unrolled", "bmi2-avx2"};
+
+static void reference_swage(byte* out, const uint64_t* in, size_t count, uint8_t bits){
+    memset(out, 0, (count * bits + 7) / 8);
+    size_t pos = 0;
+    for(size_t i = 0; i < count; i++){
+        for(int b = bits - 1; b >= 0; b--, pos++){
+            if((in[i] >> b) & 1){
+                out[pos / 8] |= 0x80 >> (pos % 8);
+            }
+        }
+    }
+}
+
+static uint64_t random_value(uint8_t bits){
+    const uint64_t value = ((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand();
+    return bits == 64 ? value : value & ((((uint64_t) 1) << bits) - 1);
+}
+
+static void check_kernel(const char* kernel){
+    const size_t max_count = 1003;
+    uint64_t* values = (uint64_t*) malloc(max_count * sizeof(uint64_t));
+    uint64_t* unpacked = (uint64_t*) malloc(max_count * sizeof(uint64_t));
+    byte* expected = (byte*) malloc(max_count * 8);
+    // the packed data is placed at the end of the buffer to detect reads beyond it
+    byte* buffer = (byte*) malloc(max_count * 8 + 1);
+
+    for(uint8_t bits = 1; bits <= 64; bits++){
+        for(size_t count = 0; count < max_count; count += 1 + count / 3){
+            for(size_t i = 0; i < count; i++){
+                values[i] = random_value(bits);
+            }
+            const size_t size = (count * bits + 7) / 8;
+            byte* packed = buffer + max_count * 8 + 1 - size;
+            reference_swage(expected, values, count, bits);
+
+            packed[-1] = 42;
+            scil_swage(packed, values, count, bits);
+            assert(packed[-1] == 42);
+            assert(memcmp(expected, packed, size) == 0);
+
+            scil_unswage(unpacked, packed, count, bits);
+            assert(memcmp(values, unpacked, count * sizeof(uint64_t)) == 0);
+
+            // single values
+            size_t bit_index = 0;
+            for(size_t i = 0; i < count; i++){
+                uint64_t value;
+                scil_unswage_value(&value, packed, bits, &bit_index);
+                assert(value == values[i]);
+            }
+        }
+    }
+    free(values);
+    free(unpacked);
+    free(expected);
+    free(buffer);
+}
+
+static void benchmark_kernel(const char* kernel){
+    const size_t count = 4 * 1024 * 1024;
+    uint64_t* values = (uint64_t*) malloc(count * sizeof(uint64_t));
+    byte* packed = (byte*) malloc(count * 8);
+
+    const uint8_t widths[] = {3, 8, 12, 21, 32, 47};
+    for(size_t w = 0; w < sizeof(widths); w++){
+        const uint8_t bits = widths[w];
+        for(size_t i = 0; i < count; i++){
+            values[i] = random_value(bits);
+        }
+        scil_timer timer;
+        scilU_start_timer(&timer);
+        scil_swage(packed, values, count, bits);
+        const double t_pack = scilU_stop_timer(timer);
+        scilU_start_timer(&timer);
+        scil_unswage(values, packed, count, bits);
+        const double t_unpack = scilU_stop_timer(timer);
+
+        // the throughput refers to the unpacked 64 bit values
+        const double gib = count * sizeof(uint64_t) / 1024.0 / 1024.0 / 1024.0;
+        printf("%s %2u bits: pack %.2f GiB/s unpack %.2f GiB/s\n", kernel, bits, gib / t_pack, gib / t_unpack);
+    }
+    free(values);
+    free(packed);
+}
+
+int main(void){
+    srand(1);
+    printf("Default kernel: %s\n", scil_swage_kernel_name());
+    assert(scil_swage_select_kernel("unknown") == SCIL_EINVAL);
+
+    for(size_t k = 0; k < sizeof(kernels) / sizeof(char*); k++){
+        if(scil_swage_select_kernel(kernels[k]) != SCIL_NO_ERR){
+            printf("%s is not supported\n", kernels[k]);
+            continue;
+        }
+        assert(strcmp(scil_swage_kernel_name(), kernels[k]) == 0);
+        check_kernel(kernels[k]);
+        benchmark_kernel(kernels[k]);
+    }
+    scil_swage_select_kernel(NULL);
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <scil.h>
+#include <scil-util.h>
+#include <scil-context-impl.h>
+#include <scil-workspace.h>
+
+static void test_mark_release(){
+    scilU_workspace_t* ws = scilU_workspace_create();
+    assert(scilU_workspace_capacity(ws) == 0);
+
+    scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte* a = (byte*) scilU_workspace_alloc(ws, 100);
+    byte* b = (byte*) scilU_workspace_alloc(ws, 1000000);
+    assert(((size_t) a) % 64 == 0 && ((size_t) b) % 64 == 0);
+    memset(a, 1, 100);
+    memset(b, 2, 1000000);
+    const size_t capacity = scilU_workspace_capacity(ws);
+    scilU_workspace_release(ws, mark);
+
+    // the same requests are served from the existing memory
+    for(int i = 0; i < 10; i++){
+        mark = scilU_workspace_mark(ws);
+        assert(scilU_workspace_alloc(ws, 100) == a);
+        scilU_workspace_alloc(ws, 1000000);
+        scilU_workspace_release(ws, mark);
+    }
+    assert(scilU_workspace_capacity(ws) == capacity);
+
+    // an allocation that cannot be served fails but leaves the workspace usable
+    mark = scilU_workspace_mark(ws);
+    assert(scilU_workspace_alloc(ws, ((size_t) 1) << 62) == NULL);
+    assert(scilU_workspace_alloc(ws, 100) != NULL);
+    scilU_workspace_release(ws, mark);
+    assert(scilU_workspace_alloc(ws, 100) == a);
+    scilU_workspace_release(ws, mark);
+    assert(scilU_workspace_capacity(ws) == capacity);
+    scilU_workspace_destroy(ws);
+}
+
+// an arena with a retained size frees the chunks beyond it once everything is released
+static void test_retained(){
+    scilU_workspace_t* ws = scilU_workspace_create();
+    scilU_workspace_set_retained(ws, 1000000);
+
+    scilU_workspace_mark_t mark = scilU_workspace_mark(ws);
+    byte* a = (byte*) scilU_workspace_alloc(ws, 100);
+    scilU_workspace_mark_t inner = scilU_workspace_mark(ws);
+    assert(scilU_workspace_alloc(ws, 10000000) != NULL);
+    const size_t capacity = scilU_workspace_capacity(ws);
+    assert(capacity > 10000000);
+
+    // memory is only freed when nothing is allocated anymore
+    scilU_workspace_release(ws, inner);
+    assert(scilU_workspace_capacity(ws) == capacity);
+    scilU_workspace_release(ws, mark);
+    assert(scilU_workspace_capacity(ws) <= 1000000);
+
+    // the chunks that are kept are reused
+    assert(scilU_workspace_alloc(ws, 100) == a);
+    scilU_workspace_release(ws, mark);
+    scilU_workspace_destroy(ws);
+}
+
+// the arena of a thread does not keep the scratch memory of a large decompression
+static void test_thread_retained(double* buffer_in, scil_dims_t* dims){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.force_compression_methods = "abstol,lz4";
+
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+    const size_t size = scil_compress_bound(ctx, dims);
+    byte* buffer_out = (byte*) malloc(size);
+    size_t out_size;
+    ret = scil_compress(buffer_out, size, buffer_in, dims, &out_size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    scil_destroy_context(ctx);
+
+    double* buffer_end = (double*) malloc(scil_dims_get_size(dims, SCIL_TYPE_DOUBLE));
+    // without the block container the region is decompressed in the arena of the calling thread
+    scil_dims_t offset;
+    scil_dims_initialize_2d(&offset, 0, 0);
+    ret = scil_decompress_region(SCIL_TYPE_DOUBLE, buffer_end, dims, &offset, dims, buffer_out, out_size);
+    assert(ret == SCIL_NO_ERR);
+    assert(buffer_end[1001] - buffer_in[1001] <= 0.01 && buffer_in[1001] - buffer_end[1001] <= 0.01);
+    printf("thread workspace after decompression: %zu\n", scilU_workspace_capacity(scilU_get_thread_workspace()));
+    assert(scilU_workspace_capacity(scilU_get_thread_workspace()) <= 16 * 1024 * 1024);
+
+    free(buffer_end);
+    free(buffer_out);
+}
+
+// repeated compression with the same context must not grow the workspace
+static void test_reuse(char* chain, size_t block_size, double* buffer_in, scil_dims_t* dims){
+    scil_user_hints_t hints;
+    scil_user_hints_initialize(&hints);
+    hints.absolute_tolerance = 0.01;
+    hints.significant_bits = 10;
+    hints.force_compression_methods = chain;
+    hints.parallel_block_size = block_size;
+
+    scil_context_t* ctx;
+    int ret = scil_context_create(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t size = scil_compress_bound(ctx, dims);
+    byte* buffer_out = (byte*) malloc(size);
+    size_t out_size;
+    size_t capacity = 0;
+    for(int i = 0; i < 5; i++){
+        ret = scil_compress(buffer_out, size, buffer_in, dims, &out_size, ctx);
+        assert(ret == SCIL_NO_ERR);
+        if(i == 0){
+            capacity = scilU_workspace_capacity(ctx->workspace);
+        }
+        assert(scilU_workspace_capacity(ctx->workspace) == capacity);
+    }
+    printf("%s block size %zu: workspace %zu\n", chain, block_size, capacity);
+
+    free(buffer_out);
+    scil_destroy_context(ctx);
+}
+
+int main(void){
+    test_mark_release();
+    test_retained();
+
+    scil_dims_t dims;
+    scil_dims_initialize_2d(&dims, 1000, 100);
+    const size_t count = scil_dims_get_count(&dims);
+    double* buffer_in = (double*) malloc(count * sizeof(double));
+    for(size_t i = 0; i < count; ++i){
+        buffer_in[i] = (double) (i % 1000) * 0.1;
+    }
+
+    test_reuse("abstol", 0, buffer_in, &dims);
+    test_reuse("sigbits,lz4", 0, buffer_in, &dims);
+    test_reuse("abstol,lz4", 64 * 1024, buffer_in, &dims);
+
+    // 64 MiB of data, larger than the memory the arena of a thread keeps
+    scil_dims_t large_dims;
+    scil_dims_initialize_2d(&large_dims, 1000, 8 * 1024);
+    const size_t large_count = scil_dims_get_count(&large_dims);
+    double* large = (double*) malloc(large_count * sizeof(double));
+    for(size_t i = 0; i < large_count; ++i){
+        large[i] = (double) (i % 1000) * 0.1;
+    }
+    test_thread_retained(large, &large_dims);
+    free(large);
+
+    free(buffer_in);
+    printf("OK\n");
+    return 0;
+}
@@ -13,8 +13,21 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
 
+/*
+ * This tool measures the performance of compression chains on the patterns of the library.
+ * Every combination of chain, datatype, size, dimensionality and pattern is run after warm-up runs
+ * for a number of repetitions, the results are written as CSV, JSON or as scil.conf for the chooser.
+ * The CSV and JSON contain the time and output size of each stage of the chain per compression as well.
+ */
+
+#define _GNU_SOURCE
+
 #include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -23,158 +36,525 @@
 #include <scil-data-characteristics.h>
 #include <scil-error.h>
 #include <scil-debug.h>
+#include <scil-energy.h>
+#include <scil-hardware-limits.h>
+#include <scil-option.h>
 #include <scil-patterns.h>
+#include <scil-thread-pool.h>
 #include <scil-util.h>
 
 #define allocate(type, name, count) type* name = (type*)malloc(count * sizeof(type))
 
+// the limits of the lists given as options
+#define LIST_MAX 64
+
+static char * chains_str = NULL;
+static char * datatypes_str = NULL;
+static char * sizes_str = "1048576";
+static char * dimensionalities_str = "1";
+static char * pattern_str = NULL;
+static char * cpus_str = NULL;
+static char * csv_file = NULL;
+static char * json_file = NULL;
+static char * conf_file = NULL;
+static int warmup = 1;
+static int repetitions = 5;
+static int threads = 0;
+static double tolerance = SCIL_ACCURACY_DBL_FINEST;
+
+typedef struct{
+	double median;
+	double stddev;
+	double p10;
+	double p90;
+} stats_t;
+
+typedef struct{
+	SCIL_Datatype_t datatype;
+	const char * pattern;
+	scil_dims_t dims;
+	const char * chain;
+	double randomness;
+	double ratio;
+	/** \brief The throughput in MiB/s of the uncompressed data */
+	stats_t compression;
+	stats_t decompression;
+	/** \brief J/MiB to compress and decompress */
+	double energy;
+	/** \brief The seconds of the phases of a run, the median for compression and decompression */
+	double setup_time;
+	double compression_time;
+	double decompression_time;
+	double validation_time;
+	/** \brief The seconds and the output bytes of each stage per compression, see scil_context_get_statistics() */
+	double stage_time[SCIL_STAGE_LAST];
+	double stage_size[SCIL_STAGE_LAST];
+} result_t;
+
+static result_t * results = NULL;
+static size_t result_count = 0;
+static size_t result_capacity = 0;
 static int error_occured = 0;
-static double * buffer_uncompressed;
 
-void benchmark(FILE * f, SCIL_Datatype_t datatype, const char * name, byte * buffer_in, scil_dims_t dims){
-	size_t out_c_size;
+static int compare_double(const void * a, const void * b){
+	const double x = *(const double*) a;
+	const double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
 
-	const size_t buff_size = scil_get_compressed_data_size_limit(&dims, datatype);
-	const size_t data_size = scil_dims_get_size(&dims, datatype);
+// the percentile p in [0, 1] of sorted values, linearly interpolated
+static double percentile(const double * sorted, int count, double p){
+	const double pos = p * (count - 1);
+	const int lower = (int) pos;
+	if (lower + 1 >= count){
+		return sorted[count - 1];
+	}
+	return sorted[lower] + (sorted[lower + 1] - sorted[lower]) * (pos - lower);
+}
 
-	allocate(byte, buffer_out, buff_size);
-	allocate(byte, tmp_buff, buff_size);
+static stats_t compute_stats(double * values, int count){
+	stats_t s;
+	qsort(values, count, sizeof(double), compare_double);
+	s.median = percentile(values, count, 0.5);
+	s.p10 = percentile(values, count, 0.1);
+	s.p90 = percentile(values, count, 0.9);
+	double mean = 0;
+	for(int i=0; i < count; i++){
+		mean += values[i];
+	}
+	mean /= count;
+	s.stddev = 0;
+	for(int i=0; i < count; i++){
+		s.stddev += (values[i] - mean) * (values[i] - mean);
+	}
+	s.stddev = count > 1 ? sqrt(s.stddev / (count - 1)) : 0;
+	return s;
+}
 
-  scil_context_t* ctx;
-  scil_user_hints_t hints;
+// split str at the delimiter into at most LIST_MAX strings, returns their number
+static int split_list(char * str, const char * delimiter, char ** out){
+	int count = 0;
+	char * saveptr;
+	for(char * token = strtok_r(str, delimiter, & saveptr); token != NULL && count < LIST_MAX; token = strtok_r(NULL, delimiter, & saveptr)){
+		out[count++] = token;
+	}
+	return count;
+}
 
-  scil_user_hints_initialize(&hints);
-	hints.absolute_tolerance = SCIL_ACCURACY_DBL_FINEST;
+// a shape with the given number of dimensions and about count elements, the dimensions are about equal
+static void create_dims(scil_dims_t * dims, size_t count, int dimensionality){
+	size_t length[SCIL_DIMS_MAX];
+	size_t remaining = count;
+	for(int i=0; i < dimensionality - 1; i++){
+		length[i] = (size_t) round(pow((double) remaining, 1.0 / (dimensionality - i)));
+		length[i] = length[i] > 0 ? length[i] : 1;
+		remaining = remaining / length[i] > 0 ? remaining / length[i] : 1;
+	}
+	length[dimensionality - 1] = remaining;
+	scil_dims_initialize_array(dims, dimensionality, length);
+}
 
-	double r = (double) scilU_get_data_randomness(buffer_in, data_size, tmp_buff, buff_size);
+/*
+ * Pinning: every thread of the pool that compresses blocks takes one task of a job,
+ * the barrier ensures that no thread takes two of them.
+ */
+typedef struct{
+	int cpus[LIST_MAX];
+	int cpu_count;
+	pthread_barrier_t barrier;
+} pin_job_t;
+
+static void pin_thread(void * user_ptr, size_t task, int slot){
+	pin_job_t * job = (pin_job_t*) user_ptr;
+	cpu_set_t set;
+	CPU_ZERO(& set);
+	CPU_SET(job->cpus[slot % job->cpu_count], & set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), & set) != 0){
+		printf("Warning: could not pin thread %d to CPU %d\n", slot, job->cpus[slot % job->cpu_count]);
+	}
+	pthread_barrier_wait(& job->barrier);
+}
 
-	char * outputFiles = getenv("SCIL_BENCHMARK_OUTPUT");
-	const size_t buffer_size = scil_get_compressed_data_size_limit(&dims, datatype);
+static void pin_threads(char * cpus){
+	pin_job_t job;
+	char * list[LIST_MAX];
+	job.cpu_count = split_list(cpus, ",", list);
+	for(int i=0; i < job.cpu_count; i++){
+		job.cpus[i] = atoi(list[i]);
+	}
+	scilU_thread_pool_t * pool = scilU_get_thread_pool();
+	const int size = scilU_thread_pool_size(pool);
+	pthread_barrier_init(& job.barrier, NULL, size);
+	scilU_thread_pool_run(pool, size, size, pin_thread, & job);
+	pthread_barrier_destroy(& job.barrier);
+}
 
-	for(int i=0; i < scilU_get_available_compressor_count(); i++ ){
-		char compression_name[1024];
-		sprintf(compression_name, "%s", scilU_get_compressor_name(i));
-		hints.force_compression_methods = compression_name;
+// the dims formatted as "x" separated lengths
+static const char * dims_to_str(const scil_dims_t * dims, char * out, size_t size){
+	int pos = 0;
+	out[0] = 0;
+	for(int i=0; i < dims->dims && (size_t) pos < size; i++){
+		pos += snprintf(out + pos, size - pos, "%s%zu", i == 0 ? "" : "x", dims->length[i]);
+	}
+	return out;
+}
 
-		int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
-		if (ret != 0){
-			printf("Invalid combination %s\n", compression_name);
-			continue;
-		}
-		assert(ctx != NULL);
-		int ret_c;
-		int ret_d;
+static result_t * add_result(){
+	if (result_count == result_capacity){
+		result_capacity = result_capacity == 0 ? 100 : result_capacity * 2;
+		results = (result_t*) realloc(results, result_capacity * sizeof(result_t));
+	}
+	memset(& results[result_count], 0, sizeof(result_t));
+	return & results[result_count++];
+}
+
+static void benchmark(SCIL_Datatype_t datatype, const char * pattern, byte * buffer_in, scil_dims_t * dims, const char * chain){
+	const size_t buff_size = scil_get_compressed_data_size_limit(dims, datatype);
+	const size_t data_size = scil_dims_get_size(dims, datatype);
+	const double mib = (double) data_size / 1024.0 / 1024.0;
+
+	scil_context_t* ctx;
+	scil_user_hints_t hints;
+	scil_user_hints_initialize(&hints);
+	hints.absolute_tolerance = tolerance;
+	hints.parallel_threads = threads;
+	hints.force_compression_methods = (char*) chain;
+
+	scil_timer timer;
+	scilU_start_timer(& timer);
+	int ret = scil_context_create(&ctx, datatype, 0, NULL, &hints);
+	if (ret != SCIL_NO_ERR){
+		printf("Invalid combination %s\n", chain);
+		return;
+	}
+	const size_t bound = scil_compress_bound(ctx, dims);
+	const double setup_time = scilU_stop_timer(timer);
 
-		scil_timer timer;
+	allocate(byte, buffer_out, bound);
+	allocate(byte, buffer_uncompressed, data_size);
+	allocate(byte, tmp_buff, buff_size);
+	allocate(double, compression_times, repetitions);
+	allocate(double, decompression_times, repetitions);
+	allocate(double, compression_speeds, repetitions);
+	allocate(double, decompression_speeds, repetitions);
+
+	size_t out_c_size = 0;
+	double joules = 0;
+	scil_context_enable_statistics(ctx, 1);
+	for(int i= -warmup; i < repetitions && ret == SCIL_NO_ERR; i++){
+		if (i == 0){
+			// the stages are accounted for the measured runs only
+			scil_context_reset_statistics(ctx);
+		}
+		scilU_energy_mark_t energy;
+		scilU_energy_start(& energy);
 		scilU_start_timer(& timer);
-		ret_c = scil_compress(buffer_out, buff_size, buffer_in, & dims, & out_c_size, ctx);
-		double seconds_compress = scilU_stop_timer(timer);
-		ret_d = -1;
-
-		double seconds_decompress;
-		if(ret_c == 0){
-			// initialize memory
-			memset(buffer_uncompressed, -1, buffer_size);
-
-			scilU_start_timer(& timer);
-			ret_d = scil_decompress(datatype, buffer_uncompressed, & dims, buffer_out, out_c_size, tmp_buff);
-			seconds_decompress = scilU_stop_timer(timer);
-		}else{
-			seconds_decompress = 1;
+		ret = scil_compress(buffer_out, bound, buffer_in, dims, & out_c_size, ctx);
+		const double c_time = scilU_stop_timer(timer);
+		const double c_joules = scilU_energy_stop(& energy);
+		if (ret != SCIL_NO_ERR){
+			break;
 		}
 
-		if ( ret_c == 0 && ret_d == 0 && outputFiles != NULL ){
-			// dump the file
-			char filename[1024];
-			sprintf(filename,"%s-%s.csv", name, compression_name);
-			// TODO
-			//scilU_plot(filename, dims, (double*) buffer_uncompressed);
+		memset(buffer_uncompressed, -1, data_size);
+		scilU_energy_start(& energy);
+		scilU_start_timer(& timer);
+		ret = scil_decompress(datatype, buffer_uncompressed, dims, buffer_out, out_c_size, tmp_buff);
+		const double d_time = scilU_stop_timer(timer);
+		const double d_joules = scilU_energy_stop(& energy);
+		if (i < 0){
+			continue;
 		}
+		compression_times[i] = c_time;
+		decompression_times[i] = d_time;
+		compression_speeds[i] = mib / c_time;
+		decompression_speeds[i] = mib / d_time;
+		joules += c_joules + d_joules;
+	}
 
+	double validation_time = 0;
+	if (ret == SCIL_NO_ERR){
+		scil_user_hints_t accuracy;
+		scil_validate_params_t validation;
+		scilU_start_timer(& timer);
+		ret = scil_validate_compression(datatype, buffer_in, dims, buffer_out, out_c_size, ctx, & accuracy, & validation);
+		validation_time = scilU_stop_timer(timer);
+	}
 
-		if (ret_c != 0 || ret_d != 0 ){
-			error_occured = 1;
-			printf("Warning: compression %s returned an error!\n",  hints.force_compression_methods);
-			continue;
+	if (ret != SCIL_NO_ERR){
+		error_occured = 1;
+		printf("Warning: compression %s returned an error!\n", chain);
+	}else{
+		result_t * r = add_result();
+		r->datatype = datatype;
+		r->pattern = pattern;
+		scil_dims_copy(& r->dims, dims);
+		r->chain = chain;
+		r->randomness = (double) scilU_get_data_randomness(buffer_in, data_size, tmp_buff, buff_size);
+		r->ratio = (double) out_c_size / data_size;
+		r->compression = compute_stats(compression_speeds, repetitions);
+		r->decompression = compute_stats(decompression_speeds, repetitions);
+		r->energy = joules / repetitions / mib;
+		r->setup_time = setup_time;
+		r->compression_time = compute_stats(compression_times, repetitions).median;
+		r->decompression_time = compute_stats(decompression_times, repetitions).median;
+		r->validation_time = validation_time;
+		scil_statistics_t statistics;
+		scil_context_get_statistics(ctx, & statistics);
+		for(int s=0; s < SCIL_STAGE_LAST; s++){
+			r->stage_time[s] = statistics.stage[s].ns * 1e-9 / repetitions;
+			r->stage_size[s] = (double) statistics.stage[s].bytes_out / repetitions;
 		}
-		double c_fac = (double)(out_c_size) / data_size;
 
-		fprintf(f, "%.1f; %d; %s; %s; %.1lf; %.1lf; %.3lf\n",
-			r, datatype, name, hints.force_compression_methods,
-			data_size/seconds_compress/1024 /1024, data_size/seconds_decompress/1024 /1024, c_fac);
-  }
+		char dims_str[256];
+		printf("%s %s %s %s: ratio %.3f compression %.1f MiB/s (stddev %.1f) decompression %.1f MiB/s (stddev %.1f)\n",
+			scil_datatype_to_str(datatype), pattern, chain, dims_to_str(dims, dims_str, sizeof(dims_str)), r->ratio,
+			r->compression.median, r->compression.stddev, r->decompression.median, r->decompression.stddev);
+	}
+
+	scil_destroy_context(ctx);
 	free(buffer_out);
+	free(buffer_uncompressed);
 	free(tmp_buff);
+	free(compression_times);
+	free(decompression_times);
+	free(compression_speeds);
+	free(decompression_speeds);
 }
 
-void scilU_check_std_err(char const * what, int ret){
+static void scilU_check_std_err(char const * what, int ret){
 	if (ret != 0){
 		critical("%s returned the error %s\n", what, strerror(errno));
 		exit(1);
 	}
 }
 
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-int main(int argc, char** argv){
-	int ret;
-	scil_dims_t dims;
-
-	if (argc != 1){
-	  switch(argc - 1){
-	    case (1):{
-	  	  scil_dims_initialize_1d(& dims, atol(argv[1]));
-	      break;
-	    }case (2):{
-	      scil_dims_initialize_2d(& dims, atol(argv[1]), atol(argv[2]));
-	      break;
-	    }case (3):{
-	      scil_dims_initialize_3d(& dims, atol(argv[1]), atol(argv[2]), atol(argv[3]));
-	      break;
-	    }default:{
-	      printf("Error will only benchmark up to 3D\n");
-	      exit(1);
-	    }
-	  }
-	}else{
-		scil_dims_initialize_1d(& dims, 1024*1024);
+static void write_csv(const char * filename){
+	FILE * f = fopen(filename, "w");
+	scilU_check_std_err("fopen", f == NULL);
+	fprintf(f, "datatype,pattern,dims,chain,randomness,ratio,"
+		"compression_median,compression_stddev,compression_p10,compression_p90,"
+		"decompression_median,decompression_stddev,decompression_p10,decompression_p90,"
+		"energy,setup_time,compression_time,decompression_time,validation_time");
+	for(int s=0; s < SCIL_STAGE_LAST; s++){
+		fprintf(f, ",%s_time,%s_size", scil_stage_names[s], scil_stage_names[s]);
+	}
+	fprintf(f, "\n");
+	for(size_t i=0; i < result_count; i++){
+		const result_t * r = & results[i];
+		char dims_str[256];
+		fprintf(f, "%s,%s,%s,\"%s\",%.3f,%.6f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.6f,%.9f,%.9f,%.9f,%.9f",
+			scil_datatype_to_str(r->datatype), r->pattern, dims_to_str(& r->dims, dims_str, sizeof(dims_str)), r->chain, r->randomness, r->ratio,
+			r->compression.median, r->compression.stddev, r->compression.p10, r->compression.p90,
+			r->decompression.median, r->decompression.stddev, r->decompression.p10, r->decompression.p90,
+			r->energy, r->setup_time, r->compression_time, r->decompression_time, r->validation_time);
+		for(int s=0; s < SCIL_STAGE_LAST; s++){
+			fprintf(f, ",%.9f,%.0f", r->stage_time[s], r->stage_size[s]);
+		}
+		fprintf(f, "\n");
 	}
+	fclose(f);
+}
 
-	int bufferSize = scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
-	double * buffer_in = (double*) malloc(bufferSize);
-	buffer_uncompressed = malloc(bufferSize);
+static void write_json_stats(FILE * f, const char * name, const stats_t * s){
+	fprintf(f, "\"%s\": {\"median\": %.3f, \"stddev\": %.3f, \"p10\": %.3f, \"p90\": %.3f}", name, s->median, s->stddev, s->p10, s->p90);
+}
 
-	printf("This program creates a new scil.conf by measuring performance\n");
+static void write_json(const char * filename){
+	FILE * f = fopen(filename, "w");
+	scilU_check_std_err("fopen", f == NULL);
+	fprintf(f, "{\"energy_meter\": \"%s\", \"warmup\": %d, \"repetitions\": %d, \"results\": [", scilU_energy_get_meter()->name, warmup, repetitions);
+	for(size_t i=0; i < result_count; i++){
+		const result_t * r = & results[i];
+		fprintf(f, "%s\n  {\"datatype\": \"%s\", \"pattern\": \"%s\", \"dims\": [", i == 0 ? "" : ",", scil_datatype_to_str(r->datatype), r->pattern);
+		for(int d=0; d < r->dims.dims; d++){
+			fprintf(f, "%s%zu", d == 0 ? "" : ", ", r->dims.length[d]);
+		}
+		fprintf(f, "], \"chain\": \"%s\", \"randomness\": %.3f, \"ratio\": %.6f, ", r->chain, r->randomness, r->ratio);
+		write_json_stats(f, "compression", & r->compression);
+		fprintf(f, ", ");
+		write_json_stats(f, "decompression", & r->decompression);
+		fprintf(f, ", \"energy\": %.6f, \"phases\": {\"setup\": %.9f, \"compression\": %.9f, \"decompression\": %.9f, \"validation\": %.9f}, \"stages\": {",
+			r->energy, r->setup_time, r->compression_time, r->decompression_time, r->validation_time);
+		for(int s=0; s < SCIL_STAGE_LAST; s++){
+			fprintf(f, "%s\"%s\": {\"time\": %.9f, \"size\": %.0f}", s == 0 ? "" : ", ", scil_stage_names[s], r->stage_time[s], r->stage_size[s]);
+		}
+		fprintf(f, "}}");
+	}
+	fprintf(f, "\n]}\n");
+	fclose(f);
+}
 
-	FILE * f = fopen("scil.conf.bak", "w+");
-	{
-		char * str = "#randomness; data type; pattern name; compressor name; compr. performance MiB; decompr. performance MiB; inverse compr. ratio\n";
-		ret = fwrite(str, strlen(str), 1, f);
-		scilU_check_std_err("fwrite", ret != 1);
+// the smallest power of two that is at least size
+static size_t size_class(size_t size){
+	size_t c = 1;
+	while (c < size){
+		c *= 2;
 	}
+	return c;
+}
 
-	char * check_pattern = getenv("SCIL_PATTERN_TO_USE");
+static void write_conf(const char * filename){
+	char tmp_name[1024];
+	snprintf(tmp_name, sizeof(tmp_name), "%s.bak", filename);
+	FILE * f = fopen(tmp_name, "w+");
+	scilU_check_std_err("fopen", f == NULL);
+	fprintf(f, "# randomness; dtype=datatype; size=size class in bytes; compressor chain; compr. performance MiB; decompr. performance MiB; inverse compr. ratio; compr. and decompr. energy J/MiB\n");
+	fprintf(f, "# energy measured by: %s\n", scilU_energy_get_meter()->name);
+	// keep the description of the machine
+	const char * limits[] = {"network", "storage", "power_active", "power_idle"};
+	for(int i=0; i < HARDWARE_MAX; i++){
+		if (scilU_get_hardware_limit(i) > 0){
+			fprintf(f, "!%s %f\n", limits[i], (double) scilU_get_hardware_limit(i));
+		}
+	}
+	for(size_t i=0; i < result_count; i++){
+		const result_t * r = & results[i];
+		fprintf(f, "%.1f; dtype=%s; size=%zu; %s; %.1f; %.1f; %.3f; %.4f\n",
+			r->randomness, scil_datatype_to_str(r->datatype), size_class(scil_dims_get_size(& r->dims, r->datatype)), r->chain,
+			r->compression.median, r->decompression.median, r->ratio, r->energy);
+	}
+	fclose(f);
+	int ret = rename(tmp_name, filename);
+	scilU_check_std_err("rename", ret);
+}
 
-	for(int i=0; i < scilP_get_pattern_library_size(); i++){
-		char * name = scilP_get_library_pattern_name(i);
+int main(int argc, char** argv){
+	int ret;
 
-		if( check_pattern != NULL && strcmp(name, check_pattern) != 0){
-			printf("Skipping %s\n", name);
-			continue;
+	option_help known_args[] = {
+		{'c', "chains", "The chains to measure separated by \":\", by default every compressor", OPTION_OPTIONAL_ARGUMENT, 's', & chains_str},
+		{'t', "datatypes", "The datatypes separated by \",\", by default all numeric types", OPTION_OPTIONAL_ARGUMENT, 's', & datatypes_str},
+		{'s', "sizes", "The numbers of elements separated by \",\"", OPTION_OPTIONAL_ARGUMENT, 's', & sizes_str},
+		{'d', "dimensionalities", "The numbers of dimensions separated by \",\"", OPTION_OPTIONAL_ARGUMENT, 's', & dimensionalities_str},
+		{'p', "patterns", "The patterns of the library separated by \",\", by default all or SCIL_PATTERN_TO_USE", OPTION_OPTIONAL_ARGUMENT, 's', & pattern_str},
+		{'w', "warmup", "Runs before the measurement", OPTION_OPTIONAL_ARGUMENT, 'd', & warmup},
+		{'r', "repetitions", "Measured runs", OPTION_OPTIONAL_ARGUMENT, 'd', & repetitions},
+		{0, "threads", "Threads to compress blocks in parallel", OPTION_OPTIONAL_ARGUMENT, 'd', & threads},
+		{0, "cpus", "Pin the threads to the CPUs separated by \",\"", OPTION_OPTIONAL_ARGUMENT, 's', & cpus_str},
+		{0, "tolerance", "The absolute tolerance of the lossy compressors", OPTION_OPTIONAL_ARGUMENT, 'F', & tolerance},
+		{0, "csv", "Write the results as CSV", OPTION_OPTIONAL_ARGUMENT, 's', & csv_file},
+		{0, "json", "Write the results as JSON", OPTION_OPTIONAL_ARGUMENT, 's', & json_file},
+		{0, "conf", "Write the results as system configuration for the chooser", OPTION_OPTIONAL_ARGUMENT, 's', & conf_file},
+		LAST_OPTION
+	};
+	int printhelp = 0;
+	scilO_parseOptions(argc, argv, known_args, & printhelp);
+	if (printhelp != 0 || repetitions < 1 || warmup < 0){
+		printf("\nSynopsis: %s ", argv[0]);
+		scilO_print_help(known_args, "\nWithout an output option a new scil.conf is created.\n");
+		exit(printhelp == 1 ? 0 : 1);
+	}
+	if (csv_file == NULL && json_file == NULL && conf_file == NULL){
+		printf("This program creates a new scil.conf by measuring performance\n");
+		conf_file = "scil.conf";
+	}
+	if (pattern_str == NULL){
+		pattern_str = getenv("SCIL_PATTERN_TO_USE");
+	}
+	if (cpus_str != NULL){
+		pin_threads(strdup(cpus_str));
+	}
+
+	char * chains[LIST_MAX];
+	int chain_count = 0;
+	if (chains_str != NULL){
+		chain_count = split_list(chains_str, ":", chains);
+	}else{
+		for(int i=0; i < scilU_get_available_compressor_count() && i < LIST_MAX; i++){
+			chains[chain_count++] = (char*) scilU_get_compressor_name(i);
 		}
+	}
 
-		for(int d=SCIL_DATATYPE_NUMERIC_MIN; d < SCIL_DATATYPE_NUMERIC_MAX; d++ ){
-			ret = scilP_create_library_pattern(buffer_in, d, &dims, i);
-			assert( ret == SCIL_NO_ERR);
-			benchmark(f, d, name, (byte*) buffer_in, dims);
+	SCIL_Datatype_t datatypes[LIST_MAX];
+	int datatype_count = 0;
+	if (datatypes_str != NULL){
+		char * list[LIST_MAX];
+		const int count = split_list(datatypes_str, ",", list);
+		for(int i=0; i < count; i++){
+			datatypes[datatype_count] = scil_str_to_datatype(list[i]);
+			if (datatypes[datatype_count] == SCIL_TYPE_UNKNOWN){
+				printf("Error unknown datatype: %s\n", list[i]);
+				exit(1);
+			}
+			datatype_count++;
+		}
+	}else{
+		for(int d=SCIL_DATATYPE_NUMERIC_MIN; d < SCIL_DATATYPE_NUMERIC_MAX; d++){
+			datatypes[datatype_count++] = d;
+		}
+	}
+
+	int patterns[LIST_MAX];
+	int pattern_count = 0;
+	if (pattern_str != NULL){
+		char * list[LIST_MAX];
+		const int count = split_list(pattern_str, ",", list);
+		for(int i=0; i < count; i++){
+			int p;
+			for(p=0; p < scilP_get_pattern_library_size(); p++){
+				if (strcmp(scilP_get_library_pattern_name(p), list[i]) == 0){
+					break;
+				}
+			}
+			if (p == scilP_get_pattern_library_size()){
+				printf("Error unknown pattern: %s\n", list[i]);
+				exit(1);
+			}
+			patterns[pattern_count++] = p;
+		}
+	}else{
+		for(int p=0; p < scilP_get_pattern_library_size() && p < LIST_MAX; p++){
+			patterns[pattern_count++] = p;
 		}
 	}
-	fclose(f);
-	ret = rename("scil.conf.bak", "scil.conf");
-	scilU_check_std_err("rename", ret);
 
+	char * list[LIST_MAX];
+	size_t sizes[LIST_MAX];
+	const int size_count = split_list(sizes_str, ",", list);
+	for(int i=0; i < size_count; i++){
+		sizes[i] = (size_t) atoll(list[i]);
+	}
+	int dimensionalities[LIST_MAX];
+	const int dimensionality_count = split_list(dimensionalities_str, ",", list);
+	for(int i=0; i < dimensionality_count; i++){
+		dimensionalities[i] = atoi(list[i]);
+		if (dimensionalities[i] < 1 || dimensionalities[i] > SCIL_DIMS_MAX){
+			printf("Error the dimensionality must be between 1 and %d\n", SCIL_DIMS_MAX);
+			exit(1);
+		}
+	}
 
-	free(buffer_in);
-	free(buffer_uncompressed);
+	for(int s=0; s < size_count; s++){
+		for(int n=0; n < dimensionality_count; n++){
+			scil_dims_t dims;
+			create_dims(& dims, sizes[s], dimensionalities[n]);
+			const size_t buffer_size = scil_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
+			byte * buffer_in = (byte*) malloc(buffer_size);
+
+			for(int p=0; p < pattern_count; p++){
+				char * name = scilP_get_library_pattern_name(patterns[p]);
+				for(int d=0; d < datatype_count; d++){
+					ret = scilP_create_library_pattern(buffer_in, datatypes[d], &dims, patterns[p]);
+					assert(ret == SCIL_NO_ERR);
+					for(int c=0; c < chain_count; c++){
+						benchmark(datatypes[d], name, buffer_in, &dims, chains[c]);
+					}
+				}
+			}
+			free(buffer_in);
+		}
+	}
 
+	if (csv_file != NULL){
+		write_csv(csv_file);
+	}
+	if (json_file != NULL){
+		write_json(json_file);
+	}
+	if (conf_file != NULL){
+		write_conf(conf_file);
+	}
+	free(results);
 	return error_occured;
 }
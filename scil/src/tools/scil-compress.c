@@ -52,6 +52,24 @@ static int print_hints = 0;
 static char * in_file_format = "csv";
 static char * out_file_format = "csv";
 
+// the counters of the compression stages, printed with -t
+static scil_statistics_t stage_statistics;
+
+static void print_stage_statistics(){
+  printf("Stages:\n");
+  for(int i=0; i < SCIL_STAGE_LAST; i++){
+    const scil_stage_statistics_t * s = & stage_statistics.stage[i];
+    if (s->calls == 0){
+      continue;
+    }
+    const double t = s->ns * 1e-9;
+    printf(" %s, %llu calls, %fs, %llu B in, %llu B out", scil_stage_names[i], (unsigned long long) s->calls, t, (unsigned long long) s->bytes_in, (unsigned long long) s->bytes_out);
+    if (t > 0.0)
+      printf(", %f MiB/s", s->bytes_in/t/1024 /1024);
+    printf("\n");
+  }
+}
+
 // data we process
 
 static scil_dims_t dims;
@@ -83,7 +101,7 @@ int main(int argc, char ** argv){
     {'x', "decompress", "Infile is expected to be a binary compressed with this tool, outfile a CSV file",OPTION_FLAG, 'd', & uncompress},
     {'c', "compress", "Infile is expected to be a CSV file, outfile a binary",OPTION_FLAG, 'd' , & compress},
     {'R', "residual", "(for decompression) compute/output the residual error instead of the data", OPTION_FLAG, 'd', & compute_residual},
-    {'t', "time", "Measure time for the operation.", OPTION_FLAG, 'd', & measure_time},
+    {'t', "time", "Measure time for the operation and of the compression stages.", OPTION_FLAG, 'd', & measure_time},
     {'V', "validate", "Validate the output", OPTION_FLAG, 'd', & validate},
     {'v', "verbose", "Increase the verbosity level", OPTION_FLAG, 'd', & verbose},
     {'H', "print-hints", "Print the effective hints", OPTION_FLAG, 'd', & print_hints},
@@ -284,6 +302,7 @@ int main(int argc, char ** argv){
             printf("*** [SCIL] error: datatype is not supported by compressor\n");
             return 0;
       }
+      scil_context_enable_statistics(ctx, measure_time);
 
       if (print_hints){
         printf("Effective hints (only needed for compression)\n");
@@ -358,6 +377,8 @@ int main(int argc, char ** argv){
           printf(" decompress, %fs, %f MiB/s\n", t_decompress, array_size/t_decompress/1024 /1024);
         if (t_write > 0.0)
           printf(" write,      %fs, %f MiB/s\n", t_write, array_size/t_write/1024 /1024);
+        scil_context_get_statistics(ctx, & stage_statistics);
+        print_stage_statistics();
       }
 
 
@@ -438,6 +459,7 @@ int main(int argc, char ** argv){
 
   ret = scil_context_create(&ctx, input_datatype, 0, NULL, &hints);
   assert(ret == SCIL_NO_ERR);
+  scil_context_enable_statistics(ctx, measure_time);
 
   if (print_hints){
     printf("Effective hints (only needed for compression)\n");
@@ -483,6 +505,7 @@ int main(int argc, char ** argv){
           }
         }
     }
+    scil_context_get_statistics(ctx, & stage_statistics);
     ret = scil_destroy_context(ctx);
     assert(ret == SCIL_NO_ERR);
 
@@ -506,13 +529,22 @@ int main(int argc, char ** argv){
           }
         }
     }
+    scil_context_get_statistics(ctx, & stage_statistics);
     ret = scil_destroy_context(ctx);
     assert(ret == SCIL_NO_ERR);
 
     output_datatype = SCIL_TYPE_BINARY;
   } else if (uncompress){
     printf("...decompression\n");
-    byte* tmp_buff = (byte*) scilU_safe_malloc(input_size);
+    size_t tmp_size = input_size;
+    scil_frame_header_t header;
+    if (scil_peek_header(input_data, read_data_size, & header) == SCIL_NO_ERR){
+      // the header provides the exact buffer sizes
+      free(output_data);
+      output_data = (byte*) scilU_safe_malloc(header.uncompressed_size);
+      tmp_size = header.tmp_buffer_size > 0 ? header.tmp_buffer_size : 1;
+    }
+    byte* tmp_buff = (byte*) scilU_safe_malloc(tmp_size);
     scilU_start_timer(& timer);
     ret = scil_decompress(input_datatype, output_data, & dims, input_data, read_data_size, tmp_buff);
     t_decompress = scilU_stop_timer(timer);
@@ -549,6 +581,8 @@ int main(int argc, char ** argv){
       printf(" decompress, %fs, %f MiB/s\n", t_decompress, array_size/t_decompress/1024 /1024);
     if (t_write > 0.0)
       printf(" write,      %fs, %f MiB/s\n", t_write, array_size/t_write/1024 /1024);
+    if (t_compress > 0.0)
+      print_stage_statistics();
   }
 
   free(input_data);
@@ -24,6 +24,7 @@
 
 #include <scil.h>
 #include <scil-algo-chooser.h>
+#include <scil-data-characteristics.h>
 #include <scil-debug.h>
 #include <scil-patterns.h>
 #include <scil-util.h>
@@ -157,16 +158,6 @@ static void close_data_file(){
     fclose(file);
 }
 
-static size_t get_index_2d(size_t x, size_t y, const scil_dims_t *dims){
-    return y * dims->length[0] + x;
-}
-static size_t get_index_3d(size_t x, size_t y, size_t z, const scil_dims_t *dims){
-    return (z * dims->length[1] + y) * dims->length[0] + x;
-}
-static size_t get_index_4d(size_t x, size_t y, size_t z, size_t w, const scil_dims_t *dims){
-    return ((w * dims->length[2] + z) * dims->length[1] + y) * dims->length[0] + x;
-}
-
 static int in_strarr(const char* string, const char* const* strarr, size_t count){
 
     for (size_t i = 0; i < count; i++) {
@@ -238,256 +229,71 @@ static void reset_current_data(){
 // # Data Characteristics Aquisition
 // #############################################################################
 
-static double get_data_minimum(const double* data, size_t count){
-
-    double min = INFINITY;
-
-    for (size_t i = 0; i < count; i++) {
-        if (data[i] < min) { min = data[i]; }
-    }
-
-    return min;
-}
-
-static double get_data_maximum(const double* data, size_t count){
-
-    double max = -INFINITY;
-
-    for (size_t i = 0; i < count; i++) {
-        if (data[i] > max) { max = data[i]; }
+// moves the k-th smallest value to position k, smaller values precede it
+static void select_kth(double *values, size_t count, size_t k){
+
+    size_t lo = 0;
+    size_t hi = count - 1;
+    while (lo < hi) {
+        const double pivot = values[lo + (hi - lo) / 2];
+        size_t i = lo;
+        size_t j = hi;
+        while (i <= j) {
+            while (values[i] < pivot) { i++; }
+            while (values[j] > pivot) { j--; }
+            if (i <= j) {
+                const double t = values[i];
+                values[i] = values[j];
+                values[j] = t;
+                i++;
+                if (j == 0) { break; }
+                j--;
+            }
+        }
+        if (k <= j) { hi = j; }
+        else if (k >= i) { lo = i; }
+        else { return; }
     }
-
-    return max;
 }
 
-static double get_data_mean(const double* data, size_t count){
-
-      double mn = 0.0;
+static double get_data_median(const double *data, size_t count){
 
-      for (size_t i = 0; i < count; i++) {
-          mn += data[i];
-      }
-
-      return mn / count;
-}
-
-static int compdblp(const void* a, const void* b){
-
-    if (*(double*)a > *(double*)b){ return 1; }
-    if (*(double*)a < *(double*)b){ return -1; }
-    return 0;
-}
-static double get_data_median(const double* data, size_t count){
+    if (count == 0) { return NAN; }
 
     allocate(double, tmp_buf, count);
     memcpy(tmp_buf, data, count * sizeof(double));
 
-    qsort(tmp_buf, count, sizeof(double), compdblp);
-
-    double median = 0.0;
-
-    if (count % 2 == 0) { median = 0.5 * (tmp_buf[count/2] + tmp_buf[count/2 + 1]); }
-    else                { median = tmp_buf[count/2]; }
-
-    free(tmp_buf);
-
-    return median;
-}
-
-static double get_data_std_deviation(const double* data, size_t count, double mean){
-
-    double variance_sum = 0.0;
-
-    for (size_t i = 0; i < count; i++) {
-        double dif = data[i] - mean;
-        variance_sum += dif * dif;
-    }
-
-    return sqrt(variance_sum / count);
-}
-
-static double get_data_std_deviation_alt(const double* data, size_t count){
-
-    double sum = 0.0, squared_sum = 0.0;
-
-    for (size_t i = 0; i < count; i++) {
-        sum         += data[i];
-        squared_sum += data[i] * data[i];
-    }
-
-    return sqrt((squared_sum - (sum * sum) / count) / count);
-}
-
-static double get_data_max_step_1d(const double *data, const scil_dims_t *dims){
+    const size_t k = count / 2;
+    select_kth(tmp_buf, count, k);
+    double median = tmp_buf[k];
 
-    double max_step = 0.0;
-
-    size_t xsize = dims->length[0];
-
-    for (size_t x = 1; x < xsize; x++) {
-        double step = fabs(data[x] - data[x-1]);
-        if (max_step < step) { max_step = step; }
-    }
-
-    return max_step;
-}
-static double get_data_max_step_2d(const double *data, const scil_dims_t *dims){
-
-    double max_step = 0.0;
-
-    size_t xsize = dims->length[0];
-    size_t ysize = dims->length[1];
-
-    // X-direction
-    for (size_t y = 0; y < ysize; y++) {
-        for (size_t x = 1; x < xsize; x++) {
-            size_t i1 = get_index_2d(x, y, dims);
-            size_t i2 = get_index_2d(x - 1, y, dims);
-            double step = fabs(data[i1] - data[i2]);
-            if (max_step < step) { max_step = step; }
-        }
-    }
-
-    // Y-direction
-    for (size_t y = 1; y < ysize; y++) {
-        for (size_t x = 0; x < xsize; x++) {
-            size_t i1 = get_index_2d(x, y, dims);
-            size_t i2 = get_index_2d(x, y-1, dims);
-            double step = fabs(data[i1] - data[i2]);
-            if (max_step < step) { max_step = step; }
-        }
-    }
-
-    return max_step;
-}
-static double get_data_max_step_3d(const double *data, const scil_dims_t *dims){
-
-    double max_step = 0.0;
-
-    size_t xsize = dims->length[0];
-    size_t ysize = dims->length[1];
-    size_t zsize = dims->length[2];
-
-    // X-direction
-    for (size_t z = 0; z < zsize; z++) {
-        for (size_t y = 0; y < ysize; y++) {
-            for (size_t x = 1; x < xsize; x++) {
-                size_t i1 = get_index_3d(x, y, z, dims);
-                size_t i2 = get_index_3d(x-1, y, z, dims);
-                double step = fabs(data[i1] - data[i2]);
-                if (max_step < step) { max_step = step; }
-            }
-        }
-    }
-    // Y-direction
-    for (size_t z = 0; z < zsize; z++) {
-        for (size_t y = 1; y < ysize; y++) {
-            for (size_t x = 0; x < xsize; x++) {
-                size_t i1 = get_index_3d(x, y, z, dims);
-                size_t i2 = get_index_3d(x, y-1, z, dims);
-                double step = fabs(data[i1] - data[i2]);
-                if (max_step < step) { max_step = step; }
-            }
-        }
-    }
-    // Z-direction
-    for (size_t z = 1; z < zsize; z++) {
-        for (size_t y = 0; y < ysize; y++) {
-            for (size_t x = 0; x < xsize; x++) {
-                size_t i1 = get_index_3d(x, y, z, dims);
-                size_t i2 = get_index_3d(x, y, z-1, dims);
-                double step = fabs(data[i1] - data[i2]);
-                if (max_step < step) { max_step = step; }
-            }
-        }
-    }
-
-    return max_step;
-}
-static double get_data_max_step_4d(const double *data, const scil_dims_t *dims){
-
-    double max_step = 0.0;
-
-    size_t xsize = dims->length[0];
-    size_t ysize = dims->length[1];
-    size_t zsize = dims->length[2];
-    size_t wsize = dims->length[3];
-
-    // X-direction
-    for (size_t w = 0; w < wsize; w++) {
-        for (size_t z = 0; z < zsize; z++) {
-            for (size_t y = 0; y < ysize; y++) {
-                for (size_t x = 1; x < xsize; x++) {
-                    size_t i1 = get_index_4d(x, y, z, w, dims);
-                    size_t i2 = get_index_4d(x-1, y, z, w, dims);
-                    double step = fabs(data[i1] - data[i2]);
-                    if (max_step < step) { max_step = step; }
-                }
-            }
-        }
-    }
-    // Y-direction
-    for (size_t w = 0; w < wsize; w++) {
-        for (size_t z = 0; z < zsize; z++) {
-            for (size_t y = 1; y < ysize; y++) {
-                for (size_t x = 0; x < xsize; x++) {
-                    size_t i1 = get_index_4d(x, y, z, w, dims);
-                    size_t i2 = get_index_4d(x, y-1, z, w, dims);
-                    double step = fabs(data[i1] - data[i2]);
-                    if (max_step < step) { max_step = step; }
-                }
-            }
-        }
-    }
-    // Z-direction
-    for (size_t w = 0; w < wsize; w++) {
-        for (size_t z = 1; z < zsize; z++) {
-            for (size_t y = 0; y < ysize; y++) {
-                for (size_t x = 0; x < xsize; x++) {
-                    size_t i1 = get_index_4d(x, y, z, w, dims);
-                    size_t i2 = get_index_4d(x, y, z-1, w, dims);
-                    double step = fabs(data[i1] - data[i2]);
-                    if (max_step < step) { max_step = step; }
-                }
-            }
-        }
-    }
-    // W-direction
-    for (size_t w = 1; w < wsize; w++) {
-        for (size_t z = 0; z < zsize; z++) {
-            for (size_t y = 0; y < ysize; y++) {
-                for (size_t x = 0; x < xsize; x++) {
-                    size_t i1 = get_index_4d(x, y, z, w, dims);
-                    size_t i2 = get_index_4d(x, y, z, w-1, dims);
-                    double step = fabs(data[i1] - data[i2]);
-                    if (max_step < step) { max_step = step; }
-                }
-            }
+    if (count % 2 == 0) {
+        // the largest value below position k is the lower middle
+        double lower = tmp_buf[0];
+        for (size_t i = 1; i < k; i++) {
+            if (tmp_buf[i] > lower) { lower = tmp_buf[i]; }
         }
+        median = 0.5 * (lower + median);
     }
 
-    return max_step;
-}
-static double get_data_max_step(const double *data, const scil_dims_t *dims){
+    free(tmp_buf);
 
-    switch (dims->dims){
-        case 1: return get_data_max_step_1d(data, dims);
-        case 2: return get_data_max_step_2d(data, dims);
-        case 3: return get_data_max_step_3d(data, dims);
-        case 4: return get_data_max_step_4d(data, dims);
-    }
+    return median;
 }
 
 static int set_data_characteristics(const double *data, const scil_dims_t *dims){
 
-    current_data.min    = get_data_minimum(data, current_data.count);
-    current_data.max    = get_data_maximum(data, current_data.count);
-    current_data.mean   = get_data_mean(data, current_data.count);
-    current_data.median = 0.0;//get_data_median(data, current_data.count);
-    current_data.stddev = get_data_std_deviation(data, current_data.count, current_data.mean);
-    current_data.maxstep = get_data_max_step(data, dims);
+    scil_data_characteristics_t characteristics;
+    int ret = scil_compute_data_characteristics(SCIL_TYPE_DOUBLE, data, dims, DBL_MAX, 0, &characteristics);
 
-    return 0;
+    current_data.min     = characteristics.minimum;
+    current_data.max     = characteristics.maximum;
+    current_data.mean    = characteristics.mean;
+    current_data.median  = get_data_median(data, scil_dims_get_count(dims));
+    current_data.stddev  = sqrt(characteristics.variance);
+    current_data.maxstep = characteristics.gradient_maximum;
+
+    return ret;
 }
 
 // #############################################################################
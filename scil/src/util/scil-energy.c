@@ -0,0 +1,243 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <scil-energy.h>
+#include <scil-hardware-limits.h>
+#include <scil-debug.h>
+#include <scil-error.h>
+
+// the powers in W the model uses if scil.conf does not define them
+#define DEFAULT_ACTIVE_POWER 25.0
+#define DEFAULT_IDLE_POWER 10.0
+
+#define POWERCAP_DIR "/sys/class/powercap"
+#define METERS_MAX 8
+
+static double seconds_between(const struct timespec * start, const struct timespec * end){
+  return (double) (end->tv_sec - start->tv_sec) + (double) (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+double scilU_energy_model(double busy_seconds, double idle_seconds){
+  double active = (double) scilU_get_hardware_limit(POWER_ACTIVE);
+  double idle = (double) scilU_get_hardware_limit(POWER_IDLE);
+  active = active > 0 ? active : DEFAULT_ACTIVE_POWER;
+  idle = idle > 0 ? idle : DEFAULT_IDLE_POWER;
+  return active * busy_seconds + idle * idle_seconds;
+}
+
+static int model_open(void){
+  return SCIL_NO_ERR;
+}
+
+static void model_start(scilU_energy_mark_t * mark){
+  (void) mark;
+}
+
+/*
+ * The busy time is the CPU time of the whole process. It includes the threads of the pool that compress blocks
+ * in parallel, which the CPU time of the calling thread (CLOCK_THREAD_CPUTIME_ID) would miss. Concurrent
+ * measurements in other threads are charged to each other, hence the model suits one measurement at a time.
+ */
+static double model_stop(const scilU_energy_mark_t * mark){
+  struct timespec wall, cpu;
+  clock_gettime(CLOCK_MONOTONIC, & wall);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, & cpu);
+  const double busy = seconds_between(& mark->cpu, & cpu);
+  const double elapsed = seconds_between(& mark->wall, & wall);
+  // the threads of the process may be busy longer than the wall clock time
+  return scilU_energy_model(busy, elapsed > busy ? elapsed - busy : 0);
+}
+
+static const scilU_energy_meter_t model_meter = {
+  .name = "model",
+  .resolution = 0,
+  .open = model_open,
+  .start = model_start,
+  .stop = model_stop
+};
+
+/*
+ * The package domains of the powercap interface, e.g., intel-rapl:0, their subdomains (intel-rapl:0:0)
+ * are part of the package and skipped. The counters are in uJ and wrap around at max_energy_range_uj.
+ */
+static int rapl_fds[SCILU_ENERGY_COUNTERS];
+static uint64_t rapl_ranges[SCILU_ENERGY_COUNTERS];
+static int rapl_count = 0;
+
+static int rapl_read(int domain, uint64_t * out){
+  char buff[32];
+  const ssize_t len = pread(rapl_fds[domain], buff, sizeof(buff) - 1, 0);
+  if (len <= 0){
+    return 0;
+  }
+  buff[len] = 0;
+  *out = strtoull(buff, NULL, 10);
+  return 1;
+}
+
+static int rapl_open(void){
+  if (rapl_count > 0){
+    return SCIL_NO_ERR;
+  }
+  DIR * dir = opendir(POWERCAP_DIR);
+  if (dir == NULL){
+    return SCIL_EINVAL;
+  }
+  struct dirent * entry;
+  while ((entry = readdir(dir)) != NULL && rapl_count < SCILU_ENERGY_COUNTERS){
+    const char * colon = strchr(entry->d_name, ':');
+    if (colon == NULL || strchr(colon + 1, ':') != NULL || strncmp(entry->d_name, "intel-rapl", 10) != 0){
+      continue;
+    }
+    char path[512];
+    snprintf(path, sizeof(path), POWERCAP_DIR "/%s/max_energy_range_uj", entry->d_name);
+    FILE * f = fopen(path, "r");
+    unsigned long long range = 0;
+    if (f == NULL){
+      continue;
+    }
+    if (fscanf(f, "%llu", & range) != 1){
+      range = 0;
+    }
+    fclose(f);
+    snprintf(path, sizeof(path), POWERCAP_DIR "/%s/energy_uj", entry->d_name);
+    // the counters are usually readable by root only
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0){
+      continue;
+    }
+    rapl_fds[rapl_count] = fd;
+    rapl_ranges[rapl_count] = range;
+    uint64_t value;
+    if (! rapl_read(rapl_count, & value)){
+      close(fd);
+      continue;
+    }
+    debug("Energy: using %s\n", path);
+    rapl_count++;
+  }
+  closedir(dir);
+  return rapl_count > 0 ? SCIL_NO_ERR : SCIL_EINVAL;
+}
+
+static void rapl_start(scilU_energy_mark_t * mark){
+  for (int i = 0; i < rapl_count; i++){
+    if (! rapl_read(i, & mark->counters[i])){
+      mark->counters[i] = 0;
+    }
+  }
+}
+
+static double rapl_stop(const scilU_energy_mark_t * mark){
+  uint64_t uj = 0;
+  for (int i = 0; i < rapl_count; i++){
+    uint64_t value;
+    if (! rapl_read(i, & value)){
+      continue;
+    }
+    if (value >= mark->counters[i]){
+      uj += value - mark->counters[i];
+    }else{
+      uj += rapl_ranges[i] - mark->counters[i] + value;
+    }
+  }
+  return (double) uj * 1e-6;
+}
+
+// the package counters are updated about every millisecond
+static const scilU_energy_meter_t rapl_meter = {
+  .name = "rapl",
+  .resolution = 0.001,
+  .open = rapl_open,
+  .start = rapl_start,
+  .stop = rapl_stop
+};
+
+static const scilU_energy_meter_t * meters[METERS_MAX] = {& rapl_meter, & model_meter};
+static int meter_count = 2;
+// the meter is selected once, scilU_energy_select() may replace it later, the lock protects both
+static const scilU_energy_meter_t * meter = NULL;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t meter_once = PTHREAD_ONCE_INIT;
+
+static void initialize(){
+  pthread_mutex_lock(& lock);
+  if (meter == NULL){
+    const char * name = getenv("SCIL_ENERGY_METER");
+    for (int i = 0; i < meter_count && meter == NULL; i++){
+      if ((name == NULL || strcmp(name, meters[i]->name) == 0) && meters[i]->open() == SCIL_NO_ERR){
+        meter = meters[i];
+      }
+    }
+    if (meter == NULL){
+      warn("Energy meter \"%s\" is not usable, using the model\n", name);
+      meter = & model_meter;
+    }
+    debug("Energy meter: %s\n", meter->name);
+  }
+  pthread_mutex_unlock(& lock);
+}
+
+int scilU_energy_register(const scilU_energy_meter_t * new_meter){
+  int ret = SCIL_EINVAL;
+  pthread_mutex_lock(& lock);
+  if (meter_count < METERS_MAX){
+    meters[meter_count++] = new_meter;
+    ret = SCIL_NO_ERR;
+  }
+  pthread_mutex_unlock(& lock);
+  return ret;
+}
+
+int scilU_energy_select(const char * name){
+  int ret = SCIL_EINVAL;
+  pthread_mutex_lock(& lock);
+  for (int i = 0; i < meter_count; i++){
+    if (strcmp(name, meters[i]->name) == 0 && meters[i]->open() == SCIL_NO_ERR){
+      meter = meters[i];
+      ret = SCIL_NO_ERR;
+      break;
+    }
+  }
+  pthread_mutex_unlock(& lock);
+  return ret;
+}
+
+const scilU_energy_meter_t * scilU_energy_get_meter(){
+  pthread_once(& meter_once, initialize);
+  pthread_mutex_lock(& lock);
+  const scilU_energy_meter_t * m = meter;
+  pthread_mutex_unlock(& lock);
+  return m;
+}
+
+void scilU_energy_start(scilU_energy_mark_t * mark){
+  const scilU_energy_meter_t * m = scilU_energy_get_meter();
+  clock_gettime(CLOCK_MONOTONIC, & mark->wall);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, & mark->cpu);
+  m->start(mark);
+}
+
+double scilU_energy_stop(const scilU_energy_mark_t * mark){
+  return scilU_energy_get_meter()->stop(mark);
+}
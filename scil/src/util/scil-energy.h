@@ -0,0 +1,80 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_ENERGY_H
+#define SCIL_ENERGY_H
+
+/**
+ * \file
+ * \brief Accounting of the energy consumed between two points of the program.
+ *
+ * The meter is selected on first use by the environment variable SCIL_ENERGY_METER, by default the
+ * counters of the Linux powercap interface ("rapl") are used if they are readable, otherwise the
+ * model ("model"). Further meters can be registered by scilU_energy_register().
+ *
+ * The model charges the power of a busy CPU for the CPU time of the process and the idle power for the
+ * remaining wall clock time, the powers are the hardware limits "power_active" and "power_idle" of scil.conf.
+ * The CPU time of the process includes all of its threads, measurements that overlap with other work of the
+ * process are charged for it as well.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#define SCILU_ENERGY_COUNTERS 8
+
+/** \brief The state of the meter at the start of a measurement */
+typedef struct {
+  struct timespec wall;
+  struct timespec cpu;
+  uint64_t counters[SCILU_ENERGY_COUNTERS];
+} scilU_energy_mark_t;
+
+typedef struct {
+  const char * name;
+  /** \brief The interval in seconds the counters are updated, shorter measurements are not meaningful */
+  double resolution;
+  /** \brief Returns SCIL_NO_ERR if the meter can be used on this machine */
+  int (*open)(void);
+  /** \brief Store the counters of the meter, the times of the mark are already set */
+  void (*start)(scilU_energy_mark_t * mark);
+  /** \brief The joules consumed since the mark */
+  double (*stop)(const scilU_energy_mark_t * mark);
+} scilU_energy_meter_t;
+
+/**
+ * \brief Add a meter that can be selected by its name, the meter must stay valid.
+ */
+int scilU_energy_register(const scilU_energy_meter_t * meter);
+
+/**
+ * \brief Use the meter with the name if it can be opened.
+ * \return SCIL_EINVAL if it is unknown or not usable, the current meter is kept then
+ */
+int scilU_energy_select(const char * name);
+
+const scilU_energy_meter_t * scilU_energy_get_meter();
+
+void scilU_energy_start(scilU_energy_mark_t * mark);
+
+/** \brief The joules consumed since scilU_energy_start() */
+double scilU_energy_stop(const scilU_energy_mark_t * mark);
+
+/**
+ * \brief The joules the model expects for the given busy CPU time and waiting time in seconds.
+ */
+double scilU_energy_model(double busy_seconds, double idle_seconds);
+
+#endif // SCIL_ENERGY_H
@@ -21,9 +21,12 @@
 #include <scil-error.h>
 
 static float hardware_limits[HARDWARE_MAX];
+// in the order of enum hardware_limit_e
 static const char* hardware_names[] = {
-  "storage",
   "network",
+  "storage",
+  "power_active",
+  "power_idle",
   NULL
 };
 
@@ -45,3 +48,7 @@ int scilU_add_hardware_limit(const char* name, const char* str){
   }
   return SCIL_EINVAL;
 }
+
+float scilU_get_hardware_limit(enum hardware_limit_e limit){
+  return hardware_limits[limit];
+}
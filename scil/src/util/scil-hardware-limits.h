@@ -19,6 +19,8 @@
 enum hardware_limit_e{
   NETWORK = 0,
   STORAGE = 1,
+  POWER_ACTIVE = 2, // the power of a busy CPU
+  POWER_IDLE = 3, // the power while waiting for the transfer of data
   HARDWARE_MAX
 };
 
@@ -26,5 +28,11 @@ void scilU_initialize_hardware_limits();
 
 int scilU_add_hardware_limit(const char* name, const char* str);
 
+/*
+ * The value as given in the configuration file, 0 if it is unknown.
+ * Throughputs are in MiB/s, powers in W.
+ */
+float scilU_get_hardware_limit(enum hardware_limit_e limit);
+
 
 #endif // SCIL_HARDWARE_LIMITS_H
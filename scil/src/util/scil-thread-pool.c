@@ -0,0 +1,260 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-thread-pool.h>
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct scilU_job scilU_job_t;
+
+struct scilU_job {
+  scilU_task_func_t func;
+  void * user_ptr;
+
+  size_t count;
+  size_t next;      // the next task to hand out
+  size_t finished;  // number of completed tasks
+
+  int max_slots;
+  int slots_used;   // number of threads that joined the job
+  int active;       // threads currently working on the job
+  int detached;     // nobody waits for the job, it is freed by the last thread
+
+  scilU_job_t * next_job;
+};
+
+struct scilU_thread_pool {
+  pthread_mutex_t lock;
+  pthread_cond_t work_available;
+  pthread_cond_t job_done;
+
+  int thread_count;
+  pthread_t * threads;
+  int shutdown;
+
+  scilU_job_t * head;
+  scilU_job_t * tail;
+};
+
+static void dequeue_job(scilU_thread_pool_t * pool, scilU_job_t * job){
+  scilU_job_t * prev = NULL;
+  for(scilU_job_t * cur = pool->head; cur != NULL; cur = cur->next_job){
+    if(cur == job){
+      if(prev == NULL){
+        pool->head = cur->next_job;
+      }else{
+        prev->next_job = cur->next_job;
+      }
+      if(pool->tail == cur){
+        pool->tail = prev;
+      }
+      return;
+    }
+    prev = cur;
+  }
+}
+
+// returns the first job a new thread may join, the lock must be held
+static scilU_job_t * find_job(scilU_thread_pool_t * pool){
+  for(scilU_job_t * cur = pool->head; cur != NULL; cur = cur->next_job){
+    if(cur->next < cur->count && cur->slots_used < cur->max_slots){
+      return cur;
+    }
+  }
+  return NULL;
+}
+
+// process tasks of the job until none are left, the lock must be held on entry and is held on exit
+static void work_on_job(scilU_thread_pool_t * pool, scilU_job_t * job, int slot){
+  job->active++;
+  while(job->next < job->count){
+    size_t task = job->next++;
+    if(job->next == job->count){
+      dequeue_job(pool, job);
+    }
+    pthread_mutex_unlock(& pool->lock);
+
+    job->func(job->user_ptr, task, slot);
+
+    pthread_mutex_lock(& pool->lock);
+    job->finished++;
+  }
+  job->active--;
+  if(job->finished == job->count && job->active == 0){
+    if(job->detached){
+      free(job);
+    }else{
+      pthread_cond_broadcast(& pool->job_done);
+    }
+  }
+}
+
+// the lock must be held
+static void enqueue_job(scilU_thread_pool_t * pool, scilU_job_t * job){
+  if(pool->tail == NULL){
+    pool->head = job;
+  }else{
+    pool->tail->next_job = job;
+  }
+  pool->tail = job;
+  pthread_cond_broadcast(& pool->work_available);
+}
+
+static void * worker_main(void * arg){
+  scilU_thread_pool_t * pool = (scilU_thread_pool_t *) arg;
+
+  pthread_mutex_lock(& pool->lock);
+  while(1){
+    scilU_job_t * job = find_job(pool);
+    if(job == NULL){
+      if(pool->shutdown){
+        break;
+      }
+      pthread_cond_wait(& pool->work_available, & pool->lock);
+      continue;
+    }
+    int slot = job->slots_used++;
+    work_on_job(pool, job, slot);
+  }
+  pthread_mutex_unlock(& pool->lock);
+  return NULL;
+}
+
+scilU_thread_pool_t * scilU_thread_pool_create(int threads){
+  if(threads < 1){
+    threads = 1;
+  }
+  scilU_thread_pool_t * pool = (scilU_thread_pool_t *) scilU_safe_malloc(sizeof(scilU_thread_pool_t));
+  memset(pool, 0, sizeof(scilU_thread_pool_t));
+
+  pthread_mutex_init(& pool->lock, NULL);
+  pthread_cond_init(& pool->work_available, NULL);
+  pthread_cond_init(& pool->job_done, NULL);
+
+  pool->threads = (pthread_t *) scilU_safe_malloc(sizeof(pthread_t) * threads);
+  pool->thread_count = 1;
+  for(int i=1; i < threads; i++){
+    if(pthread_create(& pool->threads[pool->thread_count - 1], NULL, worker_main, pool) != 0){
+      break;
+    }
+    pool->thread_count++;
+  }
+  return pool;
+}
+
+void scilU_thread_pool_destroy(scilU_thread_pool_t * pool){
+  if(pool == NULL){
+    return;
+  }
+  pthread_mutex_lock(& pool->lock);
+  pool->shutdown = 1;
+  pthread_cond_broadcast(& pool->work_available);
+  pthread_mutex_unlock(& pool->lock);
+
+  for(int i=0; i < pool->thread_count - 1; i++){
+    pthread_join(pool->threads[i], NULL);
+  }
+
+  pthread_mutex_destroy(& pool->lock);
+  pthread_cond_destroy(& pool->work_available);
+  pthread_cond_destroy(& pool->job_done);
+  free(pool->threads);
+  free(pool);
+}
+
+int scilU_thread_pool_size(const scilU_thread_pool_t * pool){
+  return pool->thread_count;
+}
+
+void scilU_thread_pool_run(scilU_thread_pool_t * pool, size_t count, int max_slots, scilU_task_func_t func, void * user_ptr){
+  if(count == 0){
+    return;
+  }
+  if(max_slots < 1){
+    max_slots = 1;
+  }
+  // nothing to share, avoid the synchronization
+  if(max_slots == 1 || count == 1 || pool->thread_count == 1){
+    for(size_t i=0; i < count; i++){
+      func(user_ptr, i, 0);
+    }
+    return;
+  }
+
+  scilU_job_t job;
+  memset(& job, 0, sizeof(job));
+  job.func = func;
+  job.user_ptr = user_ptr;
+  job.count = count;
+  job.max_slots = max_slots;
+
+  pthread_mutex_lock(& pool->lock);
+  enqueue_job(pool, & job);
+
+  // the caller always participates
+  int slot = job.slots_used++;
+  work_on_job(pool, & job, slot);
+
+  while(job.finished < job.count || job.active > 0){
+    pthread_cond_wait(& pool->job_done, & pool->lock);
+  }
+  pthread_mutex_unlock(& pool->lock);
+}
+
+void scilU_thread_pool_submit(scilU_thread_pool_t * pool, scilU_task_func_t func, void * user_ptr){
+  if(pool->thread_count == 1){
+    func(user_ptr, 0, 0);
+    return;
+  }
+  scilU_job_t * job = (scilU_job_t *) scilU_safe_malloc(sizeof(scilU_job_t));
+  memset(job, 0, sizeof(scilU_job_t));
+  job->func = func;
+  job->user_ptr = user_ptr;
+  job->count = 1;
+  job->max_slots = 1;
+  job->detached = 1;
+
+  pthread_mutex_lock(& pool->lock);
+  enqueue_job(pool, job);
+  pthread_mutex_unlock(& pool->lock);
+}
+
+int scilU_get_default_thread_count(){
+  const char * env = getenv("SCIL_THREADS");
+  if(env != NULL && atoi(env) > 0){
+    return atoi(env);
+  }
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if(cpus < 1){
+    return 1;
+  }
+  return (int) cpus;
+}
+
+static scilU_thread_pool_t * global_pool = NULL;
+static pthread_once_t global_pool_once = PTHREAD_ONCE_INIT;
+
+static void create_global_pool(){
+  global_pool = scilU_thread_pool_create(scilU_get_default_thread_count());
+}
+
+scilU_thread_pool_t * scilU_get_thread_pool(){
+  pthread_once(& global_pool_once, create_global_pool);
+  return global_pool;
+}
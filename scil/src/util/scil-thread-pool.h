@@ -0,0 +1,78 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_THREAD_POOL_H
+#define SCIL_THREAD_POOL_H
+
+/**
+ * \file
+ * \brief A small pthread based pool that executes parallel loops.
+ *
+ * A job consists of count independent tasks [0, count).
+ * The calling thread takes part in the job and the call returns once all tasks are finished.
+ * Multiple threads may submit jobs to the same pool concurrently.
+ * A single task can also be submitted without waiting for it, see scilU_thread_pool_submit().
+ */
+
+#include <stddef.h>
+
+typedef struct scilU_thread_pool scilU_thread_pool_t;
+
+/**
+ * \brief Function executed for every task of a job.
+ * \param user_ptr The pointer handed to scilU_thread_pool_run()
+ * \param task The index of the task in [0, count)
+ * \param slot The slot of the executing thread inside this job in [0, max_slots),
+ * it can be used to index per-thread scratch memory.
+ */
+typedef void (*scilU_task_func_t)(void * user_ptr, size_t task, int slot);
+
+/**
+ * \brief Create a pool with the given number of threads (including the caller), i.e., threads - 1 workers are started.
+ */
+scilU_thread_pool_t * scilU_thread_pool_create(int threads);
+
+void scilU_thread_pool_destroy(scilU_thread_pool_t * pool);
+
+/**
+ * \brief The maximum number of threads that can take part in a single job.
+ */
+int scilU_thread_pool_size(const scilU_thread_pool_t * pool);
+
+/**
+ * \brief Execute func for all tasks using up to max_slots threads of the pool.
+ * Blocks until all tasks are completed.
+ */
+void scilU_thread_pool_run(scilU_thread_pool_t * pool, size_t count, int max_slots, scilU_task_func_t func, void * user_ptr);
+
+/**
+ * \brief Execute func(user_ptr, 0, 0) by a worker of the pool and return immediately.
+ * The tasks are started in the order of submission after the jobs queued before.
+ * A pool without workers executes the task before returning.
+ */
+void scilU_thread_pool_submit(scilU_thread_pool_t * pool, scilU_task_func_t func, void * user_ptr);
+
+/**
+ * \brief The number of threads to use by default.
+ * It can be set with the environment variable SCIL_THREADS, otherwise the number of online CPUs is used.
+ */
+int scilU_get_default_thread_count();
+
+/**
+ * \brief The process wide pool that is used by the library, it is created on first use.
+ */
+scilU_thread_pool_t * scilU_get_thread_pool();
+
+#endif // SCIL_THREAD_POOL_H
@@ -2,52 +2,145 @@
 
 #include <scil-util.h>
 #include <scil-debug.h>
+#include <scil-thread-pool.h>
 
 //Supported datatypes: int8_t int16_t int32_t int64_t float double
 // Repeat for each data type
 
+// the number of independent minima and maxima, the compiler maps them to vector registers
+#define MINMAX_LANES_<DATATYPE> (64 / <DATATYPE_SIZE_BYTE>)
+
+/*
+ * The flags are constants in every caller, hence each variant is a branch free loop that can be vectorised.
+ * Excluded points are replaced by the neutral element instead of skipping them.
+ */
+static inline __attribute__((always_inline)) void minmax_kernel_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum,
+    const int use_fill, const int use_range, double ignore_up_to, double ignore_from, double fill_value){
+    <DATATYPE> mn[MINMAX_LANES_<DATATYPE>];
+    <DATATYPE> mx[MINMAX_LANES_<DATATYPE>];
+    for(int k = 0; k < MINMAX_LANES_<DATATYPE>; ++k){
+      mn[k] = INFINITY_<DATATYPE>;
+      mx[k] = NINFINITY_<DATATYPE>;
+    }
+
+    size_t i = 0;
+    for(; i + MINMAX_LANES_<DATATYPE> <= count; i += MINMAX_LANES_<DATATYPE>){
+      for(int k = 0; k < MINMAX_LANES_<DATATYPE>; ++k){
+        const <DATATYPE> v = buffer[i + k];
+        int keep = 1;
+        if(use_fill){
+          keep &= ! (fabs((double) v - fill_value) < (double) FLT_EPSILON);
+        }
+        if(use_range){
+          keep &= ! ((double) v > ignore_from) & ! ((double) v < ignore_up_to);
+        }
+        const <DATATYPE> lo = keep ? v : INFINITY_<DATATYPE>;
+        const <DATATYPE> hi = keep ? v : NINFINITY_<DATATYPE>;
+        mn[k] = lo < mn[k] ? lo : mn[k];
+        mx[k] = hi > mx[k] ? hi : mx[k];
+      }
+    }
+    <DATATYPE> min = mn[0];
+    <DATATYPE> max = mx[0];
+    for(int k = 1; k < MINMAX_LANES_<DATATYPE>; ++k){
+      if (mn[k] < min) { min = mn[k]; }
+      if (mx[k] > max) { max = mx[k]; }
+    }
+    for(; i < count; ++i){
+      const <DATATYPE> v = buffer[i];
+      if (use_fill && fabs((double) v - fill_value) < (double) FLT_EPSILON) continue;
+      if (use_range && ((double) v > ignore_from || (double) v < ignore_up_to)) continue;
+      if (v < min) { min = v; }
+      if (v > max) { max = v; }
+    }
+
+    *minimum = min;
+    *maximum = max;
+}
+
+SCILU_VECTOR_CLONES
+static void minmax_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum){
+    minmax_kernel_<DATATYPE>(buffer, count, minimum, maximum, 0, 0, 0, 0, 0);
+}
+
+SCILU_VECTOR_CLONES
+static void minmax_fill_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double fill_value){
+    minmax_kernel_<DATATYPE>(buffer, count, minimum, maximum, 1, 0, 0, 0, fill_value);
+}
+
+SCILU_VECTOR_CLONES
+static void minmax_range_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double ignore_up_to, double ignore_from){
+    minmax_kernel_<DATATYPE>(buffer, count, minimum, maximum, 0, 1, ignore_up_to, ignore_from, 0);
+}
+
+SCILU_VECTOR_CLONES
+static void minmax_fill_range_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double ignore_up_to, double ignore_from, double fill_value){
+    minmax_kernel_<DATATYPE>(buffer, count, minimum, maximum, 1, 1, ignore_up_to, ignore_from, fill_value);
+}
+
 void scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double ignore_up_to, double ignore_from, double fill_value){
 
     assert(buffer != NULL);
     assert(minimum != NULL);
     assert(maximum != NULL);
 
-    <DATATYPE> min = INFINITY_<DATATYPE>;
-    <DATATYPE> max = NINFINITY_<DATATYPE>;
-    if (fill_value != DBL_MAX && ignore_up_to != -DBL_MAX && ignore_from != DBL_MAX){
-      for(size_t i = 0; i < count; ++i){
-        if (fabs(buffer[i] - fill_value) < FLT_EPSILON){
-          debugI("%s Ignored some fill value\n", __PRETTY_FUNCTION__);
-          continue;
-        }
-        if ((double) buffer[i] > ignore_from)  continue;
-        if ((double) buffer[i] < ignore_up_to) continue;
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-      }
-    }else if (fill_value != DBL_MAX){
-      for(size_t i = 0; i < count; ++i){
-        if (fabs(buffer[i] - fill_value) < FLT_EPSILON){
-          debugI("%s Ignored some fill value\n", __PRETTY_FUNCTION__);
-          continue;
-        }
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-      }
-    } else if (ignore_up_to == -DBL_MAX && ignore_from == DBL_MAX){
-      for(size_t i = 0; i < count; ++i){
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-      }
+    // a fill value excludes the lossless range only if both of its bounds are set
+    const int use_fill = fill_value < DBL_MAX;
+    const int use_range = ignore_up_to > -DBL_MAX || ignore_from < DBL_MAX;
+    if (use_fill && ignore_up_to > -DBL_MAX && ignore_from < DBL_MAX){
+      minmax_fill_range_<DATATYPE>(buffer, count, minimum, maximum, ignore_up_to, ignore_from, fill_value);
+    }else if (use_fill){
+      minmax_fill_<DATATYPE>(buffer, count, minimum, maximum, fill_value);
+    }else if (use_range){
+      minmax_range_<DATATYPE>(buffer, count, minimum, maximum, ignore_up_to, ignore_from);
     }else{
-      for(size_t i = 0; i < count; ++i){
-        if ((double) buffer[i] > ignore_from)  continue;
-        if ((double) buffer[i] < ignore_up_to) continue;
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-      }
+      minmax_<DATATYPE>(buffer, count, minimum, maximum);
     }
+}
+
+typedef struct {
+  const <DATATYPE>* buffer;
+  size_t count;
+  size_t chunk;
+  double ignore_up_to;
+  double ignore_from;
+  double fill_value;
+  <DATATYPE>* minima;
+  <DATATYPE>* maxima;
+} minmax_job_<DATATYPE>_t;
 
+static void minmax_chunk_<DATATYPE>(void * user_ptr, size_t task, int slot){
+    minmax_job_<DATATYPE>_t * job = (minmax_job_<DATATYPE>_t *) user_ptr;
+    const size_t start = task * job->chunk;
+    const size_t count = start + job->chunk < job->count ? job->chunk : job->count - start;
+    scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(job->buffer + start, count, & job->minima[task], & job->maxima[task], job->ignore_up_to, job->ignore_from, job->fill_value);
+}
+
+void scilU_find_minimum_maximum_parallel_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, <DATATYPE>* minimum, <DATATYPE>* maximum, double ignore_up_to, double ignore_from, double fill_value, int threads){
+    size_t chunks = count * sizeof(<DATATYPE>) / SCILU_PARALLEL_MIN_SIZE;
+    if (chunks > (size_t) threads){
+      chunks = threads;
+    }
+    if (chunks > SCILU_PARALLEL_MAX_CHUNKS){
+      chunks = SCILU_PARALLEL_MAX_CHUNKS;
+    }
+    if (chunks <= 1){
+      scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(buffer, count, minimum, maximum, ignore_up_to, ignore_from, fill_value);
+      return;
+    }
+
+    <DATATYPE> minima[SCILU_PARALLEL_MAX_CHUNKS];
+    <DATATYPE> maxima[SCILU_PARALLEL_MAX_CHUNKS];
+    minmax_job_<DATATYPE>_t job = {buffer, count, (count + chunks - 1) / chunks, ignore_up_to, ignore_from, fill_value, minima, maxima};
+    scilU_thread_pool_t * pool = scilU_get_thread_pool();
+    scilU_thread_pool_run(pool, chunks, (int) chunks, minmax_chunk_<DATATYPE>, & job);
+
+    <DATATYPE> min = minima[0];
+    <DATATYPE> max = maxima[0];
+    for(size_t i = 1; i < chunks; ++i){
+      if (minima[i] < min) { min = minima[i]; }
+      if (maxima[i] > max) { max = maxima[i]; }
+    }
     *minimum = min;
     *maximum = max;
 }
@@ -62,16 +155,7 @@ void scilU_find_minimum_maximum_<DATATYPE>(const <DATATYPE>* restrict buffer,
     assert(minimum != NULL);
     assert(maximum != NULL);
 
-    <DATATYPE> min = INFINITY_<DATATYPE>;
-    <DATATYPE> max = NINFINITY_<DATATYPE>;
-
-    for(size_t i = 0; i < count; ++i){
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-    }
-
-    *minimum = min;
-    *maximum = max;
+    minmax_<DATATYPE>(buffer, count, minimum, maximum);
 }
 
 void scilU_subtract_data_<DATATYPE>(const <DATATYPE>* restrict in, <DATATYPE>* restrict inout, size_t count){
@@ -7,10 +7,10 @@
 
 #include <scil-datatypes.h>
 
-#define INFINITY_double INFINITY
+#define INFINITY_double HUGE_VAL
 #define INFINITY_float INFINITY
 
-#define NINFINITY_double -INFINITY
+#define NINFINITY_double -HUGE_VAL
 #define NINFINITY_float -INFINITY
 
 #define INFINITY_int8_t CHAR_MAX
@@ -34,6 +34,17 @@
 #define FLT_FINEST_SUB_double  0.0000000000001
 #define FLT_FINEST_SUB_float 0.000001
 
+// the minimum number of bytes a thread processes in the parallel reductions
+#define SCILU_PARALLEL_MIN_SIZE (4 * 1024 * 1024)
+#define SCILU_PARALLEL_MAX_CHUNKS 256
+
+// create variants of a function for AVX2 and the baseline instruction set that are selected at load time
+#if defined(__x86_64__) && defined(__GNUC__) && ! defined(__clang__) && defined(__linux__)
+#define SCILU_VECTOR_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define SCILU_VECTOR_CLONES
+#endif
+
 
 //Supported datatypes: int8_t int16_t int32_t int64_t float double
 // Repeat for each data type
@@ -68,6 +79,17 @@ void scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(const <DATATYPE>
                                           <DATATYPE>* maximum,
                                           double ignore_up_to, double ignore_from, double fill_value);
 
+/**
+ * \brief Like scilU_find_minimum_maximum_with_excluded_points_<DATATYPE>(), large buffers are split among
+ * up to the given number of threads of the pool.
+ */
+void scilU_find_minimum_maximum_parallel_<DATATYPE>(const <DATATYPE>* restrict buffer,
+                                          size_t count,
+                                          <DATATYPE>* minimum,
+                                          <DATATYPE>* maximum,
+                                          double ignore_up_to, double ignore_from, double fill_value,
+                                          int threads);
+
 // End repeat
 
 #endif
@@ -353,7 +353,7 @@ size_t scilU_data_pos(const scil_dims_t* pos, const scil_dims_t* size){
     return cur;
   }
   for(int i=size->dims - 2; i >= 0; i--){
-    cur *= size->length[i+1];
+    cur *= size->length[i];
     cur += pos->length[i];
   }
   return cur;
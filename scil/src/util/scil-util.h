@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include <scil-dims.h>
@@ -86,7 +87,8 @@ typedef union {
 size_t scil_dims_get_size(const scil_dims_t *dims, enum SCIL_Datatype type);
 
 /*
- * \brief Return the minimum size of the compression buffer needed.
+ * \brief Return a size that suffices for the compressed data and the temporary buffer of scil_decompress().
+ * scil_compress_bound() gives the exact worst case for compression.
  */
 size_t scil_get_compressed_data_size_limit(const scil_dims_t *dims, enum SCIL_Datatype datatype);
 
@@ -207,14 +209,14 @@ void scilU_print_dims(scil_dims_t dims);
 
 #ifdef SCIL_LITTLE_ENDIAN
 
-#define scilU_pack2(buffer, val) *((int16_t*)buffer) = *(int16_t*) & val
-#define scilU_unpack2(buffer, result_p) *(int16_t*)result_p = *((int16_t*) buffer)
+#define scilU_pack2(buffer, val) memcpy(buffer, & val, 2)
+#define scilU_unpack2(buffer, result_p) memcpy(result_p, buffer, 2)
 
-#define scilU_pack4(buffer, val) *((int32_t*)buffer) = *(int32_t*) & val
-#define scilU_unpack4(buffer, result_p) *(int32_t*)result_p = *((int32_t*) buffer)
+#define scilU_pack4(buffer, val) memcpy(buffer, & val, 4)
+#define scilU_unpack4(buffer, result_p) memcpy(result_p, buffer, 4)
 
-#define scilU_pack8(buffer, val) *((int64_t*)buffer) = *(int64_t*) & val
-#define scilU_unpack8(buffer, result_p) *(int64_t*) result_p = *((int64_t*) buffer)
+#define scilU_pack8(buffer, val) memcpy(buffer, & val, 8)
+#define scilU_unpack8(buffer, result_p) memcpy(result_p, buffer, 8)
 
 #else
 
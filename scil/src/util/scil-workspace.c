@@ -0,0 +1,163 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-workspace.h>
+#include <scil-util.h>
+#include <scil-debug.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGNMENT 64
+
+// the size of the first chunk, every further chunk is at least twice as large as the previous one
+#define MIN_CHUNK_SIZE (64 * 1024)
+
+#define MAX_CHUNKS 48
+
+// the memory the arena of a thread keeps once all its allocations are released
+#define THREAD_RETAINED_SIZE (16 * 1024 * 1024)
+
+typedef struct {
+  char * data;
+  size_t size;
+  size_t used;
+} chunk_t;
+
+struct scilU_workspace {
+  chunk_t chunks[MAX_CHUNKS];
+  int count;
+  int current; // the chunk allocations are taken from
+  size_t retained; // the capacity kept when everything is released
+};
+
+scilU_workspace_t * scilU_workspace_create(){
+  scilU_workspace_t * ws = (scilU_workspace_t *) scilU_safe_malloc(sizeof(scilU_workspace_t));
+  memset(ws, 0, sizeof(scilU_workspace_t));
+  ws->retained = (size_t) -1;
+  return ws;
+}
+
+void scilU_workspace_destroy(scilU_workspace_t * ws){
+  if(ws == NULL){
+    return;
+  }
+  for(int i=0; i < ws->count; i++){
+    free(ws->chunks[i].data);
+  }
+  free(ws);
+}
+
+void * scilU_workspace_alloc(scilU_workspace_t * ws, size_t size){
+  size = size == 0 ? ALIGNMENT : (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+  // continue with the next chunks that exist already
+  while(ws->current < ws->count){
+    chunk_t * c = & ws->chunks[ws->current];
+    if(c->size - c->used >= size){
+      void * p = c->data + c->used;
+      c->used += size;
+      return p;
+    }
+    if(ws->current + 1 == ws->count){
+      break;
+    }
+    ws->current++;
+    ws->chunks[ws->current].used = 0;
+  }
+
+  // grow
+  if(ws->count == MAX_CHUNKS){
+    debug("The workspace exceeds %d chunks\n", MAX_CHUNKS);
+    return NULL;
+  }
+  size_t chunk_size = ws->count == 0 ? MIN_CHUNK_SIZE : 2 * ws->chunks[ws->count - 1].size;
+  if(chunk_size < size){
+    chunk_size = size;
+  }
+  chunk_t * c = & ws->chunks[ws->count];
+  if(posix_memalign((void **) & c->data, ALIGNMENT, chunk_size) != 0){
+    debug("Could not allocate %zu bytes for the workspace\n", chunk_size);
+    c->data = NULL;
+    return NULL;
+  }
+  c->size = chunk_size;
+  c->used = size;
+  ws->current = ws->count;
+  ws->count++;
+  debug("Workspace grows by %zu bytes\n", chunk_size);
+  return c->data;
+}
+
+scilU_workspace_mark_t scilU_workspace_mark(const scilU_workspace_t * ws){
+  scilU_workspace_mark_t mark;
+  mark.chunk = ws->current;
+  mark.used = ws->current < ws->count ? ws->chunks[ws->current].used : 0;
+  return mark;
+}
+
+void scilU_workspace_release(scilU_workspace_t * ws, scilU_workspace_mark_t mark){
+  ws->current = mark.chunk;
+  if(mark.chunk < ws->count){
+    ws->chunks[mark.chunk].used = mark.used;
+  }
+  if(mark.chunk != 0 || mark.used != 0){
+    return;
+  }
+  // the arena is empty, free the largest chunks beyond the retained size
+  size_t capacity = scilU_workspace_capacity(ws);
+  while(ws->count > 0 && capacity > ws->retained){
+    ws->count--;
+    capacity -= ws->chunks[ws->count].size;
+    free(ws->chunks[ws->count].data);
+    debug("Workspace shrinks by %zu bytes\n", ws->chunks[ws->count].size);
+    memset(& ws->chunks[ws->count], 0, sizeof(chunk_t));
+  }
+}
+
+void scilU_workspace_set_retained(scilU_workspace_t * ws, size_t size){
+  ws->retained = size;
+}
+
+size_t scilU_workspace_capacity(const scilU_workspace_t * ws){
+  size_t size = 0;
+  for(int i=0; i < ws->count; i++){
+    size += ws->chunks[i].size;
+  }
+  return size;
+}
+
+static pthread_key_t thread_key;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+
+static void destroy_thread_workspace(void * ws){
+  scilU_workspace_destroy((scilU_workspace_t *) ws);
+}
+
+static void create_thread_key(){
+  pthread_key_create(& thread_key, destroy_thread_workspace);
+}
+
+scilU_workspace_t * scilU_get_thread_workspace(){
+  pthread_once(& thread_key_once, create_thread_key);
+  scilU_workspace_t * ws = (scilU_workspace_t *) pthread_getspecific(thread_key);
+  if(ws == NULL){
+    ws = scilU_workspace_create();
+    scilU_workspace_set_retained(ws, THREAD_RETAINED_SIZE);
+    pthread_setspecific(thread_key, ws);
+  }
+  return ws;
+}
@@ -0,0 +1,73 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_WORKSPACE_H
+#define SCIL_WORKSPACE_H
+
+/**
+ * \file
+ * \brief A growing arena for scratch memory.
+ *
+ * Memory is taken from the arena in a stack-like fashion: a user marks the current position,
+ * allocates what it needs and releases everything up to the mark when it is done.
+ * By default the memory of the arena is not returned to the system before the arena is destroyed,
+ * hence once the arena has grown to the peak demand no further heap allocations happen.
+ * An arena with a retained size frees its chunks beyond that size whenever all allocations are released.
+ * An arena must not be used by multiple threads at the same time.
+ */
+
+#include <stddef.h>
+
+typedef struct scilU_workspace scilU_workspace_t;
+
+typedef struct {
+  int chunk;
+  size_t used;
+} scilU_workspace_mark_t;
+
+scilU_workspace_t * scilU_workspace_create();
+
+void scilU_workspace_destroy(scilU_workspace_t * ws);
+
+/**
+ * \brief Allocate size bytes aligned to 64 bytes, the memory is valid until it is released.
+ * \return NULL if the memory is exhausted, the arena remains usable, callers report SCIL_MEMORY_ERR
+ */
+void * scilU_workspace_alloc(scilU_workspace_t * ws, size_t size);
+
+scilU_workspace_mark_t scilU_workspace_mark(const scilU_workspace_t * ws);
+
+/**
+ * \brief Release all allocations done after the mark was taken.
+ */
+void scilU_workspace_release(scilU_workspace_t * ws, scilU_workspace_mark_t mark);
+
+/**
+ * \brief Limit the bytes the arena keeps once all allocations are released, unlimited by default.
+ */
+void scilU_workspace_set_retained(scilU_workspace_t * ws, size_t size);
+
+/**
+ * \brief The number of bytes the arena holds.
+ */
+size_t scilU_workspace_capacity(const scilU_workspace_t * ws);
+
+/**
+ * \brief The arena of the calling thread, it is used where no context is available, e.g., for decompression.
+ * It keeps at most 16 MiB once all allocations are released.
+ */
+scilU_workspace_t * scilU_get_thread_workspace();
+
+#endif // SCIL_WORKSPACE_H
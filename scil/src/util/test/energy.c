@@ -0,0 +1,77 @@
+// Checks the energy model and that further meters can be plugged in.
+#include <scil-energy.h>
+#include <scil-hardware-limits.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static double fake_joules = 0;
+
+static int fake_open(void){
+  return SCIL_NO_ERR;
+}
+
+static void fake_start(scilU_energy_mark_t * mark){
+  mark->counters[0] = 1;
+}
+
+static double fake_stop(const scilU_energy_mark_t * mark){
+  assert(mark->counters[0] == 1);
+  return fake_joules;
+}
+
+static const scilU_energy_meter_t fake_meter = {
+  .name = "fake",
+  .resolution = 0,
+  .open = fake_open,
+  .start = fake_start,
+  .stop = fake_stop
+};
+
+static volatile double sink = 0;
+
+int main(void){
+  scilU_initialize_hardware_limits();
+  scilU_add_hardware_limit("power_active", "100");
+  scilU_add_hardware_limit("power_idle", "10");
+  assert(fabs(scilU_energy_model(2, 3) - 230) < 1e-9);
+
+  assert(scilU_energy_select("model") == SCIL_NO_ERR);
+  assert(strcmp(scilU_energy_get_meter()->name, "model") == 0);
+  scilU_energy_mark_t mark;
+  // a busy CPU consumes more than a waiting one
+  scilU_energy_start(& mark);
+  for(int i = 0; i < 10000000; i++){
+    sink += i * 0.5;
+  }
+  const double busy = scilU_energy_stop(& mark);
+  scilU_energy_start(& mark);
+  usleep(20000);
+  const double idle = scilU_energy_stop(& mark);
+  printf("busy: %f J idle: %f J\n", busy, idle);
+  assert(busy > 0 && idle > 0);
+  assert(idle < 0.02 * 100);
+
+  // the counters may not be readable, the meter is kept then
+  if (scilU_energy_select("rapl") == SCIL_NO_ERR){
+    scilU_energy_start(& mark);
+    usleep(20000);
+    printf("rapl: %f J\n", scilU_energy_stop(& mark));
+  }else{
+    assert(strcmp(scilU_energy_get_meter()->name, "model") == 0);
+  }
+  assert(scilU_energy_select("unknown") == SCIL_EINVAL);
+
+  assert(scilU_energy_register(& fake_meter) == SCIL_NO_ERR);
+  assert(scilU_energy_select("fake") == SCIL_NO_ERR);
+  fake_joules = 42;
+  scilU_energy_start(& mark);
+  assert(fabs(scilU_energy_stop(& mark) - 42) < 1e-9);
+
+  printf("OK\n");
+  return 0;
+}
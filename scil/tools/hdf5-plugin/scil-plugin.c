@@ -211,7 +211,7 @@ static herr_t compressorSetLocal(hid_t pList, hid_t type_id, hid_t space) {
 
   assert(ret == SCIL_NO_ERR);
   
-  config->dst_size = scil_get_compressed_data_size_limit(&cfg_p->dims, cfg_p->type); 
+  config->dst_size = scil_compress_bound(config->ctx, &cfg_p->dims);
   // now we store the options with the dataset, this is actually not needed...
   return H5Pmodify_filter(pList, SCIL_ID, H5Z_FLAG_MANDATORY, cd_size, cd_values);
 }
@@ -230,9 +230,6 @@ static size_t compressorFilter(unsigned int flags,
     // uncompress
     plugin_config_persisted *cfg_p = ((plugin_config_persisted *) cd_values);
 
-    const size_t buff_size = scil_get_compressed_data_size_limit(&cfg_p->dims, cfg_p->type);
-    byte *buffer = (byte *) malloc(buff_size);
-
     byte *in_buf = ((byte **) buf)[0];
 
     size_t c_buf_size;
@@ -241,9 +238,24 @@ static size_t compressorFilter(unsigned int flags,
 
     debug("DC: %zu \n", c_buf_size);
 
-    ret = scil_decompress(cfg_p->type, buffer, &cfg_p->dims, in_buf, c_buf_size, buffer + buff_size / 2 + 1);
-    free(*buf);
-    *buf = buffer;
+    scil_frame_header_t header;
+    if (scil_peek_header(in_buf, c_buf_size, &header) == SCIL_NO_ERR) {
+      // the header tells the exact sizes
+      byte *buffer = (byte *) malloc(header.uncompressed_size);
+      byte *tmp = header.tmp_buffer_size > 0 ? (byte *) malloc(header.tmp_buffer_size) : NULL;
+      ret = scil_decompress(cfg_p->type, buffer, &cfg_p->dims, in_buf, c_buf_size, tmp);
+      free(tmp);
+      out_size = header.uncompressed_size;
+      *buf_size = header.uncompressed_size;
+      free(*buf);
+      *buf = buffer;
+    } else {
+      const size_t buff_size = scil_get_compressed_data_size_limit(&cfg_p->dims, cfg_p->type);
+      byte *buffer = (byte *) malloc(buff_size);
+      ret = scil_decompress(cfg_p->type, buffer, &cfg_p->dims, in_buf, c_buf_size, buffer + buff_size / 2 + 1);
+      free(*buf);
+      *buf = buffer;
+    }
 
   } else { // compress
 